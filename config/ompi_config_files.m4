@@ -57,6 +57,7 @@ AC_DEFUN([OMPI_CONFIG_FILES],[
         ompi/tools/wrappers/ompi-fort.pc
         ompi/tools/wrappers/mpijavac.pl
         ompi/tools/mpisync/Makefile
+        ompi/tools/ompi_trace_merge/Makefile
         ompi/tools/mpirun/Makefile
     ])
 ])
@@ -65,14 +65,14 @@ AC_DEFINE_UNQUOTED([OMPI_WANT_MPI_INTERFACE_WARNING], [$OMPI_WANT_MPI_INTERFACE_
 
 AC_MSG_CHECKING([if want sparse process groups])
 AC_ARG_ENABLE(sparse-groups,
-    AC_HELP_STRING([--enable-sparse-groups],
-                   [enable sparse process groups (default: not enabled)]))
-if test "$enable_sparse_groups" = "yes"; then
-    AC_MSG_RESULT([yes])
-    GROUP_SPARSE=1
-else
+    AC_HELP_STRING([--disable-sparse-groups],
+                   [disable sparse process groups (default: enabled)]))
+if test "$enable_sparse_groups" = "no"; then
     AC_MSG_RESULT([no])
     GROUP_SPARSE=0
+else
+    AC_MSG_RESULT([yes])
+    GROUP_SPARSE=1
 fi
 AC_DEFINE_UNQUOTED([OMPI_GROUP_SPARSE],$GROUP_SPARSE,
     [Whether we want sparse process groups])
@@ -530,6 +530,23 @@ fi
 AC_DEFINE_UNQUOTED([OPAL_ENABLE_GETPWUID], [$opal_want_getpwuid],
                    [Disable getpwuid support (default: enabled)])
 
+#
+# Tagged pointers in opal_lifo_t
+#
+AC_MSG_CHECKING([if want tagged pointers in the LIFO])
+AC_ARG_ENABLE([lifo-tagged-pointers],
+    [AC_HELP_STRING([--enable-lifo-tagged-pointers],
+        [Use a 64-bit compare-and-swap on a pointer tagged with a 16-bit counter instead of a 128-bit compare-and-swap in the lock-free LIFO on x86_64. This is faster, but only protects against the ABA problem up to 65535 concurrent pops (default: disabled)])])
+if test "$enable_lifo_tagged_pointers" = "yes"; then
+    AC_MSG_RESULT([yes])
+    opal_want_lifo_tagged_pointers=1
+else
+    AC_MSG_RESULT([no])
+    opal_want_lifo_tagged_pointers=0
+fi
+AC_DEFINE_UNQUOTED([OPAL_ENABLE_LIFO_TAGGED_POINTERS], [$opal_want_lifo_tagged_pointers],
+                   [Use tagged pointers instead of a 128-bit compare-and-swap in opal_lifo_t])
+
 dnl We no longer support the old OPAL_ENABLE_PROGRESS_THREADS.  At
 dnl some point, this should die.
 AC_DEFINE([OPAL_ENABLE_PROGRESS_THREADS],
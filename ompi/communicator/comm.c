@@ -52,6 +52,7 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/mca/pml/pml.h"
 #include "ompi/request/request.h"
+#include "ompi/runtime/params.h"
 
 /*
 ** sort-function for MPI_Comm_split
@@ -665,17 +666,19 @@ static int ompi_comm_split_type_get_part (ompi_group_t *group, const int split_t
             opal_process_name_t proc_name = ompi_proc_sentinel_to_name ((uintptr_t) proc);
 
             if (split_type <= OMPI_COMM_TYPE_HOST) {
-                /* local ranks should never be represented by sentinel procs. ideally we
-                 * should be able to use OPAL_MODEX_RECV_VALUE_OPTIONAL but it does have
-                 * some overhead. update this to use the optional recv if that is ever fixed. */
-                continue;
-            }
-
-            u16ptr = &locality;
+                /* local ranks are only represented by sentinel procs if mpi_lazy_procs
+                 * is set. their locality is always available without asking the server. */
+                if (!ompi_mpi_lazy_procs) {
+                    continue;
+                }
+                locality = ompi_proc_name_locality (proc_name);
+            } else {
+                u16ptr = &locality;
 
-            OPAL_MODEX_RECV_VALUE(ret, PMIX_LOCALITY, &proc_name, &u16ptr, PMIX_UINT16);
-            if (OPAL_SUCCESS != ret) {
-                continue;
+                OPAL_MODEX_RECV_VALUE(ret, PMIX_LOCALITY, &proc_name, &u16ptr, PMIX_UINT16);
+                if (OPAL_SUCCESS != ret) {
+                    continue;
+                }
             }
         } else {
             locality = proc->super.proc_flags;
@@ -47,8 +47,10 @@
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/request/request.h"
 #include "ompi/runtime/mpiruntime.h"
+#include "ompi/runtime/params.h"
 
 struct ompi_comm_cid_context_t;
+struct ompi_comm_cid_block_t;
 
 typedef int (*ompi_comm_allreduce_impl_fn_t) (int *inbuf, int *outbuf, int count, struct ompi_op_t *op,
                                               struct ompi_comm_cid_context_t *cid_context,
@@ -78,6 +80,9 @@ struct ompi_comm_cid_context_t {
     bool send_first;
     int pml_tag;
     char *pmix_tag;
+    /** block the CID is taken from (INTRA/INTER modes) */
+    struct ompi_comm_cid_block_t *block;
+    int block_index;
 };
 
 typedef struct ompi_comm_cid_context_t ompi_comm_cid_context_t;
@@ -91,12 +96,79 @@ static void mca_comm_cid_context_destruct (ompi_comm_cid_context_t *context)
 {
     free (context->port_string);
     free (context->pmix_tag);
+    if (NULL != context->block) {
+        OBJ_RELEASE(context->block);
+    }
 }
 
 OBJ_CLASS_INSTANCE (ompi_comm_cid_context_t, opal_object_t,
                     mca_comm_cid_context_construct,
                     mca_comm_cid_context_destruct);
 
+/* number of CIDs probed by one block reservation round (multiple of 32) */
+#define OMPI_COMM_CID_WINDOW       2048
+#define OMPI_COMM_CID_WINDOW_WORDS (OMPI_COMM_CID_WINDOW / 32)
+
+/**
+ * Block of CIDs reserved over a parent communicator.
+ *
+ * Each process of the parent reserves all of its locally free CIDs in
+ * a window and the reservation bitmaps are combined with one MPI_BAND
+ * allreduce. The first size CIDs free everywhere are kept, the
+ * remainder of the window is released. Until they are handed out the
+ * kept slots hold OMPI_COMM_CID_RESERVED.
+ *
+ * The first block of a parent holds a single CID and every following
+ * block twice as many as the previous one, up to
+ * ompi_comm_cid_block_size. A parent therefore never holds more unused
+ * CIDs than it has handed out, and parents that create a single
+ * communicator do not waste any. Near the end of the CID space a block
+ * may hold fewer CIDs than requested (count < size), the creations
+ * that find no entry fall back to the agreement protocol.
+ *
+ * Blocking INTRA/INTER mode creations on the parent are made in the
+ * same order by every process of the parent, so the per-parent creation
+ * counter (c_cid_seq), incremented by the calling thread when the
+ * creation starts, selects the same entry of the block everywhere and
+ * no further agreement is needed. Nonblocking creations (MPI_Comm_idup)
+ * make progress from callbacks in an order that can differ between the
+ * processes and therefore keep using the agreement protocol.
+ */
+struct ompi_comm_cid_block_t {
+    opal_object_t super;
+
+    ompi_communicator_t *comm;
+    ompi_comm_cid_context_t *context;
+    uint32_t first_seq;
+    int size;
+    int count;
+    unsigned int window;
+    int error;
+    volatile bool complete;
+    int *cids;
+    uint32_t local[OMPI_COMM_CID_WINDOW_WORDS];
+    uint32_t global[OMPI_COMM_CID_WINDOW_WORDS];
+};
+
+typedef struct ompi_comm_cid_block_t ompi_comm_cid_block_t;
+
+static void ompi_comm_cid_block_construct (ompi_comm_cid_block_t *block)
+{
+    memset ((void *) ((intptr_t) block + sizeof (block->super)), 0, sizeof (*block) - sizeof (block->super));
+}
+
+static void ompi_comm_cid_block_destruct (ompi_comm_cid_block_t *block)
+{
+    free (block->cids);
+    if (NULL != block->context) {
+        OBJ_RELEASE(block->context);
+    }
+}
+
+OBJ_CLASS_INSTANCE (ompi_comm_cid_block_t, opal_object_t,
+                    ompi_comm_cid_block_construct,
+                    ompi_comm_cid_block_destruct);
+
 struct ompi_comm_allreduce_context_t {
     opal_object_t super;
 
@@ -246,14 +318,254 @@ static int ompi_comm_checkcid (ompi_comm_request_t *request);
 /* verify that the cid was available globally */
 static int ompi_comm_nextcid_check_flag (ompi_comm_request_t *request);
 
+/* take the CID of the new communicator from the parent's block */
+static int ompi_comm_nextcid_from_block (ompi_comm_request_t *request);
+/* reserve the free CIDs of the current window and start the allreduce */
+static int ompi_comm_cid_block_start_round (ompi_comm_request_t *request);
+/* keep the CIDs available everywhere and release the others */
+static int ompi_comm_cid_block_round_complete (ompi_comm_request_t *request);
+
 static volatile int64_t ompi_comm_cid_lowest_id = INT64_MAX;
 
-int ompi_comm_nextcid_nb (ompi_communicator_t *newcomm, ompi_communicator_t *comm,
-                          ompi_communicator_t *bridgecomm, const void *arg0, const void *arg1,
-                          bool send_first, int mode, ompi_request_t **req)
+/**
+ * Assign the next entry of the parent's CID block to the context,
+ * reserving a new block if the current one is exhausted. Only called
+ * by the thread making a blocking creation. The reservation allreduce
+ * is started here (and not from a progress callback) so that it is
+ * ordered with the other collectives on the parent communicator. The
+ * rare additional rounds are started by the completion callback while
+ * that thread still waits for the block.
+ */
+static int ompi_comm_cid_block_get (ompi_comm_cid_context_t *context, int mode,
+                                    ompi_request_t **refill)
+{
+    ompi_communicator_t *comm = context->comm;
+    ompi_comm_cid_block_t *block = NULL;
+    ompi_comm_request_t *request = NULL;
+    uint32_t seq;
+    int ret;
+
+    *refill = NULL;
+
+    OPAL_THREAD_LOCK(&ompi_cid_lock);
+
+    seq = comm->c_cid_seq++;
+    block = comm->c_cid_block;
+
+    if (NULL == block || (int) (seq - block->first_seq) >= block->size) {
+        int size = (NULL == block) ? 1 : block->size * 2;
+
+        block = OBJ_NEW(ompi_comm_cid_block_t);
+        request = ompi_comm_request_get ();
+        if (OPAL_UNLIKELY(NULL == block || NULL == request)) {
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+            goto err_exit;
+        }
+
+        block->comm = comm;
+        block->first_seq = seq;
+        block->size = (size < ompi_comm_cid_block_size) ? size : ompi_comm_cid_block_size;
+        block->cids = (int *) malloc (block->size * sizeof (int));
+        block->context = mca_comm_cid_context_alloc (NULL, comm, NULL, NULL, NULL, "cidblock",
+                                                     false, mode);
+        if (OPAL_UNLIKELY(NULL == block->cids || NULL == block->context)) {
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+            goto err_exit;
+        }
+
+        /* the parent must outlive the reservation */
+        OBJ_RETAIN(comm);
+        OBJ_RETAIN(block);
+        request->context = &block->super;
+
+        ret = ompi_comm_cid_block_start_round (request);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
+            OBJ_RELEASE(comm);
+            goto err_exit;
+        }
+
+        /* all entries of the previous block have been handed out */
+        if (NULL != comm->c_cid_block) {
+            OBJ_RELEASE(comm->c_cid_block);
+        }
+        comm->c_cid_block = block;
+
+        ompi_comm_request_start (request);
+        *refill = &request->super;
+    }
+
+    OBJ_RETAIN(block);
+    context->block = block;
+    context->block_index = (int) (seq - block->first_seq);
+
+    OPAL_THREAD_UNLOCK(&ompi_cid_lock);
+
+    return OMPI_SUCCESS;
+err_exit:
+    /* keep the creation counter consistent with the other processes */
+    --comm->c_cid_seq;
+    OPAL_THREAD_UNLOCK(&ompi_cid_lock);
+    if (NULL != request) {
+        ompi_comm_request_return (request);
+    }
+    if (NULL != block) {
+        OBJ_RELEASE(block);
+    }
+    return ret;
+}
+
+static int ompi_comm_cid_block_start_round (ompi_comm_request_t *request)
+{
+    ompi_comm_cid_block_t *block = (ompi_comm_cid_block_t *) request->context;
+    unsigned int end = block->window + OMPI_COMM_CID_WINDOW;
+    ompi_request_t *subreq;
+    int ret;
+
+    if (end > mca_pml.pml_max_contextid) {
+        end = mca_pml.pml_max_contextid;
+    }
+
+    memset (block->local, 0, sizeof (block->local));
+    for (unsigned int i = block->window ; i < end ; ++i) {
+        if (opal_pointer_array_test_and_set_item (&ompi_mpi_communicators, i, OMPI_COMM_CID_RESERVED)) {
+            block->local[(i - block->window) / 32] |= 1u << ((i - block->window) % 32);
+        }
+    }
+
+    ret = block->context->allreduce_fn ((int *) block->local, (int *) block->global,
+                                        OMPI_COMM_CID_WINDOW_WORDS, MPI_BAND, block->context,
+                                        &subreq);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
+        for (unsigned int i = block->window ; i < end ; ++i) {
+            if (block->local[(i - block->window) / 32] & (1u << ((i - block->window) % 32))) {
+                opal_pointer_array_set_item (&ompi_mpi_communicators, i, NULL);
+            }
+        }
+        return ret;
+    }
+
+    return ompi_comm_request_schedule_append (request, ompi_comm_cid_block_round_complete, &subreq, 1);
+}
+
+static int ompi_comm_cid_block_round_complete (ompi_comm_request_t *request)
+{
+    ompi_comm_cid_block_t *block = (ompi_comm_cid_block_t *) request->context;
+    ompi_communicator_t *comm = block->comm;
+    int ret = request->super.req_status.MPI_ERROR;
+
+    OPAL_THREAD_LOCK(&ompi_cid_lock);
+
+    for (unsigned int i = 0 ; i < OMPI_COMM_CID_WINDOW ; ++i) {
+        uint32_t bit = 1u << (i % 32);
+
+        if (!(block->local[i / 32] & bit)) {
+            continue;
+        }
+
+        if (OMPI_SUCCESS == ret && block->count < block->size && (block->global[i / 32] & bit)) {
+            block->cids[block->count++] = (int) (block->window + i);
+        } else {
+            opal_pointer_array_set_item (&ompi_mpi_communicators, block->window + i, NULL);
+        }
+    }
+
+    if (OMPI_SUCCESS == ret && block->count < block->size) {
+        /* not enough CIDs are free everywhere in this window. this is the
+         * only case requiring more than one collective operation. */
+        block->window += OMPI_COMM_CID_WINDOW;
+        if (block->window < mca_pml.pml_max_contextid) {
+            ret = ompi_comm_cid_block_start_round (request);
+            if (OMPI_SUCCESS == ret) {
+                OPAL_THREAD_UNLOCK(&ompi_cid_lock);
+                return OMPI_SUCCESS;
+            }
+        }
+        /* at the end of the CID space keep the CIDs found so far. the
+         * allreduce results and thus count are the same everywhere. */
+    }
+
+    if (OMPI_SUCCESS != ret) {
+        for (int i = 0 ; i < block->count ; ++i) {
+            opal_pointer_array_set_item (&ompi_mpi_communicators, block->cids[i], NULL);
+        }
+        block->count = 0;
+        block->error = ret;
+    }
+
+    opal_atomic_wmb ();
+    block->complete = true;
+    block->comm = NULL;
+
+    OPAL_THREAD_UNLOCK(&ompi_cid_lock);
+
+    OBJ_RELEASE(comm);
+
+    return ret;
+}
+
+static int ompi_comm_nextcid_from_block (ompi_comm_request_t *request)
+{
+    ompi_comm_cid_context_t *context = (ompi_comm_cid_context_t *) request->context;
+    ompi_comm_cid_block_t *block = context->block;
+    int cid;
+
+    if (OMPI_SUCCESS != request->super.req_status.MPI_ERROR) {
+        return request->super.req_status.MPI_ERROR;
+    }
+
+    if (!block->complete) {
+        /* the reservation was started by an earlier creation on the same parent */
+        return ompi_comm_request_schedule_append (request, ompi_comm_nextcid_from_block, NULL, 0);
+    }
+
+    opal_atomic_rmb ();
+
+    if (OMPI_SUCCESS != block->error) {
+        return block->error;
+    }
+
+    if (context->block_index >= block->count) {
+        /* the end of the CID space was reached while reserving the block */
+        return ompi_comm_request_schedule_append (request, ompi_comm_allreduce_getnextcid, NULL, 0);
+    }
+
+    OPAL_THREAD_LOCK(&ompi_cid_lock);
+    cid = block->cids[context->block_index];
+    block->cids[context->block_index] = -1;
+
+    context->newcomm->c_contextid = cid;
+    opal_pointer_array_set_item (&ompi_mpi_communicators, cid, context->newcomm);
+    OPAL_THREAD_UNLOCK(&ompi_cid_lock);
+
+    return OMPI_SUCCESS;
+}
+
+void ompi_comm_cid_block_release (ompi_communicator_t *comm)
+{
+    ompi_comm_cid_block_t *block = comm->c_cid_block;
+
+    OPAL_THREAD_LOCK(&ompi_cid_lock);
+    comm->c_cid_block = NULL;
+    /* the parent is retained while the reservation is in progress */
+    for (int i = 0 ; i < block->count ; ++i) {
+        if (0 <= block->cids[i] &&
+            OMPI_COMM_CID_RESERVED == opal_pointer_array_get_item (&ompi_mpi_communicators, block->cids[i])) {
+            opal_pointer_array_set_item (&ompi_mpi_communicators, block->cids[i], NULL);
+        }
+    }
+    OPAL_THREAD_UNLOCK(&ompi_cid_lock);
+
+    OBJ_RELEASE(block);
+}
+
+static int ompi_comm_nextcid_start (ompi_communicator_t *newcomm, ompi_communicator_t *comm,
+                                    ompi_communicator_t *bridgecomm, const void *arg0, const void *arg1,
+                                    bool send_first, int mode, bool use_block, ompi_request_t **req)
 {
     ompi_comm_cid_context_t *context;
     ompi_comm_request_t *request;
+    ompi_request_t *refill;
+    int ret;
 
     context = mca_comm_cid_context_alloc (newcomm, comm, bridgecomm, arg0, arg1,
                                           "nextcid", send_first, mode);
@@ -271,7 +583,20 @@ int ompi_comm_nextcid_nb (ompi_communicator_t *newcomm, ompi_communicator_t *com
 
     request->context = &context->super;
 
-    ompi_comm_request_schedule_append (request, ompi_comm_allreduce_getnextcid, NULL, 0);
+    if (use_block && (OMPI_COMM_CID_INTRA == mode || OMPI_COMM_CID_INTER == mode) &&
+        0 < ompi_comm_cid_block_size) {
+        /* all processes of the parent take part: use the parent's block */
+        ret = ompi_comm_cid_block_get (context, mode, &refill);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
+            ompi_comm_request_return (request);
+            return ret;
+        }
+
+        ompi_comm_request_schedule_append (request, ompi_comm_nextcid_from_block, &refill,
+                                           (NULL != refill) ? 1 : 0);
+    } else {
+        ompi_comm_request_schedule_append (request, ompi_comm_allreduce_getnextcid, NULL, 0);
+    }
     ompi_comm_request_start (request);
 
     *req = &request->super;
@@ -280,6 +605,15 @@ int ompi_comm_nextcid_nb (ompi_communicator_t *newcomm, ompi_communicator_t *com
     return OMPI_SUCCESS;
 }
 
+int ompi_comm_nextcid_nb (ompi_communicator_t *newcomm, ompi_communicator_t *comm,
+                          ompi_communicator_t *bridgecomm, const void *arg0, const void *arg1,
+                          bool send_first, int mode, ompi_request_t **req)
+{
+    /* may be called from a progress callback: do not draw from the block */
+    return ompi_comm_nextcid_start (newcomm, comm, bridgecomm, arg0, arg1, send_first, mode,
+                                    false, req);
+}
+
 int ompi_comm_nextcid (ompi_communicator_t *newcomm, ompi_communicator_t *comm,
                        ompi_communicator_t *bridgecomm, const void *arg0, const void *arg1,
                        bool send_first, int mode)
@@ -287,7 +621,8 @@ int ompi_comm_nextcid (ompi_communicator_t *newcomm, ompi_communicator_t *comm,
     ompi_request_t *req;
     int rc;
 
-    rc = ompi_comm_nextcid_nb (newcomm, comm, bridgecomm, arg0, arg1, send_first, mode, &req);
+    rc = ompi_comm_nextcid_start (newcomm, comm, bridgecomm, arg0, arg1, send_first, mode,
+                                  true, &req);
     if (OMPI_SUCCESS != rc) {
         return rc;
     }
@@ -55,6 +55,7 @@
 */
 opal_pointer_array_t ompi_mpi_communicators = {{0}};
 opal_pointer_array_t ompi_comm_f_to_c_table = {{0}};
+char ompi_comm_cid_reserved = 0;
 
 ompi_predefined_communicator_t  ompi_mpi_comm_world = {{{{0}}}};
 ompi_predefined_communicator_t  ompi_mpi_comm_self = {{{{0}}}};
@@ -321,7 +322,7 @@ int ompi_comm_finalize(void)
     max = opal_pointer_array_get_size(&ompi_mpi_communicators);
     for ( i=3; i<max; i++ ) {
         comm = (ompi_communicator_t *)opal_pointer_array_get_item(&ompi_mpi_communicators, i);
-        if ( NULL != comm ) {
+        if ( NULL != comm && OMPI_COMM_CID_RESERVED != (void *) comm ) {
             /* Communicator has not been freed before finalize */
             OBJ_RELEASE(comm);
             comm=(ompi_communicator_t *)opal_pointer_array_get_item(&ompi_mpi_communicators, i);
@@ -369,6 +370,8 @@ static void ompi_comm_construct(ompi_communicator_t* comm)
     comm->c_contextid    = MPI_UNDEFINED;
     comm->c_id_available = MPI_UNDEFINED;
     comm->c_id_start_index = MPI_UNDEFINED;
+    comm->c_cid_block    = NULL;
+    comm->c_cid_seq      = 0;
     comm->c_flags        = 0;
     comm->c_my_rank      = 0;
     comm->c_cube_dim     = 0;
@@ -450,6 +453,11 @@ static void ompi_comm_destruct(ompi_communicator_t* comm)
         comm->error_handler = NULL;
     }
 
+    /* return the CIDs reserved for derived communicators */
+    if (NULL != comm->c_cid_block) {
+        ompi_comm_cid_block_release (comm);
+    }
+
     /* mark this cid as available */
     if ( MPI_UNDEFINED != (int)comm->c_contextid &&
          NULL != opal_pointer_array_get_item(&ompi_mpi_communicators,
@@ -131,6 +131,12 @@ OMPI_DECLSPEC OBJ_CLASS_DECLARATION(ompi_communicator_t);
 OMPI_DECLSPEC extern opal_pointer_array_t ompi_mpi_communicators;
 OMPI_DECLSPEC extern opal_pointer_array_t ompi_comm_f_to_c_table;
 
+/* Content of the ompi_mpi_communicators slots of CIDs reserved for
+   communicators that have not been created yet (see comm_cid.c). Such
+   a slot is not free but does not refer to a communicator either. */
+OMPI_DECLSPEC extern char ompi_comm_cid_reserved;
+#define OMPI_COMM_CID_RESERVED ((void *) &ompi_comm_cid_reserved)
+
 struct ompi_communicator_t {
     opal_infosubscriber_t      super;
     opal_mutex_t               c_lock; /* mutex for name and potentially
@@ -147,6 +153,12 @@ struct ompi_communicator_t {
     int c_id_start_index; /* the starting index of the block of cids
                  allocated to this communicator*/
 
+    /* CIDs reserved for communicators derived from this one (see
+       comm_cid.c). c_cid_seq counts the INTRA/INTER mode creations
+       on this communicator and selects the entry of the block. */
+    struct ompi_comm_cid_block_t *c_cid_block;
+    uint32_t c_cid_seq;
+
     ompi_group_t        *c_local_group;
     ompi_group_t       *c_remote_group;
 
@@ -376,7 +388,9 @@ static inline uint32_t ompi_comm_get_cid(ompi_communicator_t* comm)
 static inline ompi_communicator_t *ompi_comm_lookup(uint32_t cid)
 {
     /* array of pointers to communicators, indexed by context ID */
-    return (ompi_communicator_t*)opal_pointer_array_get_item(&ompi_mpi_communicators, cid);
+    void *comm = opal_pointer_array_get_item(&ompi_mpi_communicators, cid);
+
+    return OPAL_UNLIKELY(OMPI_COMM_CID_RESERVED == comm) ? NULL : (ompi_communicator_t *) comm;
 }
 
 static inline struct ompi_proc_t* ompi_comm_peer_lookup(ompi_communicator_t* comm, int peer_id)
@@ -562,6 +576,14 @@ ompi_communicator_t* ompi_comm_allocate (int local_group_size,
  * @param send_first: to avoid a potential deadlock for
  *                    the OOB version.
  * This routine has to be thread safe in the final version.
+ *
+ * In the OMPI_COMM_CID_INTRA and OMPI_COMM_CID_INTER modes the CID is
+ * taken from a block of CIDs reserved over oldcomm (see
+ * mpi_comm_cid_block_size), so at most one collective operation is
+ * required and most creations need none. Only when the CID space is
+ * nearly exhausted the agreement protocol is used. The entry of the block is
+ * selected when this function is called, so the calls on oldcomm must
+ * be made in the same order by all processes, as for any collective.
  */
 OMPI_DECLSPEC int ompi_comm_nextcid (ompi_communicator_t *newcomm, ompi_communicator_t *comm,
                                      ompi_communicator_t *bridgecomm, const void *arg0, const void *arg1,
@@ -575,6 +597,9 @@ OMPI_DECLSPEC int ompi_comm_nextcid (ompi_communicator_t *newcomm, ompi_communic
  * @param mode: combination of input
  *              OMPI_COMM_CID_INTRA:        intra-comm
  *              OMPI_COMM_CID_INTER:        inter-comm
+ * The agreement protocol is always used: the progress of nonblocking
+ * creations does not follow the same order on all processes, so no
+ * entry of a reserved block can be selected for them.
  * This routine has to be thread safe in the final version.
  */
 OMPI_DECLSPEC int ompi_comm_nextcid_nb (ompi_communicator_t *newcomm, ompi_communicator_t *comm,
@@ -712,6 +737,12 @@ extern int ompi_comm_num_dyncomm;
 */
 OMPI_DECLSPEC int ompi_comm_cid_init ( void );
 
+/**
+ * Release the CIDs reserved for communicators derived from comm that
+ * have not been handed out yet. Called when comm is destroyed.
+ */
+void ompi_comm_cid_block_release (ompi_communicator_t *comm);
+
 
 void ompi_comm_assert_subscribe (ompi_communicator_t *comm, int32_t assert_flag);
 
@@ -187,25 +187,58 @@ int ompi_group_minloc ( int list[] , int length )
     return index;
 }
 
-int ompi_group_incl(ompi_group_t* group, int n, const int *ranks, ompi_group_t **new_group)
+int ompi_group_select_storage (int n, int orig_size, const int *ranks)
 {
-    int method,result;
+    int method = 0;
 
-    method = 0;
 #if OMPI_GROUP_SPARSE
-    if (ompi_use_sparse_group_storage) {
+    /* small groups are cheap enough as a plain list and avoid the extra
+     * translation step on every proc lookup */
+    if (ompi_use_sparse_group_storage && n >= ompi_sparse_group_min_size) {
         int len [4];
 
         len[0] = ompi_group_calc_plist    ( n ,ranks );
         len[1] = ompi_group_calc_strided  ( n ,ranks );
         len[2] = ompi_group_calc_sporadic ( n ,ranks );
-        len[3] = ompi_group_calc_bmap     ( n , group->grp_proc_count ,ranks );
+        len[3] = ompi_group_calc_bmap     ( n , orig_size ,ranks );
 
         /* determin minimum length */
         method = ompi_group_minloc ( len, 4 );
     }
 #endif
 
+    return method;
+}
+
+int ompi_group_incl(ompi_group_t* group, int n, const int *ranks, ompi_group_t **new_group)
+{
+    int method,result;
+    int *parent_ranks = NULL;
+
+    /* sparse groups always refer to a dense parent: translate the ranks up
+     * to the closest dense ancestor so lookups never walk a chain */
+    if (0 < n && !OMPI_GROUP_IS_DENSE(group)) {
+        parent_ranks = (int *) malloc (n * sizeof (int));
+        if (NULL == parent_ranks) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+
+        for (int i = 0 ; i < n ; ++i) {
+            parent_ranks[i] = ranks[i];
+        }
+
+        do {
+            for (int i = 0 ; i < n ; ++i) {
+                parent_ranks[i] = ompi_group_sparse_rank_to_parent (group, parent_ranks[i]);
+            }
+            group = group->grp_parent_group_ptr;
+        } while (!OMPI_GROUP_IS_DENSE(group));
+
+        ranks = parent_ranks;
+    }
+
+    method = ompi_group_select_storage (n, group->grp_proc_count, ranks);
+
     switch (method)
         {
         case 0:
@@ -222,6 +255,8 @@ int ompi_group_incl(ompi_group_t* group, int n, const int *ranks, ompi_group_t *
             break;
         }
 
+    free (parent_ranks);
+
     return result;
 }
 
@@ -559,18 +594,19 @@ int ompi_group_compare(ompi_group_t *group1,
 bool ompi_group_have_remote_peers (ompi_group_t *group)
 {
     for (int i = 0 ; i < group->grp_proc_count ; ++i) {
-        ompi_proc_t *proc = NULL;
-#if OMPI_GROUP_SPARSE
-        proc = ompi_group_peer_lookup (group, i);
-#else
-        proc = ompi_group_get_proc_ptr_raw (group, i);
+        /* do not create the procs (sparse groups included), coll/sm asks
+         * this of every communicator */
+        ompi_proc_t *proc = ompi_group_get_proc_ptr_raw (group, i);
         if (ompi_proc_is_sentinel (proc)) {
             /* the proc must be stored in the group or cached in the proc
              * hash table if the process resides in the local node
-             * (see ompi_proc_complete_init) */
-            return true;
+             * (see ompi_proc_complete_init), unless mpi_lazy_procs is set */
+            if (!ompi_mpi_lazy_procs ||
+                !OPAL_PROC_ON_LOCAL_NODE(ompi_proc_name_locality (ompi_proc_sentinel_to_name ((uintptr_t) proc)))) {
+                return true;
+            }
+            continue;
         }
-#endif
         if (!OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags)) {
             return true;
         }
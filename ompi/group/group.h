@@ -42,11 +42,14 @@
 BEGIN_C_DECLS
 
 #define BSIZE ((int)sizeof(unsigned char)*8)
+/* number of bitmap bytes covered by one entry of the bitmap rank directory */
+#define OMPI_GROUP_BITMAP_BLOCK 32
 
 struct ompi_group_sporadic_list_t
 {
   int rank_first;
   int length;
+  int child_first; /** rank in the child group of rank_first */
 };
 
 struct ompi_group_sporadic_data_t
@@ -54,6 +57,8 @@ struct ompi_group_sporadic_data_t
     struct ompi_group_sporadic_list_t  *grp_sporadic_list;
                                             /** list to hold the sporadic struct */
     int                        grp_sporadic_list_len;/** length of the structure*/
+    bool                       grp_sporadic_sorted; /** ranges are in increasing
+                                                        order of rank_first */
 };
 struct ompi_group_strided_data_t
 {
@@ -65,6 +70,8 @@ struct ompi_group_bitmap_data_t
 {
     unsigned char *grp_bitmap_array;     /* the bit map array for sparse groups of type BMAP */
     int            grp_bitmap_array_len; /* length of the bit array */
+    int           *grp_bitmap_rank;      /* rank of the first member of every
+                                            OMPI_GROUP_BITMAP_BLOCK bytes of the array */
 };
 
 /**
@@ -280,6 +287,35 @@ int ompi_group_translate_ranks_bmap_reverse ( ompi_group_t *group1,
                                  ompi_group_t *group2,
                                  int *ranks2);
 
+/**
+ * Rank in the parent group of rank in a sporadic group (binary search
+ * over the ranges)
+ */
+int ompi_group_sporadic_rank_to_parent (ompi_group_t *group, int rank);
+
+/**
+ * @brief Translate a rank of a sparse group to its parent group
+ *
+ * Strided groups translate in O(1) and sporadic groups in
+ * O(log(#ranges)) without going through ompi_group_translate_ranks().
+ */
+static inline int ompi_group_sparse_rank_to_parent (ompi_group_t *group, int rank)
+{
+    int parent_rank;
+
+    if (OMPI_GROUP_IS_STRIDED(group)) {
+        return group->sparse_data.grp_strided.grp_strided_offset +
+            rank * group->sparse_data.grp_strided.grp_strided_stride;
+    }
+
+    if (OMPI_GROUP_IS_SPORADIC(group)) {
+        return ompi_group_sporadic_rank_to_parent (group, rank);
+    }
+
+    ompi_group_translate_ranks (group, 1, &rank, group->grp_parent_group_ptr, &parent_rank);
+    return parent_rank;
+}
+
 /**
  *  Prototypes for the group back-end functions. Argument lists
  are similar to the according  C MPI functions.
@@ -320,6 +356,14 @@ int ompi_group_calc_strided ( int n, const int *ranks );
 int ompi_group_calc_sporadic ( int n, const int *ranks );
 int ompi_group_calc_bmap ( int n, int orig_size , const int *ranks );
 
+/**
+ * Select the storage format for a group of n processes out of a
+ * group of orig_size processes (0: plist, 1: strided, 2: sporadic,
+ * 3: bitmap). Groups smaller than mpi_sparse_group_min_size, or all
+ * groups if sparse storage is disabled, use the plist format.
+ */
+int ompi_group_select_storage ( int n, int orig_size, const int *ranks );
+
 /**
  * Function to return the minimum value in an array
  */
@@ -378,8 +422,7 @@ static inline ompi_proc_t *ompi_group_get_proc_ptr (ompi_group_t *group, int ran
         if (OMPI_GROUP_IS_DENSE(group)) {
             return ompi_group_dense_lookup (group, rank, allocate);
         }
-        int ranks1 = rank;
-        ompi_group_translate_ranks (group, 1, &ranks1, group->grp_parent_group_ptr, &rank);
+        rank = ompi_group_sparse_rank_to_parent (group, rank);
         group = group->grp_parent_group_ptr;
     } while (1);
 #else
@@ -30,54 +30,70 @@ static bool check_ranks (int, const int *);
 
 int ompi_group_calc_bmap ( int n, int orig_size , const int *ranks) {
     if (check_ranks(n,ranks)) {
-        return ompi_group_div_ceil(orig_size,BSIZE);
+        int len = ompi_group_div_ceil(orig_size,BSIZE);
+        /* the bitmap and its rank directory */
+        return len + (int) sizeof(int) * ompi_group_div_ceil(len,OMPI_GROUP_BITMAP_BLOCK);
     }
     else {
         return -1;
     }
 }
 
+/* number of bits set in every nibble */
+static const unsigned char bmap_nibble_bits[16] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+};
+
+static inline int bmap_bits (unsigned char byte)
+{
+    return bmap_nibble_bits[byte & 0xf] + bmap_nibble_bits[byte >> 4];
+}
+
+/* fill the rank directory: the rank of the first member of every block */
+static void bmap_build_rank (struct ompi_group_bitmap_data_t *bmap)
+{
+    int i, count = 0;
+
+    for (i = 0 ; i < bmap->grp_bitmap_array_len ; i++) {
+        if (0 == i % OMPI_GROUP_BITMAP_BLOCK) {
+            bmap->grp_bitmap_rank[i / OMPI_GROUP_BITMAP_BLOCK] = count;
+        }
+        count += bmap_bits (bmap->grp_bitmap_array[i]);
+    }
+}
+
 /* from parent group to child group*/
 int ompi_group_translate_ranks_bmap ( ompi_group_t *parent_group,
                                       int n_ranks, const int *ranks1,
                                       ompi_group_t *child_group,
                                       int *ranks2)
 {
-    int i,count,j,k,m;
-    unsigned char tmp, tmp1;
+    struct ompi_group_bitmap_data_t *bmap = &child_group->sparse_data.grp_bitmap;
+    int i, j, m, byte, count;
+
     for (j=0 ; j<n_ranks ; j++) {
         if ( MPI_PROC_NULL == ranks1[j]) {
             ranks2[j] = MPI_PROC_NULL;
+            continue;
         }
-        else {
-            ranks2[j] = MPI_UNDEFINED;
-            m = ranks1[j];
-            count = 0;
-            tmp = ( 1 << (m % BSIZE) );
-            /* check if the bit that correponds to the parent rank is set in the bitmap */
-            if ( tmp == (child_group->sparse_data.grp_bitmap.grp_bitmap_array[(int)(m/BSIZE)]
-                         & (1 << (m % BSIZE)))) {
-                /*
-                 * add up how many bits are set, till we get to the bit of parent
-                 * rank that we want. The rank in the child will be the sum of the bits
-                 * that are set on the way till we get to the correponding bit
-                 */
-                for (i=0 ; i<=(int)(m/BSIZE) ; i++) {
-                    for (k=0 ; k<BSIZE ; k++) {
-                        tmp1 = ( 1 << k);
-                        if ( tmp1 == ( child_group->sparse_data.grp_bitmap.grp_bitmap_array[i]
-                                       & (1 << k) ) ) {
-                            count++;
-                        }
-                        if( i==(int)(m/BSIZE) &&  k==m % BSIZE ) {
-                            ranks2[j] = count-1;
-                            i = (int)(m/BSIZE) + 1;
-                            break;
-                        }
-                    }
-                }
-            }
+
+        ranks2[j] = MPI_UNDEFINED;
+        m = ranks1[j];
+        byte = m / BSIZE;
+        /* check if the bit that correponds to the parent rank is set in the bitmap */
+        if (!(bmap->grp_bitmap_array[byte] & (1 << (m % BSIZE)))) {
+            continue;
+        }
+
+        /*
+         * the rank in the child is the number of bits set before the one of
+         * the parent rank: start from the count of the enclosing block
+         */
+        count = bmap->grp_bitmap_rank[byte / OMPI_GROUP_BITMAP_BLOCK];
+        for (i = byte - byte % OMPI_GROUP_BITMAP_BLOCK ; i < byte ; i++) {
+            count += bmap_bits (bmap->grp_bitmap_array[i]);
         }
+        ranks2[j] = count + bmap_bits (bmap->grp_bitmap_array[byte] & ((1 << (m % BSIZE)) - 1));
     }
     return OMPI_SUCCESS;
 }
@@ -87,32 +103,50 @@ int ompi_group_translate_ranks_bmap_reverse ( ompi_group_t *child_group,
                                               ompi_group_t *parent_group,
                                               int *ranks2)
 {
-    int i,j,count,m,k;
-    unsigned char tmp;
+    struct ompi_group_bitmap_data_t *bmap = &child_group->sparse_data.grp_bitmap;
+    int nblocks = ompi_group_div_ceil (bmap->grp_bitmap_array_len, OMPI_GROUP_BITMAP_BLOCK);
+    int i, j, k, m, lo, hi, count, bits;
+
     for (j=0 ; j<n_ranks ; j++) {
         if ( MPI_PROC_NULL == ranks1[j]) {
             ranks2[j] = MPI_PROC_NULL;
+            continue;
         }
-        else {
-            m = ranks1[j];
-            count = 0;
-            /*
-             * Go through all the bits set in the bitmap up to the child rank.
-             * The parent rank will be the sum of all bits passed (set and unset)
-             */
-            for (i=0 ; i<child_group->sparse_data.grp_bitmap.grp_bitmap_array_len ; i++) {
-                for (k=0 ; k<BSIZE ; k++) {
-                    tmp = ( 1 << k);
-                    if ( tmp == ( child_group->sparse_data.grp_bitmap.grp_bitmap_array[i]
-                                  & (1 << k) ) ) {
-                        count++;
-                    }
-                    if( m == count-1 ) {
-                        ranks2[j] = i*BSIZE + k;
-                        i = child_group->sparse_data.grp_bitmap.grp_bitmap_array_len + 1;
-                        break;
-                    }
+
+        ranks2[j] = MPI_UNDEFINED;
+        m = ranks1[j];
+        if (m < 0 || m >= child_group->grp_proc_count) {
+            continue;
+        }
+
+        /* last block starting at or before the child rank */
+        lo = 0;
+        hi = nblocks - 1;
+        while (lo < hi) {
+            int mid = lo + (hi - lo + 1) / 2;
+            if (bmap->grp_bitmap_rank[mid] <= m) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        /* then the byte holding the bit, then the bit itself */
+        count = bmap->grp_bitmap_rank[lo];
+        for (i = lo * OMPI_GROUP_BITMAP_BLOCK ; i < bmap->grp_bitmap_array_len ; i++) {
+            bits = bmap_bits (bmap->grp_bitmap_array[i]);
+            if (count + bits > m) {
+                break;
+            }
+            count += bits;
+        }
+        for (k = 0 ; k < BSIZE ; k++) {
+            if (bmap->grp_bitmap_array[i] & (1 << k)) {
+                if (count == m) {
+                    ranks2[j] = i * BSIZE + k;
+                    break;
                 }
+                count++;
             }
         }
     }
@@ -176,6 +210,8 @@ int ompi_group_incl_bmap(ompi_group_t* group, int n, const int *ranks,
             sparse_data.grp_bitmap.grp_bitmap_array[(int)(ranks[i]/BSIZE)] |= (1 << bit_set);
     }
 
+    bmap_build_rank (&new_group_pointer->sparse_data.grp_bitmap);
+
     new_group_pointer -> grp_parent_group_ptr = group_pointer;
 
     OBJ_RETAIN(new_group_pointer -> grp_parent_group_ptr);
@@ -148,6 +148,7 @@ ompi_group_t *ompi_group_allocate_sporadic(int group_size)
     /* initialize our rank to MPI_UNDEFINED */
     new_group->grp_my_rank       = MPI_UNDEFINED;
     new_group->grp_proc_pointers = NULL;
+    new_group->sparse_data.grp_sporadic.grp_sporadic_sorted = true;
     OMPI_GROUP_SET_SPORADIC(new_group);
 
  error_exit:
@@ -202,6 +203,17 @@ ompi_group_t *ompi_group_allocate_bmap(int orig_group_size , int group_size)
     new_group->sparse_data.grp_bitmap.grp_bitmap_array_len =
         ompi_group_div_ceil(orig_group_size,BSIZE);
 
+    new_group->sparse_data.grp_bitmap.grp_bitmap_rank = (int *)malloc
+        (sizeof(int) * ompi_group_div_ceil(new_group->sparse_data.grp_bitmap.grp_bitmap_array_len,
+                                           OMPI_GROUP_BITMAP_BLOCK));
+    if (NULL == new_group->sparse_data.grp_bitmap.grp_bitmap_array ||
+        NULL == new_group->sparse_data.grp_bitmap.grp_bitmap_rank) {
+        OMPI_GROUP_SET_BITMAP(new_group);
+        OBJ_RELEASE(new_group);
+        new_group = NULL;
+        goto error_exit;
+    }
+
     new_group->grp_proc_count = group_size;
 
     /* initialize our rank to MPI_UNDEFINED */
@@ -296,6 +308,9 @@ static void ompi_group_destruct(ompi_group_t *group)
         if (NULL != group->sparse_data.grp_bitmap.grp_bitmap_array) {
             free(group->sparse_data.grp_bitmap.grp_bitmap_array);
         }
+        if (NULL != group->sparse_data.grp_bitmap.grp_bitmap_rank) {
+            free(group->sparse_data.grp_bitmap.grp_bitmap_rank);
+        }
     }
 
     if (NULL != group->grp_parent_group_ptr){
@@ -84,8 +84,7 @@ ompi_proc_t *ompi_group_get_proc_ptr_raw (ompi_group_t *group, int rank)
         if (OMPI_GROUP_IS_DENSE(group)) {
             return ompi_group_dense_lookup_raw (group, rank);
         }
-        int ranks1 = rank;
-        ompi_group_translate_ranks (group, 1, &ranks1, group->grp_parent_group_ptr, &rank);
+        rank = ompi_group_sparse_rank_to_parent (group, rank);
         group = group->grp_parent_group_ptr;
     } while (1);
 #else
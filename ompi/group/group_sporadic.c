@@ -26,20 +26,78 @@
 #include "ompi/constants.h"
 #include "mpi.h"
 
+static int ompi_group_sporadic_count_ranges (int n, const int *ranks)
+{
+    int i, l;
+
+    if (0 == n) {
+        return 0;
+    }
+
+    for (i = 1, l = 1 ; i < n ; i++) {
+        if (ranks[i] != ranks[i-1] + 1) {
+            l++;
+        }
+    }
+    return l;
+}
+
 int ompi_group_calc_sporadic ( int n , const int *ranks)
 {
-    int i,l=0;
-    for (i=0 ; i<n ; i++) {
-        if(ranks[i] == ranks[i-1]+1) {
-            if(l==0) {
-                l++;
+    return sizeof(struct ompi_group_sporadic_list_t ) * ompi_group_sporadic_count_ranges (n, ranks);
+}
+
+/* index of the range holding the parent rank, or -1 */
+static int ompi_group_sporadic_find_parent (ompi_group_t *child_group, int rank)
+{
+    struct ompi_group_sporadic_list_t *list = child_group->sparse_data.grp_sporadic.grp_sporadic_list;
+    int len = child_group->sparse_data.grp_sporadic.grp_sporadic_list_len;
+    int lo, hi;
+
+    if (!child_group->sparse_data.grp_sporadic.grp_sporadic_sorted) {
+        for (int i = 0 ; i < len ; i++) {
+            if (list[i].rank_first <= rank && rank < list[i].rank_first + list[i].length) {
+                return i;
             }
         }
-        else {
-            l++;
+        return -1;
+    }
+
+    /* find the last range starting at or before rank */
+    lo = 0;
+    hi = len - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (list[mid].rank_first <= rank) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    if (list[lo].rank_first <= rank && rank < list[lo].rank_first + list[lo].length) {
+        return lo;
+    }
+    return -1;
+}
+
+int ompi_group_sporadic_rank_to_parent (ompi_group_t *group, int rank)
+{
+    struct ompi_group_sporadic_list_t *list = group->sparse_data.grp_sporadic.grp_sporadic_list;
+    int lo = 0, hi = group->sparse_data.grp_sporadic.grp_sporadic_list_len - 1;
+
+    /* child ranks are always increasing over the list:
+     * find the last range starting at or before rank */
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (list[mid].child_first <= rank) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
         }
     }
-    return sizeof(struct ompi_group_sporadic_list_t ) * l;
+
+    return list[lo].rank_first + (rank - list[lo].child_first);
 }
 
 /* from parent group to child group*/
@@ -48,32 +106,24 @@ int ompi_group_translate_ranks_sporadic ( ompi_group_t *parent_group,
                                           ompi_group_t *child_group,
                                           int *ranks2)
 {
-    int i,count,j;
+    struct ompi_group_sporadic_list_t *list = child_group->sparse_data.grp_sporadic.grp_sporadic_list;
+    int i, j;
+
     for (j=0 ; j<n_ranks ; j++) {
         if (MPI_PROC_NULL == ranks1[j]) {
             ranks2[j] = MPI_PROC_NULL;
         }
         else {
             /*
-             * if the rank is in the current range of the sporadic list, we calculate
-             * the rank in the child by adding the length of all ranges that we passed
-             * and the position in the current range
+             * if the rank is in one of the ranges of the sporadic list, the rank in
+             * the child is the child rank of the first element of that range plus
+             * the position in the range
              */
-            ranks2[j] = MPI_UNDEFINED;
-            count = 0;
-            for(i=0 ; i <child_group->sparse_data.grp_sporadic.grp_sporadic_list_len ; i++) {
-                if( child_group->sparse_data.grp_sporadic.grp_sporadic_list[i].rank_first
-                    <= ranks1[j] && ranks1[j] <=
-                    child_group->sparse_data.grp_sporadic.grp_sporadic_list[i].rank_first +
-                    child_group->sparse_data.grp_sporadic.grp_sporadic_list[i].length -1 ) {
-
-                    ranks2[j] = ranks1[j] - child_group->
-                        sparse_data.grp_sporadic.grp_sporadic_list[i].rank_first + count;
-                    break;
-                }
-                else {
-                    count = count + child_group->sparse_data.grp_sporadic.grp_sporadic_list[i].length;
-                }
+            i = ompi_group_sporadic_find_parent (child_group, ranks1[j]);
+            if (0 > i) {
+                ranks2[j] = MPI_UNDEFINED;
+            } else {
+                ranks2[j] = list[i].child_first + (ranks1[j] - list[i].rank_first);
             }
         }
     }
@@ -85,30 +135,14 @@ int ompi_group_translate_ranks_sporadic_reverse ( ompi_group_t *child_group,
                                                   ompi_group_t *parent_group,
                                                   int *ranks2)
 {
-    int i,j,count;
+    int j;
 
     for (j=0 ; j<n_ranks ; j++) {
         if (MPI_PROC_NULL == ranks1[j]) {
             ranks2[j] = MPI_PROC_NULL;
         }
         else {
-            count = 0;
-            /*
-             * if the rank of the child is in the current range, the rank of the parent will be
-             * the position in the current range of the sporadic list
-             */
-            for (i=0 ; i<child_group->sparse_data.grp_sporadic.grp_sporadic_list_len ; i++) {
-                if ( ranks1[j] > ( count +
-                                   child_group->sparse_data.grp_sporadic.grp_sporadic_list[i].length
-                                   - 1) ) {
-                    count = count + child_group->sparse_data.grp_sporadic.grp_sporadic_list[i].length;
-                }
-                else {
-                    ranks2[j] = child_group->sparse_data.grp_sporadic.grp_sporadic_list[i].rank_first
-                        + (ranks1[j] - count);
-                    break;
-                }
-            }
+            ranks2[j] = ompi_group_sporadic_rank_to_parent (child_group, ranks1[j]);
         }
     }
     return OMPI_SUCCESS;
@@ -129,20 +163,10 @@ int ompi_group_incl_spor(ompi_group_t* group, int n, const int *ranks,
         return OMPI_SUCCESS;
     }
 
-    l=0;
     j=0;
     proc_count = 0;
 
-    for(i=0 ; i<n ; i++){
-        if(ranks[i] == ranks[i-1]+1) {
-            if(l==0) {
-                l++;
-            }
-        }
-        else {
-            l++;
-        }
-    }
+    l = ompi_group_sporadic_count_ranges (n, ranks);
 
     new_group_pointer = ompi_group_allocate_sporadic(l);
     if( NULL == new_group_pointer ) {
@@ -153,17 +177,25 @@ int ompi_group_incl_spor(ompi_group_t* group, int n, const int *ranks,
         sparse_data.grp_sporadic.grp_sporadic_list[j].rank_first = ranks[0];
     new_group_pointer ->
         sparse_data.grp_sporadic.grp_sporadic_list[j].length = 1;
+    new_group_pointer ->
+        sparse_data.grp_sporadic.grp_sporadic_list[j].child_first = 0;
+    new_group_pointer -> sparse_data.grp_sporadic.grp_sporadic_sorted = true;
 
     for(i=1 ; i<n ; i++){
         if(ranks[i] == ranks[i-1]+1) {
             new_group_pointer -> sparse_data.grp_sporadic.grp_sporadic_list[j].length ++;
         }
         else {
+            if (ranks[i] < ranks[i-1]) {
+                new_group_pointer -> sparse_data.grp_sporadic.grp_sporadic_sorted = false;
+            }
             j++;
             new_group_pointer ->
                 sparse_data.grp_sporadic.grp_sporadic_list[j].rank_first = ranks[i];
             new_group_pointer ->
                 sparse_data.grp_sporadic.grp_sporadic_list[j].length = 1;
+            new_group_pointer ->
+                sparse_data.grp_sporadic.grp_sporadic_list[j].child_first = i;
         }
     }
 
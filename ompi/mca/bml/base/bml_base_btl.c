@@ -22,6 +22,7 @@
 
 #include "ompi/mca/bml/bml.h"
 #include "bml_base_btl.h"
+#include "opal/mca/btl/base/base.h"
 #include "opal/util/crc.h"
 #if OPAL_ENABLE_DEBUG_RELIABILITY
 #include "opal/util/alfg.h"
@@ -68,6 +69,43 @@ int mca_bml_base_btl_array_reserve(mca_bml_base_btl_array_t* array, size_t size)
     return OMPI_SUCCESS;
 }
 
+static void mca_bml_base_backoff_hold_btl (mca_btl_base_module_t *btl, int32_t count)
+{
+    opal_progress_callback_t progress = btl->btl_component->btl_progress;
+
+    if (NULL == progress) {
+        return;
+    }
+
+    if (0 == count) {
+        opal_progress_backoff_wake_cb (progress);
+    } else {
+        opal_progress_backoff_hold_cb (progress, count);
+    }
+}
+
+static void mca_bml_base_backoff_hold_array (mca_bml_base_btl_array_t *array, int32_t count)
+{
+    for (size_t i = 0 ; i < mca_bml_base_btl_array_get_size (array) ; ++i) {
+        mca_bml_base_backoff_hold_btl (mca_bml_base_btl_array_get_index (array, i)->btl, count);
+    }
+}
+
+void mca_bml_base_backoff_hold (struct mca_bml_base_endpoint_t *endpoint, int32_t count)
+{
+    mca_btl_base_selected_module_t *sm;
+
+    if (NULL != endpoint) {
+        mca_bml_base_backoff_hold_array (&endpoint->btl_eager, count);
+        mca_bml_base_backoff_hold_array (&endpoint->btl_send, count);
+        return;
+    }
+
+    OPAL_LIST_FOREACH(sm, &mca_btl_base_modules_initialized, mca_btl_base_selected_module_t) {
+        mca_bml_base_backoff_hold_btl (sm->btl_module, count);
+    }
+}
+
 
 #if OPAL_ENABLE_DEBUG_RELIABILITY
 
@@ -104,6 +142,7 @@ int mca_bml_base_send( mca_bml_base_btl_t* bml_btl,
                        mca_btl_base_tag_t tag )
 {
     des->des_context = (void*)bml_btl;
+    opal_progress_backoff_wake (bml_btl->btl->btl_component->btl_progress);
     if(mca_bml_base_error_count <= 0 && mca_bml_base_error_rate_ceiling > 0) {
       mca_bml_base_error_count = (int) (((double) mca_bml_base_error_rate_ceiling *
                   opal_rand(&mca_bml_base_rand_buff))/(UINT32_MAX+1.0));
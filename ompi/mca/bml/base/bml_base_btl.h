@@ -32,9 +32,17 @@ BEGIN_C_DECLS
 
 /* forward declarations */
 struct mca_bml_base_btl_array_t;
+struct mca_bml_base_endpoint_t;
 
 OMPI_DECLSPEC int mca_bml_base_btl_array_reserve(struct mca_bml_base_btl_array_t* array, size_t size);
 
+/**
+ * Hold (count 1) or release (count -1) the progress backoff of the btls
+ * an endpoint sends and receives through, of all btls if endpoint is
+ * NULL. Count 0 only wakes them. See opal_progress_backoff_hold().
+ */
+OMPI_DECLSPEC void mca_bml_base_backoff_hold(struct mca_bml_base_endpoint_t *endpoint, int32_t count);
+
 
 END_C_DECLS
 #endif /* MCA_BML_BASE_H */
@@ -35,6 +35,7 @@
 #include "opal/mca/crs/crs.h"
 #include "opal/mca/crs/base/base.h"
 #include "opal/mca/btl/btl.h"
+#include "opal/runtime/opal_progress.h"
 
 #include "ompi/mca/bml/base/bml_base_btl.h"
 #include "ompi/types.h"
@@ -270,6 +271,8 @@ static inline int mca_bml_base_send( mca_bml_base_btl_t* bml_btl,
     mca_btl_base_module_t* btl = bml_btl->btl;
 
     des->des_context = (void*) bml_btl;
+    /* the completion comes through the progress function of the btl */
+    opal_progress_backoff_wake (btl->btl_component->btl_progress);
     rc = btl->btl_send(btl, bml_btl->btl_endpoint, des, tag);
     if (rc == OMPI_ERR_RESOURCE_BUSY)
         rc = OMPI_SUCCESS;
@@ -286,6 +289,7 @@ static inline int mca_bml_base_send_status( mca_bml_base_btl_t* bml_btl,
     mca_btl_base_module_t* btl = bml_btl->btl;
 
     des->des_context = (void*) bml_btl;
+    opal_progress_backoff_wake (btl->btl_component->btl_progress);
     return btl->btl_send(btl, bml_btl->btl_endpoint, des, tag);
 }
 
@@ -300,6 +304,7 @@ static inline int  mca_bml_base_sendi( mca_bml_base_btl_t* bml_btl,
                                        mca_btl_base_descriptor_t** descriptor )
 {
     mca_btl_base_module_t* btl = bml_btl->btl;
+    opal_progress_backoff_wake (btl->btl_component->btl_progress);
     return btl->btl_sendi(btl, bml_btl->btl_endpoint,
                           convertor, header, header_size,
                           payload_size, order, flags, tag, descriptor);
@@ -312,6 +317,7 @@ static inline int mca_bml_base_put( mca_bml_base_btl_t* bml_btl, void *local_add
 {
     mca_btl_base_module_t* btl = bml_btl->btl;
 
+    opal_progress_backoff_wake (btl->btl_component->btl_progress);
     return btl->btl_put( btl, bml_btl->btl_endpoint, local_address, remote_address, local_handle,
                          remote_handle, size, flags, order, cbfunc, (void *) bml_btl, cbdata);
 }
@@ -323,6 +329,7 @@ static inline int mca_bml_base_get( mca_bml_base_btl_t* bml_btl, void *local_add
 {
     mca_btl_base_module_t* btl = bml_btl->btl;
 
+    opal_progress_backoff_wake (btl->btl_component->btl_progress);
     return btl->btl_get( btl, bml_btl->btl_endpoint, local_address, remote_address, local_handle,
                          remote_handle, size, flags, order, cbfunc, (void *) bml_btl, cbdata);
 }
@@ -125,6 +125,7 @@ struct ompi_coll_libnbc_request_t {
     MPI_Comm comm;
     long row_offset;
     bool nbc_complete; /* status in libnbc level */
+    bool backoff_held; /* progress is not backed off while active */
     int tag;
     volatile int req_count;
     ompi_request_t **req_array;
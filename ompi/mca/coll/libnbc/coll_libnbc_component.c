@@ -34,6 +34,7 @@
 #include "mpi.h"
 #include "ompi/mca/coll/coll.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/runtime/ompi_async_progress.h"
 
 /*
  * Public string showing the coll ompi_libnbc component version number
@@ -426,7 +427,7 @@ int
 ompi_coll_libnbc_progress(void)
 {
     ompi_coll_libnbc_request_t* request, *next;
-    int res;
+    int res, count = 0;
 
     if (0 == opal_list_get_size (&mca_coll_libnbc_component.active_requests)) {
         /* no requests -- nothing to do. do not grab a lock */
@@ -442,9 +443,22 @@ ompi_coll_libnbc_progress(void)
 
         OPAL_LIST_FOREACH_SAFE(request, next, &mca_coll_libnbc_component.active_requests,
                                ompi_coll_libnbc_request_t) {
+            /* a request progressed if subrequests completed or a new round
+             * started */
+            long row_offset = request->row_offset;
+            int req_count = request->req_count;
+
             OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
             res = NBC_Progress(request);
-            if( NBC_CONTINUE != res ) {
+            if( NBC_CONTINUE == res ) {
+                if (row_offset != request->row_offset || req_count != request->req_count) {
+                    ++count;
+                }
+            } else {
+                ++count;
+                opal_progress_backoff_release(ompi_coll_libnbc_progress, request->backoff_held);
+                request->backoff_held = false;
+                ompi_async_progress_busy_add(-1);
                 /* done, remove and complete */
                 OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
                 opal_list_remove_item(&mca_coll_libnbc_component.active_requests,
@@ -471,7 +485,7 @@ ompi_coll_libnbc_progress(void)
     }
     OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
 
-    return 0;
+    return count;
 }
 
 
@@ -28,6 +28,7 @@
 #include "ompi/mca/coll/base/coll_tags.h"
 #include "ompi/op/op.h"
 #include "ompi/mca/pml/pml.h"
+#include "ompi/runtime/ompi_async_progress.h"
 
 /* only used in this file */
 static inline int NBC_Start_round(NBC_Handle *handle);
@@ -662,6 +663,11 @@ int NBC_Start(NBC_Handle *handle) {
     return res;
   }
 
+  /* the next round has to start as soon as the current one completes,
+   * see also ompi/runtime/ompi_async_progress.h */
+  handle->backoff_held = opal_progress_backoff_hold(ompi_coll_libnbc_progress);
+  ompi_async_progress_busy_add(1);
+
   OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
   opal_list_append(&mca_coll_libnbc_component.active_requests, (opal_list_item_t *)handle);
   OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
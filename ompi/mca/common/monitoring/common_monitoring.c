@@ -25,6 +25,10 @@
 #include <ompi/communicator/communicator.h>
 #include <opal/mca/base/mca_base_component_repository.h>
 #include <opal/class/opal_hash_table.h>
+#include <opal/class/opal_pointer_array.h>
+#include <opal/class/opal_ring_buffer.h>
+#include <opal/threads/mutex.h>
+#include <opal/threads/tsd.h>
 #include <opal/util/output.h>
 #include "opal/util/printf.h"
 #include "opal/runtime/opal.h"
@@ -63,6 +67,10 @@ static int mca_common_monitoring_output_enabled = 0;
 /* File where to output the monitored data */
 static char* mca_common_monitoring_initial_filename = "";
 static char* mca_common_monitoring_current_filename = NULL;
+/* Record one in mca_common_monitoring_sampling PML messages */
+int mca_common_monitoring_sampling = 1;
+/* Signals the communication matrix row is written next to the profile */
+static int mca_common_monitoring_dump_matrix = 0;
 
 /* array for stroring monitoring data*/
 static opal_atomic_size_t* pml_data = NULL;
@@ -85,12 +93,91 @@ static int nprocs_world = 0;
 
 opal_hash_table_t *common_monitoring_translation_ht = NULL;
 
+/* Messages sent through the PML on a communicator, indexed by the rank
+ * in its remote group. The matrices are stored by context id; gen tells
+ * apart the communicators that reuse a context id. */
+typedef struct mca_monitoring_comm_matrix_t {
+    uint32_t gen;
+    int size;
+    opal_atomic_size_t *count;
+    opal_atomic_size_t *data;
+} mca_monitoring_comm_matrix_t;
+
+static opal_pointer_array_t comm_matrices;
+static bool comm_matrices_valid = false;
+static uint32_t comm_matrices_gen = 0;
+/* Number of started handles of the comm_messages pvars. The matrices are
+ * only updated while there is one, so that the other messages do not pay
+ * for the lookup of the matrix and its counters. */
+static opal_atomic_int32_t comm_matrices_started = 0;
+
+/* In sampling mode the recorded messages go into a ring buffer of the
+ * sending thread, so that the threads do not contend on the counters.
+ * The samples are added to the counters, each counted
+ * mca_common_monitoring_sampling times, when a ring is full and before
+ * the counters are read. Only the owning thread adds samples to its
+ * ring; the rings are emptied under sampling_lock, which also protects
+ * comm_matrices. */
+typedef struct mca_monitoring_sample_t {
+    uint64_t data_size;
+    uint32_t cid;
+    uint32_t gen;
+    int32_t  dst;
+    int32_t  world_rank;
+    int32_t  tag;
+    int32_t  pad;
+} mca_monitoring_sample_t;
+
+#define MCA_MONITORING_SAMPLES 256
+
+typedef struct mca_monitoring_sampler_t {
+    opal_record_ring_t samples;
+    uint64_t rng;               /* state of the random gaps */
+    int skip;                   /* messages until the next sample */
+    struct mca_monitoring_sampler_t *next;       /* all samplers */
+    struct mca_monitoring_sampler_t *next_free;  /* samplers of exited threads */
+} mca_monitoring_sampler_t;
+
+static mca_monitoring_sampler_t *samplers = NULL;
+static mca_monitoring_sampler_t *free_samplers = NULL;
+static opal_mutex_t sampling_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_tsd_key_t sampler_key;
+static bool sampler_key_valid = false;
+/* Marks a thread for which no sampler could be allocated */
+static mca_monitoring_sampler_t no_sampler;
+#if OPAL_HAVE_THREAD_LOCAL
+static opal_thread_local mca_monitoring_sampler_t *local_sampler = NULL;
+#endif
+/* Sampler used if there are no threads */
+static mca_monitoring_sampler_t *main_sampler = NULL;
+static opal_atomic_int32_t unsampled_count = 0;
+
 /* Reset all the monitoring arrays */
 static void mca_common_monitoring_reset ( void );
 
+/* Release the sampler of an exiting thread */
+static void mca_common_monitoring_sampler_release(void *value);
+
+/* Release the samplers and the per-communicator matrices */
+static void mca_common_monitoring_sampling_finalize( void );
+
 /* Flushes the monitored data and reset the values */
 static int mca_common_monitoring_flush (int fd, char* filename);
 
+/* Retreive the PML recorded count and amount of data sent on a communicator */
+static int mca_common_monitoring_get_comm_count (const struct mca_base_pvar_t *pvar,
+                                                 void *value, void *obj_handle);
+static int mca_common_monitoring_get_comm_size (const struct mca_base_pvar_t *pvar,
+                                                void *value, void *obj_handle);
+
+/* pml_monitoring_comm_messages_count and _size pvar notify function */
+static int mca_common_monitoring_comm_matrix_notify(mca_base_pvar_t *pvar,
+                                                    mca_base_pvar_event_t event,
+                                                    void *obj_handle, int *count);
+
+/* Add the samples of all threads to the counters */
+static void mca_common_monitoring_fold_all( void );
+
 /* Retreive the PML recorded count of messages sent */
 static int mca_common_monitoring_get_pml_count (const struct mca_base_pvar_t *pvar,
                                                 void *value, void *obj_handle);
@@ -210,6 +297,29 @@ static int mca_common_monitoring_comm_size_notify(mca_base_pvar_t *pvar,
     return OMPI_ERROR;
 }
 
+static int mca_common_monitoring_comm_matrix_notify(mca_base_pvar_t *pvar,
+                                                    mca_base_pvar_event_t event,
+                                                    void *obj_handle,
+                                                    int *count)
+{
+    switch (event) {
+    case MCA_BASE_PVAR_HANDLE_BIND:
+        /* The messages are counted per destination, i.e. per rank of
+         * the remote group of an intercommunicator */
+        *count = ompi_comm_remote_size ((ompi_communicator_t *) obj_handle);
+        return OMPI_SUCCESS;
+    case MCA_BASE_PVAR_HANDLE_START:
+        (void)opal_atomic_add_fetch_32(&comm_matrices_started, 1);
+        break;
+    case MCA_BASE_PVAR_HANDLE_STOP:
+        (void)opal_atomic_add_fetch_32(&comm_matrices_started, -1);
+        break;
+    default:
+        break;
+    }
+    return mca_common_monitoring_comm_size_notify(pvar, event, obj_handle, count);
+}
+
 int mca_common_monitoring_init( void )
 {
     if( !mca_common_monitoring_enabled ) return OMPI_ERROR;
@@ -227,6 +337,14 @@ int mca_common_monitoring_init( void )
     /* Initialize proc translation hashtable */
     common_monitoring_translation_ht = OBJ_NEW(opal_hash_table_t);
     opal_hash_table_init(common_monitoring_translation_ht, 2048);
+    /* Initialize the per-communicator matrices */
+    OBJ_CONSTRUCT(&comm_matrices, opal_pointer_array_t);
+    opal_pointer_array_init(&comm_matrices, 16, INT_MAX, 16);
+    comm_matrices_valid = true;
+    if( 1 < mca_common_monitoring_sampling &&
+        OPAL_SUCCESS == opal_tsd_key_create(&sampler_key, mca_common_monitoring_sampler_release) ) {
+        sampler_key_valid = true;
+    }
     return OMPI_SUCCESS;
 }
 
@@ -246,6 +364,7 @@ void mca_common_monitoring_finalize( void )
     free(mca_common_monitoring_output_stream_obj.lds_prefix);
     /* Free internal data structure */
     free((void *) pml_data);  /* a single allocation */
+    mca_common_monitoring_sampling_finalize();
     opal_hash_table_remove_all( common_monitoring_translation_ht );
     OBJ_RELEASE(common_monitoring_translation_ht);
     mca_common_monitoring_coll_finalize();
@@ -304,6 +423,31 @@ int mca_common_monitoring_register(void)
         mca_common_monitoring_current_filename = strdup(mca_common_monitoring_initial_filename);
     }
 
+    (void)mca_base_var_register("ompi", "pml", "monitoring", "sampling",
+                                "Record only one in N point-to-point messages on average, "
+                                "at random intervals, and count each recorded message N "
+                                "times. The recorded messages are buffered by each thread. "
+                                "Values larger than 1 reduce the overhead of the monitoring "
+                                "at the price of approximate counts (default 1: record "
+                                "every message)",
+                                MCA_BASE_VAR_TYPE_INT, NULL, MPI_T_BIND_NO_OBJECT,
+                                MCA_BASE_VAR_FLAG_DWG, OPAL_INFO_LVL_4,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &mca_common_monitoring_sampling);
+
+    (void)mca_base_var_register("ompi", "pml", "monitoring", "dump_matrix",
+                                "Whenever the monitoring is written to a file, also write "
+                                "the row of the communication matrix of the process, the "
+                                "bytes sent to each process of MPI_COMM_WORLD, into the file "
+                                "extended with the process rank and the \".mat\" extension. "
+                                "The rows of all processes concatenated in the order of "
+                                "their ranks are the matrix format read by TreeMatch "
+                                "(default disable)",
+                                MCA_BASE_VAR_TYPE_INT, NULL, MPI_T_BIND_NO_OBJECT,
+                                MCA_BASE_VAR_FLAG_DWG, OPAL_INFO_LVL_9,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &mca_common_monitoring_dump_matrix);
+
     /* PML PVARs */
     (void)mca_base_pvar_register("ompi", "pml", "monitoring", "flush", "Flush the monitoring "
                                  "information in the provided file. The filename is append with "
@@ -330,6 +474,24 @@ int mca_common_monitoring_register(void)
                                  mca_common_monitoring_get_pml_size, NULL,
                                  mca_common_monitoring_comm_size_notify, NULL);
 
+    (void)mca_base_pvar_register("ompi", "pml", "monitoring", "comm_messages_count", "Number of "
+                                 "messages sent on a communicator to each of its peers through the "
+                                 "PML framework.",
+                                 OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                 MCA_MONITORING_VAR_TYPE, NULL, MPI_T_BIND_MPI_COMM,
+                                 MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_IWG,
+                                 mca_common_monitoring_get_comm_count, NULL,
+                                 mca_common_monitoring_comm_matrix_notify, NULL);
+
+    (void)mca_base_pvar_register("ompi", "pml", "monitoring", "comm_messages_size", "Size of "
+                                 "messages sent on a communicator to each of its peers through the "
+                                 "PML framework.",
+                                 OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                 MCA_MONITORING_VAR_TYPE, NULL, MPI_T_BIND_MPI_COMM,
+                                 MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_IWG,
+                                 mca_common_monitoring_get_comm_size, NULL,
+                                 mca_common_monitoring_comm_matrix_notify, NULL);
+
     /* OSC PVARs */
     (void)mca_base_pvar_register("ompi", "osc", "monitoring", "messages_sent_count", "Number of "
                                  "messages sent through the OSC framework with each peer.",
@@ -497,32 +659,366 @@ int mca_common_monitoring_add_procs(struct ompi_proc_t **procs,
 static void mca_common_monitoring_reset( void )
 {
     int array_size = (10 + max_size_histogram) * nprocs_world;
+    mca_monitoring_comm_matrix_t *matrix;
+    mca_monitoring_sampler_t *sampler;
+    size_t n;
+    int i;
+
+    OPAL_THREAD_LOCK(&sampling_lock);
+    /* Drop the samples taken before the reset */
+    for( sampler = samplers; NULL != sampler; sampler = sampler->next ) {
+        while( NULL != opal_record_ring_peek(&sampler->samples, &n) ) {
+            opal_record_ring_release(&sampler->samples, n);
+        }
+    }
+    if( comm_matrices_valid ) {
+        for( i = 0; i < opal_pointer_array_get_size(&comm_matrices); i++ ) {
+            matrix = (mca_monitoring_comm_matrix_t*)opal_pointer_array_get_item(&comm_matrices, i);
+            if( NULL != matrix ) {
+                memset((void *) matrix->count, 0, 2 * matrix->size * sizeof(size_t));
+            }
+        }
+    }
+    OPAL_THREAD_UNLOCK(&sampling_lock);
+
     memset((void *) pml_data, 0, array_size * sizeof(size_t));
     mca_common_monitoring_coll_reset();
 }
 
-void mca_common_monitoring_record_pml(int world_rank, size_t data_size, int tag)
+int mca_common_monitoring_add_comm(ompi_communicator_t *comm)
 {
-    if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
+    mca_monitoring_comm_matrix_t *matrix, *old;
+    int size = ompi_comm_remote_size(comm);
+
+    if( !comm_matrices_valid ) return OMPI_SUCCESS;
+
+    matrix = (mca_monitoring_comm_matrix_t*)calloc(1, sizeof(mca_monitoring_comm_matrix_t) +
+                                                   2 * size * sizeof(size_t));
+    if( NULL == matrix ) return OMPI_ERR_OUT_OF_RESOURCE;
+    matrix->size  = size;
+    matrix->count = (opal_atomic_size_t*)(matrix + 1);
+    matrix->data  = matrix->count + size;
+
+    OPAL_THREAD_LOCK(&sampling_lock);
+    matrix->gen = ++comm_matrices_gen;
+    old = (mca_monitoring_comm_matrix_t*)opal_pointer_array_get_item(&comm_matrices, comm->c_contextid);
+    if( OPAL_SUCCESS != opal_pointer_array_set_item(&comm_matrices, comm->c_contextid, matrix) ) {
+        OPAL_THREAD_UNLOCK(&sampling_lock);
+        free(matrix);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    OPAL_THREAD_UNLOCK(&sampling_lock);
+    free(old);
+    return OMPI_SUCCESS;
+}
+
+void mca_common_monitoring_del_comm(ompi_communicator_t *comm)
+{
+    mca_monitoring_comm_matrix_t *matrix;
+
+    if( !comm_matrices_valid ) return;
+
+    OPAL_THREAD_LOCK(&sampling_lock);
+    matrix = (mca_monitoring_comm_matrix_t*)opal_pointer_array_get_item(&comm_matrices, comm->c_contextid);
+    opal_pointer_array_set_item(&comm_matrices, comm->c_contextid, NULL);
+    OPAL_THREAD_UNLOCK(&sampling_lock);
+    free(matrix);
+}
 
+/* Add weight messages of data_size bytes each to the counters */
+static void mca_common_monitoring_account_pml(mca_monitoring_comm_matrix_t *matrix, int dst,
+                                              int world_rank, size_t data_size, int tag,
+                                              size_t weight)
+{
     /* Keep tracks of the data_size distribution */
     if( 0 == data_size ) {
-        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram], 1);
+        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram], weight);
     } else {
         int log2_size = log10(data_size)/log10_2;
         if(log2_size > max_size_histogram - 2) /* Avoid out-of-bound write */
             log2_size = max_size_histogram - 2;
-        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram + log2_size + 1], 1);
+        opal_atomic_add_fetch_size_t(&size_histogram[world_rank * max_size_histogram + log2_size + 1], weight);
     }
 
     /* distinguishses positive and negative tags if requested */
     if( (tag < 0) && (mca_common_monitoring_filter()) ) {
-        opal_atomic_add_fetch_size_t(&filtered_pml_data[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&filtered_pml_count[world_rank], 1);
+        opal_atomic_add_fetch_size_t(&filtered_pml_data[world_rank], data_size * weight);
+        opal_atomic_add_fetch_size_t(&filtered_pml_count[world_rank], weight);
     } else { /* if filtered monitoring is not activated data is aggregated indifferently */
-        opal_atomic_add_fetch_size_t(&pml_data[world_rank], data_size);
-        opal_atomic_add_fetch_size_t(&pml_count[world_rank], 1);
+        opal_atomic_add_fetch_size_t(&pml_data[world_rank], data_size * weight);
+        opal_atomic_add_fetch_size_t(&pml_count[world_rank], weight);
+    }
+
+    if( NULL != matrix && 0 <= dst && dst < matrix->size ) {
+        opal_atomic_add_fetch_size_t(&matrix->data[dst], data_size * weight);
+        opal_atomic_add_fetch_size_t(&matrix->count[dst], weight);
+    }
+}
+
+/* Add the samples of a thread to the counters. Called with sampling_lock held. */
+static void mca_common_monitoring_fold(mca_monitoring_sampler_t *sampler)
+{
+    mca_monitoring_comm_matrix_t *matrix;
+    mca_monitoring_sample_t *samples;
+    size_t i, n;
+
+    while( NULL != (samples = (mca_monitoring_sample_t*)
+                    opal_record_ring_peek(&sampler->samples, &n)) ) {
+        for( i = 0; i < n; i++ ) {
+            matrix = NULL;
+            if( 0 != samples[i].gen ) {
+                matrix = (mca_monitoring_comm_matrix_t*)
+                    opal_pointer_array_get_item(&comm_matrices, samples[i].cid);
+                if( NULL != matrix && matrix->gen != samples[i].gen ) {
+                    matrix = NULL;  /* the communicator is gone */
+                }
+            }
+            mca_common_monitoring_account_pml(matrix, samples[i].dst, samples[i].world_rank,
+                                              samples[i].data_size, samples[i].tag,
+                                              (size_t)mca_common_monitoring_sampling);
+        }
+        opal_record_ring_release(&sampler->samples, n);
+    }
+}
+
+static void mca_common_monitoring_fold_all( void )
+{
+    mca_monitoring_sampler_t *sampler;
+
+    if( NULL == samplers ) return;
+
+    OPAL_THREAD_LOCK(&sampling_lock);
+    for( sampler = samplers; NULL != sampler; sampler = sampler->next ) {
+        mca_common_monitoring_fold(sampler);
     }
+    OPAL_THREAD_UNLOCK(&sampling_lock);
+}
+
+/* Called at the exit of a thread that owns a sampler */
+static void mca_common_monitoring_sampler_release(void *value)
+{
+    mca_monitoring_sampler_t *sampler = (mca_monitoring_sampler_t*)value;
+
+    if( NULL == sampler || &no_sampler == sampler ) return;
+
+    OPAL_THREAD_LOCK(&sampling_lock);
+    sampler->next_free = free_samplers;
+    free_samplers = sampler;
+    OPAL_THREAD_UNLOCK(&sampling_lock);
+}
+
+/* Length of the gap before the next sample, uniformly distributed in
+ * [1, 2N-1] so that the mean is N */
+static inline int mca_common_monitoring_next_skip(mca_monitoring_sampler_t *sampler)
+{
+    /* xorshift64 */
+    sampler->rng ^= sampler->rng << 13;
+    sampler->rng ^= sampler->rng >> 7;
+    sampler->rng ^= sampler->rng << 17;
+    return 1 + (int)(sampler->rng % (uint64_t)(2 * mca_common_monitoring_sampling - 1));
+}
+
+/* Assigns a sampler to the calling thread on its first message */
+static mca_monitoring_sampler_t *mca_common_monitoring_sampler_attach( void )
+{
+    mca_monitoring_sampler_t *sampler;
+
+    OPAL_THREAD_LOCK(&sampling_lock);
+    sampler = free_samplers;
+    if( NULL != sampler ) {
+        free_samplers = sampler->next_free;
+    } else {
+        sampler = (mca_monitoring_sampler_t*)malloc(sizeof(mca_monitoring_sampler_t));
+        if( NULL != sampler ) {
+            OBJ_CONSTRUCT(&sampler->samples, opal_record_ring_t);
+            if( OPAL_SUCCESS != opal_record_ring_init(&sampler->samples, sizeof(mca_monitoring_sample_t),
+                                                      MCA_MONITORING_SAMPLES) ) {
+                OBJ_DESTRUCT(&sampler->samples);
+                free(sampler);
+                sampler = NULL;
+            }
+        }
+        if( NULL != sampler ) {
+            sampler->rng = ((uint64_t)(uintptr_t)sampler * 0x9e3779b97f4a7c15ULL) ^
+                ((uint64_t)getpid() << 32) ^ (uint64_t)rank_world;
+            if( 0 == sampler->rng ) sampler->rng = 1;
+            sampler->skip = mca_common_monitoring_next_skip(sampler);
+            sampler->next = samplers;
+            sampler->next_free = NULL;
+            samplers = sampler;
+        } else {
+            sampler = &no_sampler;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&sampling_lock);
+
+    if( sampler_key_valid ) {
+        (void)opal_tsd_setspecific(sampler_key, sampler);
+    }
+#if OPAL_HAVE_THREAD_LOCAL
+    local_sampler = sampler;
+#endif
+    return sampler;
+}
+
+/* Returns the sampler of the calling thread, NULL if there is none */
+static inline mca_monitoring_sampler_t *mca_common_monitoring_sampler_get( void )
+{
+    mca_monitoring_sampler_t *sampler;
+
+    if( !opal_using_threads() ) {
+        if( OPAL_UNLIKELY(NULL == main_sampler) ) {
+            main_sampler = mca_common_monitoring_sampler_attach();
+        }
+        sampler = main_sampler;
+    } else {
+        if( !sampler_key_valid ) return NULL;
+#if OPAL_HAVE_THREAD_LOCAL
+        sampler = local_sampler;
+#else
+        if( OPAL_SUCCESS != opal_tsd_getspecific(sampler_key, (void**)&sampler) ) return NULL;
+#endif
+        if( OPAL_UNLIKELY(NULL == sampler) ) {
+            sampler = mca_common_monitoring_sampler_attach();
+        }
+    }
+    return (&no_sampler == sampler) ? NULL : sampler;
+}
+
+static void mca_common_monitoring_sampling_finalize( void )
+{
+    mca_monitoring_comm_matrix_t *matrix;
+    mca_monitoring_sampler_t *sampler;
+    int i;
+
+    if( sampler_key_valid ) {
+        opal_tsd_key_delete(sampler_key);
+        sampler_key_valid = false;
+    }
+    while( NULL != (sampler = samplers) ) {
+        samplers = sampler->next;
+        OBJ_DESTRUCT(&sampler->samples);
+        free(sampler);
+    }
+    free_samplers = NULL;
+    main_sampler = NULL;
+#if OPAL_HAVE_THREAD_LOCAL
+    local_sampler = NULL;
+#endif
+
+    if( comm_matrices_valid ) {
+        for( i = 0; i < opal_pointer_array_get_size(&comm_matrices); i++ ) {
+            matrix = (mca_monitoring_comm_matrix_t*)opal_pointer_array_get_item(&comm_matrices, i);
+            free(matrix);
+        }
+        OBJ_DESTRUCT(&comm_matrices);
+        comm_matrices_valid = false;
+    }
+}
+
+bool mca_common_monitoring_sample_next( void )
+{
+    mca_monitoring_sampler_t *sampler = mca_common_monitoring_sampler_get();
+
+    if( OPAL_UNLIKELY(NULL == sampler) ) {
+        /* no buffer for this thread, sample at regular intervals */
+        return 0 == (OPAL_THREAD_ADD_FETCH32(&unsampled_count, 1) % mca_common_monitoring_sampling);
+    }
+    if( 0 < --sampler->skip ) return false;
+    sampler->skip = mca_common_monitoring_next_skip(sampler);
+    return true;
+}
+
+void mca_common_monitoring_record_pml(ompi_communicator_t *comm, int dst,
+                                      int world_rank, size_t data_size, int tag)
+{
+    mca_monitoring_comm_matrix_t *matrix = NULL;
+    mca_monitoring_sampler_t *sampler;
+    mca_monitoring_sample_t *sample;
+
+    if( 0 == mca_common_monitoring_current_state ) return;  /* right now the monitoring is not started */
+
+    if( 1 >= mca_common_monitoring_sampling ) {
+        if( OPAL_UNLIKELY(0 < comm_matrices_started) && comm_matrices_valid ) {
+            matrix = (mca_monitoring_comm_matrix_t*)
+                opal_pointer_array_get_item(&comm_matrices, comm->c_contextid);
+        }
+        mca_common_monitoring_account_pml(matrix, dst, world_rank, data_size, tag, 1);
+        return;
+    }
+
+    sampler = mca_common_monitoring_sampler_get();
+    if( OPAL_UNLIKELY(NULL == sampler) ) {
+        OPAL_THREAD_LOCK(&sampling_lock);
+        if( 0 < comm_matrices_started && comm_matrices_valid ) {
+            matrix = (mca_monitoring_comm_matrix_t*)
+                opal_pointer_array_get_item(&comm_matrices, comm->c_contextid);
+        }
+        mca_common_monitoring_account_pml(matrix, dst, world_rank, data_size, tag,
+                                          (size_t)mca_common_monitoring_sampling);
+        OPAL_THREAD_UNLOCK(&sampling_lock);
+        return;
+    }
+
+    sample = (mca_monitoring_sample_t*)opal_record_ring_reserve(&sampler->samples);
+    if( OPAL_UNLIKELY(NULL == sample) ) {
+        OPAL_THREAD_LOCK(&sampling_lock);
+        mca_common_monitoring_fold(sampler);
+        OPAL_THREAD_UNLOCK(&sampling_lock);
+        sample = (mca_monitoring_sample_t*)opal_record_ring_reserve(&sampler->samples);
+    }
+    if( 0 < comm_matrices_started && comm_matrices_valid ) {
+        matrix = (mca_monitoring_comm_matrix_t*)
+            opal_pointer_array_get_item(&comm_matrices, comm->c_contextid);
+    }
+    sample->data_size  = data_size;
+    sample->cid        = comm->c_contextid;
+    sample->gen        = (NULL != matrix) ? matrix->gen : 0;
+    sample->dst        = dst;
+    sample->world_rank = world_rank;
+    sample->tag        = tag;
+    opal_record_ring_commit(&sampler->samples);
+}
+
+static int mca_common_monitoring_get_comm_values(ompi_communicator_t *comm,
+                                                 size_t *values, bool data)
+{
+    mca_monitoring_comm_matrix_t *matrix = NULL;
+    int i;
+
+    mca_common_monitoring_fold_all();
+
+    OPAL_THREAD_LOCK(&sampling_lock);
+    if( comm_matrices_valid ) {
+        matrix = (mca_monitoring_comm_matrix_t*)
+            opal_pointer_array_get_item(&comm_matrices, comm->c_contextid);
+    }
+    if( NULL == matrix ) {
+        OPAL_THREAD_UNLOCK(&sampling_lock);
+        return OMPI_ERROR;
+    }
+    for (i = 0 ; i < matrix->size ; ++i) {
+        values[i] = data ? matrix->data[i] : matrix->count[i];
+    }
+    OPAL_THREAD_UNLOCK(&sampling_lock);
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_common_monitoring_get_comm_count(const struct mca_base_pvar_t *pvar,
+                                                void *value,
+                                                void *obj_handle)
+{
+    return mca_common_monitoring_get_comm_values((ompi_communicator_t *) obj_handle,
+                                                 (size_t*) value, false);
+}
+
+static int mca_common_monitoring_get_comm_size(const struct mca_base_pvar_t *pvar,
+                                               void *value,
+                                               void *obj_handle)
+{
+    return mca_common_monitoring_get_comm_values((ompi_communicator_t *) obj_handle,
+                                                 (size_t*) value, true);
 }
 
 static int mca_common_monitoring_get_pml_count(const struct mca_base_pvar_t *pvar,
@@ -536,6 +1032,7 @@ static int mca_common_monitoring_get_pml_count(const struct mca_base_pvar_t *pva
     if(comm != &ompi_mpi_comm_world.comm || NULL == pml_count)
         return OMPI_ERROR;
 
+    mca_common_monitoring_fold_all();
     for (i = 0 ; i < comm_size ; ++i) {
         values[i] = pml_count[i];
     }
@@ -555,6 +1052,7 @@ static int mca_common_monitoring_get_pml_size(const struct mca_base_pvar_t *pvar
     if(comm != &ompi_mpi_comm_world.comm || NULL == pml_data)
         return OMPI_ERROR;
 
+    mca_common_monitoring_fold_all();
     for (i = 0 ; i < comm_size ; ++i) {
         values[i] = pml_data[i];
     }
@@ -755,6 +1253,30 @@ static void mca_common_monitoring_output( FILE *pf, int my_rank, int nbprocs )
     mca_common_monitoring_coll_flush_all(pf);
 }
 
+/* Write the bytes sent to each process of MPI_COMM_WORLD as one line of
+ * integers separated by spaces */
+static int mca_common_monitoring_output_matrix( char *filename )
+{
+    char *tmpfn = NULL;
+    FILE *pf;
+
+    opal_asprintf(&tmpfn, "%s.%" PRId32 ".mat", filename, rank_world);
+    if( NULL == tmpfn ) return OMPI_ERR_OUT_OF_RESOURCE;
+    pf = fopen(tmpfn, "w");
+    if( NULL == pf ) {
+        OPAL_MONITORING_PRINT_ERR("Error while flushing to: %s", tmpfn);
+        free(tmpfn);
+        return OMPI_ERROR;
+    }
+    for (int i = 0 ; i < nprocs_world ; i++) {
+        fprintf(pf, "%zu%s", pml_data[i] + filtered_pml_data[i],
+                i < nprocs_world - 1 ? " " : "\n");
+    }
+    fclose(pf);
+    free(tmpfn);
+    return OMPI_SUCCESS;
+}
+
 /*
  * Flushes the monitoring into filename
  * Useful for phases (see example in test/monitoring)
@@ -765,6 +1287,8 @@ static int mca_common_monitoring_flush(int fd, char* filename)
     if( 0 == mca_common_monitoring_current_state || 0 == fd ) /* if disabled do nothing */
         return OMPI_SUCCESS;
 
+    mca_common_monitoring_fold_all();
+
     if( 1 == fd ) {
         OPAL_MONITORING_PRINT_INFO("Proc %" PRId32 " flushing monitoring to stdout", rank_world);
         mca_common_monitoring_output( stdout, rank_world, nprocs_world );
@@ -796,6 +1320,10 @@ static int mca_common_monitoring_flush(int fd, char* filename)
         mca_common_monitoring_output( pf, rank_world, nprocs_world );
 
         fclose(pf);
+
+        if( mca_common_monitoring_dump_matrix ) {
+            (void)mca_common_monitoring_output_matrix( filename );
+        }
     }
     /* Reset to 0 all monitored data */
     mca_common_monitoring_reset();
@@ -43,6 +43,7 @@ BEGIN_C_DECLS
 extern int mca_common_monitoring_output_stream_id;
 extern int mca_common_monitoring_enabled;
 extern int mca_common_monitoring_current_state;
+extern int mca_common_monitoring_sampling;
 extern opal_hash_table_t *common_monitoring_translation_ht;
 
 OMPI_DECLSPEC int mca_common_monitoring_init( void );
@@ -50,8 +51,32 @@ OMPI_DECLSPEC void mca_common_monitoring_finalize( void );
 OMPI_DECLSPEC int mca_common_monitoring_add_procs(struct ompi_proc_t **procs, size_t nprocs);
 OMPI_DECLSPEC int mca_common_monitoring_register(void);
 
-/* Records PML communication */
-OMPI_DECLSPEC void mca_common_monitoring_record_pml(int world_rank, size_t data_size, int tag);
+/* Keep track of the communicators for the per-communicator matrices */
+OMPI_DECLSPEC int mca_common_monitoring_add_comm(ompi_communicator_t *comm);
+OMPI_DECLSPEC void mca_common_monitoring_del_comm(ompi_communicator_t *comm);
+
+/* Random sampling of the PML messages, see mca_common_monitoring_sample() */
+OMPI_DECLSPEC bool mca_common_monitoring_sample_next(void);
+
+/* Return whether the next PML message has to be recorded.
+ *
+ * With pml_monitoring_sampling N > 1 only one in N messages on average
+ * is recorded, the gaps between the recorded messages being random so
+ * that periodic communication patterns are not aliased. The recorded
+ * messages are counted N times. Call this before translating the
+ * destination, so that the messages that are not recorded cost a
+ * counter decrement only.
+ */
+static inline bool mca_common_monitoring_sample(void)
+{
+    if( 0 == mca_common_monitoring_current_state ) return false;
+    return 1 >= mca_common_monitoring_sampling || mca_common_monitoring_sample_next();
+}
+
+/* Records PML communication to dst, the rank of world_rank in the remote
+ * group of comm */
+OMPI_DECLSPEC void mca_common_monitoring_record_pml(ompi_communicator_t *comm, int dst,
+                                                    int world_rank, size_t data_size, int tag);
 
 /* SEND corresponds to data emitted from the current proc to the given
  * one. RECV represents data emitted from the given proc to the
@@ -67,6 +67,7 @@
 #define OMPIO_LOCK_NEVER             0x00000100
 #define OMPIO_LOCK_NOT_THIS_OP       0x00000200
 #define OMPIO_DATAREP_NATIVE         0x00000400
+#define OMPIO_DIRECT_IO              0x00000800
 
 #define OMPIO_ROOT                    0
 
@@ -141,6 +142,10 @@ typedef int (*mca_common_ompio_get_mca_parameter_value_fn_t) ( char *mca_paramet
 
 
 struct mca_common_ompio_print_queue;
+struct mca_common_ompio_cache_t;
+struct mca_common_ompio_wbuf_t;
+struct mca_common_ompio_tuner_t;
+struct mca_common_ompio_compress_t;
 
 /**
  * Back-end structure for MPI_File
@@ -176,6 +181,8 @@ struct ompio_file_t {
        Note: Neither f_sharedfp nor f_sharedfp_component seemed appropriate for this.
     */
     void                  *f_sharedfp_data;
+    /* Place for the selected fbtl module to hang its data */
+    void                  *f_fbtl_data;
 
 
     /* File View parameters */
@@ -212,6 +219,15 @@ struct ompio_file_t {
     struct mca_common_ompio_print_queue *f_coll_write_time;
     struct mca_common_ompio_print_queue *f_coll_read_time;
 
+    /* read cache for independent reads, NULL if disabled */
+    struct mca_common_ompio_cache_t *f_read_cache;
+    /* write-behind buffer for independent writes, NULL if disabled */
+    struct mca_common_ompio_wbuf_t *f_write_buf;
+    /* adaptive aggregator selection, NULL if disabled */
+    struct mca_common_ompio_tuner_t *f_aggr_tuner;
+    /* compressed storage of the file data, NULL if disabled */
+    struct mca_common_ompio_compress_t *f_compress;
+
     /*initial list of aggregators and groups*/
     int *f_init_aggr_list;
     int  f_init_num_aggrs;
@@ -40,6 +40,7 @@
 #include <unistd.h>
 
 #include "common_ompio.h"
+#include "common_ompio_tuner.h"
 
 /*
 ** This file contains all the functionality related to determing the number of aggregators
@@ -497,6 +498,65 @@ int mca_common_ompio_finalize_initial_grouping(ompio_file_t *fh,
 /*****************************************************************************************************/
 /*****************************************************************************************************/
 /*****************************************************************************************************/
+/*
+** Contiguous groups for a given number of aggregators, used instead of the
+** initial grouping in adaptive mode and for stripe aligned operations.
+*/
+static int tuned_grouping (ompio_file_t *fh, int num_groups)
+{
+    mca_common_ompio_contg *contg_groups=NULL;
+    int i, j, ret=OMPI_SUCCESS;
+
+    contg_groups = (mca_common_ompio_contg*) calloc ( num_groups, sizeof(mca_common_ompio_contg));
+    if (NULL == contg_groups) {
+        opal_output (1, "OUT OF MEMORY\n");
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for ( i = 0; i < num_groups; i++ ) {
+        contg_groups[i].procs_in_contg_group = (int*) malloc ( (fh->f_size / num_groups + 1) * sizeof(int));
+        if (NULL == contg_groups[i].procs_in_contg_group) {
+            opal_output (1, "OUT OF MEMORY\n");
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+    }
+
+    mca_common_ompio_forced_grouping ( fh, num_groups, contg_groups);
+
+    fh->f_num_aggrs = num_groups;
+    fh->f_aggr_list = (int*) malloc ( fh->f_num_aggrs * sizeof(int));
+    if (NULL == fh->f_aggr_list ) {
+        opal_output (1, "OUT OF MEMORY\n");
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto exit;
+    }
+
+    for ( i = 0; i < num_groups; i++ ) {
+        fh->f_aggr_list[i] = contg_groups[i].procs_in_contg_group[0];
+        for ( j = 0; j < contg_groups[i].procs_per_contg_group; j++ ) {
+            if ( fh->f_rank == contg_groups[i].procs_in_contg_group[j] ) {
+                fh->f_procs_per_group = contg_groups[i].procs_per_contg_group;
+                fh->f_procs_in_group  = (int*) malloc ( fh->f_procs_per_group * sizeof(int));
+                if (NULL == fh->f_procs_in_group) {
+                    opal_output (1, "OUT OF MEMORY\n");
+                    ret = OMPI_ERR_OUT_OF_RESOURCE;
+                    goto exit;
+                }
+                memcpy ( fh->f_procs_in_group, contg_groups[i].procs_in_contg_group,
+                         fh->f_procs_per_group * sizeof(int));
+            }
+        }
+    }
+
+exit:
+    for ( i = 0; i < num_groups; i++ ) {
+        free ( contg_groups[i].procs_in_contg_group );
+    }
+    free ( contg_groups );
+
+    return ret;
+}
+
 /* 
 ** This function is called by the collective I/O operations to determine the final number
 ** of aggregators.
@@ -517,6 +577,11 @@ int mca_common_ompio_set_aggregator_props (struct ompio_file_t *fh,
            SIMPLE_PLUS   != OMPIO_MCA_GET(fh, grouping_option) ))) {
         ret = mca_common_ompio_create_groups(fh,bytes_per_proc);
     }
+    else if ( (-1 == num_aggregators) && (-1 != mca_common_ompio_tuner_num_aggrs (fh)) ) {
+        /* adaptive mode: the number of aggregators is chosen based on the
+           throughput measured in earlier collective operations */
+        ret = tuned_grouping (fh, mca_common_ompio_tuner_num_aggrs (fh));
+    }
     else {
         fh->f_procs_per_group  = fh->f_init_procs_per_group;
         fh->f_procs_in_group   = (int*)malloc (fh->f_procs_per_group * sizeof(int));
@@ -539,9 +604,62 @@ int mca_common_ompio_set_aggregator_props (struct ompio_file_t *fh,
         }            
     }
 
+    if ( OMPI_SUCCESS == ret && (-1 == num_aggregators) &&
+         (-1 == mca_common_ompio_tuner_num_aggrs (fh)) &&
+         0 < mca_common_ompio_stripe_unit (fh) ) {
+        int num_aggrs = mca_common_ompio_stripe_num_aggrs (fh, fh->f_num_aggrs);
+
+        if ( num_aggrs != fh->f_num_aggrs ) {
+            /* a number of aggregators that maps every stripe target to
+               a single aggregator */
+            free ( fh->f_aggr_list );
+            fh->f_aggr_list = NULL;
+            free ( fh->f_procs_in_group );
+            fh->f_procs_in_group = NULL;
+            ret = tuned_grouping (fh, num_aggrs);
+        }
+    }
+
     return ret;
 }
 
+/*
+** Stripe size to align the file domains of collective operations to, 0 if the
+** file is not striped or alignment is disabled.
+*/
+size_t mca_common_ompio_stripe_unit (ompio_file_t *fh)
+{
+    if ( 0 >= OMPIO_MCA_GET(fh, stripe_aligned) ) {
+        return 0;
+    }
+    return fh->f_stripe_size;
+}
+
+/*
+** Number of aggregators close to num_aggregators for stripe aligned operations.
+** Stripe k of the file is stored on target k % f_stripe_count, and the stripe aligned
+** algorithms assign it to aggregator k % num_aggregators. If the number of
+** aggregators divides the stripe count or is a multiple of it, every target is
+** accessed by exactly one aggregator, or every aggregator accesses a single target.
+** Returns the largest such number not above num_aggregators and the number of processes.
+*/
+int mca_common_ompio_stripe_num_aggrs (ompio_file_t *fh, int num_aggregators)
+{
+    int stripe_count = fh->f_stripe_count;
+    int n = OMPIO_MIN(num_aggregators, fh->f_size);
+
+    if ( 1 >= stripe_count || 1 >= n ) {
+        return OMPIO_MAX(n, 1);
+    }
+    if ( n >= stripe_count ) {
+        return n - n % stripe_count;
+    }
+    while ( 0 != stripe_count % n ) {
+        n--;
+    }
+    return n;
+}
+
 
 
 /*****************************************************************************************************/
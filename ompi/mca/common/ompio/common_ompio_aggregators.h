@@ -52,6 +52,10 @@ OMPI_DECLSPEC int mca_common_ompio_set_aggregator_props (struct ompio_file_t *fh
                                                          int num_aggregators,
                                                          size_t bytes_per_proc);
 
+/*Alignment to the striping of the file*/
+OMPI_DECLSPEC size_t mca_common_ompio_stripe_unit (ompio_file_t *fh);
+OMPI_DECLSPEC int mca_common_ompio_stripe_num_aggrs (ompio_file_t *fh, int num_aggregators);
+
 int  mca_common_ompio_forced_grouping ( ompio_file_t *fh,
                                         int num_groups,
                                         mca_common_ompio_contg *contg_groups);
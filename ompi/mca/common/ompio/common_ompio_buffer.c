@@ -19,6 +19,8 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+
 #include "opal/datatype/opal_convertor.h"
 #include "opal/datatype/opal_datatype_cuda.h"
 #include "opal/mca/common/cuda/common_cuda.h"
@@ -68,7 +70,10 @@ static void* mca_common_ompio_buffer_alloc_seg ( void*ctx, size_t *size )
     numpages = (*size + mca_common_ompio_pagesize -1 )/mca_common_ompio_pagesize;
     realsize = numpages * mca_common_ompio_pagesize;
 
-    buf = malloc ( realsize);
+    /* whole, page aligned segments */
+    if ( 0 != posix_memalign ( (void **) &buf, mca_common_ompio_pagesize, realsize ) ) {
+        buf = NULL;
+    }
 #if OPAL_CUDA_SUPPORT
     if ( NULL != buf ) {
         mca_common_cuda_register ( ( char *)buf, realsize, NULL  );
@@ -150,6 +155,20 @@ void *mca_common_ompio_alloc_buf ( ompio_file_t *fh, size_t bufsize )
     return tmp;
 }
 
+void *mca_common_ompio_alloc_aligned_buf ( ompio_file_t *fh, size_t bufsize )
+{
+    size_t align = (size_t) opal_getpagesize();
+    void *buf=NULL;
+
+    if ( fh->f_flags & OMPIO_DIRECT_IO ) {
+        align = OMPIO_MAX(align, (size_t) fh->f_fs_block_size);
+    }
+    if ( 0 != posix_memalign ( &buf, align, bufsize ) ) {
+        return NULL;
+    }
+    return buf;
+}
+
 void mca_common_ompio_release_buf ( ompio_file_t *fh, void *buf )
 {
 
@@ -69,4 +69,9 @@ int mca_common_ompio_buffer_alloc_fini ( void );
 void* mca_common_ompio_alloc_buf ( ompio_file_t *fh, size_t bufsize);
 void mca_common_ompio_release_buf ( ompio_file_t *fh,  void *buf );
 
+/* Collective buffers of the aggregators. Aligned to the block size if
+   the file is accessed with O_DIRECT, so that they can be transferred in
+   place. Released with free(). */
+OMPI_DECLSPEC void *mca_common_ompio_alloc_aligned_buf ( ompio_file_t *fh, size_t bufsize );
+
 #endif
@@ -0,0 +1,458 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ompi/request/request.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "opal/threads/thread_usage.h"
+#include "opal/util/output.h"
+
+#include "common_ompio.h"
+#include "common_ompio_request.h"
+#include "common_ompio_cache.h"
+
+/*
+ * Read cache for independent read operations.
+ *
+ * The cache holds fixed size, block aligned pages of the file, indexed
+ * by block number and evicted in LRU order. Small entries of an io
+ * array are served from the cache, large ones go straight to the fbtl.
+ * Once two consecutive blocks have been accessed, the next
+ * read_cache_prefetch blocks are read ahead through fbtl_ipreadv.
+ *
+ * Only clean data is ever cached. The cache is dropped on every write
+ * of this process and on MPI_File_sync, which is where the MPI
+ * consistency semantics require writes of other processes to become
+ * visible, and is bypassed entirely in atomic mode.
+ *
+ * Read-ahead requests belong to the file: they are not pending requests
+ * of the application (so they do not make MPI_File_sync fail on other
+ * files) and are completed by the invalidation in sync and close.
+ */
+
+unsigned long long mca_common_ompio_read_cache_hits = 0;
+unsigned long long mca_common_ompio_read_cache_misses = 0;
+unsigned long long mca_common_ompio_read_cache_prefetches = 0;
+
+/* the counters are shared by all the files, which may be used by
+ * different threads */
+#define CACHE_COUNT(counter) \
+    (void) OPAL_THREAD_ADD_FETCH64((opal_atomic_int64_t *) &(counter), 1)
+
+static void mca_common_ompio_cache_block_construct (mca_common_ompio_cache_block_t *block)
+{
+    block->cb_offset = -1;
+    block->cb_valid  = 0;
+    block->cb_buf    = NULL;
+    block->cb_req    = NULL;
+}
+
+OBJ_CLASS_INSTANCE(mca_common_ompio_cache_block_t, opal_list_item_t,
+                   mca_common_ompio_cache_block_construct, NULL);
+
+static void cache_block_touch (mca_common_ompio_cache_t *cache,
+                               mca_common_ompio_cache_block_t *block)
+{
+    opal_list_remove_item (&cache->c_lru, &block->super);
+    opal_list_prepend (&cache->c_lru, &block->super);
+}
+
+static void cache_block_drop (mca_common_ompio_cache_t *cache,
+                              mca_common_ompio_cache_block_t *block)
+{
+    if (0 <= block->cb_offset) {
+        opal_hash_table_remove_value_uint64 (&cache->c_map,
+                                             (uint64_t) block->cb_offset / cache->c_block_size);
+    }
+    block->cb_offset = -1;
+    block->cb_valid  = 0;
+
+    opal_list_remove_item (&cache->c_lru, &block->super);
+    opal_list_append (&cache->c_lru, &block->super);
+}
+
+static void cache_block_wait (mca_common_ompio_cache_t *cache,
+                              mca_common_ompio_cache_block_t *block)
+{
+    ompi_status_public_t status;
+    int ret;
+
+    if (NULL == block->cb_req) {
+        return;
+    }
+
+    ret = ompi_request_wait (&block->cb_req, &status);
+    if (OMPI_SUCCESS == ret) {
+        block->cb_valid = status._ucount;
+    }
+    else {
+        /* failed requests are not released by wait */
+        ompi_request_free (&block->cb_req);
+        cache_block_drop (cache, block);
+    }
+    block->cb_req = NULL;
+}
+
+/* least recently used block that is not being filled. With can_wait the
+ * oldest read-ahead is completed if every block is busy */
+static mca_common_ompio_cache_block_t *cache_victim (mca_common_ompio_cache_t *cache,
+                                                     bool can_wait)
+{
+    mca_common_ompio_cache_block_t *block;
+
+    OPAL_LIST_FOREACH_REV(block, &cache->c_lru, mca_common_ompio_cache_block_t) {
+        if (NULL == block->cb_req) {
+            cache_block_drop (cache, block);
+            return block;
+        }
+    }
+
+    if (!can_wait) {
+        return NULL;
+    }
+
+    block = (mca_common_ompio_cache_block_t *) opal_list_get_last (&cache->c_lru);
+    cache_block_wait (cache, block);
+    cache_block_drop (cache, block);
+    return block;
+}
+
+/* read one block, either blocking or as a read-ahead on request */
+static ssize_t cache_fill (ompio_file_t *fh, mca_common_ompio_cache_t *cache,
+                           mca_common_ompio_cache_block_t *block, uint64_t blockno,
+                           ompi_request_t *request)
+{
+    mca_common_ompio_io_array_t entry, *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    ssize_t ret;
+
+    entry.memory_address = block->cb_buf;
+    entry.offset = (IOVBASE_TYPE *)(intptr_t)(blockno * cache->c_block_size);
+    entry.length = cache->c_block_size;
+
+    fh->f_io_array = &entry;
+    fh->f_num_of_io_entries = 1;
+
+    if (NULL == request) {
+        ret = fh->f_fbtl->fbtl_preadv (fh);
+    }
+    else {
+        ret = fh->f_fbtl->fbtl_ipreadv (fh, request);
+    }
+
+    fh->f_io_array = io_array;
+    fh->f_num_of_io_entries = num_of_io_entries;
+
+    return ret;
+}
+
+static void cache_prefetch (ompio_file_t *fh, mca_common_ompio_cache_t *cache,
+                            uint64_t blockno)
+{
+    mca_common_ompio_cache_block_t *block;
+    mca_ompio_request_t *req;
+    void *value;
+    ssize_t ret;
+
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64 (&cache->c_map, blockno, &value)) {
+        /* already cached or in flight */
+        return;
+    }
+
+    block = cache_victim (cache, false);
+    if (NULL == block) {
+        return;
+    }
+
+    mca_common_ompio_request_alloc_internal (&req, MCA_OMPIO_REQUEST_READ);
+    ret = cache_fill (fh, cache, block, blockno, &req->req_ompi);
+    if (OMPI_SUCCESS != ret || NULL == req->req_progress_fn) {
+        /* the read-ahead could not be started, give up quietly */
+        ompi_request_complete (&req->req_ompi, false);
+        ompi_request_free ((ompi_request_t **) &req);
+        return;
+    }
+    mca_common_ompio_register_progress ();
+
+    block->cb_offset = (OMPI_MPI_OFFSET_TYPE) (blockno * cache->c_block_size);
+    block->cb_req = &req->req_ompi;
+    opal_hash_table_set_value_uint64 (&cache->c_map, blockno, block);
+    cache_block_touch (cache, block);
+
+    CACHE_COUNT(mca_common_ompio_read_cache_prefetches);
+}
+
+static void cache_detect_sequential (ompio_file_t *fh, mca_common_ompio_cache_t *cache,
+                                     uint64_t blockno)
+{
+    if ((int64_t) blockno == cache->c_last_block) {
+        return;
+    }
+
+    if ((int64_t) blockno == cache->c_last_block + 1) {
+        cache->c_seq_count++;
+    }
+    else {
+        cache->c_seq_count = 0;
+    }
+    cache->c_last_block = (int64_t) blockno;
+
+    if (0 == cache->c_seq_count) {
+        return;
+    }
+
+    for (int k = 1 ; k <= cache->c_prefetch_depth ; ++k) {
+        cache_prefetch (fh, cache, blockno + k);
+    }
+}
+
+static mca_common_ompio_cache_block_t *cache_get (ompio_file_t *fh, mca_common_ompio_cache_t *cache,
+                                                  uint64_t blockno)
+{
+    mca_common_ompio_cache_block_t *block;
+    void *value;
+    ssize_t ret;
+
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64 (&cache->c_map, blockno, &value)) {
+        block = (mca_common_ompio_cache_block_t *) value;
+        cache_block_wait (cache, block);
+        if (0 <= block->cb_offset) {
+            CACHE_COUNT(mca_common_ompio_read_cache_hits);
+            cache_block_touch (cache, block);
+            return block;
+        }
+    }
+
+    CACHE_COUNT(mca_common_ompio_read_cache_misses);
+
+    block = cache_victim (cache, true);
+    ret = cache_fill (fh, cache, block, blockno, NULL);
+    if (0 > ret) {
+        return NULL;
+    }
+
+    block->cb_offset = (OMPI_MPI_OFFSET_TYPE) (blockno * cache->c_block_size);
+    block->cb_valid = (size_t) ret;
+    opal_hash_table_set_value_uint64 (&cache->c_map, blockno, block);
+    cache_block_touch (cache, block);
+
+    return block;
+}
+
+int mca_common_ompio_cache_init (ompio_file_t *fh)
+{
+    mca_common_ompio_cache_t *cache;
+    char value[MPI_MAX_INFO_VAL];
+    long cache_size;
+    int block_size, num_blocks, flag;
+
+    fh->f_read_cache = NULL;
+
+    if (fh->f_amode & MPI_MODE_WRONLY) {
+        return OMPI_SUCCESS;
+    }
+
+    cache_size = OMPIO_MCA_GET(fh, read_cache_size);
+    opal_info_get (fh->f_info, "ompio_read_cache_size", MPI_MAX_INFO_VAL, value, &flag);
+    if ( flag ) {
+        /* Info object trumps mca parameter value */
+        cache_size = strtol (value, NULL, 10);
+        OMPIO_MCA_PRINT_INFO(fh, "ompio_read_cache_size", value, "");
+    }
+
+    block_size = OMPIO_MCA_GET(fh, read_cache_block_size);
+    if (0 >= cache_size || 0 >= block_size) {
+        return OMPI_SUCCESS;
+    }
+
+    /* at least two blocks, so that a read-ahead never evicts the block
+     * currently being copied out */
+    num_blocks = (int) (cache_size / block_size);
+    if (num_blocks < 2) {
+        num_blocks = 2;
+    }
+
+    cache = (mca_common_ompio_cache_t *) calloc (1, sizeof (*cache));
+    if (NULL == cache) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    cache->c_buffer = (char *) malloc ((size_t) num_blocks * block_size);
+    cache->c_blocks = (mca_common_ompio_cache_block_t *) malloc (num_blocks * sizeof (mca_common_ompio_cache_block_t));
+    if (NULL == cache->c_buffer || NULL == cache->c_blocks) {
+        free (cache->c_buffer);
+        free (cache->c_blocks);
+        free (cache);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    cache->c_block_size = (size_t) block_size;
+    cache->c_num_blocks = num_blocks;
+    cache->c_last_block = -2;
+    cache->c_seq_count  = 0;
+
+    cache->c_prefetch_depth = OMPIO_MCA_GET(fh, read_cache_prefetch);
+    if (cache->c_prefetch_depth > num_blocks / 2) {
+        cache->c_prefetch_depth = num_blocks / 2;
+    }
+    if (cache->c_prefetch_depth < 0 || NULL == fh->f_fbtl->fbtl_ipreadv) {
+        cache->c_prefetch_depth = 0;
+    }
+
+    OBJ_CONSTRUCT(&cache->c_lru, opal_list_t);
+    OBJ_CONSTRUCT(&cache->c_map, opal_hash_table_t);
+    opal_hash_table_init (&cache->c_map, num_blocks);
+
+    for (int i = 0 ; i < num_blocks ; ++i) {
+        OBJ_CONSTRUCT(cache->c_blocks + i, mca_common_ompio_cache_block_t);
+        cache->c_blocks[i].cb_buf = cache->c_buffer + (size_t) i * block_size;
+        opal_list_append (&cache->c_lru, &cache->c_blocks[i].super);
+    }
+
+    fh->f_read_cache = cache;
+
+    return OMPI_SUCCESS;
+}
+
+void mca_common_ompio_cache_invalidate (ompio_file_t *fh)
+{
+    mca_common_ompio_cache_t *cache = fh->f_read_cache;
+
+    if (NULL == cache) {
+        return;
+    }
+
+    for (int i = 0 ; i < cache->c_num_blocks ; ++i) {
+        cache_block_wait (cache, cache->c_blocks + i);
+        cache_block_drop (cache, cache->c_blocks + i);
+    }
+
+    cache->c_last_block = -2;
+    cache->c_seq_count  = 0;
+}
+
+void mca_common_ompio_cache_fini (ompio_file_t *fh)
+{
+    mca_common_ompio_cache_t *cache = fh->f_read_cache;
+
+    if (NULL == cache) {
+        return;
+    }
+
+    mca_common_ompio_cache_invalidate (fh);
+
+    while (NULL != opal_list_remove_first (&cache->c_lru));
+    for (int i = 0 ; i < cache->c_num_blocks ; ++i) {
+        OBJ_DESTRUCT(cache->c_blocks + i);
+    }
+    OBJ_DESTRUCT(&cache->c_lru);
+    OBJ_DESTRUCT(&cache->c_map);
+
+    free (cache->c_blocks);
+    free (cache->c_buffer);
+    free (cache);
+
+    fh->f_read_cache = NULL;
+}
+
+/* read the consecutive large entries [first, first + count) through the
+ * fbtl, returns the number of bytes read or an error */
+static ssize_t cache_preadv_direct (ompio_file_t *fh, int first, int count, size_t *expected)
+{
+    mca_common_ompio_io_array_t *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    ssize_t ret;
+
+    *expected = 0;
+    for (int i = first ; i < first + count ; ++i) {
+        *expected += io_array[i].length;
+    }
+
+    fh->f_io_array = io_array + first;
+    fh->f_num_of_io_entries = count;
+
+    ret = fh->f_fbtl->fbtl_preadv (fh);
+
+    fh->f_io_array = io_array;
+    fh->f_num_of_io_entries = num_of_io_entries;
+
+    return ret;
+}
+
+ssize_t mca_common_ompio_cache_preadv (ompio_file_t *fh)
+{
+    mca_common_ompio_cache_t *cache = fh->f_read_cache;
+    mca_common_ompio_io_array_t *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    ssize_t total = 0, ret;
+    size_t expected;
+
+    /* the entries are read in order and the read stops at the first one
+     * that is short, so that the bytes counted are the ones at the start
+     * of the request, as for a plain fbtl_preadv */
+    for (int i = 0 ; i < num_of_io_entries ; ++i) {
+        OMPI_MPI_OFFSET_TYPE offset = (OMPI_MPI_OFFSET_TYPE)(intptr_t) io_array[i].offset;
+        char *dst = (char *) io_array[i].memory_address;
+        size_t len = io_array[i].length;
+
+        if (len >= cache->c_block_size) {
+            /* large entries do not benefit from the cache, read the run
+             * of them in a single call */
+            int count = 1;
+
+            while (i + count < num_of_io_entries &&
+                   io_array[i + count].length >= cache->c_block_size) {
+                ++count;
+            }
+
+            ret = cache_preadv_direct (fh, i, count, &expected);
+            if (0 > ret) {
+                return ret;
+            }
+            total += ret;
+            if ((size_t) ret < expected) {
+                return total;
+            }
+            i += count - 1;
+            continue;
+        }
+
+        while (len > 0) {
+            mca_common_ompio_cache_block_t *block;
+            uint64_t blockno = (uint64_t) offset / cache->c_block_size;
+            size_t in_block = (size_t) offset - blockno * cache->c_block_size;
+            size_t n = OMPIO_MIN(len, cache->c_block_size - in_block);
+
+            block = cache_get (fh, cache, blockno);
+            if (NULL == block) {
+                return OMPI_ERROR;
+            }
+
+            if (in_block >= block->cb_valid) {
+                /* end of file */
+                return total;
+            }
+            n = OMPIO_MIN(n, block->cb_valid - in_block);
+            memcpy (dst, block->cb_buf + in_block, n);
+
+            cache_detect_sequential (fh, cache, blockno);
+
+            total  += n;
+            offset += n;
+            dst    += n;
+            len    -= n;
+        }
+    }
+
+    return total;
+}
@@ -0,0 +1,90 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COMMON_OMPIO_CACHE_H
+#define MCA_COMMON_OMPIO_CACHE_H
+
+#include "ompi_config.h"
+#include "opal/class/opal_list.h"
+#include "opal/class/opal_hash_table.h"
+#include "common_ompio.h"
+#include "common_ompio_request.h"
+
+BEGIN_C_DECLS
+
+/**
+ * One page of the read cache. A block either holds clean file data
+ * starting at cb_offset, is being filled by an outstanding read-ahead
+ * (cb_req != NULL), or is empty (cb_offset == -1).
+ */
+struct mca_common_ompio_cache_block_t {
+    opal_list_item_t      super;     /* position in the LRU list */
+    OMPI_MPI_OFFSET_TYPE  cb_offset; /* block aligned file offset */
+    size_t                cb_valid;  /* valid bytes, short at the end of file */
+    char                 *cb_buf;
+    ompi_request_t       *cb_req;    /* outstanding read-ahead */
+};
+typedef struct mca_common_ompio_cache_block_t mca_common_ompio_cache_block_t;
+OBJ_CLASS_DECLARATION(mca_common_ompio_cache_block_t);
+
+/**
+ * Per-file read cache used by the independent read operations.
+ */
+struct mca_common_ompio_cache_t {
+    size_t                          c_block_size;
+    int                             c_num_blocks;
+    int                             c_prefetch_depth;
+    char                           *c_buffer;
+    mca_common_ompio_cache_block_t *c_blocks;
+    opal_list_t                     c_lru;   /* most recently used first */
+    opal_hash_table_t               c_map;   /* block number -> block */
+    /* sequential pattern detection */
+    int64_t                         c_last_block;
+    int                             c_seq_count;
+};
+typedef struct mca_common_ompio_cache_t mca_common_ompio_cache_t;
+
+/* performance counters exported as pvars by the io/ompio component */
+OMPI_DECLSPEC extern unsigned long long mca_common_ompio_read_cache_hits;
+OMPI_DECLSPEC extern unsigned long long mca_common_ompio_read_cache_misses;
+OMPI_DECLSPEC extern unsigned long long mca_common_ompio_read_cache_prefetches;
+
+/**
+ * Set up the read cache of a file if it has been requested through the
+ * read_cache_size mca parameter or the ompio_read_cache_size info key.
+ * Leaves fh->f_read_cache NULL otherwise.
+ */
+OMPI_DECLSPEC int mca_common_ompio_cache_init (ompio_file_t *fh);
+OMPI_DECLSPEC void mca_common_ompio_cache_fini (ompio_file_t *fh);
+
+/**
+ * Drop all cached data, waiting for outstanding read-ahead first.
+ * Called whenever data in the file might have changed: writes of this
+ * process, MPI_File_sync and changes of the atomicity mode.
+ */
+OMPI_DECLSPEC void mca_common_ompio_cache_invalidate (ompio_file_t *fh);
+
+/**
+ * Same interface as fbtl_preadv: serve the entries of fh->f_io_array,
+ * going through the cache for small entries and straight to the fbtl
+ * for large ones. The entries are read in order up to the first short
+ * read (end of file). Returns the number of bytes read or a negative
+ * error.
+ */
+OMPI_DECLSPEC ssize_t mca_common_ompio_cache_preadv (ompio_file_t *fh);
+
+static inline bool mca_common_ompio_cache_in_use (ompio_file_t *fh)
+{
+    /* in atomic mode every read has to observe concurrent writes */
+    return NULL != fh->f_read_cache && !fh->f_atomicity;
+}
+
+END_C_DECLS
+
+#endif /* MCA_COMMON_OMPIO_CACHE_H */
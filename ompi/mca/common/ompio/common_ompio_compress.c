@@ -0,0 +1,810 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/io/base/base.h"
+#include "ompi/mca/osc/osc.h"
+#include "ompi/win/win.h"
+#include "opal/mca/compress/compress.h"
+#include "opal/mca/compress/base/base.h"
+#include "opal/util/info.h"
+#include "opal/util/output.h"
+
+#include "common_ompio.h"
+#include "common_ompio_compress.h"
+
+/*
+ * Compressed storage of the file data.
+ *
+ * Reads and writes reach this code through a copy of the fbtl module
+ * whose preadv and pwritev are replaced, so that the collective as well
+ * as the individual paths, the read cache and the write-behind buffer
+ * work unchanged on the logical file. The fcoll components issue one
+ * pwritev per aggregator and collective buffer cycle, which therefore
+ * becomes one block. Blocks that do not get smaller are stored as is.
+ * Data that has never been written reads as zeros.
+ *
+ * The non-blocking fbtl functions are not provided, their users fall
+ * back to the blocking ones.
+ */
+
+static ssize_t compress_preadv (ompio_file_t *fh);
+static ssize_t compress_pwritev (ompio_file_t *fh);
+
+static int compress_reserve (uint8_t **buf, size_t *size, size_t need)
+{
+    uint8_t *tmp;
+
+    if (*size >= need) {
+        return OMPI_SUCCESS;
+    }
+    tmp = (uint8_t *) realloc (*buf, need);
+    if (NULL == tmp) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    *buf  = tmp;
+    *size = need;
+
+    return OMPI_SUCCESS;
+}
+
+/* physical I/O of a single contiguous piece through the original fbtl */
+static ssize_t compress_pio (ompio_file_t *fh, mca_common_ompio_compress_t *z, bool write,
+                             void *buf, uint64_t offset, size_t len)
+{
+    mca_common_ompio_io_array_t entry, *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    ssize_t ret;
+
+    entry.memory_address = buf;
+    entry.offset = (IOVBASE_TYPE *)(intptr_t) offset;
+    entry.length = len;
+
+    fh->f_io_array = &entry;
+    fh->f_num_of_io_entries = 1;
+    if (write) {
+        ret = z->z_orig_fbtl->fbtl_pwritev (fh);
+    }
+    else {
+        ret = z->z_orig_fbtl->fbtl_preadv (fh);
+    }
+    fh->f_io_array = io_array;
+    fh->f_num_of_io_entries = num_of_io_entries;
+
+    if (0 <= ret && (size_t) ret != len) {
+        /* a block or the index is cut off */
+        ret = OMPI_ERROR;
+    }
+    return ret;
+}
+
+/* reserve len bytes at the end of the log, 0 only reads the end */
+static int compress_alloc (mca_common_ompio_compress_t *z, OMPI_MPI_OFFSET_TYPE len,
+                           OMPI_MPI_OFFSET_TYPE *offset)
+{
+    struct ompi_win_t *win = z->z_win;
+    int ret;
+
+    ret = win->w_osc_module->osc_fetch_and_op (&len, offset, OMPI_OFFSET_DATATYPE, 0, 0,
+                                               0 == len ? MPI_NO_OP : MPI_SUM, win);
+    if (OMPI_SUCCESS == ret) {
+        ret = win->w_osc_module->osc_flush (0, win);
+    }
+    return ret;
+}
+
+static int compress_append (mca_common_ompio_compress_extent_t **ext, size_t *num,
+                            size_t *max, const mca_common_ompio_compress_extent_t *x)
+{
+    mca_common_ompio_compress_extent_t *last;
+
+    if (*num > 0) {
+        last = &(*ext)[*num - 1];
+        if (last->x_block == x->x_block &&
+            last->x_offset + last->x_length == x->x_offset &&
+            last->x_block_off + last->x_length == x->x_block_off) {
+            /* continues the previous range within the same block */
+            last->x_length += x->x_length;
+            return OMPI_SUCCESS;
+        }
+    }
+
+    if (*num == *max) {
+        size_t n = 0 == *max ? 64 : 2 * *max;
+        mca_common_ompio_compress_extent_t *tmp;
+
+        tmp = (mca_common_ompio_compress_extent_t *) realloc (*ext, n * sizeof (*tmp));
+        if (NULL == tmp) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        *ext = tmp;
+        *max = n;
+    }
+    (*ext)[(*num)++] = *x;
+
+    return OMPI_SUCCESS;
+}
+
+static int compress_add (mca_common_ompio_compress_t *z,
+                         const mca_common_ompio_compress_extent_t *x, bool own)
+{
+    int ret;
+
+    ret = compress_append (&z->z_ext, &z->z_num_ext, &z->z_max_ext, x);
+    if (OMPI_SUCCESS == ret && own) {
+        ret = compress_append (&z->z_new, &z->z_num_new, &z->z_max_new, x);
+    }
+    if ((OMPI_MPI_OFFSET_TYPE) (x->x_offset + x->x_length) > z->z_size) {
+        z->z_size = (OMPI_MPI_OFFSET_TYPE) (x->x_offset + x->x_length);
+    }
+    z->z_sorted = false;
+
+    return ret;
+}
+
+static int compress_cmp_offset (const void *a, const void *b)
+{
+    const mca_common_ompio_compress_extent_t *x = a, *y = b;
+
+    return (x->x_offset > y->x_offset) - (x->x_offset < y->x_offset);
+}
+
+static int compress_cmp_block (const void *a, const void *b)
+{
+    const mca_common_ompio_compress_extent_t *x = *(mca_common_ompio_compress_extent_t * const *) a;
+    const mca_common_ompio_compress_extent_t *y = *(mca_common_ompio_compress_extent_t * const *) b;
+
+    return (x->x_block > y->x_block) - (x->x_block < y->x_block);
+}
+
+static int compress_sort (mca_common_ompio_compress_t *z)
+{
+    uint64_t max_end = 0;
+    uint64_t *tmp;
+
+    qsort (z->z_ext, z->z_num_ext, sizeof (*z->z_ext), compress_cmp_offset);
+
+    tmp = (uint64_t *) realloc (z->z_max_end, (z->z_max_ext + 1) * sizeof (uint64_t));
+    if (NULL == tmp) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    z->z_max_end = tmp;
+
+    for (size_t i = 0 ; i < z->z_num_ext ; ++i) {
+        max_end = OMPIO_MAX(max_end, z->z_ext[i].x_offset + z->z_ext[i].x_length);
+        z->z_max_end[i] = max_end;
+    }
+    z->z_sorted = true;
+
+    return OMPI_SUCCESS;
+}
+
+/* decompress the block of x into z_dbuf, unless it is already there */
+static int compress_load_block (ompio_file_t *fh, mca_common_ompio_compress_t *z,
+                                const mca_common_ompio_compress_extent_t *x)
+{
+    size_t olen = (size_t) x->x_raw_len;
+    ssize_t ret;
+
+    if (z->z_dblock == x->x_block) {
+        return OMPI_SUCCESS;
+    }
+    if (!z->z_codec) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    z->z_dblock = UINT64_MAX;
+    if (OMPI_SUCCESS != compress_reserve (&z->z_cbuf, &z->z_cbuf_size, x->x_block_len) ||
+        OMPI_SUCCESS != compress_reserve (&z->z_dbuf, &z->z_dbuf_size, x->x_raw_len)) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    ret = compress_pio (fh, z, false, z->z_cbuf, x->x_block, (size_t) x->x_block_len);
+    if (0 > ret) {
+        return (int) ret;
+    }
+
+    if (OPAL_SUCCESS != opal_compress.block_decompress (z->z_cbuf, (size_t) x->x_block_len,
+                                                        z->z_dbuf, &olen) ||
+        olen != x->x_raw_len) {
+        opal_output (1, "common_ompio_compress: corrupted block at offset %llu of %s\n",
+                     (unsigned long long) x->x_block, fh->f_filename);
+        return OMPI_ERROR;
+    }
+    z->z_dblock = x->x_block;
+
+    return OMPI_SUCCESS;
+}
+
+/* fill [offset, offset+len) from the blocks, later blocks override earlier ones */
+static int compress_read_range (ompio_file_t *fh, mca_common_ompio_compress_t *z,
+                                char *buf, uint64_t offset, size_t len)
+{
+    uint64_t end = offset + len;
+    size_t lo = 0, hi, num_match = 0;
+    int ret;
+
+    memset (buf, 0, len);
+
+    if (!z->z_sorted) {
+        ret = compress_sort (z);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+    }
+
+    /* first record that reaches beyond offset */
+    hi = z->z_num_ext;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (z->z_max_end[mid] > offset) {
+            hi = mid;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
+
+    for (size_t i = lo ; i < z->z_num_ext && z->z_ext[i].x_offset < end ; ++i) {
+        if (z->z_ext[i].x_offset + z->z_ext[i].x_length <= offset) {
+            continue;
+        }
+        if (num_match == z->z_max_match) {
+            size_t n = 0 == z->z_max_match ? 16 : 2 * z->z_max_match;
+            mca_common_ompio_compress_extent_t **tmp;
+
+            tmp = (mca_common_ompio_compress_extent_t **) realloc (z->z_match, n * sizeof (*tmp));
+            if (NULL == tmp) {
+                return OMPI_ERR_OUT_OF_RESOURCE;
+            }
+            z->z_match = tmp;
+            z->z_max_match = n;
+        }
+        z->z_match[num_match++] = &z->z_ext[i];
+    }
+
+    if (num_match > 1) {
+        qsort (z->z_match, num_match, sizeof (*z->z_match), compress_cmp_block);
+    }
+
+    for (size_t i = 0 ; i < num_match ; ++i) {
+        const mca_common_ompio_compress_extent_t *x = z->z_match[i];
+        uint64_t start = OMPIO_MAX(offset, x->x_offset);
+        uint64_t stop  = OMPIO_MIN(end, x->x_offset + x->x_length);
+        uint64_t pos   = x->x_block_off + (start - x->x_offset);
+
+        if (x->x_block_len == x->x_raw_len) {
+            /* stored as is, read just the part needed */
+            ssize_t rret = compress_pio (fh, z, false, buf + (start - offset),
+                                         x->x_block + pos, (size_t) (stop - start));
+            if (0 > rret) {
+                return (int) rret;
+            }
+            continue;
+        }
+
+        ret = compress_load_block (fh, z, x);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+        memcpy (buf + (start - offset), z->z_dbuf + pos, (size_t) (stop - start));
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static ssize_t compress_preadv (ompio_file_t *fh)
+{
+    mca_common_ompio_compress_t *z = fh->f_compress;
+    mca_common_ompio_io_array_t *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    ssize_t total = 0;
+    int ret;
+
+    for (int i = 0 ; i < num_of_io_entries ; ++i) {
+        OMPI_MPI_OFFSET_TYPE offset = (OMPI_MPI_OFFSET_TYPE)(intptr_t) io_array[i].offset;
+
+        ret = compress_read_range (fh, z, (char *) io_array[i].memory_address,
+                                   (uint64_t) offset, io_array[i].length);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+        /* like a short read at the end of the file */
+        if (offset < z->z_size) {
+            total += (ssize_t) OMPIO_MIN((OMPI_MPI_OFFSET_TYPE) io_array[i].length,
+                                         z->z_size - offset);
+        }
+    }
+
+    return total;
+}
+
+static ssize_t compress_pwritev (ompio_file_t *fh)
+{
+    mca_common_ompio_compress_t *z = fh->f_compress;
+    mca_common_ompio_io_array_t *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    size_t skip = 0, remaining = 0;
+    ssize_t total = 0;
+    int i = 0, ret;
+
+    if (NULL == z->z_win) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    for (int k = 0 ; k < num_of_io_entries ; ++k) {
+        remaining += io_array[k].length;
+    }
+
+    while (i < num_of_io_entries) {
+        mca_common_ompio_compress_extent_t x;
+        OMPI_MPI_OFFSET_TYPE block;
+        size_t raw_len = 0, stored, boff;
+        size_t start_skip = skip;
+        int start = i;
+        uint8_t *out;
+        ssize_t wret;
+
+        if (OMPI_SUCCESS != compress_reserve (&z->z_raw, &z->z_raw_size,
+                                              OMPIO_MIN(remaining, z->z_block_size))) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+
+        /* the next block: consecutive entries up to the block size */
+        while (i < num_of_io_entries && raw_len < z->z_block_size) {
+            size_t len = OMPIO_MIN(io_array[i].length - skip, z->z_block_size - raw_len);
+
+            memcpy (z->z_raw + raw_len, (char *) io_array[i].memory_address + skip, len);
+            raw_len += len;
+            skip    += len;
+            if (skip == io_array[i].length) {
+                ++i;
+                skip = 0;
+            }
+        }
+        if (0 == raw_len) {
+            break;
+        }
+        remaining -= raw_len;
+
+        out    = z->z_raw;
+        stored = raw_len;
+        if (z->z_codec &&
+            OMPI_SUCCESS == compress_reserve (&z->z_cbuf, &z->z_cbuf_size,
+                                              opal_compress.block_bound (raw_len))) {
+            size_t clen = z->z_cbuf_size;
+
+            if (OPAL_SUCCESS == opal_compress.block_compress (z->z_raw, raw_len, z->z_cbuf, &clen) &&
+                clen < raw_len) {
+                out    = z->z_cbuf;
+                stored = clen;
+            }
+        }
+        ret = compress_alloc (z, (OMPI_MPI_OFFSET_TYPE) stored, &block);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+        wret = compress_pio (fh, z, true, out, (uint64_t) block, stored);
+        if (0 > wret) {
+            return wret;
+        }
+
+        /* one record per entry, or part of an entry, in the block */
+        x.x_block     = (uint64_t) block;
+        x.x_block_len = stored;
+        x.x_raw_len   = raw_len;
+        boff = 0;
+        for (int j = start ; boff < raw_len ; ++j) {
+            size_t len = OMPIO_MIN(io_array[j].length - start_skip, raw_len - boff);
+
+            if (len > 0) {
+                x.x_offset    = (uint64_t)(intptr_t) io_array[j].offset + start_skip;
+                x.x_length    = len;
+                x.x_block_off = boff;
+                ret = compress_add (z, &x, true);
+                if (OMPI_SUCCESS != ret) {
+                    return ret;
+                }
+            }
+            boff += len;
+            start_skip = 0;
+        }
+
+        total += (ssize_t) raw_len;
+    }
+
+    return total;
+}
+
+/* the lowest, i.e. the first failing, status of all processes */
+static int compress_agree (ompio_file_t *fh, int status)
+{
+    int ret, result = status;
+
+    ret = fh->f_comm->c_coll->coll_allreduce (&status, &result, 1, MPI_INT, MPI_MIN, fh->f_comm,
+                                              fh->f_comm->c_coll->coll_allreduce_module);
+    return OMPI_SUCCESS == ret ? result : ret;
+}
+
+/* exchange the records written since the last exchange, with all
+ * processes or only towards the first one */
+static int compress_exchange (ompio_file_t *fh, mca_common_ompio_compress_t *z, bool all)
+{
+    ompi_communicator_t *comm = fh->f_comm;
+    mca_common_ompio_compress_extent_t *recv = NULL;
+    ompi_datatype_t *type = NULL;
+    int *counts = NULL, *displs = NULL;
+    int num = (int) z->z_num_new, total = 0, ret;
+    bool root = all || 0 == fh->f_rank;
+
+    if (z->z_num_new > INT_MAX) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    ret = ompi_datatype_create_contiguous (sizeof (mca_common_ompio_compress_extent_t),
+                                           &ompi_mpi_byte.dt, &type);
+    if (OMPI_SUCCESS == ret) {
+        ret = ompi_datatype_commit (&type);
+    }
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+
+    if (root) {
+        counts = (int *) malloc (fh->f_size * sizeof (int));
+        displs = (int *) malloc (fh->f_size * sizeof (int));
+        if (NULL == counts || NULL == displs) {
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+    }
+
+    if (all) {
+        ret = comm->c_coll->coll_allgather (&num, 1, MPI_INT, counts, 1, MPI_INT,
+                                            comm, comm->c_coll->coll_allgather_module);
+    }
+    else {
+        ret = comm->c_coll->coll_gather (&num, 1, MPI_INT, counts, 1, MPI_INT, 0,
+                                         comm, comm->c_coll->coll_gather_module);
+    }
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+
+    if (root) {
+        for (int i = 0 ; i < fh->f_size ; ++i) {
+            displs[i] = total;
+            total += counts[i];
+        }
+        recv = (mca_common_ompio_compress_extent_t *) malloc ((total + 1) * sizeof (*recv));
+        if (NULL == recv) {
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    /* all processes have to agree on whether the records can be received */
+    ret = compress_agree (fh, ret);
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+
+    if (all) {
+        ret = comm->c_coll->coll_allgatherv (z->z_new, num, type, recv, counts, displs, type,
+                                             comm, comm->c_coll->coll_allgatherv_module);
+    }
+    else {
+        ret = comm->c_coll->coll_gatherv (z->z_new, num, type, recv, counts, displs, type, 0,
+                                          comm, comm->c_coll->coll_gatherv_module);
+    }
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+
+    if (root) {
+        for (int i = 0 ; i < fh->f_size ; ++i) {
+            if (i == fh->f_rank) {
+                /* own records are already in the index */
+                continue;
+            }
+            for (int k = displs[i] ; k < displs[i] + counts[i] ; ++k) {
+                ret = compress_add (z, &recv[k], false);
+                if (OMPI_SUCCESS != ret) {
+                    goto exit;
+                }
+            }
+        }
+    }
+    z->z_num_new = 0;
+
+exit:
+    if (NULL != type) {
+        ompi_datatype_destroy (&type);
+    }
+    free (recv);
+    free (counts);
+    free (displs);
+
+    return ret;
+}
+
+/* bcast of an array of records, in pieces that fit an int count */
+static int compress_bcast_index (ompio_file_t *fh, mca_common_ompio_compress_extent_t *ext,
+                                 size_t num)
+{
+    ompi_communicator_t *comm = fh->f_comm;
+    ompi_datatype_t *type = NULL;
+    int ret;
+
+    ret = ompi_datatype_create_contiguous (sizeof (mca_common_ompio_compress_extent_t),
+                                           &ompi_mpi_byte.dt, &type);
+    if (OMPI_SUCCESS == ret) {
+        ret = ompi_datatype_commit (&type);
+    }
+
+    for (size_t done = 0 ; OMPI_SUCCESS == ret && done < num ; ) {
+        int count = (int) OMPIO_MIN(num - done, (size_t) INT_MAX);
+
+        ret = comm->c_coll->coll_bcast (ext + done, count, type, 0, comm,
+                                        comm->c_coll->coll_bcast_module);
+        done += count;
+    }
+
+    if (NULL != type) {
+        ompi_datatype_destroy (&type);
+    }
+    return ret;
+}
+
+static void compress_free (mca_common_ompio_compress_t *z)
+{
+    free (z->z_ext);
+    free (z->z_max_end);
+    free (z->z_new);
+    free (z->z_match);
+    free (z->z_raw);
+    free (z->z_cbuf);
+    free (z->z_dbuf);
+    free (z);
+}
+
+int mca_common_ompio_compress_init (ompio_file_t *fh)
+{
+    mca_common_ompio_compress_trailer_t trailer;
+    mca_common_ompio_compress_t *z;
+    /* status, number of records, start of the index and whether the file
+     * is a plain one, as found by the first process */
+    OMPI_MPI_OFFSET_TYPE hdr[4] = {OMPI_SUCCESS, 0, 0, 0};
+    const char *codec = opal_compress_base_selected_component.base_version.mca_component_name;
+    ompi_communicator_t *comm = fh->f_comm;
+    bool value;
+    int enabled, flag, ret;
+
+    fh->f_compress = NULL;
+
+    enabled = OMPIO_MCA_GET(fh, compress);
+    opal_info_get_bool (fh->f_info, "ompio_compress", &value, &flag);
+    if ( flag ) {
+        /* Info object trumps mca parameter value */
+        enabled = value;
+        OMPIO_MCA_PRINT_INFO(fh, "ompio_compress", value ? "true" : "false", "");
+    }
+    if (0 >= enabled) {
+        return OMPI_SUCCESS;
+    }
+
+    z = (mca_common_ompio_compress_t *) calloc (1, sizeof (*z));
+    if (NULL == z) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    z->z_codec      = NULL != opal_compress.block_compress && NULL != opal_compress.block_decompress &&
+                      NULL != opal_compress.block_bound;
+    z->z_block_size = 0 < fh->f_bytes_per_agg ? (size_t) fh->f_bytes_per_agg : 1048576;
+    z->z_dblock     = UINT64_MAX;
+
+    z->z_orig_fbtl  = fh->f_fbtl;
+
+    if (0 == fh->f_rank) {
+        OMPI_MPI_OFFSET_TYPE size = 0;
+
+        ret = fh->f_fs->fs_file_get_size (fh, &size);
+        if (OMPI_SUCCESS == ret && 0 < size) {
+            if ((size_t) size < sizeof (trailer) ||
+                0 > compress_pio (fh, z, false, &trailer, (uint64_t) size - sizeof (trailer),
+                                  sizeof (trailer)) ||
+                OMPIO_COMPRESS_MAGIC != trailer.t_magic ||
+                OMPIO_COMPRESS_VERSION != trailer.t_version) {
+                /* an existing plain file is accessed as is */
+                opal_output_verbose (10, ompi_io_base_framework.framework_output,
+                                     "common_ompio_compress: %s has not been written "
+                                     "compressed\n", fh->f_filename);
+                hdr[3] = 1;
+            }
+            else if ('\0' != trailer.t_codec[0] &&
+                     (!z->z_codec || 0 != strncmp (trailer.t_codec, codec, OMPIO_COMPRESS_CODEC_LEN))) {
+                opal_output (1, "common_ompio_compress: %s requires the %.16s compress "
+                             "component\n", fh->f_filename, trailer.t_codec);
+                ret = OMPI_ERR_NOT_SUPPORTED;
+            }
+            else if (0 < trailer.t_num_extents) {
+                z->z_ext = (mca_common_ompio_compress_extent_t *)
+                    malloc (trailer.t_num_extents * sizeof (*z->z_ext));
+                if (NULL == z->z_ext) {
+                    ret = OMPI_ERR_OUT_OF_RESOURCE;
+                }
+                else if (0 > compress_pio (fh, z, false, z->z_ext, trailer.t_index,
+                                           trailer.t_num_extents * sizeof (*z->z_ext))) {
+                    opal_output (1, "common_ompio_compress: cannot read the index of %s\n",
+                                 fh->f_filename);
+                    ret = OMPI_ERROR;
+                }
+            }
+            if (OMPI_SUCCESS == ret && 0 == hdr[3]) {
+                hdr[1] = (OMPI_MPI_OFFSET_TYPE) trailer.t_num_extents;
+                hdr[2] = (OMPI_MPI_OFFSET_TYPE) trailer.t_index;
+            }
+        }
+        hdr[0] = ret;
+    }
+
+    ret = comm->c_coll->coll_bcast (hdr, 4, OMPI_OFFSET_DATATYPE, 0, comm,
+                                    comm->c_coll->coll_bcast_module);
+    if (OMPI_SUCCESS == ret) {
+        ret = (int) hdr[0];
+    }
+    if (OMPI_SUCCESS != ret || 0 != hdr[3]) {
+        compress_free (z);
+        return ret;
+    }
+
+    if (0 < hdr[1]) {
+        if (0 != fh->f_rank) {
+            z->z_ext = (mca_common_ompio_compress_extent_t *) malloc (hdr[1] * sizeof (*z->z_ext));
+            if (NULL == z->z_ext) {
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+            }
+        }
+        ret = compress_agree (fh, ret);
+        if (OMPI_SUCCESS == ret) {
+            z->z_num_ext = z->z_max_ext = (size_t) hdr[1];
+            ret = compress_bcast_index (fh, z->z_ext, z->z_num_ext);
+        }
+        if (OMPI_SUCCESS != ret) {
+            compress_free (z);
+            return ret;
+        }
+        for (size_t i = 0 ; i < z->z_num_ext ; ++i) {
+            z->z_size = OMPIO_MAX(z->z_size, (OMPI_MPI_OFFSET_TYPE) (z->z_ext[i].x_offset +
+                                                                     z->z_ext[i].x_length));
+        }
+    }
+
+    if (!(fh->f_amode & MPI_MODE_RDONLY)) {
+        opal_info_t *win_info = OBJ_NEW(opal_info_t);
+        size_t win_size = ( 0 == fh->f_rank ) ? sizeof(OMPI_MPI_OFFSET_TYPE) : 0;
+
+        if (NULL == win_info) {
+            compress_free (z);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        ret = ompi_win_allocate (win_size, sizeof(OMPI_MPI_OFFSET_TYPE), win_info, comm,
+                                 &z->z_end_ptr, &z->z_win);
+        OBJ_RELEASE(win_info);
+        if (OMPI_SUCCESS != ret) {
+            compress_free (z);
+            return ret;
+        }
+        if (0 == fh->f_rank) {
+            /* new blocks replace the old index, it is written again on close */
+            *z->z_end_ptr = hdr[2];
+        }
+        ret = comm->c_coll->coll_barrier (comm, comm->c_coll->coll_barrier_module);
+        if (OMPI_SUCCESS == ret) {
+            ret = z->z_win->w_osc_module->osc_lock_all (MPI_MODE_NOCHECK, z->z_win);
+        }
+        if (OMPI_SUCCESS != ret) {
+            ompi_win_free (z->z_win);
+            compress_free (z);
+            return ret;
+        }
+    }
+
+    z->z_fbtl = *fh->f_fbtl;
+    z->z_fbtl.fbtl_preadv  = compress_preadv;
+    z->z_fbtl.fbtl_pwritev = compress_pwritev;
+    z->z_fbtl.fbtl_ipreadv  = NULL;
+    z->z_fbtl.fbtl_ipwritev = NULL;
+    fh->f_fbtl = &z->z_fbtl;
+    fh->f_compress = z;
+
+    return OMPI_SUCCESS;
+}
+
+int mca_common_ompio_compress_sync (ompio_file_t *fh)
+{
+    mca_common_ompio_compress_t *z = fh->f_compress;
+
+    if (NULL == z) {
+        return OMPI_SUCCESS;
+    }
+    return compress_exchange (fh, z, true);
+}
+
+int mca_common_ompio_compress_fini (ompio_file_t *fh)
+{
+    mca_common_ompio_compress_t *z = fh->f_compress;
+    int ret = OMPI_SUCCESS, tret;
+
+    if (NULL == z) {
+        return OMPI_SUCCESS;
+    }
+
+    if (NULL != z->z_win) {
+        ret = compress_exchange (fh, z, false);
+
+        if (0 == fh->f_rank && OMPI_SUCCESS == ret) {
+            mca_common_ompio_compress_trailer_t trailer;
+            OMPI_MPI_OFFSET_TYPE end = 0;
+            ssize_t wret = 0;
+
+            memset (&trailer, 0, sizeof (trailer));
+            for (size_t i = 0 ; i < z->z_num_ext ; ++i) {
+                if (z->z_ext[i].x_block_len < z->z_ext[i].x_raw_len) {
+                    strncpy (trailer.t_codec,
+                             opal_compress_base_selected_component.base_version.mca_component_name,
+                             OMPIO_COMPRESS_CODEC_LEN - 1);
+                    break;
+                }
+            }
+
+            /* all blocks have been allocated before the gather completed */
+            ret = compress_alloc (z, 0, &end);
+            if (OMPI_SUCCESS == ret && 0 < z->z_num_ext) {
+                wret = compress_pio (fh, z, true, z->z_ext, (uint64_t) end,
+                                     z->z_num_ext * sizeof (*z->z_ext));
+            }
+            if (OMPI_SUCCESS == ret && 0 <= wret) {
+                trailer.t_num_extents = z->z_num_ext;
+                trailer.t_index       = (uint64_t) end;
+                trailer.t_version     = OMPIO_COMPRESS_VERSION;
+                trailer.t_magic       = OMPIO_COMPRESS_MAGIC;
+                wret = compress_pio (fh, z, true, &trailer,
+                                     (uint64_t) end + z->z_num_ext * sizeof (*z->z_ext),
+                                     sizeof (trailer));
+            }
+            if (OMPI_SUCCESS == ret && 0 > wret) {
+                ret = (int) wret;
+            }
+            if (OMPI_SUCCESS != ret) {
+                opal_output (1, "common_ompio_compress: error %d writing the index of %s\n",
+                             ret, fh->f_filename);
+            }
+        }
+
+        fh->f_comm->c_coll->coll_bcast (&ret, 1, MPI_INT, 0, fh->f_comm,
+                                        fh->f_comm->c_coll->coll_bcast_module);
+
+        tret = z->z_win->w_osc_module->osc_unlock_all (z->z_win);
+        ompi_win_free (z->z_win);
+        if (OMPI_SUCCESS == ret) {
+            ret = tret;
+        }
+    }
+
+    fh->f_fbtl = z->z_orig_fbtl;
+    fh->f_compress = NULL;
+    compress_free (z);
+
+    return ret;
+}
@@ -0,0 +1,126 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COMMON_OMPIO_COMPRESS_H
+#define MCA_COMMON_OMPIO_COMPRESS_H
+
+#include "ompi_config.h"
+#include "common_ompio.h"
+
+BEGIN_C_DECLS
+
+#define OMPIO_COMPRESS_MAGIC    0x315a43494f504d4fULL  /* "OMPIOCZ1" */
+#define OMPIO_COMPRESS_VERSION  1
+#define OMPIO_COMPRESS_CODEC_LEN 16
+
+/**
+ * Index record: a contiguous range of the logical file stored in a
+ * block. A block is stored compressed if x_block_len < x_raw_len and
+ * as is otherwise. Where records overlap, the one of the block with the
+ * higher physical offset, i.e. the one written later, is valid.
+ */
+struct mca_common_ompio_compress_extent_t {
+    uint64_t x_offset;     /* logical file offset */
+    uint64_t x_length;
+    uint64_t x_block;      /* physical offset of the block */
+    uint64_t x_block_len;  /* stored length of the block */
+    uint64_t x_raw_len;    /* uncompressed length of the block */
+    uint64_t x_block_off;  /* offset of the range in the uncompressed block */
+};
+typedef struct mca_common_ompio_compress_extent_t mca_common_ompio_compress_extent_t;
+
+/**
+ * Last bytes of a compressed file, following the index. Integers are
+ * stored in the byte order of the writing host.
+ */
+struct mca_common_ompio_compress_trailer_t {
+    char     t_codec[OMPIO_COMPRESS_CODEC_LEN];  /* "" if no block is compressed */
+    uint64_t t_num_extents;
+    uint64_t t_index;      /* physical offset of the index */
+    uint64_t t_version;
+    uint64_t t_magic;
+};
+typedef struct mca_common_ompio_compress_trailer_t mca_common_ompio_compress_trailer_t;
+
+/**
+ * Per-file state of a compressed file.
+ *
+ * The physical file is a log of blocks: every pwritev issued on the
+ * file, i.e. one collective buffer cycle of an aggregator or one
+ * independent write, is compressed into a block of its own and appended
+ * at a position obtained from an atomic counter on the first process.
+ * The index maps logical ranges to blocks. It is written behind the
+ * last block on close, merged between the processes by MPI_File_sync and
+ * loaded again on open.
+ */
+struct mca_common_ompio_compress_t {
+    mca_fbtl_base_module_t   z_fbtl;       /* installed as fh->f_fbtl */
+    mca_fbtl_base_module_t  *z_orig_fbtl;  /* does the physical I/O */
+    struct ompi_win_t       *z_win;        /* end of the log, NULL if read-only */
+    OMPI_MPI_OFFSET_TYPE    *z_end_ptr;
+    bool                     z_codec;      /* block codec available */
+    size_t                   z_block_size; /* largest uncompressed block */
+    OMPI_MPI_OFFSET_TYPE     z_size;       /* logical size of the file */
+
+    /* index known to this process */
+    mca_common_ompio_compress_extent_t *z_ext;
+    size_t                   z_num_ext;
+    size_t                   z_max_ext;
+    uint64_t                *z_max_end;    /* running maximum of the extent ends */
+    bool                     z_sorted;
+
+    /* records written by this process since the last exchange */
+    mca_common_ompio_compress_extent_t *z_new;
+    size_t                   z_num_new;
+    size_t                   z_max_new;
+
+    /* overlapping records of a read, ordered by block */
+    mca_common_ompio_compress_extent_t **z_match;
+    size_t                   z_max_match;
+
+    /* staging buffers and the last decompressed block */
+    uint8_t                 *z_raw;
+    size_t                   z_raw_size;
+    uint8_t                 *z_cbuf;
+    size_t                   z_cbuf_size;
+    uint8_t                 *z_dbuf;
+    size_t                   z_dbuf_size;
+    uint64_t                 z_dblock;     /* physical offset of z_dbuf, UINT64_MAX if none */
+};
+typedef struct mca_common_ompio_compress_t mca_common_ompio_compress_t;
+
+/**
+ * Turn on compression for a file if requested through the compress mca
+ * parameter or the ompio_compress info key: load the index of an
+ * existing compressed file and install the compressing fbtl wrapper.
+ * Existing files that have not been written compressed are accessed as
+ * they are. Collective.
+ */
+OMPI_DECLSPEC int mca_common_ompio_compress_init (ompio_file_t *fh);
+
+/**
+ * Write the index behind the last block and restore the original fbtl.
+ * Collective.
+ */
+OMPI_DECLSPEC int mca_common_ompio_compress_fini (ompio_file_t *fh);
+
+/**
+ * Exchange the records written since the last exchange, so that every
+ * process can read the data written by the others. Collective.
+ */
+OMPI_DECLSPEC int mca_common_ompio_compress_sync (ompio_file_t *fh);
+
+static inline bool mca_common_ompio_compress_in_use (ompio_file_t *fh)
+{
+    return NULL != fh->f_compress;
+}
+
+END_C_DECLS
+
+#endif /* MCA_COMMON_OMPIO_COMPRESS_H */
@@ -40,6 +40,10 @@
 #include <unistd.h>
 #include <math.h>
 #include "common_ompio.h"
+#include "common_ompio_cache.h"
+#include "common_ompio_wbuf.h"
+#include "common_ompio_tuner.h"
+#include "common_ompio_compress.h"
 #include "ompi/mca/topo/topo.h"
 
 static mca_common_ompio_generate_current_file_view_fn_t generate_current_file_view_fn;
@@ -165,6 +169,26 @@ int mca_common_ompio_file_open (ompi_communicator_t *comm,
         goto fn_fail;
     }
 
+    ret = mca_common_ompio_compress_init (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        goto fn_fail;
+    }
+
+    ret = mca_common_ompio_cache_init (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        goto fn_fail;
+    }
+
+    ret = mca_common_ompio_wbuf_init (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        goto fn_fail;
+    }
+
+    ret = mca_common_ompio_tuner_init (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        goto fn_fail;
+    }
+
     if ( true == use_sharedfp ) {
 	/* open the file once more for the shared file pointer if required.           
         ** Can be disabled by the user if no shared file pointer operations
@@ -199,8 +223,8 @@ int mca_common_ompio_file_open (ompi_communicator_t *comm,
         OMPI_MPI_OFFSET_TYPE current_size;
         mca_sharedfp_base_module_t * shared_fp_base_module;
 
-        ompio_fh->f_fs->fs_file_get_size( ompio_fh,
-                                          &current_size);
+        mca_common_ompio_file_get_size( ompio_fh,
+                                        &current_size);
         mca_common_ompio_set_explicit_offset (ompio_fh, current_size);
         if ( true == use_sharedfp ) {
             if ( NULL != ompio_fh->f_sharedfp ) {
@@ -235,6 +259,12 @@ int mca_common_ompio_file_close (ompio_file_t *ompio_fh)
     int delete_flag = 0;
     char name[256];
 
+    /* buffered data has to reach the file before the barrier */
+    ret = mca_common_ompio_wbuf_fini (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        opal_output (1,"mca_common_ompio_file_close: error writing buffered data\n");
+    }
+
     ret = ompio_fh->f_comm->c_coll->coll_barrier ( ompio_fh->f_comm, ompio_fh->f_comm->c_coll->coll_barrier_module);
     if ( OMPI_SUCCESS != ret ) {
         /* Not sure what to do */
@@ -272,6 +302,14 @@ int mca_common_ompio_file_close (ompio_file_t *ompio_fh)
     if( NULL != ompio_fh->f_sharedfp ){
         ret = ompio_fh->f_sharedfp->sharedfp_file_close(ompio_fh);
     }
+    mca_common_ompio_cache_fini (ompio_fh);
+    mca_common_ompio_tuner_fini (ompio_fh);
+    /* the index has to be written before the file is closed */
+    ret = mca_common_ompio_compress_fini (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        opal_output (1,"mca_common_ompio_file_close: error writing the index of the compressed file\n");
+    }
+
     if ( NULL != ompio_fh->f_fs ) {
 	/* The pointer might not be set if file_close() is
 	** called from the file destructor in case of an error
@@ -380,6 +418,17 @@ int mca_common_ompio_file_get_size (ompio_file_t *ompio_fh,
 {
     int ret = OMPI_SUCCESS;
 
+    ret = mca_common_ompio_wbuf_flush (ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
+    if ( mca_common_ompio_compress_in_use (ompio_fh) ) {
+        /* size of the logical file as far as known to this process */
+        *size = ompio_fh->f_compress->z_size;
+        return OMPI_SUCCESS;
+    }
+
     ret = ompio_fh->f_fs->fs_file_get_size (ompio_fh, size);
 
     return ret;
@@ -422,6 +471,11 @@ int mca_common_ompio_set_file_defaults (ompio_file_t *fh)
        int i, flag;
        
        fh->f_io_array = NULL;
+       fh->f_read_cache = NULL;
+       fh->f_write_buf = NULL;
+       fh->f_aggr_tuner = NULL;
+       fh->f_compress = NULL;
+       fh->f_fbtl_data = NULL;
        fh->f_perm = OMPIO_PERM_NULL;
        fh->f_flags = 0;
        
@@ -28,6 +28,7 @@
 
 #include "common_ompio.h"
 #include "common_ompio_aggregators.h"
+#include "common_ompio_wbuf.h"
 #include "ompi/mca/fcoll/base/base.h"
 #include "ompi/mca/topo/topo.h"
 
@@ -72,6 +73,11 @@ int mca_common_ompio_set_view (ompio_file_t *fh,
     ptrdiff_t ftype_extent, lb, ub;
     ompi_datatype_t *newfiletype;
 
+    ret = mca_common_ompio_wbuf_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     if ( NULL != fh->f_etype ) {
         ompi_datatype_destroy (&fh->f_etype);
     }
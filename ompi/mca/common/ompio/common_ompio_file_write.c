@@ -32,6 +32,9 @@
 #include "common_ompio.h"
 #include "common_ompio_request.h"
 #include "common_ompio_buffer.h"
+#include "common_ompio_cache.h"
+#include "common_ompio_wbuf.h"
+#include "common_ompio_tuner.h"
 #include <unistd.h>
 #include <math.h>
 
@@ -61,6 +64,9 @@ int mca_common_ompio_file_write (ompio_file_t *fh,
       return ret;
     }
 
+    /* cached data of the file can not be trusted anymore */
+    mca_common_ompio_cache_invalidate (fh);
+
     
     if ( 0 == count ) {
         if ( MPI_STATUS_IGNORE != status ) {
@@ -151,7 +157,12 @@ int mca_common_ompio_file_write (ompio_file_t *fh,
                                           &fh->f_num_of_io_entries);
 
         if (fh->f_num_of_io_entries) {
-            ret_code =fh->f_fbtl->fbtl_pwritev (fh);
+            if ( mca_common_ompio_wbuf_in_use (fh) ) {
+                ret_code = mca_common_ompio_wbuf_pwritev (fh);
+            }
+            else {
+                ret_code = fh->f_fbtl->fbtl_pwritev (fh);
+            }
             if ( 0<= ret_code ) {
                 real_bytes_written+= (size_t)ret_code;
             }
@@ -220,6 +231,15 @@ int mca_common_ompio_file_iwrite (ompio_file_t *fh,
         ret = MPI_ERR_READ_ONLY;
       return ret;
     }
+
+    /* cached data of the file can not be trusted anymore */
+    mca_common_ompio_cache_invalidate (fh);
+
+    /* non-blocking writes bypass the write-behind buffer */
+    ret = mca_common_ompio_wbuf_flush (fh);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
     
     mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_WRITE);
 
@@ -386,8 +406,20 @@ int mca_common_ompio_file_write_all (ompio_file_t *fh,
                                      struct ompi_datatype_t *datatype,
                                      ompi_status_public_t *status)
 {
-    int ret = OMPI_SUCCESS;
-    
+    int ret = OMPI_SUCCESS, tuner_ret, flush_ret;
+    size_t type_size;
+
+    mca_common_ompio_cache_invalidate (fh);
+    /* a failed flush is only reported once this process has taken part
+     * in the collective steps, the other processes wait for them */
+    flush_ret = mca_common_ompio_wbuf_flush (fh);
+
+    ompi_datatype_type_size (datatype, &type_size);
+    ret = mca_common_ompio_tuner_begin (fh, type_size * (size_t) count);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+
     if ( !( fh->f_flags & OMPIO_DATAREP_NATIVE ) &&
          !(datatype == &ompi_mpi_byte.dt  ||
            datatype == &ompi_mpi_char.dt   )) {
@@ -434,7 +466,12 @@ int mca_common_ompio_file_write_all (ompio_file_t *fh,
                                                  datatype,
                                                  status);
     }
-    return ret;
+
+    tuner_ret = mca_common_ompio_tuner_end (fh, ret);
+    if ( OMPI_SUCCESS != flush_ret ) {
+        return flush_ret;
+    }
+    return OMPI_SUCCESS == ret ? tuner_ret : ret;
 }
 
 int mca_common_ompio_file_write_at_all (ompio_file_t *fh,
@@ -465,7 +502,10 @@ int mca_common_ompio_file_iwrite_all (ompio_file_t *fp,
                                       struct ompi_datatype_t *datatype,
                                       ompi_request_t **request)
 {
-    int ret = OMPI_SUCCESS;
+    int ret = OMPI_SUCCESS, flush_ret;
+
+    mca_common_ompio_cache_invalidate (fp);
+    flush_ret = mca_common_ompio_wbuf_flush (fp);
 
     if ( NULL != fp->f_fcoll->fcoll_file_iwrite_all ) {
 	ret = fp->f_fcoll->fcoll_file_iwrite_all (fp,
@@ -481,6 +521,16 @@ int mca_common_ompio_file_iwrite_all (ompio_file_t *fp,
 	ret = mca_common_ompio_file_iwrite ( fp, buf, count, datatype, request );
     }
 
+    if ( OMPI_SUCCESS != flush_ret && OMPI_SUCCESS == ret ) {
+        /* the other processes wait for the part of this process: complete
+         * it before reporting the failed flush, no request is returned */
+        if ( OMPI_SUCCESS != ompi_request_wait (request, MPI_STATUS_IGNORE) ) {
+            /* failed requests are not released by wait */
+            ompi_request_free (request);
+        }
+        ret = flush_ret;
+    }
+
     return ret;
 }
 
@@ -29,6 +29,10 @@ bool mca_common_ompio_progress_is_registered=false;
  * Global list of requests for this component
  */
 opal_list_t mca_common_ompio_pending_requests = {{0}};
+/*
+ * Requests ompio issues on its own, they do not count as pending
+ */
+static opal_list_t mca_common_ompio_internal_requests = {{0}};
 
 
 
@@ -50,7 +54,8 @@ static int mca_common_ompio_request_free ( struct ompi_request_t **req)
     if ( NULL != ompio_req->req_free_fn ) {
         ompio_req->req_free_fn (ompio_req );
     }
-    opal_list_remove_item (&mca_common_ompio_pending_requests, &ompio_req->req_item);
+    opal_list_remove_item (ompio_req->req_internal ? &mca_common_ompio_internal_requests :
+                           &mca_common_ompio_pending_requests, &ompio_req->req_item);
 
     OBJ_RELEASE (*req);
     *req = MPI_REQUEST_NULL;
@@ -77,6 +82,7 @@ void mca_common_ompio_request_construct(mca_ompio_request_t* req)
     req->req_size            = 0;
     req->req_progress_fn     = NULL;
     req->req_free_fn         = NULL;
+    req->req_internal        = false;
 
     OBJ_CONSTRUCT(&req->req_item, opal_list_item_t);
     opal_list_append (&mca_common_ompio_pending_requests, &req->req_item);
@@ -97,6 +103,7 @@ void mca_common_ompio_request_init ( void )
 {
     /* Create the list of pending requests */
     OBJ_CONSTRUCT(&mca_common_ompio_pending_requests, opal_list_t);
+    OBJ_CONSTRUCT(&mca_common_ompio_internal_requests, opal_list_t);
     return;
 }
 
@@ -107,6 +114,7 @@ void mca_common_ompio_request_fini ( void )
        were not destroyed / completed upon MPI_FINALIZE */
 
     OBJ_DESTRUCT(&mca_common_ompio_pending_requests);
+    OBJ_DESTRUCT(&mca_common_ompio_internal_requests);
     return;
 }
 
@@ -123,6 +131,17 @@ void mca_common_ompio_request_alloc ( mca_ompio_request_t **req, mca_ompio_reque
     return;
 }
 
+void mca_common_ompio_request_alloc_internal ( mca_ompio_request_t **req, mca_ompio_request_type_t type )
+{
+    mca_common_ompio_request_alloc (req, type);
+
+    opal_list_remove_item (&mca_common_ompio_pending_requests, &(*req)->req_item);
+    opal_list_append (&mca_common_ompio_internal_requests, &(*req)->req_item);
+    (*req)->req_internal = true;
+
+    return;
+}
+
 void mca_common_ompio_register_progress ( void ) 
 {
     if ( false == mca_common_ompio_progress_is_registered) {
@@ -131,13 +150,13 @@ void mca_common_ompio_register_progress ( void )
     }
     return;
 }
-int mca_common_ompio_progress ( void )
+static int mca_common_ompio_progress_list ( opal_list_t *list )
 {
     mca_ompio_request_t *req=NULL;
     opal_list_item_t *litem=NULL;
     int completed=0;
 
-    OPAL_LIST_FOREACH(litem, &mca_common_ompio_pending_requests, opal_list_item_t) {
+    OPAL_LIST_FOREACH(litem, list, opal_list_item_t) {
         req = GET_OMPIO_REQ_FROM_ITEM(litem);
         if( REQUEST_COMPLETE(&req->req_ompi) ) {
             continue;
@@ -156,3 +175,9 @@ int mca_common_ompio_progress ( void )
 
     return completed;
 }
+
+int mca_common_ompio_progress ( void )
+{
+    return mca_common_ompio_progress_list (&mca_common_ompio_pending_requests) +
+        mca_common_ompio_progress_list (&mca_common_ompio_internal_requests);
+}
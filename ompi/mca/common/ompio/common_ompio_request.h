@@ -57,6 +57,7 @@ struct mca_ompio_request_t {
     opal_convertor_t                          req_convertor;
     mca_fbtl_base_module_progress_fn_t      req_progress_fn;
     mca_fbtl_base_module_request_free_fn_t      req_free_fn;
+    bool                                       req_internal;
 };
 typedef struct mca_ompio_request_t mca_ompio_request_t;
 OBJ_CLASS_DECLARATION(mca_ompio_request_t);
@@ -67,6 +68,10 @@ OBJ_CLASS_DECLARATION(mca_ompio_request_t);
 OMPI_DECLSPEC void mca_common_ompio_request_init ( void);
 OMPI_DECLSPEC void mca_common_ompio_request_fini ( void ); 
 OMPI_DECLSPEC void mca_common_ompio_request_alloc ( mca_ompio_request_t **req, mca_ompio_request_type_t type);
+/* request issued by ompio itself on behalf of a file (read-ahead, write-behind).
+ * It is progressed like the others but is not a pending request of the
+ * application: the file it belongs to completes it in sync and close. */
+OMPI_DECLSPEC void mca_common_ompio_request_alloc_internal ( mca_ompio_request_t **req, mca_ompio_request_type_t type);
 OMPI_DECLSPEC int mca_common_ompio_progress ( void);
 OMPI_DECLSPEC void mca_common_ompio_register_progress ( void ); 
 
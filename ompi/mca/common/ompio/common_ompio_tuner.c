@@ -0,0 +1,402 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/info/info.h"
+#include "opal/util/output.h"
+#include "opal/util/printf.h"
+
+#include "common_ompio.h"
+#include "common_ompio_tuner.h"
+
+/*
+ * Profiles are text files named ompio_profile_<file system> in the
+ * directory given by the io_ompio_aggregator_profile parameter, one line
+ * per measured configuration:
+ *
+ *   <processes> <size class> <aggregators> <buffer size> <bytes/s>
+ *
+ * Only lines matching the number of processes of the file are used, the
+ * others are kept when the profile is written back.
+ */
+
+char *mca_common_ompio_aggregator_profile = NULL;
+
+static const char *tuner_fs_names[] = {"none", "ufs", "pvfs2", "lustre", "plfs", "ime", "gpfs"};
+
+/* weight of a new measurement in the running average */
+#define TUNER_WEIGHT 0.5
+
+#define TUNER_BW(_t,_s,_a,_b) \
+    (_t)->t_bw[((_s) * (_t)->t_num_steps + (_a)) * OMPIO_TUNER_NUM_BUFS + (_b)]
+
+static int tuner_num_aggrs (mca_common_ompio_tuner_t *tuner, int step)
+{
+    return (1 << step) < tuner->t_max_aggrs ? (1 << step) : tuner->t_max_aggrs;
+}
+
+static int tuner_bytes_per_agg (mca_common_ompio_tuner_t *tuner, int buf)
+{
+    long bytes = tuner->t_bytes_per_agg;
+
+    if (buf < OMPIO_TUNER_NUM_BUFS / 2) {
+        bytes >>= (OMPIO_TUNER_NUM_BUFS / 2 - buf);
+    }
+    else {
+        bytes <<= (buf - OMPIO_TUNER_NUM_BUFS / 2);
+    }
+
+    return bytes > INT_MAX ? INT_MAX : (int) bytes;
+}
+
+static int tuner_size_class (long bytes)
+{
+    int size_class = 0;
+
+    bytes >>= 20;
+    while (bytes > 0 && size_class < OMPIO_TUNER_NUM_SIZES - 1) {
+        bytes >>= 1;
+        size_class++;
+    }
+
+    return size_class;
+}
+
+static char *tuner_profile_name (ompio_file_t *fh)
+{
+    char *name = NULL;
+    int fstype = (int) fh->f_fstype;
+
+    if (NULL == mca_common_ompio_aggregator_profile || '\0' == mca_common_ompio_aggregator_profile[0]) {
+        return NULL;
+    }
+    if (fstype < 0 || fstype >= (int) (sizeof (tuner_fs_names) / sizeof (tuner_fs_names[0]))) {
+        fstype = 0;
+    }
+    if (0 > opal_asprintf (&name, "%s/ompio_profile_%s", mca_common_ompio_aggregator_profile,
+                           tuner_fs_names[fstype])) {
+        return NULL;
+    }
+
+    return name;
+}
+
+static void tuner_load_profile (ompio_file_t *fh, mca_common_ompio_tuner_t *tuner)
+{
+    char *name = tuner_profile_name (fh);
+    char line[256];
+    FILE *fp;
+
+    if (NULL == name) {
+        return;
+    }
+    fp = fopen (name, "r");
+    free (name);
+    if (NULL == fp) {
+        return;
+    }
+
+    while (NULL != fgets (line, sizeof (line), fp)) {
+        int nprocs, size_class, num_aggrs, bytes_per_agg, step, buf;
+        double bw;
+
+        if ('#' == line[0] ||
+            5 != sscanf (line, "%d %d %d %d %lf", &nprocs, &size_class, &num_aggrs, &bytes_per_agg, &bw) ||
+            nprocs != fh->f_size || size_class < 0 || size_class >= OMPIO_TUNER_NUM_SIZES || bw <= 0.0) {
+            continue;
+        }
+        /* entries recorded with a different cap or buffer size do not map */
+        for (step = 0 ; step < tuner->t_num_steps ; ++step) {
+            if (tuner_num_aggrs (tuner, step) == num_aggrs) {
+                break;
+            }
+        }
+        for (buf = 0 ; buf < OMPIO_TUNER_NUM_BUFS ; ++buf) {
+            if (tuner_bytes_per_agg (tuner, buf) == bytes_per_agg) {
+                break;
+            }
+        }
+        if (step < tuner->t_num_steps && buf < OMPIO_TUNER_NUM_BUFS) {
+            TUNER_BW(tuner, size_class, step, buf) = bw;
+        }
+    }
+
+    fclose (fp);
+}
+
+static void tuner_save_profile (ompio_file_t *fh, mca_common_ompio_tuner_t *tuner)
+{
+    char *name = tuner_profile_name (fh), *tmp_name = NULL;
+    char line[256];
+    FILE *in, *out;
+
+    if (NULL == name) {
+        return;
+    }
+    if (0 > opal_asprintf (&tmp_name, "%s.%d", name, (int) getpid ())) {
+        free (name);
+        return;
+    }
+
+    out = fopen (tmp_name, "w");
+    if (NULL == out) {
+        opal_output (1, "ompio: could not write the aggregator profile %s\n", tmp_name);
+        goto exit;
+    }
+
+    fprintf (out, "# ompio aggregator profile: processes size_class aggregators buffer_size bytes/s\n");
+
+    /* keep the measurements of other process counts */
+    in = fopen (name, "r");
+    if (NULL != in) {
+        while (NULL != fgets (line, sizeof (line), in)) {
+            int nprocs;
+
+            if ('#' != line[0] && 1 == sscanf (line, "%d", &nprocs) && nprocs != fh->f_size) {
+                fputs (line, out);
+            }
+        }
+        fclose (in);
+    }
+
+    for (int s = 0 ; s < OMPIO_TUNER_NUM_SIZES ; ++s) {
+        for (int a = 0 ; a < tuner->t_num_steps ; ++a) {
+            for (int b = 0 ; b < OMPIO_TUNER_NUM_BUFS ; ++b) {
+                if (TUNER_BW(tuner, s, a, b) > 0.0) {
+                    fprintf (out, "%d %d %d %d %g\n", fh->f_size, s, tuner_num_aggrs (tuner, a),
+                             tuner_bytes_per_agg (tuner, b), TUNER_BW(tuner, s, a, b));
+                }
+            }
+        }
+    }
+
+    if (0 != fclose (out) || 0 != rename (tmp_name, name)) {
+        opal_output (1, "ompio: could not write the aggregator profile %s\n", name);
+        unlink (tmp_name);
+    }
+
+exit:
+    free (tmp_name);
+    free (name);
+}
+
+int mca_common_ompio_tuner_init (ompio_file_t *fh)
+{
+    mca_common_ompio_tuner_t *tuner;
+    char value[MPI_MAX_INFO_VAL];
+    int flag, ret, max_aggrs;
+
+    fh->f_aggr_tuner = NULL;
+
+    if (0 == OMPIO_MCA_GET(fh, adaptive_aggregators) || -1 != OMPIO_MCA_GET(fh, num_aggregators)) {
+        return OMPI_SUCCESS;
+    }
+    opal_info_get (fh->f_info, "cb_nodes", MPI_MAX_INFO_VAL, value, &flag);
+    if (flag) {
+        /* the user chose the number of aggregators */
+        return OMPI_SUCCESS;
+    }
+    if (SIMPLE        != OMPIO_MCA_GET(fh, grouping_option) &&
+        NO_REFINEMENT != OMPIO_MCA_GET(fh, grouping_option) &&
+        SIMPLE_PLUS   != OMPIO_MCA_GET(fh, grouping_option)) {
+        /* the other grouping options choose the aggregators themselves, see
+           mca_common_ompio_set_aggregator_props. The measurements would be
+           attributed to a number of aggregators that was never used. */
+        return OMPI_SUCCESS;
+    }
+
+    tuner = (mca_common_ompio_tuner_t *) calloc (1, sizeof (*tuner));
+    if (NULL == tuner) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* same cap as the static selection */
+    max_aggrs = fh->f_size / OMPIO_MCA_GET(fh, max_aggregators_ratio);
+    tuner->t_max_aggrs = max_aggrs < 1 ? 1 : max_aggrs;
+    while ((1 << tuner->t_num_steps) < tuner->t_max_aggrs) {
+        tuner->t_num_steps++;
+    }
+    tuner->t_num_steps++;
+
+    tuner->t_bytes_per_agg = fh->f_bytes_per_agg;
+    opal_info_get (fh->f_info, "cb_buffer_size", MPI_MAX_INFO_VAL, value, &flag);
+    tuner->t_tune_buffer = !flag;
+    tuner->t_num_aggrs = -1;
+
+    tuner->t_bw = (double *) calloc (OMPIO_TUNER_NUM_SIZES * tuner->t_num_steps * OMPIO_TUNER_NUM_BUFS,
+                                     sizeof (double));
+    if (NULL == tuner->t_bw) {
+        free (tuner);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    if (NULL != mca_common_ompio_aggregator_profile && '\0' != mca_common_ompio_aggregator_profile[0]) {
+        if (0 == fh->f_rank) {
+            tuner_load_profile (fh, tuner);
+        }
+        ret = fh->f_comm->c_coll->coll_bcast (tuner->t_bw,
+                                              OMPIO_TUNER_NUM_SIZES * tuner->t_num_steps * OMPIO_TUNER_NUM_BUFS,
+                                              MPI_DOUBLE, 0, fh->f_comm,
+                                              fh->f_comm->c_coll->coll_bcast_module);
+        if (OMPI_SUCCESS != ret) {
+            free (tuner->t_bw);
+            free (tuner);
+            return ret;
+        }
+    }
+
+    fh->f_aggr_tuner = tuner;
+
+    return OMPI_SUCCESS;
+}
+
+void mca_common_ompio_tuner_fini (ompio_file_t *fh)
+{
+    mca_common_ompio_tuner_t *tuner = fh->f_aggr_tuner;
+
+    if (NULL == tuner) {
+        return;
+    }
+
+    if (0 == fh->f_rank) {
+        tuner_save_profile (fh, tuner);
+    }
+
+    free (tuner->t_bw);
+    free (tuner);
+    fh->f_aggr_tuner = NULL;
+}
+
+/* best measured configuration of a size class, false if there is none */
+static bool tuner_best (mca_common_ompio_tuner_t *tuner, int size_class, int *step, int *buf)
+{
+    double best = 0.0;
+
+    for (int a = 0 ; a < tuner->t_num_steps ; ++a) {
+        for (int b = 0 ; b < OMPIO_TUNER_NUM_BUFS ; ++b) {
+            if (TUNER_BW(tuner, size_class, a, b) > best) {
+                best = TUNER_BW(tuner, size_class, a, b);
+                *step = a;
+                *buf = b;
+            }
+        }
+    }
+
+    return best > 0.0;
+}
+
+static void tuner_choose (ompio_file_t *fh, mca_common_ompio_tuner_t *tuner, int size_class)
+{
+    const int dstep[4] = {1, -1, 0, 0}, dbuf[4] = {0, 0, 1, -1};
+    int step = 0, buf = OMPIO_TUNER_NUM_BUFS / 2;
+
+    if (!tuner_best (tuner, size_class, &step, &buf)) {
+        bool found = false;
+
+        /* start from the closest class with measurements, or from the
+         * number of aggregators of the static selection */
+        for (int d = 1 ; d < OMPIO_TUNER_NUM_SIZES && !found ; ++d) {
+            found = (size_class - d >= 0 && tuner_best (tuner, size_class - d, &step, &buf)) ||
+                (size_class + d < OMPIO_TUNER_NUM_SIZES && tuner_best (tuner, size_class + d, &step, &buf));
+        }
+        if (!found) {
+            while (step + 1 < tuner->t_num_steps && (2 << step) <= fh->f_init_num_aggrs) {
+                step++;
+            }
+        }
+    }
+    else {
+        /* explore the untested neighbours of the best configuration */
+        for (int i = 0 ; i < 4 ; ++i) {
+            int a = step + dstep[i], b = buf + dbuf[i];
+
+            if (a < 0 || a >= tuner->t_num_steps || b < 0 || b >= OMPIO_TUNER_NUM_BUFS ||
+                (0 != dbuf[i] && !tuner->t_tune_buffer)) {
+                continue;
+            }
+            if (0.0 == TUNER_BW(tuner, size_class, a, b)) {
+                step = a;
+                buf = b;
+                break;
+            }
+        }
+    }
+
+    tuner->t_size_class = size_class;
+    tuner->t_step = step;
+    tuner->t_buf = buf;
+}
+
+int mca_common_ompio_tuner_begin (ompio_file_t *fh, size_t bytes)
+{
+    mca_common_ompio_tuner_t *tuner = fh->f_aggr_tuner;
+    int ret;
+
+    if (NULL == tuner) {
+        return OMPI_SUCCESS;
+    }
+
+    tuner->t_bytes = (long) bytes;
+    ret = fh->f_comm->c_coll->coll_allreduce (MPI_IN_PLACE, &tuner->t_bytes, 1, MPI_LONG, MPI_SUM,
+                                              fh->f_comm, fh->f_comm->c_coll->coll_allreduce_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    tuner_choose (fh, tuner, tuner_size_class (tuner->t_bytes));
+
+    tuner->t_num_aggrs = tuner_num_aggrs (tuner, tuner->t_step);
+    if (tuner->t_tune_buffer) {
+        fh->f_bytes_per_agg = tuner_bytes_per_agg (tuner, tuner->t_buf);
+    }
+    tuner->t_start = MPI_Wtime ();
+
+    return OMPI_SUCCESS;
+}
+
+int mca_common_ompio_tuner_end (ompio_file_t *fh, int status)
+{
+    mca_common_ompio_tuner_t *tuner = fh->f_aggr_tuner;
+    double result[2];
+    int ret;
+
+    if (NULL == tuner || -1 == tuner->t_num_aggrs) {
+        return OMPI_SUCCESS;
+    }
+
+    result[0] = MPI_Wtime () - tuner->t_start;
+    result[1] = OMPI_SUCCESS == status ? 0.0 : 1.0;
+
+    fh->f_bytes_per_agg = tuner->t_bytes_per_agg;
+    tuner->t_num_aggrs = -1;
+
+    ret = fh->f_comm->c_coll->coll_allreduce (MPI_IN_PLACE, result, 2, MPI_DOUBLE, MPI_MAX,
+                                              fh->f_comm, fh->f_comm->c_coll->coll_allreduce_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    if (0.0 == result[1] && result[0] > 0.0 && tuner->t_bytes > 0) {
+        double bw = (double) tuner->t_bytes / result[0];
+        double *entry = &TUNER_BW(tuner, tuner->t_size_class, tuner->t_step, tuner->t_buf);
+
+        *entry = 0.0 == *entry ? bw : (1.0 - TUNER_WEIGHT) * *entry + TUNER_WEIGHT * bw;
+    }
+
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,93 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COMMON_OMPIO_TUNER_H
+#define MCA_COMMON_OMPIO_TUNER_H
+
+#include "ompi_config.h"
+#include "common_ompio.h"
+
+BEGIN_C_DECLS
+
+/* classes of the total data volume of a collective operation: below
+ * 1 MiB, then one class per power of two */
+#define OMPIO_TUNER_NUM_SIZES  16
+/* cycle buffer sizes tried: 1/4, 1/2, 1, 2 and 4 times bytes_per_agg */
+#define OMPIO_TUNER_NUM_BUFS    5
+
+/**
+ * Adaptive selection of the number of aggregators and the cycle buffer
+ * size of the collective operations of a file.
+ *
+ * The throughput achieved by every blocking collective read and write
+ * is recorded for the configuration used, separately for each class of
+ * data volume. The next operation of the same class uses the best
+ * configuration measured so far, or first tries an untested neighbour of
+ * it: twice or half the number of aggregators, twice or half the buffer
+ * size. All decisions are based on values reduced over the communicator
+ * of the file and are therefore identical on all processes.
+ */
+struct mca_common_ompio_tuner_t {
+    int     t_num_steps;      /* aggregator counts 1, 2, 4, ..., t_max_aggrs */
+    int     t_max_aggrs;
+    int     t_bytes_per_agg;  /* buffer size the candidates are derived from */
+    bool    t_tune_buffer;    /* false if the buffer size was set by an info key */
+    double *t_bw;             /* [size][step][buf] bytes/s, 0.0 if not measured */
+    /* configuration of the ongoing collective operation */
+    int     t_size_class;
+    int     t_step;
+    int     t_buf;
+    int     t_num_aggrs;      /* -1 outside of a tuned operation */
+    long    t_bytes;
+    double  t_start;
+};
+typedef struct mca_common_ompio_tuner_t mca_common_ompio_tuner_t;
+
+/* directory of the per file system profiles, set by the io/ompio component */
+OMPI_DECLSPEC extern char *mca_common_ompio_aggregator_profile;
+
+/**
+ * Set up the tuner of a file if the adaptive_aggregators mca parameter
+ * is set and neither the num_aggregators parameter nor the cb_nodes info
+ * key fix the number of aggregators. Loads the profile of the file
+ * system if a profile directory is given. Collective.
+ */
+OMPI_DECLSPEC int mca_common_ompio_tuner_init (ompio_file_t *fh);
+
+/**
+ * Store the measurements in the profile of the file system and release
+ * the tuner. Only the first process writes the profile.
+ */
+OMPI_DECLSPEC void mca_common_ompio_tuner_fini (ompio_file_t *fh);
+
+/**
+ * Choose the configuration of a collective operation accessing bytes
+ * bytes on this process and set fh->f_bytes_per_agg accordingly.
+ * Collective, to be followed by mca_common_ompio_tuner_end.
+ */
+OMPI_DECLSPEC int mca_common_ompio_tuner_begin (ompio_file_t *fh, size_t bytes);
+
+/**
+ * Record the throughput of the operation started by tuner_begin unless
+ * it failed on any process, and restore the buffer size. Collective.
+ */
+OMPI_DECLSPEC int mca_common_ompio_tuner_end (ompio_file_t *fh, int status);
+
+/**
+ * Number of aggregators chosen for the ongoing collective operation, -1
+ * if the static selection applies.
+ */
+static inline int mca_common_ompio_tuner_num_aggrs (ompio_file_t *fh)
+{
+    return NULL == fh->f_aggr_tuner ? -1 : fh->f_aggr_tuner->t_num_aggrs;
+}
+
+END_C_DECLS
+
+#endif /* MCA_COMMON_OMPIO_TUNER_H */
@@ -0,0 +1,289 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ompi/request/request.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "opal/util/output.h"
+
+#include "common_ompio.h"
+#include "common_ompio_request.h"
+#include "common_ompio_wbuf.h"
+
+/*
+ * Write-behind for independent write operations.
+ *
+ * Small writes are copied into the current window and reported as
+ * written. A window is written out as one operation when it is full,
+ * when a write does not touch the buffered extent, or whenever the file
+ * data has to be consistent: before reads, collective and non-blocking
+ * writes, MPI_File_sync, set_view, set_size, get_size, changes of the
+ * atomicity mode and close. Windows that are pushed out by new data are
+ * written with fbtl_ipwritev if available, while the rest of the data of
+ * the same call is copied into the other buffer. At most one such write
+ * is in flight, and the call that started it completes it before it
+ * returns, so that a failed write is reported by that call. These
+ * writes belong to the file and are not pending requests of the
+ * application.
+ */
+
+static void wbuf_record_error (mca_common_ompio_wbuf_t *wbuf, int ret)
+{
+    if (OMPI_SUCCESS == wbuf->w_error) {
+        wbuf->w_error = ret;
+    }
+}
+
+static void wbuf_wait (mca_common_ompio_wbuf_t *wbuf, int index)
+{
+    int ret;
+
+    if (NULL == wbuf->w_req[index]) {
+        return;
+    }
+
+    ret = ompi_request_wait (&wbuf->w_req[index], MPI_STATUS_IGNORE);
+    if (OMPI_SUCCESS != ret) {
+        /* failed requests are not released by wait */
+        wbuf_record_error (wbuf, ret);
+        ompi_request_free (&wbuf->w_req[index]);
+    }
+    wbuf->w_req[index] = NULL;
+}
+
+/* write the extent of the current buffer and switch to the other one */
+static void wbuf_write_current (ompio_file_t *fh, mca_common_ompio_wbuf_t *wbuf,
+                                bool async)
+{
+    mca_common_ompio_io_array_t entry, *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    int current = wbuf->w_current;
+    ssize_t ret;
+
+    if (wbuf->w_start == wbuf->w_end) {
+        return;
+    }
+
+    /* the other buffer is the next one to be filled, its write has to be
+     * complete before this one is started */
+    wbuf_wait (wbuf, 1 - current);
+
+    entry.memory_address = wbuf->w_buf[current] + (wbuf->w_start - wbuf->w_base);
+    entry.offset = (IOVBASE_TYPE *)(intptr_t) wbuf->w_start;
+    entry.length = (size_t) (wbuf->w_end - wbuf->w_start);
+
+    fh->f_io_array = &entry;
+    fh->f_num_of_io_entries = 1;
+
+    if (async && NULL != fh->f_fbtl->fbtl_ipwritev) {
+        mca_ompio_request_t *req;
+
+        mca_common_ompio_request_alloc_internal (&req, MCA_OMPIO_REQUEST_WRITE);
+        ret = fh->f_fbtl->fbtl_ipwritev (fh, (ompi_request_t *) req);
+        if (OMPI_SUCCESS == ret && NULL != req->req_progress_fn) {
+            mca_common_ompio_register_progress ();
+            wbuf->w_req[current] = &req->req_ompi;
+        }
+        else {
+            /* could not be started, fall back to a blocking write */
+            ompi_request_complete (&req->req_ompi, false);
+            ompi_request_free ((ompi_request_t **) &req);
+            async = false;
+        }
+    }
+    else {
+        async = false;
+    }
+
+    if (!async) {
+        ret = fh->f_fbtl->fbtl_pwritev (fh);
+        if (0 > ret) {
+            wbuf_record_error (wbuf, (int) ret);
+        }
+    }
+
+    fh->f_io_array = io_array;
+    fh->f_num_of_io_entries = num_of_io_entries;
+
+    wbuf->w_start = wbuf->w_end = 0;
+    wbuf->w_current = 1 - current;
+}
+
+static void wbuf_add (ompio_file_t *fh, mca_common_ompio_wbuf_t *wbuf,
+                      OMPI_MPI_OFFSET_TYPE offset, const char *src, size_t len)
+{
+    OMPI_MPI_OFFSET_TYPE size = (OMPI_MPI_OFFSET_TYPE) wbuf->w_size;
+
+    while (len > 0) {
+        OMPI_MPI_OFFSET_TYPE end;
+        size_t n;
+
+        if (wbuf->w_start != wbuf->w_end &&
+            (offset < wbuf->w_base || offset >= wbuf->w_base + size ||
+             offset > wbuf->w_end ||
+             offset + (OMPI_MPI_OFFSET_TYPE) OMPIO_MIN(len, (size_t) (wbuf->w_base + size - offset)) < wbuf->w_start)) {
+            /* outside of the window or not contiguous with the extent */
+            wbuf_write_current (fh, wbuf, true);
+        }
+
+        if (wbuf->w_start == wbuf->w_end) {
+            wbuf->w_base  = offset - offset % size;
+            wbuf->w_start = wbuf->w_end = offset;
+        }
+
+        n = OMPIO_MIN(len, (size_t) (wbuf->w_base + size - offset));
+        memcpy (wbuf->w_buf[wbuf->w_current] + (offset - wbuf->w_base), src, n);
+
+        end = offset + (OMPI_MPI_OFFSET_TYPE) n;
+        wbuf->w_start = OMPIO_MIN(wbuf->w_start, offset);
+        wbuf->w_end   = OMPIO_MAX(wbuf->w_end, end);
+
+        if (wbuf->w_start == wbuf->w_base && wbuf->w_end == wbuf->w_base + size) {
+            /* a complete, aligned window */
+            wbuf_write_current (fh, wbuf, true);
+        }
+
+        offset += n;
+        src    += n;
+        len    -= n;
+    }
+}
+
+int mca_common_ompio_wbuf_init (ompio_file_t *fh)
+{
+    mca_common_ompio_wbuf_t *wbuf;
+    char value[MPI_MAX_INFO_VAL];
+    long size;
+    int flag;
+
+    fh->f_write_buf = NULL;
+
+    if (fh->f_amode & MPI_MODE_RDONLY) {
+        return OMPI_SUCCESS;
+    }
+
+    size = OMPIO_MCA_GET(fh, write_behind_size);
+    opal_info_get (fh->f_info, "ompio_write_behind_size", MPI_MAX_INFO_VAL, value, &flag);
+    if ( flag ) {
+        /* Info object trumps mca parameter value */
+        size = strtol (value, NULL, 10);
+        OMPIO_MCA_PRINT_INFO(fh, "ompio_write_behind_size", value, "");
+    }
+
+    if (0 >= size) {
+        return OMPI_SUCCESS;
+    }
+
+    wbuf = (mca_common_ompio_wbuf_t *) calloc (1, sizeof (*wbuf));
+    if (NULL == wbuf) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    wbuf->w_buf[0] = (char *) malloc (2 * (size_t) size);
+    if (NULL == wbuf->w_buf[0]) {
+        free (wbuf);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    wbuf->w_buf[1] = wbuf->w_buf[0] + size;
+    wbuf->w_size   = (size_t) size;
+    wbuf->w_error  = OMPI_SUCCESS;
+
+    fh->f_write_buf = wbuf;
+
+    return OMPI_SUCCESS;
+}
+
+int mca_common_ompio_wbuf_flush (ompio_file_t *fh)
+{
+    mca_common_ompio_wbuf_t *wbuf = fh->f_write_buf;
+    int ret;
+
+    if (NULL == wbuf) {
+        return OMPI_SUCCESS;
+    }
+
+    wbuf_write_current (fh, wbuf, false);
+    wbuf_wait (wbuf, 0);
+    wbuf_wait (wbuf, 1);
+
+    ret = wbuf->w_error;
+    wbuf->w_error = OMPI_SUCCESS;
+
+    return ret;
+}
+
+int mca_common_ompio_wbuf_fini (ompio_file_t *fh)
+{
+    mca_common_ompio_wbuf_t *wbuf = fh->f_write_buf;
+    int ret;
+
+    if (NULL == wbuf) {
+        return OMPI_SUCCESS;
+    }
+
+    ret = mca_common_ompio_wbuf_flush (fh);
+
+    free (wbuf->w_buf[0]);
+    free (wbuf);
+    fh->f_write_buf = NULL;
+
+    return ret;
+}
+
+ssize_t mca_common_ompio_wbuf_pwritev (ompio_file_t *fh)
+{
+    mca_common_ompio_wbuf_t *wbuf = fh->f_write_buf;
+    mca_common_ompio_io_array_t *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    ssize_t total = 0, ret;
+
+    for (int i = 0 ; i < num_of_io_entries ; ++i) {
+        OMPI_MPI_OFFSET_TYPE offset = (OMPI_MPI_OFFSET_TYPE)(intptr_t) io_array[i].offset;
+
+        if (io_array[i].length < wbuf->w_size) {
+            wbuf_add (fh, wbuf, offset, (const char *) io_array[i].memory_address,
+                      io_array[i].length);
+            total += io_array[i].length;
+            continue;
+        }
+
+        /* large entries are written directly, after everything that has
+         * been buffered before them */
+        ret = mca_common_ompio_wbuf_flush (fh);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+
+        fh->f_io_array = io_array + i;
+        fh->f_num_of_io_entries = 1;
+        ret = fh->f_fbtl->fbtl_pwritev (fh);
+        fh->f_io_array = io_array;
+        fh->f_num_of_io_entries = num_of_io_entries;
+
+        if (0 > ret) {
+            return ret;
+        }
+        total += ret;
+    }
+
+    /* complete the windows written by this call */
+    wbuf_wait (wbuf, 0);
+    wbuf_wait (wbuf, 1);
+    if (OMPI_SUCCESS != wbuf->w_error) {
+        ret = wbuf->w_error;
+        wbuf->w_error = OMPI_SUCCESS;
+        return ret;
+    }
+
+    return total;
+}
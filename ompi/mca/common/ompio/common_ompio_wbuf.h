@@ -0,0 +1,71 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COMMON_OMPIO_WBUF_H
+#define MCA_COMMON_OMPIO_WBUF_H
+
+#include "ompi_config.h"
+#include "common_ompio.h"
+#include "common_ompio_request.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Per-file write-behind buffer used by the independent write operations.
+ *
+ * Dirty data is collected in a window of w_size bytes aligned to w_size
+ * in the file. The window holds one contiguous extent [w_start, w_end):
+ * writes overlapping or adjacent to it are merged, anything else pushes
+ * the window out. Two buffers are used alternately so that one can be
+ * written asynchronously while the next one is being filled by the same
+ * call.
+ */
+struct mca_common_ompio_wbuf_t {
+    size_t                w_size;
+    char                 *w_buf[2];
+    ompi_request_t       *w_req[2];
+    int                   w_current;
+    OMPI_MPI_OFFSET_TYPE  w_base;   /* file offset of the current window */
+    OMPI_MPI_OFFSET_TYPE  w_start;  /* buffered extent, empty if w_start == w_end */
+    OMPI_MPI_OFFSET_TYPE  w_end;
+    int                   w_error;  /* first error of a write, reported by the calling operation */
+};
+typedef struct mca_common_ompio_wbuf_t mca_common_ompio_wbuf_t;
+
+/**
+ * Set up the write-behind buffer of a file if it has been requested
+ * through the write_behind_size mca parameter or the
+ * ompio_write_behind_size info key. Leaves fh->f_write_buf NULL otherwise.
+ */
+OMPI_DECLSPEC int mca_common_ompio_wbuf_init (ompio_file_t *fh);
+OMPI_DECLSPEC int mca_common_ompio_wbuf_fini (ompio_file_t *fh);
+
+/**
+ * Write all buffered data and wait for every outstanding write-behind.
+ * Returns the error of these writes.
+ */
+OMPI_DECLSPEC int mca_common_ompio_wbuf_flush (ompio_file_t *fh);
+
+/**
+ * Same interface as fbtl_pwritev: buffer the small entries of
+ * fh->f_io_array, write large ones directly. The windows pushed out by
+ * this call are complete when it returns. Returns the number of bytes
+ * accepted or the error of a write started by this call.
+ */
+OMPI_DECLSPEC ssize_t mca_common_ompio_wbuf_pwritev (ompio_file_t *fh);
+
+static inline bool mca_common_ompio_wbuf_in_use (ompio_file_t *fh)
+{
+    /* in atomic mode every write has to be visible immediately */
+    return NULL != fh->f_write_buf && !fh->f_atomicity;
+}
+
+END_C_DECLS
+
+#endif /* MCA_COMMON_OMPIO_WBUF_H */
@@ -135,6 +135,9 @@ typedef bool (*mca_fbtl_base_module_progress_fn_t)
 
 typedef void (*mca_fbtl_base_module_request_free_fn_t)
     ( struct mca_ompio_request_t *request);
+
+typedef int (*mca_fbtl_base_module_sync_fn_t)
+    (struct ompio_file_t *file);
 /*
  * ***********************************************************************
  * ***************************  module structure *************************
@@ -156,6 +159,11 @@ struct mca_fbtl_base_module_1_0_0_t {
     mca_fbtl_base_module_ipwritev_fn_t      fbtl_ipwritev;
     mca_fbtl_base_module_progress_fn_t      fbtl_progress;
     mca_fbtl_base_module_request_free_fn_t  fbtl_request_free;
+
+    /* Optional: write back data held by the module and revalidate what
+       it caches about the file, e.g. its size. Called by MPI_File_sync
+       and after the size of the file was changed. */
+    mca_fbtl_base_module_sync_fn_t          fbtl_sync;
 };
 typedef struct mca_fbtl_base_module_1_0_0_t mca_fbtl_base_module_1_0_0_t;
 typedef mca_fbtl_base_module_1_0_0_t mca_fbtl_base_module_t;
@@ -0,0 +1,213 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ompi/group/group.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/fbtl/base/base.h"
+#include "ompi/mca/fbtl/mmap/fbtl_mmap.h"
+#include "opal/util/output.h"
+#include "opal/util/sys_limits.h"
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+static mca_fbtl_base_module_1_0_0_t mmap_module =  {
+    mca_fbtl_mmap_module_init,     /* initalise after being selected */
+    mca_fbtl_mmap_module_finalize, /* close a module on a communicator */
+    mca_fbtl_mmap_preadv,          /* blocking read */
+    NULL,                          /* non-blocking read */
+    mca_fbtl_mmap_pwritev,         /* blocking write */
+    NULL,                          /* non-blocking write */
+    NULL,                          /* module specific progress */
+    NULL,                          /* free module specific data items on the request */
+    mca_fbtl_mmap_sync             /* sync */
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+int mca_fbtl_mmap_component_init_query(bool enable_progress_threads,
+                                       bool enable_mpi_threads) {
+    /* Nothing to do */
+
+   return OMPI_SUCCESS;
+}
+
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_mmap_component_file_query (ompio_file_t *fh, int *priority) {
+    int enabled = mca_fbtl_mmap_enable;
+    bool value;
+    int flag;
+
+    opal_info_get_bool (fh->f_info, "ompio_mmap", &value, &flag);
+    if ( flag ) {
+        /* Info object trumps mca parameter value */
+        enabled = value;
+        OMPIO_MCA_PRINT_INFO(fh, "ompio_mmap", value ? "true" : "false", "");
+    }
+    if ( 0 >= enabled ) {
+        return NULL;
+    }
+
+    /* The mappings of the processes are only coherent if they share the
+       page cache of the file */
+    if ( UFS != fh->f_fstype || ompi_group_have_remote_peers (fh->f_comm->c_local_group) ) {
+        opal_output_verbose (10, ompi_fbtl_base_framework.framework_output,
+                             "fbtl:mmap: %s is not a node-local file, not using a mapping",
+                             fh->f_filename);
+        return NULL;
+    }
+
+    *priority = mca_fbtl_mmap_priority;
+    return &mmap_module;
+}
+
+int mca_fbtl_mmap_component_file_unquery (ompio_file_t *file) {
+   /* This function might be needed for some purposes later. for now it
+    * does not have anything to do since there are no steps which need
+    * to be undone if this module is not selected */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_fbtl_mmap_module_init (ompio_file_t *file) {
+    mca_fbtl_mmap_file_t *m;
+
+    /* the file is not open yet, it is mapped on the first access */
+    m = (mca_fbtl_mmap_file_t *) calloc (1, sizeof (mca_fbtl_mmap_file_t));
+    if ( NULL == m ) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    file->f_fbtl_data = m;
+
+    return OMPI_SUCCESS;
+}
+
+int mca_fbtl_mmap_module_finalize (ompio_file_t *file) {
+    mca_fbtl_mmap_file_t *m = (mca_fbtl_mmap_file_t *) file->f_fbtl_data;
+
+    if ( NULL != m ) {
+        if ( NULL != m->m_base ) {
+            munmap (m->m_base, m->m_map_size);
+        }
+        free (m);
+        file->f_fbtl_data = NULL;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+/* make the mapping cover the file up to its current size. The mapping
+ * is grown to at least twice its length, so that a file which is
+ * extended piece by piece is only remapped a logarithmic number of
+ * times. Only the part below the end of the file is ever accessed. */
+static int mmap_remap (ompio_file_t *fh, mca_fbtl_mmap_file_t *m)
+{
+    size_t map_size, page = (size_t) opal_getpagesize ();
+    struct stat st;
+    void *base;
+
+    if ( 0 == m->m_prot ) {
+        m->m_prot = PROT_READ;
+        if ( !(fh->f_amode & MPI_MODE_RDONLY) ) {
+            m->m_prot |= PROT_WRITE;
+        }
+#ifdef O_DIRECT
+        if ( fh->f_flags & OMPIO_DIRECT_IO ) {
+            /* a mapping goes through the page cache anyway, and the
+               writes extending the file are not aligned */
+            fcntl (fh->fd, F_SETFL, fcntl (fh->fd, F_GETFL) & ~O_DIRECT);
+            fh->f_flags &= ~OMPIO_DIRECT_IO;
+        }
+#endif
+    }
+
+    if ( 0 != fstat (fh->fd, &st) ) {
+        opal_output(1, "mca_fbtl_mmap: error in fstat:%s", strerror(errno));
+        return OMPI_ERROR;
+    }
+    if ( (size_t) st.st_size <= m->m_map_size ) {
+        /* grown within the mapping, or shrunk */
+        m->m_size = (size_t) st.st_size;
+        return OMPI_SUCCESS;
+    }
+
+    if ( NULL != m->m_base ) {
+        munmap (m->m_base, m->m_map_size);
+        m->m_base = NULL;
+        m->m_size = m->m_map_size = 0;
+    }
+
+    map_size = OMPIO_MAX((size_t) st.st_size, 2 * m->m_map_size);
+    map_size = (map_size + page - 1) & ~(page - 1);
+    base = mmap (NULL, map_size, m->m_prot, MAP_SHARED, fh->fd, 0);
+    if ( MAP_FAILED == base && map_size > (size_t) st.st_size ) {
+        /* not enough address space for the reserve */
+        map_size = (size_t) st.st_size;
+        base = mmap (NULL, map_size, m->m_prot, MAP_SHARED, fh->fd, 0);
+    }
+    if ( MAP_FAILED == base ) {
+        opal_output_verbose (10, ompi_fbtl_base_framework.framework_output,
+                             "fbtl:mmap: cannot map %s: %s, using pread/pwrite",
+                             fh->f_filename, strerror(errno));
+        m->m_failed = true;
+        return OMPI_SUCCESS;
+    }
+    m->m_base = (char *) base;
+    m->m_size = (size_t) st.st_size;
+    m->m_map_size = map_size;
+
+    return OMPI_SUCCESS;
+}
+
+ssize_t mca_fbtl_mmap_map (ompio_file_t *fh, off_t offset, size_t len)
+{
+    mca_fbtl_mmap_file_t *m = (mca_fbtl_mmap_file_t *) fh->f_fbtl_data;
+
+    if ( !m->m_failed && (size_t) offset + len > m->m_size ) {
+        if ( OMPI_SUCCESS != mmap_remap (fh, m) ) {
+            return -1;
+        }
+    }
+    if ( m->m_failed || (size_t) offset >= m->m_size ) {
+        return 0;
+    }
+    return (ssize_t) OMPIO_MIN(len, m->m_size - (size_t) offset);
+}
+
+int mca_fbtl_mmap_sync (ompio_file_t *fh)
+{
+    mca_fbtl_mmap_file_t *m = (mca_fbtl_mmap_file_t *) fh->f_fbtl_data;
+
+    if ( NULL != m->m_base && (m->m_prot & PROT_WRITE) &&
+         0 != msync (m->m_base, m->m_size, MS_SYNC) ) {
+        opal_output(1, "mca_fbtl_mmap_sync: error in msync:%s", strerror(errno));
+        return OMPI_ERROR;
+    }
+
+    /* the file might have been resized */
+    if ( !m->m_failed && 0 <= fh->fd ) {
+        return mmap_remap (fh, m);
+    }
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,77 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_FBTL_MMAP_H
+#define MCA_FBTL_MMAP_H
+
+#include "ompi_config.h"
+#include "ompi/mca/mca.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/common/ompio/common_ompio.h"
+
+extern int mca_fbtl_mmap_priority;
+extern int mca_fbtl_mmap_enable;
+
+BEGIN_C_DECLS
+
+int mca_fbtl_mmap_component_init_query(bool enable_progress_threads,
+                                       bool enable_mpi_threads);
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_mmap_component_file_query (ompio_file_t *file, int *priority);
+int mca_fbtl_mmap_component_file_unquery (ompio_file_t *file);
+
+int mca_fbtl_mmap_module_init (ompio_file_t *file);
+int mca_fbtl_mmap_module_finalize (ompio_file_t *file);
+
+OMPI_MODULE_DECLSPEC extern mca_fbtl_base_component_2_0_0_t mca_fbtl_mmap_component;
+
+/*
+ * Per-file state, hung off fh->f_fbtl_data.
+ *
+ * The file is mapped from offset 0 on the first access after it was
+ * opened. Accesses behind the known size of the file check the size
+ * again, e.g. after writes of other processes, and the mapping is
+ * replaced by one of at least twice the length only if the file has
+ * outgrown it. Writes behind the end of the file extend it through
+ * pwrite, reads there are short. Files that cannot be mapped are
+ * accessed with pread/pwrite.
+ */
+struct mca_fbtl_mmap_file_t {
+    char   *m_base;     /* NULL if nothing is mapped */
+    size_t  m_size;     /* size of the file as last seen, the accessible part of the mapping */
+    size_t  m_map_size; /* length of the mapping */
+    int     m_prot;
+    bool    m_failed;   /* mmap not possible for this file */
+};
+typedef struct mca_fbtl_mmap_file_t mca_fbtl_mmap_file_t;
+
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */
+
+ssize_t mca_fbtl_mmap_preadv (ompio_file_t *file );
+ssize_t mca_fbtl_mmap_pwritev (ompio_file_t *file );
+int mca_fbtl_mmap_sync (ompio_file_t *file );
+
+/* Make sure the mapping covers [offset, offset+len) if the file is
+   large enough. Returns the number of bytes of the range that are
+   mapped, or -1 if the file has to be accessed with pread/pwrite. */
+ssize_t mca_fbtl_mmap_map (ompio_file_t *file, off_t offset, size_t len);
+
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */
+
+END_C_DECLS
+
+#endif /* MCA_FBTL_MMAP_H */
@@ -0,0 +1,77 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_mmap.h"
+
+#include "mpi.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+/*
+ * The entries of the io array point into the user buffer, or into the
+ * packed buffer if the data has to be converted, so the data is copied
+ * from the mapping straight to its destination.
+ */
+ssize_t mca_fbtl_mmap_preadv (ompio_file_t *fh )
+{
+    mca_fbtl_mmap_file_t *m = (mca_fbtl_mmap_file_t *) fh->f_fbtl_data;
+    ssize_t bytes_read = 0, mapped, ret_code;
+    int i;
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+
+    for (i=0 ; i<fh->f_num_of_io_entries ; i++) {
+        off_t offset = (off_t)(intptr_t) fh->f_io_array[i].offset;
+        char *mem = (char *) fh->f_io_array[i].memory_address;
+        size_t len = fh->f_io_array[i].length;
+
+        mapped = mca_fbtl_mmap_map (fh, offset, len);
+        if ( 0 > mapped ) {
+            return OMPI_ERROR;
+        }
+        if ( 0 < mapped ) {
+            memcpy (mem, m->m_base + offset, mapped);
+        }
+        bytes_read += mapped;
+        if ( (size_t) mapped == len ) {
+            continue;
+        }
+        if ( !m->m_failed ) {
+            /* end of the file */
+            break;
+        }
+
+        /* the file could not be mapped */
+        while ( 0 < len ) {
+            ret_code = pread (fh->fd, mem, len, offset);
+            if ( -1 == ret_code ) {
+                if ( EINTR == errno ) {
+                    continue;
+                }
+                opal_output(1, "mca_fbtl_mmap_preadv: error in pread:%s", strerror(errno));
+                return OMPI_ERROR;
+            }
+            if ( 0 == ret_code ) {
+                return bytes_read;
+            }
+            bytes_read += ret_code;
+            offset += ret_code;
+            mem += ret_code;
+            len -= ret_code;
+        }
+    }
+
+    return bytes_read;
+}
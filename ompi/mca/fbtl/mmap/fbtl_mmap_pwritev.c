@@ -0,0 +1,67 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_mmap.h"
+
+#include "mpi.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+ssize_t mca_fbtl_mmap_pwritev (ompio_file_t *fh )
+{
+    mca_fbtl_mmap_file_t *m = (mca_fbtl_mmap_file_t *) fh->f_fbtl_data;
+    ssize_t bytes_written = 0, mapped, ret_code;
+    int i;
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+
+    for (i=0 ; i<fh->f_num_of_io_entries ; i++) {
+        off_t offset = (off_t)(intptr_t) fh->f_io_array[i].offset;
+        const char *mem = (const char *) fh->f_io_array[i].memory_address;
+        size_t len = fh->f_io_array[i].length;
+
+        mapped = mca_fbtl_mmap_map (fh, offset, len);
+        if ( 0 > mapped ) {
+            return OMPI_ERROR;
+        }
+        if ( 0 < mapped ) {
+            memcpy (m->m_base + offset, mem, mapped);
+        }
+        bytes_written += mapped;
+        offset += mapped;
+        mem += mapped;
+        len -= mapped;
+
+        /* Behind the end of the file. pwrite extends the file without
+           ever shrinking it, which a ftruncate by one process could do
+           to data written by another one. */
+        while ( 0 < len ) {
+            ret_code = pwrite (fh->fd, mem, len, offset);
+            if ( -1 == ret_code ) {
+                if ( EINTR == errno ) {
+                    continue;
+                }
+                opal_output(1, "mca_fbtl_mmap_pwritev: error in pwrite:%s", strerror(errno));
+                return OMPI_ERROR;
+            }
+            bytes_written += ret_code;
+            offset += ret_code;
+            mem += ret_code;
+            len -= ret_code;
+        }
+    }
+
+    return bytes_written;
+}
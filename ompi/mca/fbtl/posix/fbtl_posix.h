@@ -57,6 +57,10 @@ ssize_t mca_fbtl_posix_ipreadv (ompio_file_t *file,
 ssize_t mca_fbtl_posix_ipwritev (ompio_file_t *file,
                                 ompi_request_t *request);
 
+ssize_t mca_fbtl_posix_direct_io (ompio_file_t *file, bool write);
+ssize_t mca_fbtl_posix_direct_start (ompio_file_t *file, ompi_request_t *request,
+                                     bool write);
+
 bool mca_fbtl_posix_progress     ( mca_ompio_request_t *req);
 void mca_fbtl_posix_request_free ( mca_ompio_request_t *req);
 
@@ -0,0 +1,353 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_posix.h"
+
+#include "mpi.h"
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+/*
+ * I/O on files opened with O_DIRECT (OMPIO_DIRECT_IO, set by fs/ufs).
+ *
+ * The file offset, the length and the memory address of every transfer
+ * have to be multiples of fh->f_fs_block_size. Entries of the io array
+ * that are contiguous in the file and in memory are merged. The aligned
+ * middle part of a range is transferred in place if the buffer is
+ * aligned like the file offset, which is the case for the collective
+ * buffers of the aggregators; heads, tails and misaligned buffers go
+ * through an aligned bounce buffer.
+ *
+ * Blocks that a write covers only partially are read, updated and
+ * written back while holding an exclusive lock on them, independent of
+ * the locking mode of the file, since the kernel does not serialize
+ * these updates between processes. A partial block behind the end of
+ * the file is written completely and the file is cut back afterwards.
+ * The lock then reaches to the end of the file, and writes of whole
+ * blocks hold a shared lock on their range, so that no concurrent write
+ * behind the old end of the file can be cut off.
+ */
+
+#define FBTL_POSIX_DIRECT_BOUNCE_SIZE (1024*1024)
+
+static int direct_lock ( ompio_file_t *fh, struct flock *lock, short op,
+                         off_t offset, off_t len )
+{
+    int ret;
+
+    if ( fh->f_flags & OMPIO_LOCK_ENTIRE_FILE ) {
+        op     = F_WRLCK;
+        offset = 0;
+        len    = 0;
+    }
+    lock->l_type   = op;
+    lock->l_whence = SEEK_SET;
+    lock->l_start  = offset;
+    lock->l_len    = len;
+
+    do {
+        ret = fcntl ( fh->fd, F_SETLKW, lock );
+    } while ( -1 == ret && EINTR == errno );
+
+    if ( -1 == ret ) {
+        opal_output(1, "mca_fbtl_posix_direct: error in fcntl():%s", strerror(errno));
+        lock->l_start = -1;
+        lock->l_len   = -1;
+    }
+    return ret;
+}
+
+/* Transfer len bytes, stopping at the end of the file. Returns the number
+   of bytes transferred or -1. */
+static ssize_t direct_pio ( int fd, bool write, char *buf, size_t len, off_t offset )
+{
+    size_t done = 0;
+    ssize_t ret;
+
+    while ( done < len ) {
+        if ( write ) {
+            ret = pwrite ( fd, buf + done, len - done, offset + done );
+        }
+        else {
+            ret = pread ( fd, buf + done, len - done, offset + done );
+        }
+        if ( -1 == ret ) {
+            if ( EINTR == errno ) {
+                continue;
+            }
+            return -1;
+        }
+        if ( !write && (size_t) ret < len - done ) {
+            /* short read at the end of the file, the next transfer would
+               not be aligned */
+            done += ret;
+            break;
+        }
+        done += ret;
+    }
+    return (ssize_t) done;
+}
+
+/* read a block for a read-modify-write, zero filled behind the end of the file */
+static int direct_read_block ( ompio_file_t *fh, char *buf, off_t offset )
+{
+    size_t block = (size_t) fh->f_fs_block_size;
+    ssize_t ret;
+
+    ret = direct_pio ( fh->fd, false, buf, block, offset );
+    if ( -1 == ret ) {
+        return OMPI_ERROR;
+    }
+    memset ( buf + ret, 0, block - ret );
+    return OMPI_SUCCESS;
+}
+
+static ssize_t direct_read_bounce ( ompio_file_t *fh, char *bounce, size_t bounce_size,
+                                    off_t offset, char *mem, size_t len )
+{
+    size_t block = (size_t) fh->f_fs_block_size;
+    ssize_t total = 0, ret;
+
+    while ( len > 0 ) {
+        off_t start = offset - offset % block;
+        size_t skip = (size_t) (offset - start);
+        size_t n = OMPIO_MIN(len, bounce_size - skip);
+        size_t avail;
+
+        ret = direct_pio ( fh->fd, false, bounce, ((skip + n + block - 1) / block) * block,
+                           start );
+        if ( -1 == ret ) {
+            return -1;
+        }
+        avail = ( (size_t) ret > skip ) ? OMPIO_MIN(n, (size_t) ret - skip) : 0;
+        memcpy ( mem, bounce + skip, avail );
+        total += avail;
+        if ( avail < n ) {
+            break;
+        }
+        offset += n;
+        mem    += n;
+        len    -= n;
+    }
+    return total;
+}
+
+static ssize_t direct_write_bounce ( ompio_file_t *fh, char *bounce, size_t bounce_size,
+                                     off_t offset, char *mem, size_t len )
+{
+    size_t block = (size_t) fh->f_fs_block_size;
+    ssize_t total = 0;
+
+    while ( len > 0 ) {
+        off_t start = offset - offset % block;
+        size_t skip = (size_t) (offset - start);
+        size_t n = OMPIO_MIN(len, bounce_size - skip);
+        off_t end = start + (off_t) (((skip + n + block - 1) / block) * block);
+        struct flock lock;
+        struct stat st;
+        int ret = OMPI_SUCCESS;
+
+        if ( -1 == direct_lock ( fh, &lock, F_WRLCK, start, end - start ) ) {
+            return -1;
+        }
+        if ( 0 != fstat ( fh->fd, &st ) ) {
+            goto fail;
+        }
+        if ( end > st.st_size ) {
+            if ( -1 == direct_lock ( fh, &lock, F_WRLCK, start, 0 ) ||
+                 0 != fstat ( fh->fd, &st ) ) {
+                goto fail;
+            }
+        }
+
+        if ( 0 < skip ) {
+            ret = direct_read_block ( fh, bounce, start );
+        }
+        if ( OMPI_SUCCESS == ret && offset + (off_t) n < end &&
+             ( 0 == skip || end - start > (off_t) block ) ) {
+            ret = direct_read_block ( fh, bounce + (end - start) - block, end - block );
+        }
+        if ( OMPI_SUCCESS != ret ) {
+            goto fail;
+        }
+
+        memcpy ( bounce + skip, mem, n );
+        if ( end - start != direct_pio ( fh->fd, true, bounce, end - start, start ) ) {
+            goto fail;
+        }
+        if ( end > st.st_size && offset + (off_t) n < end &&
+             0 != ftruncate ( fh->fd, OMPIO_MAX(st.st_size, offset + (off_t) n) ) ) {
+            goto fail;
+        }
+
+        mca_fbtl_posix_unlock ( &lock, fh );
+        total  += n;
+        offset += n;
+        mem    += n;
+        len    -= n;
+        continue;
+
+    fail:
+        mca_fbtl_posix_unlock ( &lock, fh );
+        return -1;
+    }
+    return total;
+}
+
+static ssize_t direct_inplace ( ompio_file_t *fh, bool write, off_t offset,
+                                char *mem, size_t len )
+{
+    struct flock lock;
+    ssize_t ret;
+
+    if ( !write ) {
+        return direct_pio ( fh->fd, false, mem, len, offset );
+    }
+    if ( -1 == direct_lock ( fh, &lock, F_RDLCK, offset, (off_t) len ) ) {
+        return -1;
+    }
+    ret = direct_pio ( fh->fd, true, mem, len, offset );
+    mca_fbtl_posix_unlock ( &lock, fh );
+    return ret;
+}
+
+ssize_t mca_fbtl_posix_direct_io ( ompio_file_t *fh, bool write )
+{
+    size_t block = (size_t) fh->f_fs_block_size;
+    size_t bounce_size = OMPIO_MAX(FBTL_POSIX_DIRECT_BOUNCE_SIZE, 2 * block);
+    char *bounce = NULL;
+    ssize_t total = 0, ret;
+    struct flock lock;
+    int i = 0;
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+    bounce_size -= bounce_size % block;
+
+    while ( i < fh->f_num_of_io_entries ) {
+        off_t offset = (off_t) (intptr_t) fh->f_io_array[i].offset;
+        char *mem = (char *) fh->f_io_array[i].memory_address;
+        size_t len = fh->f_io_array[i].length;
+        size_t head, middle = 0, tail, done;
+        size_t part[3];
+        int p;
+
+        for ( i++; i < fh->f_num_of_io_entries; i++ ) {
+            if ( (off_t) (intptr_t) fh->f_io_array[i].offset != offset + (off_t) len ||
+                 (char *) fh->f_io_array[i].memory_address != mem + len ) {
+                break;
+            }
+            len += fh->f_io_array[i].length;
+        }
+
+        head = (block - (size_t) (offset % block)) % block;
+        if ( len >= head + block && 0 == ((uintptr_t) (mem + head)) % block ) {
+            middle = ((len - head) / block) * block;
+        }
+        else {
+            head = len;
+        }
+        tail = len - head - middle;
+        part[0] = head;
+        part[1] = middle;
+        part[2] = tail;
+
+        if ( 0 < head + tail && NULL == bounce ) {
+            if ( 0 != posix_memalign ( (void **) &bounce, block, bounce_size ) ) {
+                opal_output(1, "OUT OF MEMORY\n");
+                return OMPI_ERR_OUT_OF_RESOURCE;
+            }
+        }
+
+        if ( !write ) {
+            /* same protection as the buffered path */
+            ret = mca_fbtl_posix_lock ( &lock, fh, F_RDLCK, offset, len, OMPIO_LOCK_SELECTIVE );
+            if ( 0 < ret ) {
+                opal_output(1, "mca_fbtl_posix_direct_io: error in mca_fbtl_posix_lock() error ret=%d %s",
+                            (int) ret, strerror(errno));
+                mca_fbtl_posix_unlock ( &lock, fh );
+                free ( bounce );
+                return OMPI_ERROR;
+            }
+        }
+
+        done = 0;
+        ret  = 0;
+        for ( p = 0 ; p < 3 ; p++ ) {
+            if ( 0 == part[p] ) {
+                continue;
+            }
+            if ( 1 == p ) {
+                ret = direct_inplace ( fh, write, offset + done, mem + done, part[p] );
+            }
+            else if ( write ) {
+                ret = direct_write_bounce ( fh, bounce, bounce_size, offset + done,
+                                            mem + done, part[p] );
+            }
+            else {
+                ret = direct_read_bounce ( fh, bounce, bounce_size, offset + done,
+                                           mem + done, part[p] );
+            }
+            if ( 0 < ret ) {
+                done += ret;
+            }
+            if ( (size_t) ret != part[p] ) {
+                break;
+            }
+        }
+
+        if ( !write ) {
+            mca_fbtl_posix_unlock ( &lock, fh );
+        }
+        if ( -1 == ret ) {
+            opal_output(1, "mca_fbtl_posix_direct_io: error in %s:%s",
+                        write ? "pwrite" : "pread", strerror(errno));
+            free ( bounce );
+            return OMPI_ERROR;
+        }
+        total += done;
+        if ( done < len ) {
+            /* end of the file */
+            break;
+        }
+    }
+
+    free ( bounce );
+    return total;
+}
+
+static bool direct_progress ( mca_ompio_request_t *req )
+{
+    return true;
+}
+
+ssize_t mca_fbtl_posix_direct_start ( ompio_file_t *fh, ompi_request_t *request,
+                                      bool write )
+{
+    mca_ompio_request_t *req = (mca_ompio_request_t *) request;
+    ssize_t ret;
+
+    ret = mca_fbtl_posix_direct_io ( fh, write );
+    if ( 0 > ret ) {
+        return ret;
+    }
+
+    /* completed by the first call to the progress function */
+    req->req_ompi.req_status.MPI_ERROR = OMPI_SUCCESS;
+    req->req_ompi.req_status._ucount = ret;
+    req->req_progress_fn = direct_progress;
+    return OMPI_SUCCESS;
+}
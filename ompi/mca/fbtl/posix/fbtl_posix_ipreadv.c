@@ -36,6 +36,12 @@
 ssize_t mca_fbtl_posix_ipreadv (ompio_file_t *fh,
 			       ompi_request_t *request)
 {
+    if ( fh->f_flags & OMPIO_DIRECT_IO ) {
+        /* aio has the same alignment restrictions as O_DIRECT, the data is
+           transferred right away */
+        return mca_fbtl_posix_direct_start ( fh, request, false );
+    }
+
 #if defined (FBTL_POSIX_HAVE_AIO)
     mca_fbtl_posix_request_data_t *data;
     mca_ompio_request_t *req = (mca_ompio_request_t *) request;
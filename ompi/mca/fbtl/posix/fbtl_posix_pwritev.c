@@ -45,6 +45,10 @@ ssize_t  mca_fbtl_posix_pwritev(ompio_file_t *fh )
         return OMPI_ERROR;
     }
 
+    if ( fh->f_flags & OMPIO_DIRECT_IO ) {
+        return mca_fbtl_posix_direct_io ( fh, true );
+    }
+
     iov = (struct iovec *) malloc
         (OMPIO_IOVEC_INITIAL_SIZE * sizeof (struct iovec));
     if (NULL == iov) {
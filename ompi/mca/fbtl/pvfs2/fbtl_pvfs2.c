@@ -43,7 +43,8 @@ static mca_fbtl_base_module_1_0_0_t pvfs2 =  {
     mca_fbtl_pvfs2_pwritev,         /* blocking write */
     NULL,                           /* non-blocking write */
     NULL,                           /* module specific progress */
-    NULL                            /* free module specific data items on the request */
+    NULL,                           /* free module specific data items on the request */
+    NULL                            /* sync */
 };
 /*
  * *******************************************************************
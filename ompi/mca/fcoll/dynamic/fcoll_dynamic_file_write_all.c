@@ -28,6 +28,7 @@
 #include "ompi/mca/fcoll/fcoll.h"
 #include "ompi/mca/fcoll/base/fcoll_base_coll_array.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
+#include "ompi/mca/common/ompio/common_ompio_buffer.h"
 #include "ompi/mca/io/io.h"
 #include "math.h"
 #include "ompi/mca/pml/pml.h"
@@ -394,7 +395,7 @@ mca_fcoll_dynamic_file_write_all (ompio_file_t *fh,
 	    goto exit;
 	}
 
-	global_buf  = (char *) malloc (bytes_per_cycle);
+	global_buf  = (char *) mca_common_ompio_alloc_aligned_buf (fh, bytes_per_cycle);
 	if (NULL == global_buf){
 	    opal_output(1, "OUT OF MEMORY");
 	    ret = OMPI_ERR_OUT_OF_RESOURCE;
@@ -37,6 +37,8 @@ BEGIN_C_DECLS
 extern int mca_fcoll_dynamic_gen2_priority;
 extern int mca_fcoll_dynamic_gen2_num_groups;
 extern int mca_fcoll_dynamic_gen2_write_chunksize;
+extern int mca_fcoll_dynamic_gen2_async_io;
+extern int mca_fcoll_dynamic_gen2_pipeline_depth;
 
 OMPI_MODULE_DECLSPEC extern mca_fcoll_base_component_2_0_0_t mca_fcoll_dynamic_gen2_component;
 
@@ -28,6 +28,8 @@
 #include "ompi/mca/fcoll/fcoll.h"
 #include "ompi/mca/fcoll/base/fcoll_base_coll_array.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
+#include "ompi/mca/common/ompio/common_ompio_buffer.h"
+#include "ompi/mca/common/ompio/common_ompio_request.h"
 #include "ompi/mca/io/io.h"
 #include "math.h"
 #include "ompi/mca/pml/pml.h"
@@ -43,10 +45,28 @@ typedef struct mca_io_ompio_local_io_array{
 }mca_io_ompio_local_io_array;
 
 
+/* State of one cycle of the read pipeline. The aggregator fills the
+   buffer of a stage while the data of older stages is scattered. */
+typedef struct mca_io_ompio_read_stage {
+    int *disp_index;
+    int **blocklen_per_process;
+    MPI_Aint **displs_per_process;
+    int entries_per_aggregator;
+    mca_io_ompio_local_io_array *file_offsets_for_agg;
+    int *sorted_file_offsets;
+    MPI_Aint *memory_displacements;
+    char *global_buf;
+    ompi_request_t *read_req;
+    int bytes_received;
+} mca_io_ompio_read_stage;
+
+
 static int read_heap_sort (mca_io_ompio_local_io_array *io_array,
                            int num_entries,
                            int *sorted);
 
+static int read_init (ompio_file_t *fh, int read_synchType, ompi_request_t **request);
+
 
 
 int
@@ -66,8 +86,6 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
     int n=0; /* current position in total_bytes_per_process array */
     MPI_Aint bytes_remaining = 0; /* how many bytes have been read from the current
                                      value from total_bytes_per_process */
-    int *sorted_file_offsets=NULL, entries_per_aggregator=0;
-    int bytes_received = 0;
     int blocks = 0;
     /* iovec structure and count of the buffer passed in */
     uint32_t iov_count = 0;
@@ -76,18 +94,16 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
     size_t current_position = 0;
     struct iovec *local_iov_array=NULL, *global_iov_array=NULL;
     char *receive_buf = NULL;
-    MPI_Aint *memory_displacements=NULL;
     /* global iovec at the readers that contain the iovecs created from
        file_set_view */
     uint32_t total_fview_count = 0;
     int local_count = 0;
-    int *fview_count = NULL, *disp_index=NULL, *temp_disp_index=NULL;
+    int *fview_count = NULL, *temp_disp_index=NULL;
     int current_index=0, temp_index=0;
-    int **blocklen_per_process=NULL;
-    MPI_Aint **displs_per_process=NULL;
-    char *global_buf = NULL;
     MPI_Aint global_count = 0;
-    mca_io_ompio_local_io_array *file_offsets_for_agg=NULL;
+    mca_io_ompio_read_stage *stages = NULL, *st = NULL;
+    int num_stages = 1, s;
+    int read_synch_type = 2;
 
     /* array that contains the sorted indices of the global_iov */
     int *sorted = NULL;
@@ -103,12 +119,10 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
     ptrdiff_t ftype_extent, lb;
 
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     double read_time = 0.0, start_read_time = 0.0, end_read_time = 0.0;
     double rcomm_time = 0.0, start_rcomm_time = 0.0, end_rcomm_time = 0.0;
     double read_exch = 0.0, start_rexch = 0.0, end_rexch = 0.0;
     mca_common_ompio_print_entry nentry;
-#endif
 
     /**************************************************************************
      ** 1. In case the data is not contigous in memory, decode it into an iovec
@@ -150,6 +164,13 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
         ret = OMPI_ERROR;
         goto exit;
     }
+
+    if( (1 == mca_fcoll_dynamic_gen2_async_io) && (NULL == fh->f_fbtl->fbtl_ipreadv) ) {
+        opal_output (1, "dynamic_gen2_read_all: fbtl Does NOT support ipreadv() (asynchronous read) \n");
+        ret = MPI_ERR_UNSUPPORTED_OPERATION;
+        goto exit;
+    }
+
     ret = mca_common_ompio_set_aggregator_props ((struct ompio_file_t *) fh,
                                                  dynamic_gen2_num_io_procs,
                                                  max_data);
@@ -167,9 +188,7 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
         ret = OMPI_ERR_OUT_OF_RESOURCE;
         goto exit;
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_rcomm_time = MPI_Wtime();
-#endif
     ret = ompi_fcoll_base_coll_allgather_array (&max_data,
                                            1,
                                            MPI_LONG,
@@ -183,10 +202,8 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
     if (OMPI_SUCCESS != ret){
         goto exit;
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_rcomm_time = MPI_Wtime();
     rcomm_time += end_rcomm_time - start_rcomm_time;
-#endif
 
     for (i=0 ; i<fh->f_procs_per_group ; i++) {
         total_bytes += total_bytes_per_process[i];
@@ -219,9 +236,7 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
         ret = OMPI_ERR_OUT_OF_RESOURCE;
         goto exit;
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_rcomm_time = MPI_Wtime();
-#endif
     ret = ompi_fcoll_base_coll_allgather_array (&local_count,
                                            1,
                                            MPI_INT,
@@ -236,10 +251,8 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
     if (OMPI_SUCCESS != ret){
         goto exit;
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_rcomm_time = MPI_Wtime();
     rcomm_time += end_rcomm_time - start_rcomm_time;
-#endif
 
     displs = (int*)malloc (fh->f_procs_per_group*sizeof(int));
     if (NULL == displs) {
@@ -277,9 +290,7 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
             goto exit;
         }
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_rcomm_time = MPI_Wtime();
-#endif
     ret =  ompi_fcoll_base_coll_allgatherv_array (local_iov_array,
                                              local_count,
                                              fh->f_iov_type,
@@ -295,10 +306,8 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
     if (OMPI_SUCCESS != ret){
         goto exit;
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_rcomm_time = MPI_Wtime();
     rcomm_time += end_rcomm_time - start_rcomm_time;
-#endif
 
     /****************************************************************************************
      *** 5. Sort the global offset/lengths list based on the offsets.
@@ -341,31 +350,60 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
     bytes_per_cycle = fh->f_bytes_per_agg;
     cycles = ceil((double)total_bytes/bytes_per_cycle);
 
-    if ( my_aggregator == fh->f_rank) {
-      disp_index = (int *)malloc (fh->f_procs_per_group * sizeof (int));
-      if (NULL == disp_index) {
-            opal_output (1, "OUT OF MEMORY\n");
-            ret = OMPI_ERR_OUT_OF_RESOURCE;
-            goto exit;
+    /* Reading ahead is only done if asynchronous I/O was requested, since
+       it changes how the buffer is split. The pipeline keeps num_stages
+       cycles in flight, each of them gets an equal share of the buffer size
+       the user requested. */
+    if( 1 == mca_fcoll_dynamic_gen2_async_io ) {
+        read_synch_type = 1;
+        num_stages = mca_fcoll_dynamic_gen2_pipeline_depth;
+        if ( num_stages < 2 ) {
+            num_stages = 2;
         }
+        bytes_per_cycle = bytes_per_cycle/num_stages;
+        cycles = ceil((double)total_bytes/bytes_per_cycle);
+    }
 
-        blocklen_per_process = (int **)malloc (fh->f_procs_per_group * sizeof (int*));
-        if (NULL == blocklen_per_process) {
-            opal_output (1, "OUT OF MEMORY\n");
-            ret = OMPI_ERR_OUT_OF_RESOURCE;
-            goto exit;
-        }
+    stages = (mca_io_ompio_read_stage *) calloc (num_stages, sizeof(mca_io_ompio_read_stage));
+    if (NULL == stages) {
+        opal_output (1, "OUT OF MEMORY\n");
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto exit;
+    }
+    for (s=0; s<num_stages; s++) {
+        stages[s].read_req = MPI_REQUEST_NULL;
+    }
 
-        displs_per_process = (MPI_Aint **)malloc (fh->f_procs_per_group * sizeof (MPI_Aint*));
-        if (NULL == displs_per_process){
-            opal_output (1, "OUT OF MEMORY\n");
-            ret = OMPI_ERR_OUT_OF_RESOURCE;
-            goto exit;
-        }
+    if ( my_aggregator == fh->f_rank) {
+        for (s=0; s<num_stages; s++) {
+            st = &stages[s];
+            st->disp_index = (int *)malloc (fh->f_procs_per_group * sizeof (int));
+            if (NULL == st->disp_index) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
+
+            st->blocklen_per_process = (int **)calloc (fh->f_procs_per_group, sizeof (int*));
+            if (NULL == st->blocklen_per_process) {
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
+
+            st->displs_per_process = (MPI_Aint **)calloc (fh->f_procs_per_group, sizeof (MPI_Aint*));
+            if (NULL == st->displs_per_process){
+                opal_output (1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
 
-        for (i=0;i<fh->f_procs_per_group;i++){
-            blocklen_per_process[i] = NULL;
-            displs_per_process[i] = NULL;
+            st->global_buf = (char *) mca_common_ompio_alloc_aligned_buf (fh, bytes_per_cycle);
+            if (NULL == st->global_buf){
+                opal_output(1, "OUT OF MEMORY\n");
+                ret = OMPI_ERR_OUT_OF_RESOURCE;
+                goto exit;
+            }
         }
 
 	send_req = (MPI_Request *) malloc (fh->f_procs_per_group * sizeof(MPI_Request));
@@ -375,13 +413,6 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
 	    goto exit;
 	}
 
-	global_buf = (char *) malloc (bytes_per_cycle);
-	if (NULL == global_buf){
-	    opal_output(1, "OUT OF MEMORY\n");
-	    ret = OMPI_ERR_OUT_OF_RESOURCE;
-	    goto exit;
-	}
-
 	sendtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group * sizeof(ompi_datatype_t *));
 	if (NULL == sendtype) {
             opal_output (1, "OUT OF MEMORY\n");
@@ -397,226 +428,220 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
 
 
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_rexch = MPI_Wtime();
-#endif
     n = 0;
     bytes_remaining = 0;
     current_index = 0;
 
-    for (index = 0; index < cycles; index++) {
-        /**********************************************************************
-         ***  7a. Getting ready for next cycle: initializing and freeing buffers
-	 **********************************************************************/
-        if (my_aggregator == fh->f_rank) {
-             if (NULL != fh->f_io_array) {
-                free (fh->f_io_array);
-                fh->f_io_array = NULL;
-            }
-            fh->f_num_of_io_entries = 0;
-
-            if (NULL != sendtype){
-                for (i =0; i< fh->f_procs_per_group; i++) {
-		    if ( MPI_DATATYPE_NULL != sendtype[i] ) {
-                        ompi_datatype_destroy(&sendtype[i]);
-                        sendtype[i] = MPI_DATATYPE_NULL;
+    /*************************************************************************
+     *** 7. The pipeline. Step 'index' plans cycle 'index' and starts reading
+     ***    it into its stage, then scatters the data of the oldest cycle in
+     ***    flight, index-num_stages+1, whose read had the most time to complete.
+     *************************************************************************/
+    for (index = 0; index < cycles + num_stages - 1; index++) {
+        if ( index < cycles ) {
+            st = &stages[index % num_stages];
+
+            /**********************************************************************
+             ***  7a. Getting ready for next cycle: initializing and freeing buffers
+             **********************************************************************/
+            if (my_aggregator == fh->f_rank) {
+                for(l=0;l<fh->f_procs_per_group;l++){
+                    st->disp_index[l] =  1;
+
+                    if (NULL != st->blocklen_per_process[l]){
+                        free(st->blocklen_per_process[l]);
+                        st->blocklen_per_process[l] = NULL;
+                    }
+                    if (NULL != st->displs_per_process[l]){
+                        free(st->displs_per_process[l]);
+                        st->displs_per_process[l] = NULL;
+                    }
+                    st->blocklen_per_process[l] = (int *) calloc (1, sizeof(int));
+                    if (NULL == st->blocklen_per_process[l]) {
+                        opal_output (1, "OUT OF MEMORY for blocklen\n");
+                        ret = OMPI_ERR_OUT_OF_RESOURCE;
+                        goto exit;
+                    }
+                    st->displs_per_process[l] = (MPI_Aint *) calloc (1, sizeof(MPI_Aint));
+                    if (NULL == st->displs_per_process[l]){
+                        opal_output (1, "OUT OF MEMORY for displs\n");
+                        ret = OMPI_ERR_OUT_OF_RESOURCE;
+                        goto exit;
                     }
-		}
-            }
-
-            for(l=0;l<fh->f_procs_per_group;l++){
-                disp_index[l] =  1;
-
-                if (NULL != blocklen_per_process[l]){
-                    free(blocklen_per_process[l]);
-                    blocklen_per_process[l] = NULL;
                 }
-                if (NULL != displs_per_process[l]){
-                    free(displs_per_process[l]);
-                    displs_per_process[l] = NULL;
+
+                if (NULL != st->sorted_file_offsets){
+                    free(st->sorted_file_offsets);
+                    st->sorted_file_offsets = NULL;
                 }
-                blocklen_per_process[l] = (int *) calloc (1, sizeof(int));
-                if (NULL == blocklen_per_process[l]) {
-                    opal_output (1, "OUT OF MEMORY for blocklen\n");
-                    ret = OMPI_ERR_OUT_OF_RESOURCE;
-                    goto exit;
+
+                if(NULL != st->file_offsets_for_agg){
+                    free(st->file_offsets_for_agg);
+                    st->file_offsets_for_agg = NULL;
                 }
-                displs_per_process[l] = (MPI_Aint *) calloc (1, sizeof(MPI_Aint));
-                if (NULL == displs_per_process[l]){
-                    opal_output (1, "OUT OF MEMORY for displs\n");
-                    ret = OMPI_ERR_OUT_OF_RESOURCE;
-                    goto exit;
+                if (NULL != st->memory_displacements){
+                    free(st->memory_displacements);
+                    st->memory_displacements = NULL;
                 }
-            }
-
-            if (NULL != sorted_file_offsets){
-                free(sorted_file_offsets);
-                sorted_file_offsets = NULL;
-            }
+            }  /* (my_aggregator == fh->f_rank */
 
-            if(NULL != file_offsets_for_agg){
-                free(file_offsets_for_agg);
-                file_offsets_for_agg = NULL;
+            /**************************************************************************
+             ***  7b. Determine the number of bytes to be actually read in this cycle
+             **************************************************************************/
+            if (cycles-1 == index) {
+                bytes_to_read_in_cycle = total_bytes - bytes_per_cycle*index;
             }
-            if (NULL != memory_displacements){
-                free(memory_displacements);
-                memory_displacements = NULL;
+            else {
+                bytes_to_read_in_cycle = bytes_per_cycle;
             }
-        }  /* (my_aggregator == fh->f_rank */
-
-        /**************************************************************************
-         ***  7b. Determine the number of bytes to be actually read in this cycle
-	 **************************************************************************/
-        if (cycles-1 == index) {
-            bytes_to_read_in_cycle = total_bytes - bytes_per_cycle*index;
-        }
-        else {
-            bytes_to_read_in_cycle = bytes_per_cycle;
-        }
 
 #if DEBUG_ON
-        if (my_aggregator == fh->f_rank) {
-            printf ("****%d: CYCLE %d   Bytes %d**********\n",
-                    fh->f_rank,
-                    index,
-                    bytes_to_write_in_cycle);
-        }
-#endif
-
-        /*****************************************************************
-         *** 7c. Calculate how much data will be contributed in this cycle
-	 ***     by each process
-         *****************************************************************/
-        bytes_received = 0;
-
-        while (bytes_to_read_in_cycle) {
-            /* This next block identifies which process is the holder
-            ** of the sorted[current_index] element;
-            */
-            blocks = fview_count[0];
-            for (j=0 ; j<fh->f_procs_per_group ; j++) {
-                if (sorted[current_index] < blocks) {
-                    n = j;
-                    break;
-                }
-                else {
-                    blocks += fview_count[j+1];
-                }
+            if (my_aggregator == fh->f_rank) {
+                printf ("****%d: CYCLE %d   Bytes %d**********\n",
+                        fh->f_rank,
+                        index,
+                        bytes_to_write_in_cycle);
             }
+#endif
 
-            if (bytes_remaining) {
-                /* Finish up a partially used buffer from the previous  cycle */
-                if (bytes_remaining <= bytes_to_read_in_cycle) {
-                    /* Data fits completely into the block */
-                    if (my_aggregator == fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] = bytes_remaining;
-                        displs_per_process[n][disp_index[n] - 1] =
-                            (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
-                            (global_iov_array[sorted[current_index]].iov_len - bytes_remaining);
-
-                        blocklen_per_process[n] = (int *) realloc
-                            ((void *)blocklen_per_process[n], (disp_index[n]+1)*sizeof(int));
-                        displs_per_process[n] = (MPI_Aint *) realloc
-                            ((void *)displs_per_process[n], (disp_index[n]+1)*sizeof(MPI_Aint));
-                        blocklen_per_process[n][disp_index[n]] = 0;
-                        displs_per_process[n][disp_index[n]] = 0;
-                        disp_index[n] += 1;
-                    }
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_remaining;
+            /*****************************************************************
+             *** 7c. Calculate how much data will be contributed in this cycle
+             ***     by each process
+             *****************************************************************/
+            st->bytes_received = 0;
+
+            while (bytes_to_read_in_cycle) {
+                /* This next block identifies which process is the holder
+                ** of the sorted[current_index] element;
+                */
+                blocks = fview_count[0];
+                for (j=0 ; j<fh->f_procs_per_group ; j++) {
+                    if (sorted[current_index] < blocks) {
+                        n = j;
+                        break;
                     }
-                    current_index ++;
-                    bytes_to_read_in_cycle -= bytes_remaining;
-                    bytes_remaining = 0;
-                    continue;
-                }
-                else {
-                     /* the remaining data from the previous cycle is larger than the
-                        bytes_to_write_in_cycle, so we have to segment again */
-                    if (my_aggregator == fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] = bytes_to_read_in_cycle;
-                        displs_per_process[n][disp_index[n] - 1] =
-                            (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
-                            (global_iov_array[sorted[current_index]].iov_len
-                             - bytes_remaining);
-                    }
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_to_read_in_cycle;
+                    else {
+                        blocks += fview_count[j+1];
                     }
-                    bytes_remaining -= bytes_to_read_in_cycle;
-                    bytes_to_read_in_cycle = 0;
-                    break;
                 }
-            }
-            else {
-                /* No partially used entry available, have to start a new one */
-                if (bytes_to_read_in_cycle <
-                    (MPI_Aint) global_iov_array[sorted[current_index]].iov_len) {
-                    /* This entry has more data than we can sendin one cycle */
-                    if (my_aggregator == fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] = bytes_to_read_in_cycle;
-                        displs_per_process[n][disp_index[n] - 1] =
-                            (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base ;
-                    }
 
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received += bytes_to_read_in_cycle;
+                if (bytes_remaining) {
+                    /* Finish up a partially used buffer from the previous  cycle */
+                    if (bytes_remaining <= bytes_to_read_in_cycle) {
+                        /* Data fits completely into the block */
+                        if (my_aggregator == fh->f_rank) {
+                            st->blocklen_per_process[n][st->disp_index[n] - 1] = bytes_remaining;
+                            st->displs_per_process[n][st->disp_index[n] - 1] =
+                                (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
+                                (global_iov_array[sorted[current_index]].iov_len - bytes_remaining);
+
+                            st->blocklen_per_process[n] = (int *) realloc
+                                ((void *)st->blocklen_per_process[n], (st->disp_index[n]+1)*sizeof(int));
+                            st->displs_per_process[n] = (MPI_Aint *) realloc
+                                ((void *)st->displs_per_process[n], (st->disp_index[n]+1)*sizeof(MPI_Aint));
+                            st->blocklen_per_process[n][st->disp_index[n]] = 0;
+                            st->displs_per_process[n][st->disp_index[n]] = 0;
+                            st->disp_index[n] += 1;
+                        }
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            st->bytes_received += bytes_remaining;
+                        }
+                        current_index ++;
+                        bytes_to_read_in_cycle -= bytes_remaining;
+                        bytes_remaining = 0;
+                        continue;
+                    }
+                    else {
+                         /* the remaining data from the previous cycle is larger than the
+                            bytes_to_write_in_cycle, so we have to segment again */
+                        if (my_aggregator == fh->f_rank) {
+                            st->blocklen_per_process[n][st->disp_index[n] - 1] = bytes_to_read_in_cycle;
+                            st->displs_per_process[n][st->disp_index[n] - 1] =
+                                (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base +
+                                (global_iov_array[sorted[current_index]].iov_len
+                                 - bytes_remaining);
+                        }
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            st->bytes_received += bytes_to_read_in_cycle;
+                        }
+                        bytes_remaining -= bytes_to_read_in_cycle;
+                        bytes_to_read_in_cycle = 0;
+                        break;
                     }
-                    bytes_remaining = global_iov_array[sorted[current_index]].iov_len -
-                        bytes_to_read_in_cycle;
-                    bytes_to_read_in_cycle = 0;
-                    break;
                 }
                 else {
-                    /* Next data entry is less than bytes_to_write_in_cycle */
-                    if (my_aggregator ==  fh->f_rank) {
-                        blocklen_per_process[n][disp_index[n] - 1] =
-                            global_iov_array[sorted[current_index]].iov_len;
-                        displs_per_process[n][disp_index[n] - 1] = (ptrdiff_t)
-                            global_iov_array[sorted[current_index]].iov_base;
-                        blocklen_per_process[n] =
-                            (int *) realloc ((void *)blocklen_per_process[n], (disp_index[n]+1)*sizeof(int));
-                        displs_per_process[n] = (MPI_Aint *)realloc
-                            ((void *)displs_per_process[n], (disp_index[n]+1)*sizeof(MPI_Aint));
-                        blocklen_per_process[n][disp_index[n]] = 0;
-                        displs_per_process[n][disp_index[n]] = 0;
-                        disp_index[n] += 1;
+                    /* No partially used entry available, have to start a new one */
+                    if (bytes_to_read_in_cycle <
+                        (MPI_Aint) global_iov_array[sorted[current_index]].iov_len) {
+                        /* This entry has more data than we can sendin one cycle */
+                        if (my_aggregator == fh->f_rank) {
+                            st->blocklen_per_process[n][st->disp_index[n] - 1] = bytes_to_read_in_cycle;
+                            st->displs_per_process[n][st->disp_index[n] - 1] =
+                                (ptrdiff_t)global_iov_array[sorted[current_index]].iov_base ;
+                        }
+
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            st->bytes_received += bytes_to_read_in_cycle;
+                        }
+                        bytes_remaining = global_iov_array[sorted[current_index]].iov_len -
+                            bytes_to_read_in_cycle;
+                        bytes_to_read_in_cycle = 0;
+                        break;
                     }
-                    if (fh->f_procs_in_group[n] == fh->f_rank) {
-                        bytes_received +=
+                    else {
+                        /* Next data entry is less than bytes_to_write_in_cycle */
+                        if (my_aggregator ==  fh->f_rank) {
+                            st->blocklen_per_process[n][st->disp_index[n] - 1] =
+                                global_iov_array[sorted[current_index]].iov_len;
+                            st->displs_per_process[n][st->disp_index[n] - 1] = (ptrdiff_t)
+                                global_iov_array[sorted[current_index]].iov_base;
+                            st->blocklen_per_process[n] =
+                                (int *) realloc ((void *)st->blocklen_per_process[n], (st->disp_index[n]+1)*sizeof(int));
+                            st->displs_per_process[n] = (MPI_Aint *)realloc
+                                ((void *)st->displs_per_process[n], (st->disp_index[n]+1)*sizeof(MPI_Aint));
+                            st->blocklen_per_process[n][st->disp_index[n]] = 0;
+                            st->displs_per_process[n][st->disp_index[n]] = 0;
+                            st->disp_index[n] += 1;
+                        }
+                        if (fh->f_procs_in_group[n] == fh->f_rank) {
+                            st->bytes_received +=
+                                global_iov_array[sorted[current_index]].iov_len;
+                        }
+                        bytes_to_read_in_cycle -=
                             global_iov_array[sorted[current_index]].iov_len;
+                        current_index ++;
+                        continue;
                     }
-                    bytes_to_read_in_cycle -=
-                        global_iov_array[sorted[current_index]].iov_len;
-                    current_index ++;
-                    continue;
                 }
-            }
-        } /* end while (bytes_to_read_in_cycle) */
+            } /* end while (bytes_to_read_in_cycle) */
 
-        /*************************************************************************
-	 *** 7d. Calculate the displacement on where to put the data and allocate
-         ***     the recieve buffer (global_buf)
-	 *************************************************************************/
-        if (my_aggregator == fh->f_rank) {
-            entries_per_aggregator=0;
-            for (i=0;i<fh->f_procs_per_group; i++){
-                for (j=0;j<disp_index[i];j++){
-                    if (blocklen_per_process[i][j] > 0)
-                        entries_per_aggregator++ ;
+
+            /*************************************************************************
+             *** 7d. Calculate the displacement on where to put the data in the
+             ***     buffer of the stage (global_buf)
+             *************************************************************************/
+            if (my_aggregator == fh->f_rank) {
+                st->entries_per_aggregator=0;
+                for (i=0;i<fh->f_procs_per_group; i++){
+                    for (j=0;j<st->disp_index[i];j++){
+                        if (st->blocklen_per_process[i][j] > 0)
+                            st->entries_per_aggregator++ ;
+                    }
                 }
             }
-            if (entries_per_aggregator > 0){
-                file_offsets_for_agg = (mca_io_ompio_local_io_array *)
-                    malloc(entries_per_aggregator*sizeof(mca_io_ompio_local_io_array));
-                if (NULL == file_offsets_for_agg) {
+
+            if (my_aggregator == fh->f_rank && 0 < st->entries_per_aggregator) {
+                st->file_offsets_for_agg = (mca_io_ompio_local_io_array *)
+                    malloc(st->entries_per_aggregator*sizeof(mca_io_ompio_local_io_array));
+                if (NULL == st->file_offsets_for_agg) {
                     opal_output (1, "OUT OF MEMORY\n");
                     ret = OMPI_ERR_OUT_OF_RESOURCE;
                     goto exit;
                 }
-                sorted_file_offsets = (int *)
-                    malloc (entries_per_aggregator*sizeof(int));
-                if (NULL == sorted_file_offsets){
+                st->sorted_file_offsets = (int *)
+                    malloc (st->entries_per_aggregator*sizeof(int));
+                if (NULL == st->sorted_file_offsets){
                     opal_output (1, "OUT OF MEMORY\n");
                     ret =  OMPI_ERR_OUT_OF_RESOURCE;
                     goto exit;
@@ -625,113 +650,131 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
                 temp_index = 0;
                 global_count = 0;
                 for (i=0;i<fh->f_procs_per_group; i++){
-                    for(j=0;j<disp_index[i];j++){
-                        if (blocklen_per_process[i][j] > 0){
-                            file_offsets_for_agg[temp_index].length =
-                                blocklen_per_process[i][j];
-                            global_count += blocklen_per_process[i][j];
-                            file_offsets_for_agg[temp_index].process_id = i;
-                            file_offsets_for_agg[temp_index].offset =
-                                displs_per_process[i][j];
+                    for(j=0;j<st->disp_index[i];j++){
+                        if (st->blocklen_per_process[i][j] > 0){
+                            st->file_offsets_for_agg[temp_index].length =
+                                st->blocklen_per_process[i][j];
+                            global_count += st->blocklen_per_process[i][j];
+                            st->file_offsets_for_agg[temp_index].process_id = i;
+                            st->file_offsets_for_agg[temp_index].offset =
+                                st->displs_per_process[i][j];
                             temp_index++;
                         }
                     }
                 }
-            }
-            else{
-                continue;
-            }
 
-             /* Sort the displacements for each aggregator */
-            read_heap_sort (file_offsets_for_agg,
-                            entries_per_aggregator,
-                            sorted_file_offsets);
-
-            memory_displacements = (MPI_Aint *) malloc
-                (entries_per_aggregator * sizeof(MPI_Aint));
-            memory_displacements[sorted_file_offsets[0]] = 0;
-            for (i=1; i<entries_per_aggregator; i++){
-                memory_displacements[sorted_file_offsets[i]] =
-                    memory_displacements[sorted_file_offsets[i-1]] +
-                    file_offsets_for_agg[sorted_file_offsets[i-1]].length;
-            }
+                /* Sort the displacements for each aggregator */
+                read_heap_sort (st->file_offsets_for_agg,
+                                st->entries_per_aggregator,
+                                st->sorted_file_offsets);
+
+                st->memory_displacements = (MPI_Aint *) malloc
+                    (st->entries_per_aggregator * sizeof(MPI_Aint));
+                st->memory_displacements[st->sorted_file_offsets[0]] = 0;
+                for (i=1; i<st->entries_per_aggregator; i++){
+                    st->memory_displacements[st->sorted_file_offsets[i]] =
+                        st->memory_displacements[st->sorted_file_offsets[i-1]] +
+                        st->file_offsets_for_agg[st->sorted_file_offsets[i-1]].length;
+                }
 
-             /**********************************************************
-	     *** 7e. Create the io array, and pass it to fbtl
-	     *********************************************************/
-            fh->f_io_array = (mca_common_ompio_io_array_t *) malloc
-                (entries_per_aggregator * sizeof (mca_common_ompio_io_array_t));
-            if (NULL == fh->f_io_array) {
-                opal_output(1, "OUT OF MEMORY\n");
-                ret = OMPI_ERR_OUT_OF_RESOURCE;
-                goto exit;
-            }
+                /**********************************************************
+                 *** 7e. Create the io array, and pass it to fbtl
+                 *********************************************************/
+                fh->f_io_array = (mca_common_ompio_io_array_t *) malloc
+                    (st->entries_per_aggregator * sizeof (mca_common_ompio_io_array_t));
+                if (NULL == fh->f_io_array) {
+                    opal_output(1, "OUT OF MEMORY\n");
+                    ret = OMPI_ERR_OUT_OF_RESOURCE;
+                    goto exit;
+                }
 
-            fh->f_num_of_io_entries = 0;
-            fh->f_io_array[0].offset =
-                (IOVBASE_TYPE *)(intptr_t)file_offsets_for_agg[sorted_file_offsets[0]].offset;
-            fh->f_io_array[0].length =
-                file_offsets_for_agg[sorted_file_offsets[0]].length;
-            fh->f_io_array[0].memory_address =
-                global_buf+memory_displacements[sorted_file_offsets[0]];
-            fh->f_num_of_io_entries++;
-            for (i=1;i<entries_per_aggregator;i++){
-                if (file_offsets_for_agg[sorted_file_offsets[i-1]].offset +
-                    file_offsets_for_agg[sorted_file_offsets[i-1]].length ==
-                    file_offsets_for_agg[sorted_file_offsets[i]].offset){
-                    fh->f_io_array[fh->f_num_of_io_entries - 1].length +=
-                        file_offsets_for_agg[sorted_file_offsets[i]].length;
+                fh->f_num_of_io_entries = 0;
+                fh->f_io_array[0].offset =
+                    (IOVBASE_TYPE *)(intptr_t)st->file_offsets_for_agg[st->sorted_file_offsets[0]].offset;
+                fh->f_io_array[0].length =
+                    st->file_offsets_for_agg[st->sorted_file_offsets[0]].length;
+                fh->f_io_array[0].memory_address =
+                    st->global_buf+st->memory_displacements[st->sorted_file_offsets[0]];
+                fh->f_num_of_io_entries++;
+                for (i=1;i<st->entries_per_aggregator;i++){
+                    if (st->file_offsets_for_agg[st->sorted_file_offsets[i-1]].offset +
+                        st->file_offsets_for_agg[st->sorted_file_offsets[i-1]].length ==
+                        st->file_offsets_for_agg[st->sorted_file_offsets[i]].offset){
+                        fh->f_io_array[fh->f_num_of_io_entries - 1].length +=
+                            st->file_offsets_for_agg[st->sorted_file_offsets[i]].length;
+                    }
+                    else{
+                        fh->f_io_array[fh->f_num_of_io_entries].offset =
+                            (IOVBASE_TYPE *)(intptr_t)st->file_offsets_for_agg[st->sorted_file_offsets[i]].offset;
+                        fh->f_io_array[fh->f_num_of_io_entries].length =
+                            st->file_offsets_for_agg[st->sorted_file_offsets[i]].length;
+                        fh->f_io_array[fh->f_num_of_io_entries].memory_address =
+                            st->global_buf+st->memory_displacements[st->sorted_file_offsets[i]];
+                        fh->f_num_of_io_entries++;
+                    }
                 }
-                else{
-                    fh->f_io_array[fh->f_num_of_io_entries].offset =
-                        (IOVBASE_TYPE *)(intptr_t)file_offsets_for_agg[sorted_file_offsets[i]].offset;
-                    fh->f_io_array[fh->f_num_of_io_entries].length =
-                        file_offsets_for_agg[sorted_file_offsets[i]].length;
-                    fh->f_io_array[fh->f_num_of_io_entries].memory_address =
-                        global_buf+memory_displacements[sorted_file_offsets[i]];
-                    fh->f_num_of_io_entries++;
+
+                /* the read of this cycle overlaps with the scatter of the
+                   previous ones if it can be done asynchronously */
+                start_read_time = MPI_Wtime();
+                ret = read_init (fh, read_synch_type, &st->read_req);
+                if (OMPI_SUCCESS != ret){
+                    goto exit;
                 }
+                end_read_time = MPI_Wtime();
+                read_time += end_read_time - start_read_time;
             }
+        } /* end if ( index < cycles ) */
 
+        if ( index < num_stages - 1 ) {
+            continue;
+        }
+        st = &stages[(index - num_stages + 1) % num_stages];
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            start_read_time = MPI_Wtime();
-#endif
-
-            if (fh->f_num_of_io_entries) {
-                if ( 0 >  fh->f_fbtl->fbtl_preadv (fh)) {
-                    opal_output (1, "READ FAILED\n");
-                    ret = OMPI_ERROR;
-                    goto exit;
-                }
+        if (my_aggregator == fh->f_rank) {
+            if ( 0 == st->entries_per_aggregator ) {
+                continue;
             }
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+            start_read_time = MPI_Wtime();
+            ret = ompi_request_wait (&st->read_req, MPI_STATUS_IGNORE);
+            if (OMPI_SUCCESS != ret){
+                opal_output (1, "READ FAILED\n");
+                goto exit;
+            }
             end_read_time = MPI_Wtime();
             read_time += end_read_time - start_read_time;
-#endif
             /**********************************************************
              ******************** DONE READING ************************
              *********************************************************/
 
+            if (NULL != sendtype){
+                for (i =0; i< fh->f_procs_per_group; i++) {
+                    if ( MPI_DATATYPE_NULL != sendtype[i] ) {
+                        ompi_datatype_destroy(&sendtype[i]);
+                        sendtype[i] = MPI_DATATYPE_NULL;
+                    }
+                }
+            }
+
             temp_disp_index = (int *)calloc (1, fh->f_procs_per_group * sizeof (int));
             if (NULL == temp_disp_index) {
                 opal_output (1, "OUT OF MEMORY\n");
                 ret = OMPI_ERR_OUT_OF_RESOURCE;
                 goto exit;
             }
-            for (i=0; i<entries_per_aggregator; i++){
+            for (i=0; i<st->entries_per_aggregator; i++){
                 temp_index =
-                    file_offsets_for_agg[sorted_file_offsets[i]].process_id;
-                displs_per_process[temp_index][temp_disp_index[temp_index]] =
-                    memory_displacements[sorted_file_offsets[i]];
-                if (temp_disp_index[temp_index] < disp_index[temp_index]){
+                    st->file_offsets_for_agg[st->sorted_file_offsets[i]].process_id;
+                st->displs_per_process[temp_index][temp_disp_index[temp_index]] =
+                    st->memory_displacements[st->sorted_file_offsets[i]];
+                if (temp_disp_index[temp_index] < st->disp_index[temp_index]){
                     temp_disp_index[temp_index] += 1;
                 }
                 else{
                     printf("temp_disp_index[%d]: %d is greater than disp_index[%d]: %d\n",
                            temp_index, temp_disp_index[temp_index],
-                           temp_index, disp_index[temp_index]);
+                           temp_index, st->disp_index[temp_index]);
                 }
             }
             if (NULL != temp_disp_index){
@@ -739,19 +782,17 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
                 temp_disp_index = NULL;
             }
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
             start_rcomm_time = MPI_Wtime();
-#endif
             for (i=0;i<fh->f_procs_per_group;i++){
                 send_req[i] = MPI_REQUEST_NULL;
-                if ( 0 < disp_index[i] ) {
-                    ompi_datatype_create_hindexed(disp_index[i],
-                                                  blocklen_per_process[i],
-                                                  displs_per_process[i],
+                if ( 0 < st->disp_index[i] ) {
+                    ompi_datatype_create_hindexed(st->disp_index[i],
+                                                  st->blocklen_per_process[i],
+                                                  st->displs_per_process[i],
                                                   MPI_BYTE,
                                                   &sendtype[i]);
                     ompi_datatype_commit(&sendtype[i]);
-                    ret = MCA_PML_CALL (isend(global_buf,
+                    ret = MCA_PML_CALL (isend(st->global_buf,
                                               1,
                                               sendtype[i],
                                               fh->f_procs_in_group[i],
@@ -764,10 +805,8 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
                     }
                 }
             }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
             end_rcomm_time = MPI_Wtime();
             rcomm_time += end_rcomm_time - start_rcomm_time;
-#endif
         }
 
         /**********************************************************
@@ -776,11 +815,11 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
         if ( recvbuf_is_contiguous ) {
             receive_buf = &((char*)buf)[position];
         }
-        else if (bytes_received) {
+        else if (st->bytes_received) {
             /* allocate a receive buffer and copy the data that needs
                to be received into it in case the data is non-contigous
                in memory */
-            receive_buf = malloc (bytes_received);
+            receive_buf = malloc (st->bytes_received);
             if (NULL == receive_buf) {
                 opal_output (1, "OUT OF MEMORY\n");
                 ret = OMPI_ERR_OUT_OF_RESOURCE;
@@ -788,11 +827,9 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
             }
         }
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         start_rcomm_time = MPI_Wtime();
-#endif
         ret = MCA_PML_CALL(irecv(receive_buf,
-                                 bytes_received,
+                                 st->bytes_received,
                                  MPI_BYTE,
                                  my_aggregator,
                                  123,
@@ -816,7 +853,7 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
         if (OMPI_SUCCESS != ret){
             goto exit;
         }
-        position += bytes_received;
+        position += st->bytes_received;
 
         /* If data is not contigous in memory, copy the data from the
            receive buffer into the buffer passed in */
@@ -825,7 +862,7 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
             size_t remaining = 0;
             size_t temp_position = 0;
 
-            remaining = bytes_received;
+            remaining = st->bytes_received;
 
             while (remaining) {
                 mem_address = (ptrdiff_t)
@@ -857,40 +894,45 @@ mca_fcoll_dynamic_gen2_file_read_all (ompio_file_t *fh,
                 receive_buf = NULL;
             }
         }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         end_rcomm_time = MPI_Wtime();
         rcomm_time += end_rcomm_time - start_rcomm_time;
-#endif
-    } /* end for (index=0; index < cycles; index ++) */
+    } /* end for (index = 0; index < cycles + num_stages - 1; index++) */
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_rexch = MPI_Wtime();
     read_exch += end_rexch - start_rexch;
-    nentry.time[0] = read_time;
-    nentry.time[1] = rcomm_time;
-    nentry.time[2] = read_exch;
-    if (my_aggregator == fh->f_rank)
-        nentry.aggregator = 1;
-    else
-        nentry.aggregator = 0;
-    nentry.nprocs_for_coll = dynamic_gen2_num_io_procs;
-    if (!mca_common_ompio_full_print_queue(fh->f_coll_read_time)){
-        mca_common_ompio_register_print_entry(fh->f_coll_read_time,
-                                              nentry);
+    if ( OMPIO_FCOLL_WANT_TIME_BREAKDOWN || OMPIO_MCA_GET(fh, coll_timing_info) ) {
+        /* time[0]: reading and waiting for the reads of the pipeline,
+           time[1]: scatter, time[2]: the whole exchange phase */
+        nentry.time[0] = read_time;
+        nentry.time[1] = rcomm_time;
+        nentry.time[2] = read_exch;
+        if (my_aggregator == fh->f_rank)
+            nentry.aggregator = 1;
+        else
+            nentry.aggregator = 0;
+        nentry.nprocs_for_coll = dynamic_gen2_num_io_procs;
+        if (!mca_common_ompio_full_print_queue(fh->f_coll_read_time)){
+            mca_common_ompio_register_print_entry(fh->f_coll_read_time,
+                                                  nentry);
+        }
     }
-#endif
 
 exit:
+    if (NULL != stages) {
+        /* the stage buffers might still be read into after an error */
+        for (s=0; s<num_stages; s++) {
+            if ( MPI_REQUEST_NULL != stages[s].read_req &&
+                 OMPI_SUCCESS != ompi_request_wait (&stages[s].read_req, MPI_STATUS_IGNORE) ) {
+                ompi_request_free (&stages[s].read_req);
+            }
+        }
+    }
     if (!recvbuf_is_contiguous) {
         if (NULL != receive_buf) {
             free (receive_buf);
             receive_buf = NULL;
         }
     }
-    if (NULL != global_buf) {
-        free (global_buf);
-        global_buf = NULL;
-    }
     if (NULL != sorted) {
         free (sorted);
         sorted = NULL;
@@ -918,18 +960,6 @@ exit:
     }
     if (my_aggregator == fh->f_rank) {
 
-        if (NULL != sorted_file_offsets){
-            free(sorted_file_offsets);
-            sorted_file_offsets = NULL;
-        }
-        if (NULL != file_offsets_for_agg){
-            free(file_offsets_for_agg);
-            file_offsets_for_agg = NULL;
-        }
-        if (NULL != memory_displacements){
-            free(memory_displacements);
-            memory_displacements= NULL;
-        }
         if (NULL != sendtype){
             for (i = 0; i < fh->f_procs_per_group; i++) {
                 if ( MPI_DATATYPE_NULL != sendtype[i] ) {
@@ -940,42 +970,82 @@ exit:
             sendtype=NULL;
         }
 
-        if (NULL != disp_index){
-            free(disp_index);
-            disp_index = NULL;
-        }
-
-        if ( NULL != blocklen_per_process){
-            for(l=0;l<fh->f_procs_per_group;l++){
-                if (NULL != blocklen_per_process[l]){
-                    free(blocklen_per_process[l]);
-                    blocklen_per_process[l] = NULL;
+        for (s=0; NULL != stages && s<num_stages; s++) {
+            st = &stages[s];
+            free(st->sorted_file_offsets);
+            free(st->file_offsets_for_agg);
+            free(st->memory_displacements);
+            free(st->disp_index);
+            free(st->global_buf);
+
+            if ( NULL != st->blocklen_per_process){
+                for(l=0;l<fh->f_procs_per_group;l++){
+                    free(st->blocklen_per_process[l]);
                 }
+                free(st->blocklen_per_process);
             }
 
-            free(blocklen_per_process);
-            blocklen_per_process = NULL;
-        }
-
-        if (NULL != displs_per_process){
-            for (l=0; i<fh->f_procs_per_group; l++){
-                if (NULL != displs_per_process[l]){
-                    free(displs_per_process[l]);
-                    displs_per_process[l] = NULL;
+            if (NULL != st->displs_per_process){
+                for (l=0; l<fh->f_procs_per_group; l++){
+                    free(st->displs_per_process[l]);
                 }
+                free(st->displs_per_process);
             }
-            free(displs_per_process);
-            displs_per_process = NULL;
         }
         if ( NULL != send_req ) {
             free ( send_req );
             send_req = NULL;
         }
     }
+    free(stages);
     return ret;
 }
 
 
+static int read_init (ompio_file_t *fh,
+                      int read_synchType,
+                      ompi_request_t **request)
+{
+    int ret = OMPI_SUCCESS;
+    ssize_t ret_temp = 0;
+    mca_ompio_request_t *ompio_req = NULL;
+
+    mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_READ );
+
+    if (1 == read_synchType) {
+        ret = fh->f_fbtl->fbtl_ipreadv(fh, (ompi_request_t *) ompio_req);
+        if (OMPI_SUCCESS == ret && NULL != ompio_req->req_progress_fn) {
+            mca_common_ompio_register_progress ();
+        }
+        else {
+            /* the read could not be started, do it synchronously */
+            opal_output (1, "dynamic_gen2_read_all: fbtl_ipreadv failed\n");
+            read_synchType = 2;
+            ret = OMPI_SUCCESS;
+        }
+    }
+    if (1 != read_synchType) {
+        ret_temp = fh->f_fbtl->fbtl_preadv(fh);
+        if (0 > ret_temp) {
+            opal_output (1, "READ FAILED\n");
+            ret = OMPI_ERROR;
+            ret_temp = 0;
+        }
+
+        ompio_req->req_ompi.req_status.MPI_ERROR = ret;
+        ompio_req->req_ompi.req_status._ucount = ret_temp;
+        ompi_request_complete (&ompio_req->req_ompi, false);
+    }
+
+    *request = (ompi_request_t *) ompio_req;
+
+    free(fh->f_io_array);
+    fh->f_io_array=NULL;
+    fh->f_num_of_io_entries=0;
+
+    return ret;
+}
+
 static int read_heap_sort (mca_io_ompio_local_io_array *io_array,
                            int num_entries,
                            int *sorted)
@@ -29,6 +29,8 @@
 #include "ompi/mca/fcoll/fcoll.h"
 #include "ompi/mca/fcoll/base/fcoll_base_coll_array.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
+#include "ompi/mca/common/ompio/common_ompio_buffer.h"
+#include "ompi/mca/common/ompio/common_ompio_request.h"
 #include "ompi/mca/io/io.h"
 #include "math.h"
 #include "ompi/mca/pml/pml.h"
@@ -46,23 +48,35 @@ typedef struct mca_io_ompio_local_io_array{
     int                  process_id;
 }mca_io_ompio_local_io_array;
 
+/* Buffers of one stage of the write pipeline at an aggregator. A stage
+   holds the data of one cycle from the start of its shuffle until the
+   write of that cycle has completed. */
+typedef struct mca_io_ompio_aggregator_stage {
+    char *global_buf;
+    ompi_datatype_t **recvtype;
+    mca_common_ompio_io_array_t *io_array;
+    int num_io_entries;
+    int bytes_to_write;
+} mca_io_ompio_aggregator_stage;
+
 typedef struct mca_io_ompio_aggregator_data {
     int *disp_index, *sorted, *fview_count, n;
     int *max_disp_index;
     int **blocklen_per_process;
     MPI_Aint **displs_per_process, total_bytes, bytes_per_cycle, total_bytes_written;
     MPI_Comm comm;
-    char *buf, *global_buf, *prev_global_buf;
-    ompi_datatype_t **recvtype, **prev_recvtype;
+    char *buf, *global_buf;
+    ompi_datatype_t **recvtype;
     struct iovec *global_iov_array;
     int current_index, current_position;
     int bytes_to_write_in_cycle, bytes_remaining, procs_per_group;    
     int *procs_in_group, iov_index;
-    int bytes_sent, prev_bytes_sent;
+    int bytes_sent;
     struct iovec *decoded_iov;
-    int bytes_to_write, prev_bytes_to_write;
-    mca_common_ompio_io_array_t *io_array, *prev_io_array;
-    int num_io_entries, prev_num_io_entries;
+    int bytes_to_write;
+    mca_common_ompio_io_array_t *io_array;
+    int num_io_entries;
+    mca_io_ompio_aggregator_stage *stages;
 } mca_io_ompio_aggregator_data;
 
 
@@ -71,20 +85,27 @@ typedef struct mca_io_ompio_aggregator_data {
     _r1=_r2;                     \
     _r2=_t;}
 
-#define SWAP_AGGR_POINTERS(_aggr,_num) {                        \
+/* let the next shuffle_init fill the buffers of stage _s */
+#define LOAD_AGGR_STAGE(_aggr,_num,_s) {                         \
     int _i;                                                     \
-    char *_t;                                                   \
     for (_i=0; _i<_num; _i++ ) {                                \
-        _aggr[_i]->prev_io_array=_aggr[_i]->io_array;             \
-        _aggr[_i]->prev_num_io_entries=_aggr[_i]->num_io_entries; \
-        _aggr[_i]->prev_bytes_sent=_aggr[_i]->bytes_sent;         \
-        _aggr[_i]->prev_bytes_to_write=_aggr[_i]->bytes_to_write; \
-        _t=_aggr[_i]->prev_global_buf;                            \
-        _aggr[_i]->prev_global_buf=_aggr[_i]->global_buf;         \
-        _aggr[_i]->global_buf=_t;                                 \
-        _t=(char *)_aggr[_i]->recvtype;                           \
-        _aggr[_i]->recvtype=_aggr[_i]->prev_recvtype;             \
-        _aggr[_i]->prev_recvtype=(ompi_datatype_t **)_t;          }                                                             \
+        if (NULL != _aggr[_i]->stages) {                        \
+            _aggr[_i]->global_buf=_aggr[_i]->stages[_s].global_buf; \
+            _aggr[_i]->recvtype=_aggr[_i]->stages[_s].recvtype;     \
+        }                                                       \
+    }                                                           \
+}
+
+/* remember the io array shuffle_init created for stage _s */
+#define STORE_AGGR_STAGE(_aggr,_num,_s) {                        \
+    int _i;                                                     \
+    for (_i=0; _i<_num; _i++ ) {                                \
+        if (NULL != _aggr[_i]->stages) {                        \
+            _aggr[_i]->stages[_s].io_array=_aggr[_i]->io_array;             \
+            _aggr[_i]->stages[_s].num_io_entries=_aggr[_i]->num_io_entries; \
+            _aggr[_i]->stages[_s].bytes_to_write=_aggr[_i]->bytes_to_write; \
+        }                                                       \
+    }                                                           \
 }
 
 
@@ -92,7 +113,8 @@ typedef struct mca_io_ompio_aggregator_data {
 static int shuffle_init ( int index, int cycles, int aggregator, int rank, 
                           mca_io_ompio_aggregator_data *data, 
                           ompi_request_t **reqs );
-static int write_init (ompio_file_t *fh, int aggregator, mca_io_ompio_aggregator_data *aggr_data, int write_chunksize );
+static int write_init (ompio_file_t *fh, int aggregator, mca_io_ompio_aggregator_stage *stage,
+                       int write_chunksize, int write_synchType, ompi_request_t **request );
 
 int mca_fcoll_dynamic_gen2_break_file_view ( struct iovec *decoded_iov, int iov_count, 
                                         struct iovec *local_iov_array, int local_count, 
@@ -129,9 +151,10 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
     struct iovec *local_iov_array=NULL;
     uint32_t total_fview_count = 0;
     int local_count = 0;
-    ompi_request_t **reqs1=NULL,**reqs2=NULL;
-    ompi_request_t **curr_reqs=NULL,**prev_reqs=NULL;
+    ompi_request_t **reqs=NULL;
+    ompi_request_t **req_iwrite=NULL;
     mca_io_ompio_aggregator_data **aggr_data=NULL;
+    int num_stages = 2, stage, prev_stage, num_reqs;
     
     int *displs = NULL;
     int dynamic_gen2_num_io_procs;
@@ -145,15 +168,15 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
     MPI_Aint *broken_total_lengths=NULL;
 
     int *aggregators=NULL;
+    int write_synch_type = 2;
     int write_chunksize, *result_counts=NULL;
+    size_t stripe_size;
     
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     double write_time = 0.0, start_write_time = 0.0, end_write_time = 0.0;
     double comm_time = 0.0, start_comm_time = 0.0, end_comm_time = 0.0;
     double exch_write = 0.0, start_exch = 0.0, end_exch = 0.0;
     mca_common_ompio_print_entry nentry;
-#endif
     
     
     /**************************************************************************
@@ -161,9 +184,17 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
      **************************************************************************/
     bytes_per_cycle = fh->f_bytes_per_agg;
 
-    /* since we want to overlap 2 iterations, define the bytes_per_cycle to be half of what
-       the user requested */
-    bytes_per_cycle =bytes_per_cycle/2;
+    /* the pipeline keeps num_stages cycles in flight, each of them gets an equal
+       share of the buffer size the user requested */
+    num_stages = mca_fcoll_dynamic_gen2_pipeline_depth;
+    if ( num_stages < 2 ) {
+        num_stages = 2;
+    }
+    bytes_per_cycle = bytes_per_cycle/num_stages;
+    if ( (fh->f_flags & OMPIO_DIRECT_IO) && bytes_per_cycle > fh->f_fs_block_size ) {
+        /* cycles of aligned data fill whole blocks */
+        bytes_per_cycle -= bytes_per_cycle % fh->f_fs_block_size;
+    }
         
     ret =   mca_common_ompio_decode_datatype ((struct ompio_file_t *) fh,
                                               datatype,
@@ -180,6 +211,12 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
     if ( MPI_STATUS_IGNORE != status ) {
 	status->_ucount = max_data;
     }
+
+    if( (1 == mca_fcoll_dynamic_gen2_async_io) && (NULL == fh->f_fbtl->fbtl_ipwritev) ) {
+        opal_output (1, "dynamic_gen2_write_all: fbtl Does NOT support ipwritev() (asynchrounous write) \n");
+        ret = MPI_ERR_UNSUPPORTED_OPERATION;
+        goto exit;
+    }
     
     /* difference to the first generation of this function:
     ** dynamic_gen2_num_io_procs should be the number of io_procs per group
@@ -197,12 +234,19 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
     }
 
 
-    if ( fh->f_stripe_size == 0 ) {
-        // EDGAR: just a quick heck for testing 
-        fh->f_stripe_size = 65536;
+    /* the file is partitioned in units of the stripe size, a default unit is used
+       if the file system does not report one */
+    stripe_size = fh->f_stripe_size;
+    if ( stripe_size == 0 ) {
+        stripe_size = 65536;
+    }
+    if ( (fh->f_flags & OMPIO_DIRECT_IO) && 0 != stripe_size % fh->f_fs_block_size ) {
+        /* with O_DIRECT the aggregators only write whole blocks, apart from
+           the ends of the accessed range */
+        stripe_size = ((stripe_size + fh->f_fs_block_size - 1) / fh->f_fs_block_size) * fh->f_fs_block_size;
     }
     if ( -1 == mca_fcoll_dynamic_gen2_write_chunksize  ) {
-        write_chunksize = fh->f_stripe_size;
+        write_chunksize = stripe_size;
     }
     else {
         write_chunksize = mca_fcoll_dynamic_gen2_write_chunksize;
@@ -250,15 +294,13 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
                                               &broken_decoded_iovs, &broken_iov_counts,
                                               &broken_iov_arrays, &broken_counts, 
                                               &broken_total_lengths,
-                                              dynamic_gen2_num_io_procs,  fh->f_stripe_size); 
+                                              dynamic_gen2_num_io_procs,  stripe_size); 
 
 
     /**************************************************************************
      ** 3. Determine the total amount of data to be written and no. of cycles
      **************************************************************************/
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_comm_time = MPI_Wtime();
-#endif
     if ( 1 == mca_fcoll_dynamic_gen2_num_groups ) {
         ret = fh->f_comm->c_coll->coll_allreduce (MPI_IN_PLACE,
                                                   broken_total_lengths,
@@ -304,10 +346,8 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
             total_bytes_per_process = NULL;
         }
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_comm_time = MPI_Wtime();
     comm_time += (end_comm_time - start_comm_time);
-#endif
 
     cycles=0;
     for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
@@ -326,9 +366,7 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
         goto exit;
     }
 
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_comm_time = MPI_Wtime();
-#endif
     if ( 1 == mca_fcoll_dynamic_gen2_num_groups ) {
         ret = fh->f_comm->c_coll->coll_allgather(broken_counts,
                                                 dynamic_gen2_num_io_procs,
@@ -354,10 +392,8 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
     if( OMPI_SUCCESS != ret){
         goto exit;
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_comm_time = MPI_Wtime();
     comm_time += (end_comm_time - start_comm_time);
-#endif
 
     /*************************************************************
      *** 4. Allgather the offset/lengths array from all processes
@@ -412,9 +448,7 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
             }            
         }
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         start_comm_time = MPI_Wtime();
-#endif
         if ( 1 == mca_fcoll_dynamic_gen2_num_groups ) {
             ret = fh->f_comm->c_coll->coll_allgatherv (broken_iov_arrays[i],
                                                       broken_counts[i],
@@ -442,10 +476,8 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
         if (OMPI_SUCCESS != ret){
             goto exit;
         }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         end_comm_time = MPI_Wtime();
         comm_time += (end_comm_time - start_comm_time);
-#endif
         
         /****************************************************************************************
          *** 5. Sort the global offset/lengths list based on the offsets.
@@ -524,174 +556,186 @@ int mca_fcoll_dynamic_gen2_file_write_all (ompio_file_t *fh,
             }
         
             
-            aggr_data[i]->global_buf       = (char *) malloc (bytes_per_cycle);
-            aggr_data[i]->prev_global_buf  = (char *) malloc (bytes_per_cycle);
-            if (NULL == aggr_data[i]->global_buf || NULL == aggr_data[i]->prev_global_buf){
-                opal_output(1, "OUT OF MEMORY");
-                ret = OMPI_ERR_OUT_OF_RESOURCE;
-                goto exit;
-            }
-        
-            aggr_data[i]->recvtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group  * 
-                                                                  sizeof(ompi_datatype_t *));
-            aggr_data[i]->prev_recvtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group  * 
-                                                                       sizeof(ompi_datatype_t *));
-            if (NULL == aggr_data[i]->recvtype || NULL == aggr_data[i]->prev_recvtype) {
+            aggr_data[i]->stages = (mca_io_ompio_aggregator_stage *) calloc (num_stages,
+                                                                             sizeof(mca_io_ompio_aggregator_stage));
+            if (NULL == aggr_data[i]->stages) {
                 opal_output (1, "OUT OF MEMORY\n");
                 ret = OMPI_ERR_OUT_OF_RESOURCE;
                 goto exit;
             }
-            for(l=0;l<fh->f_procs_per_group;l++){
-                aggr_data[i]->recvtype[l]      = MPI_DATATYPE_NULL;
-                aggr_data[i]->prev_recvtype[l] = MPI_DATATYPE_NULL;
+
+            for (stage=0; stage<num_stages; stage++) {
+                aggr_data[i]->stages[stage].global_buf = (char *) mca_common_ompio_alloc_aligned_buf (fh, bytes_per_cycle);
+                aggr_data[i]->stages[stage].recvtype   = (ompi_datatype_t **) malloc (fh->f_procs_per_group  *
+                                                                                      sizeof(ompi_datatype_t *));
+                if (NULL == aggr_data[i]->stages[stage].global_buf ||
+                    NULL == aggr_data[i]->stages[stage].recvtype) {
+                    opal_output (1, "OUT OF MEMORY\n");
+                    ret = OMPI_ERR_OUT_OF_RESOURCE;
+                    goto exit;
+                }
+                for(l=0;l<fh->f_procs_per_group;l++){
+                    aggr_data[i]->stages[stage].recvtype[l] = MPI_DATATYPE_NULL;
+                }
             }
         }
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         start_exch = MPI_Wtime();
-#endif
     }    
 
-    reqs1 = (ompi_request_t **)malloc ((fh->f_procs_per_group + 1 )*dynamic_gen2_num_io_procs *sizeof(ompi_request_t *));
-    reqs2 = (ompi_request_t **)malloc ((fh->f_procs_per_group + 1 )*dynamic_gen2_num_io_procs *sizeof(ompi_request_t *));
-    if ( NULL == reqs1 || NULL == reqs2 ) {
+    /* one set of shuffle requests per stage, one write request per stage and aggregator */
+    num_reqs = (fh->f_procs_per_group + 1 )*dynamic_gen2_num_io_procs;
+    reqs = (ompi_request_t **)malloc (num_stages * num_reqs *sizeof(ompi_request_t *));
+    req_iwrite = (ompi_request_t **)malloc (num_stages * dynamic_gen2_num_io_procs * sizeof(ompi_request_t *));
+    if ( NULL == reqs || NULL == req_iwrite ) {
         opal_output (1, "OUT OF MEMORY\n");
         ret = OMPI_ERR_OUT_OF_RESOURCE;
         goto exit;
     }
-    for (l=0,i=0; i < dynamic_gen2_num_io_procs; i++ ) {
-        for ( j=0; j< (fh->f_procs_per_group+1); j++ ) {
-            reqs1[l] = MPI_REQUEST_NULL;
-            reqs2[l] = MPI_REQUEST_NULL;
-            l++;
-        }
+    for (l=0; l < num_stages * num_reqs; l++ ) {
+        reqs[l] = MPI_REQUEST_NULL;
     }
-
-    curr_reqs = reqs1;
-    prev_reqs = reqs2;
-    
-    /* Initialize communication for iteration 0 */
-    if ( cycles > 0 ) {
-        for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
-            ret = shuffle_init ( 0, cycles, aggregators[i], fh->f_rank, aggr_data[i], 
-                                 &curr_reqs[i*(fh->f_procs_per_group + 1)] );
-            if ( OMPI_SUCCESS != ret ) {
-                goto exit;
-            }
-        }
+    for (l=0; l < num_stages * dynamic_gen2_num_io_procs; l++ ) {
+        req_iwrite[l] = MPI_REQUEST_NULL;
     }
 
+    if( 1 == mca_fcoll_dynamic_gen2_async_io ) {
+        write_synch_type = 1;
+    }
 
-    for (index = 1; index < cycles; index++) {
-        SWAP_REQUESTS(curr_reqs,prev_reqs);
-        SWAP_AGGR_POINTERS(aggr_data,dynamic_gen2_num_io_procs); 
+    /*************************************************************************
+     *** 7. The pipeline. Step 'index' starts the shuffle of cycle 'index' into
+     ***    its stage, then completes the shuffle of cycle index-1 and starts
+     ***    writing it. Up to num_stages cycles are in flight, a stage is only
+     ***    reused after the write of the cycle it held before has finished.
+     *************************************************************************/
+    for (index = 0; index <= cycles; index++) {
+        stage      = index % num_stages;
+        prev_stage = (index + num_stages - 1) % num_stages;
 
-        /* Initialize communication for iteration i */
-        for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
-            ret = shuffle_init ( index, cycles, aggregators[i], fh->f_rank, aggr_data[i], 
-                                 &curr_reqs[i*(fh->f_procs_per_group + 1)] );
-            if ( OMPI_SUCCESS != ret ) {
-                goto exit;
+        if ( index < cycles ) {
+            start_write_time = MPI_Wtime();
+            for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
+                if ( MPI_REQUEST_NULL != req_iwrite[stage*dynamic_gen2_num_io_procs + i] ) {
+                    ret = ompi_request_wait(&req_iwrite[stage*dynamic_gen2_num_io_procs + i], MPI_STATUS_IGNORE);
+                    if (OMPI_SUCCESS != ret){
+                        goto exit;
+                    }
+                }
             }
-        }
+            end_write_time = MPI_Wtime();
+            write_time += end_write_time - start_write_time;
 
-        /* Finish communication for iteration i-1 */
-        ret = ompi_request_wait_all ( (fh->f_procs_per_group + 1 )*dynamic_gen2_num_io_procs, 
-                                      prev_reqs, MPI_STATUS_IGNORE);
-        if (OMPI_SUCCESS != ret){
-            goto exit;
+            /* Initialize communication for iteration index */
+            start_comm_time = MPI_Wtime();
+            LOAD_AGGR_STAGE(aggr_data, dynamic_gen2_num_io_procs, stage);
+            for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
+                ret = shuffle_init ( index, cycles, aggregators[i], fh->f_rank, aggr_data[i], 
+                                     &reqs[stage*num_reqs + i*(fh->f_procs_per_group + 1)] );
+                if ( OMPI_SUCCESS != ret ) {
+                    goto exit;
+                }
+            }
+            STORE_AGGR_STAGE(aggr_data, dynamic_gen2_num_io_procs, stage);
+            end_comm_time = MPI_Wtime();
+            comm_time += end_comm_time - start_comm_time;
         }
 
-        
-        /* Write data for iteration i-1 */
-        for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            start_write_time = MPI_Wtime();
-#endif
-            ret = write_init (fh, aggregators[i], aggr_data[i], write_chunksize );
+        if ( 0 < index ) {
+            /* Finish communication for iteration index-1 */
+            start_comm_time = MPI_Wtime();
+            ret = ompi_request_wait_all ( num_reqs, &reqs[prev_stage*num_reqs], MPI_STATUS_IGNORE);
             if (OMPI_SUCCESS != ret){
                 goto exit;
-            }            
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            end_write_time = MPI_Wtime();
-            write_time += end_write_time - start_write_time;
-#endif
-        }
-        
-    } /* end  for (index = 0; index < cycles; index++) */
-
+            }
+            end_comm_time = MPI_Wtime();
+            comm_time += end_comm_time - start_comm_time;
 
-    /* Finish communication for iteration i = cycles-1 */
-    if ( cycles > 0 ) {
-        SWAP_REQUESTS(curr_reqs,prev_reqs);
-        SWAP_AGGR_POINTERS(aggr_data,dynamic_gen2_num_io_procs); 
-        
-        ret = ompi_request_wait_all ( (fh->f_procs_per_group + 1 )*dynamic_gen2_num_io_procs, 
-                                      prev_reqs, MPI_STATUS_IGNORE);
-        if (OMPI_SUCCESS != ret){
-            goto exit;
+            /* Write data for iteration index-1 */
+            for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
+                if ( aggregators[i] != fh->f_rank ) {
+                    continue;
+                }
+                start_write_time = MPI_Wtime();
+                ret = write_init (fh, aggregators[i], &aggr_data[i]->stages[prev_stage], write_chunksize,
+                                  write_synch_type, &req_iwrite[prev_stage*dynamic_gen2_num_io_procs + i]);
+                if (OMPI_SUCCESS != ret){
+                    goto exit;
+                }
+                end_write_time = MPI_Wtime();
+                write_time += end_write_time - start_write_time;
+            }
         }
-        
-        /* Write data for iteration i=cycles-1 */
-        for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            start_write_time = MPI_Wtime();
-#endif
-            ret = write_init (fh, aggregators[i], aggr_data[i], write_chunksize );
+    } /* end  for (index = 0; index <= cycles; index++) */
+
+    start_write_time = MPI_Wtime();
+    for (l=0; l < num_stages * dynamic_gen2_num_io_procs; l++ ) {
+        if ( MPI_REQUEST_NULL != req_iwrite[l] ) {
+            ret = ompi_request_wait(&req_iwrite[l], MPI_STATUS_IGNORE);
             if (OMPI_SUCCESS != ret){
                 goto exit;
-            }                    
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            end_write_time = MPI_Wtime();
-            write_time += end_write_time - start_write_time;
-#endif
+            }
         }
     }
+    end_write_time = MPI_Wtime();
+    write_time += end_write_time - start_write_time;
 
-        
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_exch = MPI_Wtime();
     exch_write += end_exch - start_exch;
-    nentry.time[0] = write_time;
-    nentry.time[1] = comm_time;
-    nentry.time[2] = exch_write;
-    nentry.aggregator = 0;
-    for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
-        if (aggregators[i] == fh->f_rank)
-	nentry.aggregator = 1;
-    }
-    nentry.nprocs_for_coll = dynamic_gen2_num_io_procs;
-    if (!mca_common_ompio_full_print_queue(fh->f_coll_write_time)){
-        mca_common_ompio_register_print_entry(fh->f_coll_write_time,
-                                               nentry);
+    if ( OMPIO_FCOLL_WANT_TIME_BREAKDOWN || OMPIO_MCA_GET(fh, coll_timing_info) ) {
+        /* time[0]: writing and waiting for the writes of the pipeline,
+           time[1]: shuffle, time[2]: the whole exchange phase */
+        nentry.time[0] = write_time;
+        nentry.time[1] = comm_time;
+        nentry.time[2] = exch_write;
+        nentry.aggregator = 0;
+        for ( i=0; i<dynamic_gen2_num_io_procs; i++ ) {
+            if (aggregators[i] == fh->f_rank)
+                nentry.aggregator = 1;
+        }
+        nentry.nprocs_for_coll = dynamic_gen2_num_io_procs;
+        if (!mca_common_ompio_full_print_queue(fh->f_coll_write_time)){
+            mca_common_ompio_register_print_entry(fh->f_coll_write_time,
+                                                  nentry);
+        }
     }
-#endif
     
     
 exit :
     
+    if ( NULL != req_iwrite ) {
+        /* the stage buffers might still be in use after an error */
+        for (l=0; l < num_stages * dynamic_gen2_num_io_procs; l++ ) {
+            if ( MPI_REQUEST_NULL != req_iwrite[l] &&
+                 OMPI_SUCCESS != ompi_request_wait(&req_iwrite[l], MPI_STATUS_IGNORE) ) {
+                ompi_request_free(&req_iwrite[l]);
+            }
+        }
+        free(req_iwrite);
+    }
+
     if ( NULL != aggr_data ) {
         
         for ( i=0; i< dynamic_gen2_num_io_procs; i++ ) {            
             if (aggregators[i] == fh->f_rank) {
-                if (NULL != aggr_data[i]->recvtype){
-                    for (j =0; j< aggr_data[i]->procs_per_group; j++) {
-                        if ( MPI_DATATYPE_NULL != aggr_data[i]->recvtype[j] ) {
-                            ompi_datatype_destroy(&aggr_data[i]->recvtype[j]);
-                        }
-                        if ( MPI_DATATYPE_NULL != aggr_data[i]->prev_recvtype[j] ) {
-                            ompi_datatype_destroy(&aggr_data[i]->prev_recvtype[j]);
+                if (NULL != aggr_data[i]->stages){
+                    for (stage=0; stage < num_stages; stage++ ) {
+                        if (NULL != aggr_data[i]->stages[stage].recvtype) {
+                            for (j =0; j< aggr_data[i]->procs_per_group; j++) {
+                                if ( MPI_DATATYPE_NULL != aggr_data[i]->stages[stage].recvtype[j] ) {
+                                    ompi_datatype_destroy(&aggr_data[i]->stages[stage].recvtype[j]);
+                                }
+                            }
                         }
-
+                        free (aggr_data[i]->stages[stage].recvtype);
+                        free (aggr_data[i]->stages[stage].global_buf);
+                        free (aggr_data[i]->stages[stage].io_array);
                     }
-                    free(aggr_data[i]->recvtype);
-                    free(aggr_data[i]->prev_recvtype);
+                    free (aggr_data[i]->stages);
                 }
                 
                 free (aggr_data[i]->disp_index);
                 free (aggr_data[i]->max_disp_index);
-                free (aggr_data[i]->global_buf);
-                free (aggr_data[i]->prev_global_buf);
                 for(l=0;l<aggr_data[i]->procs_per_group;l++){
                     free (aggr_data[i]->blocklen_per_process[l]);
                     free (aggr_data[i]->displs_per_process[l]);
@@ -726,8 +770,7 @@ exit :
     free(fh->f_procs_in_group);
     fh->f_procs_in_group=NULL;
     fh->f_procs_per_group=0;
-    free(reqs1);
-    free(reqs2);
+    free(reqs);
     free(result_counts);
 
      
@@ -735,31 +778,64 @@ exit :
 }
 
 
-static int write_init (ompio_file_t *fh, int aggregator, mca_io_ompio_aggregator_data *aggr_data, int write_chunksize )
+static int write_init (ompio_file_t *fh,
+                       int aggregator,
+                       mca_io_ompio_aggregator_stage *stage,
+                       int write_chunksize,
+                       int write_synchType,
+                       ompi_request_t **request )
 {
     int ret=OMPI_SUCCESS;
     int last_array_pos=0;
     int last_pos=0;
-        
-
-    if ( aggregator == fh->f_rank && aggr_data->prev_num_io_entries) {
-        while ( aggr_data->prev_bytes_to_write > 0 ) {                    
-            aggr_data->prev_bytes_to_write -= mca_fcoll_dynamic_gen2_split_iov_array (fh, aggr_data->prev_io_array, 
-                                                                                      aggr_data->prev_num_io_entries, 
-                                                                                      &last_array_pos, &last_pos,
-                                                                                      write_chunksize );
+    mca_ompio_request_t *ompio_req = NULL;
+
+    mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_WRITE );
+
+    if ( aggregator == fh->f_rank && stage->num_io_entries) {
+        if (1 == write_synchType) {
+            /* the whole cycle is written by one asynchronous operation */
+            mca_fcoll_dynamic_gen2_split_iov_array (fh, stage->io_array,
+                                                    stage->num_io_entries,
+                                                    &last_array_pos, &last_pos,
+                                                    stage->bytes_to_write );
+            ret = fh->f_fbtl->fbtl_ipwritev(fh, (ompi_request_t *) ompio_req);
+            if (OMPI_SUCCESS == ret && NULL != ompio_req->req_progress_fn) {
+                mca_common_ompio_register_progress ();
+                stage->bytes_to_write = 0;
+            }
+            else {
+                /* the write could not be started, do it synchronously */
+                opal_output (1, "dynamic_gen2_write_all: fbtl_ipwritev failed\n");
+                free ( fh->f_io_array );
+                last_array_pos = 0;
+                last_pos = 0;
+                ret = OMPI_SUCCESS;
+            }
+        }
+        while ( stage->bytes_to_write > 0 ) {                    
+            stage->bytes_to_write -= mca_fcoll_dynamic_gen2_split_iov_array (fh, stage->io_array, 
+                                                                             stage->num_io_entries, 
+                                                                             &last_array_pos, &last_pos,
+                                                                             write_chunksize );
             if ( 0 >  fh->f_fbtl->fbtl_pwritev (fh)) {
-                free ( aggr_data->prev_io_array);
                 opal_output (1, "dynamic_gen2_write_all: fbtl_pwritev failed\n");
                 ret = OMPI_ERROR;
-                goto exit;
+                break;
             }
         }
         free ( fh->f_io_array );
-        free ( aggr_data->prev_io_array);
+        free ( stage->io_array);
+        stage->io_array = NULL;
+        stage->num_io_entries = 0;
     } 
 
-exit:
+    if ( NULL == ompio_req->req_progress_fn ) {
+        ompio_req->req_ompi.req_status.MPI_ERROR = ret;
+        ompio_req->req_ompi.req_status._ucount = 0;
+        ompi_request_complete (&ompio_req->req_ompi, false);
+    }
+    *request = (ompi_request_t *) ompio_req;
 
     fh->f_io_array=NULL;
     fh->f_num_of_io_entries=0;
@@ -1567,6 +1643,11 @@ int mca_fcoll_dynamic_gen2_get_configuration (ompio_file_t *fh, int *dynamic_gen
     if ( num_io_procs > fh->f_size ) {
         num_io_procs = fh->f_size;
     }
+    if ( 0 < mca_common_ompio_stripe_unit (fh) ) {
+        /* stripe k is written by aggregator k % num_io_procs, keep a single
+           aggregator per stripe target if there are fewer processes than targets */
+        num_io_procs = mca_common_ompio_stripe_num_aggrs (fh, num_io_procs);
+    }
 
     fh->f_procs_per_group = fh->f_size;
     fh->f_procs_in_group = (int *) malloc ( sizeof(int) * fh->f_size );
@@ -397,6 +397,9 @@ mca_fcoll_two_phase_file_read_all (ompio_file_t *fh,
 	   fh->f_rank,interleave_count);
 #endif
 
+    /* align the file domains to the stripes of the file system, if known */
+    striping_unit = (int) mca_common_ompio_stripe_unit (fh);
+
     ret = mca_fcoll_two_phase_domain_partition(fh,
 					       start_offsets,
 					       end_offsets,
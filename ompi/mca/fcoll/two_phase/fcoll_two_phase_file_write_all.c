@@ -456,6 +456,9 @@ mca_fcoll_two_phase_file_write_all (ompio_file_t *fh,
 #endif
 
 
+    /* align the file domains to the stripes of the file system, if known */
+    striping_unit = (int) mca_common_ompio_stripe_unit (fh);
+
     ret = mca_fcoll_two_phase_domain_partition(fh,
 					       start_offsets,
 					       end_offsets,
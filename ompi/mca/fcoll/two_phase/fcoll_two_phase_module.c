@@ -27,6 +27,7 @@
 #include "mpi.h"
 #include "ompi/mca/fcoll/fcoll.h"
 #include "ompi/mca/fcoll/base/base.h"
+#include "ompi/mca/common/ompio/common_ompio_compress.h"
 
 
 /*
@@ -62,6 +63,12 @@ mca_fcoll_two_phase_component_file_query (ompio_file_t *fh, int *priority)
         return NULL;
     }
 
+    /* data sieving would fill the holes of a write from the local index
+       of a compressed file, which misses unsynced writes of others */
+    if (mca_common_ompio_compress_in_use (fh)) {
+        return NULL;
+    }
+
     if (mca_fcoll_base_query_table (fh, "two_phase")) {
         if (*priority < 35) {
             *priority = 35;
@@ -69,6 +69,14 @@ int mca_fcoll_two_phase_domain_partition (ompio_file_t *fh,
     if (fd_size < min_fd_size)
 	fd_size = min_fd_size;
 
+    if (striping_unit > 0 && 0 != fd_size % striping_unit) {
+	/* whole stripes per domain, so that aligning the boundaries below
+	   moves every one of them by the same amount. The rounding can leave
+	   the last aggregators without data, their domains are marked as
+	   empty (-1) at the end. */
+	fd_size = (fd_size / striping_unit + 1) * striping_unit;
+    }
+
     *fd_st_ptr = (OMPI_MPI_OFFSET_TYPE *)
 	malloc(nprocs_for_coll*sizeof(OMPI_MPI_OFFSET_TYPE));
 
@@ -44,6 +44,7 @@ int mca_fcoll_vulcan_priority = 10;
 int mca_fcoll_vulcan_num_groups = 1;
 int mca_fcoll_vulcan_write_chunksize = -1;
 int mca_fcoll_vulcan_async_io = 0;
+int mca_fcoll_vulcan_pipeline_depth = 2;
 
 /*
  * Local function
@@ -105,11 +106,20 @@ vulcan_register(void)
 
     mca_fcoll_vulcan_async_io = 0;
     (void) mca_base_component_var_register(&mca_fcoll_vulcan_component.fcollm_version,
-                                           "async_io", "Asynchronous I/O support options. 0: Automatic choice (default) "
-                                           "1: Asynchronous I/O only. 2: Synchronous I/O only.",
+                                           "async_io", "Asynchronous I/O support options. 0: Automatic choice for writes, "
+                                           "synchronous reads (default) 1: Asynchronous I/O only. 2: Synchronous I/O only.",
                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY, &mca_fcoll_vulcan_async_io);
 
+    mca_fcoll_vulcan_pipeline_depth = 2;
+    (void) mca_base_component_var_register(&mca_fcoll_vulcan_component.fcollm_version,
+                                           "pipeline_depth", "Number of cycles of a collective read or write that are in flight "
+                                           "at the same time, overlapping data shuffle and file access (minimum and default: 2). "
+                                           "The collective buffer is divided evenly among them.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fcoll_vulcan_pipeline_depth);
+
     return OMPI_SUCCESS;
 }
@@ -27,6 +27,7 @@
 #include "ompi/mca/fcoll/fcoll.h"
 #include "ompi/mca/fcoll/base/fcoll_base_coll_array.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
+#include "ompi/mca/common/ompio/common_ompio_buffer.h"
 #include "ompi/mca/io/io.h"
 #include "ompi/mca/common/ompio/common_ompio_request.h"
 #include "math.h"
@@ -45,23 +46,35 @@ typedef struct mca_io_ompio_local_io_array{
     int                  process_id;
 }mca_io_ompio_local_io_array;
 
+/* Buffers of one stage of the write pipeline at an aggregator. A stage
+   holds the data of one cycle from the start of its shuffle until the
+   write of that cycle has completed. */
+typedef struct mca_io_ompio_aggregator_stage {
+    char *global_buf;
+    ompi_datatype_t **recvtype;
+    mca_common_ompio_io_array_t *io_array;
+    int num_io_entries;
+    int bytes_to_write;
+} mca_io_ompio_aggregator_stage;
+
 typedef struct mca_io_ompio_aggregator_data {
     int *disp_index, *sorted, *fview_count, n;
     int *max_disp_index;
     int **blocklen_per_process;
     MPI_Aint **displs_per_process, total_bytes, bytes_per_cycle, total_bytes_written;
     MPI_Comm comm;
-    char *buf, *global_buf, *prev_global_buf;
-    ompi_datatype_t **recvtype, **prev_recvtype;
+    char *buf, *global_buf;
+    ompi_datatype_t **recvtype;
     struct iovec *global_iov_array;
     int current_index, current_position;
     int bytes_to_write_in_cycle, bytes_remaining, procs_per_group;    
     int *procs_in_group, iov_index;
-    int bytes_sent, prev_bytes_sent;
+    int bytes_sent;
     struct iovec *decoded_iov;
-    int bytes_to_write, prev_bytes_to_write;
-    mca_common_ompio_io_array_t *io_array, *prev_io_array;
-    int num_io_entries, prev_num_io_entries;
+    int bytes_to_write;
+    mca_common_ompio_io_array_t *io_array;
+    int num_io_entries;
+    mca_io_ompio_aggregator_stage *stages;
 } mca_io_ompio_aggregator_data;
 
 
@@ -70,20 +83,27 @@ typedef struct mca_io_ompio_aggregator_data {
     _r1=_r2;                     \
     _r2=_t;}
 
-#define SWAP_AGGR_POINTERS(_aggr,_num) {                        \
+/* let the next shuffle_init fill the buffers of stage _s */
+#define LOAD_AGGR_STAGE(_aggr,_num,_s) {                         \
+    int _i;                                                     \
+    for (_i=0; _i<_num; _i++ ) {                                \
+        if (NULL != _aggr[_i]->stages) {                        \
+            _aggr[_i]->global_buf=_aggr[_i]->stages[_s].global_buf; \
+            _aggr[_i]->recvtype=_aggr[_i]->stages[_s].recvtype;     \
+        }                                                       \
+    }                                                           \
+}
+
+/* remember the io array shuffle_init created for stage _s */
+#define STORE_AGGR_STAGE(_aggr,_num,_s) {                        \
     int _i;                                                     \
-    char *_t;                                                   \
     for (_i=0; _i<_num; _i++ ) {                                \
-        _aggr[_i]->prev_io_array=_aggr[_i]->io_array;             \
-        _aggr[_i]->prev_num_io_entries=_aggr[_i]->num_io_entries; \
-        _aggr[_i]->prev_bytes_sent=_aggr[_i]->bytes_sent;         \
-        _aggr[_i]->prev_bytes_to_write=_aggr[_i]->bytes_to_write; \
-        _t=_aggr[_i]->prev_global_buf;                            \
-        _aggr[_i]->prev_global_buf=_aggr[_i]->global_buf;         \
-        _aggr[_i]->global_buf=_t;                                 \
-        _t=(char *)_aggr[_i]->recvtype;                           \
-        _aggr[_i]->recvtype=_aggr[_i]->prev_recvtype;             \
-        _aggr[_i]->prev_recvtype=(ompi_datatype_t **)_t;          }                                                             \
+        if (NULL != _aggr[_i]->stages) {                        \
+            _aggr[_i]->stages[_s].io_array=_aggr[_i]->io_array;             \
+            _aggr[_i]->stages[_s].num_io_entries=_aggr[_i]->num_io_entries; \
+            _aggr[_i]->stages[_s].bytes_to_write=_aggr[_i]->bytes_to_write; \
+        }                                                       \
+    }                                                           \
 }
 
 
@@ -91,7 +111,7 @@ typedef struct mca_io_ompio_aggregator_data {
 static int shuffle_init ( int index, int cycles, int aggregator, int rank, 
                           mca_io_ompio_aggregator_data *data, 
                           ompi_request_t **reqs );
-static int write_init (ompio_file_t *fh, int aggregator, mca_io_ompio_aggregator_data *aggr_data,
+static int write_init (ompio_file_t *fh, int aggregator, mca_io_ompio_aggregator_stage *stage,
                         int write_chunksize, int write_synchType, ompi_request_t **request);
 int mca_fcoll_vulcan_break_file_view ( struct iovec *decoded_iov, int iov_count, 
                                         struct iovec *local_iov_array, int local_count, 
@@ -133,8 +153,9 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
     uint32_t total_fview_count = 0;
     int local_count = 0;
     ompi_request_t **reqs = NULL;
-    ompi_request_t *req_iwrite = MPI_REQUEST_NULL;
+    ompi_request_t **req_iwrite = NULL;
     mca_io_ompio_aggregator_data **aggr_data=NULL;
+    int num_stages = 2, stage, prev_stage, num_reqs;
     
     int *displs = NULL;
     int vulcan_num_io_procs;
@@ -151,12 +172,10 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
     int write_synch_type = 2;
     int write_chunksize, *result_counts=NULL;
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     double write_time = 0.0, start_write_time = 0.0, end_write_time = 0.0;
     double comm_time = 0.0, start_comm_time = 0.0, end_comm_time = 0.0;
     double exch_write = 0.0, start_exch = 0.0, end_exch = 0.0;
     mca_common_ompio_print_entry nentry;
-#endif
     
     
     /**************************************************************************
@@ -175,9 +194,17 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
         goto exit;
     }
 
-    /* since we want to overlap 2 iterations, define the bytes_per_cycle to be half of what
-       the user requested */
-    bytes_per_cycle =bytes_per_cycle/2;
+    /* the pipeline keeps num_stages cycles in flight, each of them gets an equal
+       share of the buffer size the user requested */
+    num_stages = mca_fcoll_vulcan_pipeline_depth;
+    if ( num_stages < 2 ) {
+        num_stages = 2;
+    }
+    bytes_per_cycle = bytes_per_cycle/num_stages;
+    if ( (fh->f_flags & OMPIO_DIRECT_IO) && bytes_per_cycle > fh->f_fs_block_size ) {
+        /* cycles of aligned data fill whole blocks */
+        bytes_per_cycle -= bytes_per_cycle % fh->f_fs_block_size;
+    }
     write_chunksize = bytes_per_cycle;
     
     ret =   mca_common_ompio_decode_datatype ((struct ompio_file_t *) fh,
@@ -238,7 +265,26 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
      *************************************************************************/
     // Modifications for the even distribution:
     long domain_size;
+    size_t stripe_unit = mca_common_ompio_stripe_unit (fh);
+
     ret = mca_fcoll_vulcan_minmax ( fh, local_iov_array, local_count,  fh->f_num_aggrs, &domain_size);
+    if ( 0 < stripe_unit ) {
+        /* File domains consist of whole stripes. With several stripe targets the
+           stripes are assigned round-robin, so that each target is written by a
+           single aggregator (see mca_common_ompio_stripe_num_aggrs). */
+        if ( 1 < fh->f_stripe_count ) {
+            domain_size = (long) stripe_unit;
+        }
+        else {
+            domain_size = ((domain_size + stripe_unit - 1) / stripe_unit) * stripe_unit;
+        }
+    }
+    if ( fh->f_flags & OMPIO_DIRECT_IO ) {
+        /* with O_DIRECT the aggregators only write whole blocks, apart from
+           the ends of the accessed range */
+        long block = fh->f_fs_block_size;
+        domain_size = ((domain_size + block - 1) / block) * block;
+    }
     
     // broken_iov_arrays[0] contains broken_counts[0] entries to aggregator 0,
     // broken_iov_arrays[1] contains broken_counts[1] entries to aggregator 1, etc.
@@ -253,9 +299,7 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
     /**************************************************************************
      ** 3. Determine the total amount of data to be written and no. of cycles
      **************************************************************************/
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_comm_time = MPI_Wtime();
-#endif
     if ( 1 == mca_fcoll_vulcan_num_groups ) {
         ret = fh->f_comm->c_coll->coll_allreduce (MPI_IN_PLACE,
                                                   broken_total_lengths,
@@ -304,10 +348,8 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
         }    
     }
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_comm_time = MPI_Wtime();
     comm_time += (end_comm_time - start_comm_time);
-#endif
     
     cycles=0;
     for ( i=0; i<fh->f_num_aggrs; i++ ) {
@@ -325,9 +367,7 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
         goto exit;
     }
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     start_comm_time = MPI_Wtime();
-#endif
     if ( 1 == mca_fcoll_vulcan_num_groups ) {
         ret = fh->f_comm->c_coll->coll_allgather(broken_counts,
 						 fh->f_num_aggrs,
@@ -353,10 +393,8 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
     if( OMPI_SUCCESS != ret){
         goto exit;
     }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
     end_comm_time = MPI_Wtime();
     comm_time += (end_comm_time - start_comm_time);
-#endif
     
     /*************************************************************
      *** 4. Allgather the offset/lengths array from all processes
@@ -411,9 +449,7 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
             }            
         }
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         start_comm_time = MPI_Wtime();
-#endif
         if ( 1 == mca_fcoll_vulcan_num_groups ) {
             ret = fh->f_comm->c_coll->coll_allgatherv (broken_iov_arrays[i],
                                                       broken_counts[i],
@@ -441,10 +477,8 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
         if (OMPI_SUCCESS != ret){
             goto exit;
         }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         end_comm_time = MPI_Wtime();
         comm_time += (end_comm_time - start_comm_time);
-#endif
         
         /****************************************************************************************
          *** 5. Sort the global offset/lengths list based on the offsets.
@@ -523,47 +557,48 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
             }
         
             
-            aggr_data[i]->global_buf       = (char *) malloc (bytes_per_cycle);
-            aggr_data[i]->prev_global_buf  = (char *) malloc (bytes_per_cycle);
-            if (NULL == aggr_data[i]->global_buf || NULL == aggr_data[i]->prev_global_buf){
-                opal_output(1, "OUT OF MEMORY");
-                ret = OMPI_ERR_OUT_OF_RESOURCE;
-                goto exit;
-            }
-        
-            aggr_data[i]->recvtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group  * 
-                                                                  sizeof(ompi_datatype_t *));
-            aggr_data[i]->prev_recvtype = (ompi_datatype_t **) malloc (fh->f_procs_per_group  * 
-                                                                       sizeof(ompi_datatype_t *));
-            if (NULL == aggr_data[i]->recvtype || NULL == aggr_data[i]->prev_recvtype) {
+            aggr_data[i]->stages = (mca_io_ompio_aggregator_stage *) calloc (num_stages,
+                                                                             sizeof(mca_io_ompio_aggregator_stage));
+            if (NULL == aggr_data[i]->stages) {
                 opal_output (1, "OUT OF MEMORY\n");
                 ret = OMPI_ERR_OUT_OF_RESOURCE;
                 goto exit;
             }
-            for(l=0;l<fh->f_procs_per_group;l++){
-                aggr_data[i]->recvtype[l]      = MPI_DATATYPE_NULL;
-                aggr_data[i]->prev_recvtype[l] = MPI_DATATYPE_NULL;
+
+            for (stage=0; stage<num_stages; stage++) {
+                aggr_data[i]->stages[stage].global_buf = (char *) mca_common_ompio_alloc_aligned_buf (fh, bytes_per_cycle);
+                aggr_data[i]->stages[stage].recvtype   = (ompi_datatype_t **) malloc (fh->f_procs_per_group  *
+                                                                                      sizeof(ompi_datatype_t *));
+                if (NULL == aggr_data[i]->stages[stage].global_buf ||
+                    NULL == aggr_data[i]->stages[stage].recvtype) {
+                    opal_output (1, "OUT OF MEMORY\n");
+                    ret = OMPI_ERR_OUT_OF_RESOURCE;
+                    goto exit;
+                }
+                for(l=0;l<fh->f_procs_per_group;l++){
+                    aggr_data[i]->stages[stage].recvtype[l] = MPI_DATATYPE_NULL;
+                }
             }
         }
     
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
         start_exch = MPI_Wtime();
-#endif
     }    
 
-    reqs = (ompi_request_t **)malloc ((fh->f_procs_per_group + 1 )*fh->f_num_aggrs *sizeof(ompi_request_t *));
-
-    if ( NULL == reqs ) {
+    /* one set of shuffle requests per stage */
+    num_reqs = (fh->f_procs_per_group + 1 )*fh->f_num_aggrs;
+    reqs = (ompi_request_t **)malloc (num_stages * num_reqs *sizeof(ompi_request_t *));
+    req_iwrite = (ompi_request_t **)malloc (num_stages * sizeof(ompi_request_t *));
+    if ( NULL == reqs || NULL == req_iwrite ) {
         opal_output (1, "OUT OF MEMORY\n");
         ret = OMPI_ERR_OUT_OF_RESOURCE;
         goto exit;
     }
 
-    for (l=0,i=0; i < fh->f_num_aggrs; i++ ) {
-        for ( j=0; j< (fh->f_procs_per_group+1); j++ ) {
-            reqs[l] = MPI_REQUEST_NULL;
-            l++;
-        }
+    for (l=0; l < num_stages * num_reqs; l++ ) {
+        reqs[l] = MPI_REQUEST_NULL;
+    }
+    for (stage=0; stage < num_stages; stage++ ) {
+        req_iwrite[stage] = MPI_REQUEST_NULL;
     }
 
     // In fact it should be: if ((1 == mca_fcoll_vulcan_async_io) && (NULL != fh->f_fbtl->fbtl_ipwritev))
@@ -573,132 +608,138 @@ int mca_fcoll_vulcan_file_write_all (ompio_file_t *fh,
         write_synch_type = 1;
     }
 
-    if ( cycles > 0 ) {
-        for ( i=0; i<fh->f_num_aggrs; i++ ) {
-            ret = shuffle_init ( 0, cycles, fh->f_aggr_list[i], fh->f_rank, aggr_data[i],
-                                 &reqs[i*(fh->f_procs_per_group + 1)] );
-            if ( OMPI_SUCCESS != ret ) {
-                goto exit;
-            }
-        }
-        // Register progress function that should be used by ompi_request_wait
-        if (NOT_AGGR_INDEX != aggr_index)  {
-            mca_common_ompio_register_progress ();
-        }
+    // Register progress function that should be used by ompi_request_wait
+    if ( cycles > 0 && NOT_AGGR_INDEX != aggr_index ) {
+        mca_common_ompio_register_progress ();
     }
 
-    ret = ompi_request_wait_all ( (fh->f_procs_per_group + 1 )*fh->f_num_aggrs,
-                                  reqs, MPI_STATUS_IGNORE);
-
-    for (index = 1; index < cycles; index++) {
-        SWAP_AGGR_POINTERS(aggr_data, fh->f_num_aggrs);
-
-        if(NOT_AGGR_INDEX != aggr_index) {
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            start_write_time = MPI_Wtime();
-#endif
-            ret = write_init (fh, fh->f_aggr_list[aggr_index], aggr_data[aggr_index],
-                              write_chunksize, write_synch_type, &req_iwrite);
-            if (OMPI_SUCCESS != ret){
-                goto exit;
+    /*************************************************************************
+     *** 7. The pipeline. Step 'index' starts the shuffle of cycle 'index' into
+     ***    its stage, then completes the shuffle of cycle index-1 and starts
+     ***    writing it. Up to num_stages cycles are in flight, a stage is only
+     ***    reused after the write of the cycle it held before has finished.
+     *************************************************************************/
+    for (index = 0; index <= cycles; index++) {
+        stage      = index % num_stages;
+        prev_stage = (index + num_stages - 1) % num_stages;
+
+        if ( index < cycles ) {
+            if ( NOT_AGGR_INDEX != aggr_index && MPI_REQUEST_NULL != req_iwrite[stage] ) {
+                start_write_time = MPI_Wtime();
+                ret = ompi_request_wait(&req_iwrite[stage], MPI_STATUS_IGNORE);
+                if (OMPI_SUCCESS != ret){
+                    goto exit;
+                }
+                end_write_time = MPI_Wtime();
+                write_time += end_write_time - start_write_time;
             }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            end_write_time = MPI_Wtime();
-            write_time += end_write_time - start_write_time;
-#endif
-        }
 
-        for ( i=0; i<fh->f_num_aggrs; i++ ) {
-            ret = shuffle_init ( index, cycles, fh->f_aggr_list[i], fh->f_rank, aggr_data[i],
-                                 &reqs[i*(fh->f_procs_per_group + 1)] );
-            if ( OMPI_SUCCESS != ret ) {
-                goto exit;
+            start_comm_time = MPI_Wtime();
+            LOAD_AGGR_STAGE(aggr_data, fh->f_num_aggrs, stage);
+            for ( i=0; i<fh->f_num_aggrs; i++ ) {
+                ret = shuffle_init ( index, cycles, fh->f_aggr_list[i], fh->f_rank, aggr_data[i],
+                                     &reqs[stage*num_reqs + i*(fh->f_procs_per_group + 1)] );
+                if ( OMPI_SUCCESS != ret ) {
+                    goto exit;
+                }
             }
+            STORE_AGGR_STAGE(aggr_data, fh->f_num_aggrs, stage);
+            end_comm_time = MPI_Wtime();
+            comm_time += end_comm_time - start_comm_time;
         }
 
-        ret = ompi_request_wait_all ( (fh->f_procs_per_group + 1 )*fh->f_num_aggrs,
-                                      reqs, MPI_STATUS_IGNORE);
-        if (OMPI_SUCCESS != ret){
-            goto exit;
-        }
-
-        if(NOT_AGGR_INDEX != aggr_index) {
-            ret = ompi_request_wait(&req_iwrite, MPI_STATUS_IGNORE);
+        if ( 0 < index ) {
+            start_comm_time = MPI_Wtime();
+            ret = ompi_request_wait_all ( num_reqs, &reqs[prev_stage*num_reqs], MPI_STATUS_IGNORE);
             if (OMPI_SUCCESS != ret){
                 goto exit;
             }
-        }
-    } /* end  for (index = 0; index < cycles; index++) */
-
-    if ( cycles > 0 ) {
-        SWAP_AGGR_POINTERS(aggr_data,fh->f_num_aggrs);
-
-        if(NOT_AGGR_INDEX != aggr_index) {
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            start_write_time = MPI_Wtime();
-#endif
-            ret = write_init (fh, fh->f_aggr_list[aggr_index], aggr_data[aggr_index],
-                              write_chunksize, write_synch_type, &req_iwrite);
-            if (OMPI_SUCCESS != ret){
-                goto exit;
+            end_comm_time = MPI_Wtime();
+            comm_time += end_comm_time - start_comm_time;
+
+            if(NOT_AGGR_INDEX != aggr_index) {
+                start_write_time = MPI_Wtime();
+                ret = write_init (fh, fh->f_aggr_list[aggr_index], &aggr_data[aggr_index]->stages[prev_stage],
+                                  write_chunksize, write_synch_type, &req_iwrite[prev_stage]);
+                if (OMPI_SUCCESS != ret){
+                    goto exit;
+                }
+                end_write_time = MPI_Wtime();
+                write_time += end_write_time - start_write_time;
             }
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
-            end_write_time = MPI_Wtime();
-            write_time += end_write_time - start_write_time;
-#endif
         }
-
-        if(NOT_AGGR_INDEX != aggr_index) {
-            ret = ompi_request_wait(&req_iwrite, MPI_STATUS_IGNORE);
-            if (OMPI_SUCCESS != ret){
-                goto exit;
+    } /* end  for (index = 0; index <= cycles; index++) */
+
+    if ( NOT_AGGR_INDEX != aggr_index ) {
+        start_write_time = MPI_Wtime();
+        for (stage=0; stage < num_stages; stage++ ) {
+            if ( MPI_REQUEST_NULL != req_iwrite[stage] ) {
+                ret = ompi_request_wait(&req_iwrite[stage], MPI_STATUS_IGNORE);
+                if (OMPI_SUCCESS != ret){
+                    goto exit;
+                }
             }
         }
+        end_write_time = MPI_Wtime();
+        write_time += end_write_time - start_write_time;
     }
-        
-#if OMPIO_FCOLL_WANT_TIME_BREAKDOWN
+
     end_exch = MPI_Wtime();
     exch_write += end_exch - start_exch;
-    nentry.time[0] = write_time;
-    nentry.time[1] = comm_time;
-    nentry.time[2] = exch_write;
-    nentry.aggregator = 0;
-    for ( i=0; i<fh->f_num_aggrs; i++ ) {
-        if (fh->f_aggr_list[i] == fh->f_rank)
-	nentry.aggregator = 1;
-    }
-    nentry.nprocs_for_coll = fh->f_num_aggrs;
-    if (!mca_common_ompio_full_print_queue(fh->f_coll_write_time)){
-        mca_common_ompio_register_print_entry(fh->f_coll_write_time,
-                                               nentry);
+    if ( OMPIO_FCOLL_WANT_TIME_BREAKDOWN || OMPIO_MCA_GET(fh, coll_timing_info) ) {
+        /* time[0]: writing and waiting for the writes of the pipeline,
+           time[1]: shuffle, time[2]: the whole exchange phase */
+        nentry.time[0] = write_time;
+        nentry.time[1] = comm_time;
+        nentry.time[2] = exch_write;
+        nentry.aggregator = 0;
+        for ( i=0; i<fh->f_num_aggrs; i++ ) {
+            if (fh->f_aggr_list[i] == fh->f_rank)
+                nentry.aggregator = 1;
+        }
+        nentry.nprocs_for_coll = fh->f_num_aggrs;
+        if (!mca_common_ompio_full_print_queue(fh->f_coll_write_time)){
+            mca_common_ompio_register_print_entry(fh->f_coll_write_time,
+                                                  nentry);
+        }
     }
-#endif
     
     
 exit :
     
+    if ( NULL != req_iwrite ) {
+        /* the stage buffers might still be in use after an error */
+        for (stage=0; stage < num_stages; stage++ ) {
+            if ( MPI_REQUEST_NULL != req_iwrite[stage] &&
+                 OMPI_SUCCESS != ompi_request_wait(&req_iwrite[stage], MPI_STATUS_IGNORE) ) {
+                ompi_request_free(&req_iwrite[stage]);
+            }
+        }
+        free(req_iwrite);
+    }
+
     if ( NULL != aggr_data ) {
         
         for ( i=0; i< fh->f_num_aggrs; i++ ) {            
             if (fh->f_aggr_list[i] == fh->f_rank) {
-                if (NULL != aggr_data[i]->recvtype){
-                    for (j =0; j< aggr_data[i]->procs_per_group; j++) {
-                        if ( MPI_DATATYPE_NULL != aggr_data[i]->recvtype[j] ) {
-                            ompi_datatype_destroy(&aggr_data[i]->recvtype[j]);
+                if (NULL != aggr_data[i]->stages){
+                    for (stage=0; stage < num_stages; stage++ ) {
+                        if (NULL != aggr_data[i]->stages[stage].recvtype) {
+                            for (j =0; j< aggr_data[i]->procs_per_group; j++) {
+                                if ( MPI_DATATYPE_NULL != aggr_data[i]->stages[stage].recvtype[j] ) {
+                                    ompi_datatype_destroy(&aggr_data[i]->stages[stage].recvtype[j]);
+                                }
+                            }
                         }
-                        if ( MPI_DATATYPE_NULL != aggr_data[i]->prev_recvtype[j] ) {
-                            ompi_datatype_destroy(&aggr_data[i]->prev_recvtype[j]);
-                        }
-			
+                        free (aggr_data[i]->stages[stage].recvtype);
+                        free (aggr_data[i]->stages[stage].global_buf);
+                        free (aggr_data[i]->stages[stage].io_array);
                     }
-                    free(aggr_data[i]->recvtype);
-                    free(aggr_data[i]->prev_recvtype);
+                    free (aggr_data[i]->stages);
                 }
                 
                 free (aggr_data[i]->disp_index);
                 free (aggr_data[i]->max_disp_index);
-                free (aggr_data[i]->global_buf);
-                free (aggr_data[i]->prev_global_buf);
                 for(l=0;l<aggr_data[i]->procs_per_group;l++){
                     free (aggr_data[i]->blocklen_per_process[l]);
                     free (aggr_data[i]->displs_per_process[l]);
@@ -739,7 +780,7 @@ exit :
 
 static int write_init (ompio_file_t *fh,
                        int aggregator,
-                       mca_io_ompio_aggregator_data *aggr_data,
+                       mca_io_ompio_aggregator_stage *stage,
                        int write_chunksize,
                        int write_synchType,
                        ompi_request_t **request )
@@ -752,25 +793,26 @@ static int write_init (ompio_file_t *fh,
 
     mca_common_ompio_request_alloc ( &ompio_req, MCA_OMPIO_REQUEST_WRITE );
 
-    if (aggr_data->prev_num_io_entries) {
-        /*  In this case, aggr_data->prev_num_io_entries is always == 1.
-            Therefore we can write the data of size aggr_data->prev_bytes_to_write in one iteration.
-            In fact, aggr_data->prev_bytes_to_write <= write_chunksize.
+    if (stage->num_io_entries) {
+        /*  In this case, stage->num_io_entries is always == 1.
+            Therefore we can write the data of size stage->bytes_to_write in one iteration.
+            In fact, stage->bytes_to_write <= write_chunksize.
         */
-        mca_fcoll_vulcan_split_iov_array (fh, aggr_data->prev_io_array,
-                                          aggr_data->prev_num_io_entries,
+        mca_fcoll_vulcan_split_iov_array (fh, stage->io_array,
+                                          stage->num_io_entries,
                                           &last_array_pos, &last_pos,
                                           write_chunksize);
 
         if (1 == write_synchType) {
             ret = fh->f_fbtl->fbtl_ipwritev(fh, (ompi_request_t *) ompio_req);
-            if(0 > ret) {
+            if (OMPI_SUCCESS != ret || NULL == ompio_req->req_progress_fn) {
+                /* the write could not be started, do it synchronously */
                 opal_output (1, "vulcan_write_all: fbtl_ipwritev failed\n");
-                ompio_req->req_ompi.req_status.MPI_ERROR = ret;
-                ompio_req->req_ompi.req_status._ucount = 0;
+                write_synchType = 2;
+                ret = OMPI_SUCCESS;
             }
         }
-        else {
+        if (1 != write_synchType) {
             ret_temp = fh->f_fbtl->fbtl_pwritev(fh);
             if(0 > ret_temp) {
                 opal_output (1, "vulcan_write_all: fbtl_pwritev failed\n");
@@ -784,7 +826,9 @@ static int write_init (ompio_file_t *fh,
         }
 
         free(fh->f_io_array);
-        free(aggr_data->prev_io_array);
+        free(stage->io_array);
+        stage->io_array = NULL;
+        stage->num_io_entries = 0;
     }
     else {
         ompio_req->req_ompi.req_status.MPI_ERROR = OMPI_SUCCESS;
@@ -30,6 +30,10 @@
 
 extern int mca_fs_ufs_priority;
 extern int mca_fs_ufs_lock_algorithm;
+extern int mca_fs_ufs_stripe_size;
+extern int mca_fs_ufs_stripe_width;
+extern int mca_fs_ufs_direct_io;
+extern int mca_fs_ufs_direct_io_alignment;
 
 #define FS_UFS_LOCK_AUTO        0
 #define FS_UFS_LOCK_NEVER       1
@@ -32,6 +32,10 @@
 
 int mca_fs_ufs_priority = 10;
 int mca_fs_ufs_lock_algorithm=0; /* auto */
+int mca_fs_ufs_stripe_size=0;
+int mca_fs_ufs_stripe_width=0;
+int mca_fs_ufs_direct_io=0;
+int mca_fs_ufs_direct_io_alignment=4096;
 /*
  * Private functions
  */
@@ -91,5 +95,45 @@ static int register_component(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_fs_ufs_lock_algorithm );
 
+    mca_fs_ufs_stripe_size = 0;
+    (void) mca_base_component_var_register(&mca_fs_ufs_component.fsm_version,
+                                           "stripe_size", "Stripe size reported for files on a ufs file system, "
+                                           "emulating a striped (e.g. Lustre) file system for the collective "
+                                           "I/O algorithms. The data layout is not changed. 0: not striped (default)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fs_ufs_stripe_size );
+
+    mca_fs_ufs_stripe_width = 0;
+    (void) mca_base_component_var_register(&mca_fs_ufs_component.fsm_version,
+                                           "stripe_width", "Stripe count reported for files on a ufs file system "
+                                           "if stripe_size is set. Default: 1",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fs_ufs_stripe_width );
+
+    mca_fs_ufs_direct_io = 0;
+    (void) mca_base_component_var_register(&mca_fs_ufs_component.fsm_version,
+                                           "direct_io", "Open files with O_DIRECT, bypassing the page cache. "
+                                           "Can be overridden per file with the ompio_direct_io info key. "
+                                           "Files on file systems that do not support O_DIRECT are opened "
+                                           "without it. 0: disabled (default), 1: enabled",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fs_ufs_direct_io );
+
+    mca_fs_ufs_direct_io_alignment = 4096;
+    (void) mca_base_component_var_register(&mca_fs_ufs_component.fsm_version,
+                                           "direct_io_alignment", "Alignment in bytes of file offsets, lengths and "
+                                           "buffers of O_DIRECT transfers, a multiple of the logical block size "
+                                           "of the device. Default: 4096",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_fs_ufs_direct_io_alignment );
+
     return OMPI_SUCCESS;
 }
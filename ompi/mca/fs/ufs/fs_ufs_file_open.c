@@ -25,6 +25,8 @@
 #include "fs_ufs.h"
 
 #include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
 #include <sys/stat.h>
 #include "mpi.h"
 #include "ompi/constants.h"
@@ -33,6 +35,21 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/info/info.h"
 #include "opal/util/path.h"
+#include "opal/util/output.h"
+
+#ifdef O_DIRECT
+/* Flags of a descriptor opened with O_DIRECT. Blocks that are written
+   only partially are read first, write-only files are therefore opened
+   for reading as well. */
+static int fs_ufs_direct_amode (int amode)
+{
+    amode &= ~(O_CREAT | O_EXCL);
+    if ( O_WRONLY == (amode & O_ACCMODE) ) {
+        amode = (amode & ~O_ACCMODE) | O_RDWR;
+    }
+    return amode | O_DIRECT;
+}
+#endif
 
 /*
  *	file_open_ufs
@@ -50,34 +67,89 @@ mca_fs_ufs_file_open (struct ompi_communicator_t *comm,
 {
     int amode, perm;
     int ret=OMPI_SUCCESS;
+    /* return code and O_DIRECT usage of the first process */
+    int result[2] = {OMPI_SUCCESS, 0};
+#ifdef O_DIRECT
+    bool bval;
+    int flag;
+#endif
 
     perm = mca_fs_base_get_file_perm(fh);
     amode = mca_fs_base_get_file_amode(fh->f_rank, access_mode);
 
+#ifdef O_DIRECT
+    result[1] = mca_fs_ufs_direct_io;
+    opal_info_get_bool (info, "ompio_direct_io", &bval, &flag);
+    if ( flag ) {
+        /* Info object trumps mca parameter value */
+        result[1] = bval;
+        OMPIO_MCA_PRINT_INFO(fh, "ompio_direct_io", bval ? "true" : "false", "");
+    }
+    if ( 0 >= mca_fs_ufs_direct_io_alignment ) {
+        result[1] = 0;
+    }
+#endif
+
     /* Reset errno */
     errno = 0;
     if (OMPIO_ROOT == fh->f_rank) {
 	   fh->fd = open (filename, amode, perm);
         if ( 0 > fh->fd ) {
-            ret = mca_fs_base_get_mpi_err(errno);
+            result[0] = mca_fs_base_get_mpi_err(errno);
+        }
+#ifdef O_DIRECT
+        else if ( result[1] ) {
+            /* The file is created without O_DIRECT, which might not be
+               supported by the file system. Open it again to find out. */
+            int fd = open (filename, fs_ufs_direct_amode (amode), perm);
+            if ( 0 > fd ) {
+                opal_output_verbose (10, ompi_fs_base_framework.framework_output,
+                                     "fs:ufs: cannot open %s with O_DIRECT: %s",
+                                     filename, strerror(errno));
+                result[1] = 0;
+            }
+            else {
+                close (fh->fd);
+                fh->fd = fd;
+            }
         }
+#endif
     }
 
-    comm->c_coll->coll_bcast ( &ret, 1, MPI_INT, 0, comm, comm->c_coll->coll_bcast_module);
+    comm->c_coll->coll_bcast ( result, 2, MPI_INT, 0, comm, comm->c_coll->coll_bcast_module);
+    ret = result[0];
     if ( OMPI_SUCCESS != ret ) {
         fh->fd = -1;
         return ret;
     }
 
     if (OMPIO_ROOT != fh->f_rank) {
+#ifdef O_DIRECT
+        if ( result[1] ) {
+            amode = fs_ufs_direct_amode (amode);
+        }
+#endif
         fh->fd = open (filename, amode, perm);
         if ( 0 > fh->fd) {
             return mca_fs_base_get_mpi_err(errno);
         }
     }
 
+    if ( result[1] ) {
+        /* the fbtl transfers whole, aligned blocks of this size */
+        fh->f_flags |= OMPIO_DIRECT_IO;
+        fh->f_fs_block_size = mca_fs_ufs_direct_io_alignment;
+    }
+
     fh->f_stripe_size=0;
     fh->f_stripe_count=1;
+    if ( 0 < mca_fs_ufs_stripe_size ) {
+        /* emulated striping, only seen by the collective I/O algorithms */
+        fh->f_stripe_size = mca_fs_ufs_stripe_size;
+        if ( 0 < mca_fs_ufs_stripe_width ) {
+            fh->f_stripe_count = mca_fs_ufs_stripe_width;
+        }
+    }
 
     /* Need to check for NFS here. If the file system is not NFS but a regular UFS file system,
        we do not need to enforce locking. A regular XFS or EXT4 file system can only be used 
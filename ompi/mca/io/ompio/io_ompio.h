@@ -53,6 +53,13 @@ extern int mca_io_ompio_max_aggregators_ratio;
 extern int mca_io_ompio_aggregators_cutoff_threshold;
 extern int mca_io_ompio_overwrite_amode;
 extern int mca_io_ompio_verbose_info_parsing;
+extern int mca_io_ompio_read_cache_size;
+extern int mca_io_ompio_read_cache_block_size;
+extern int mca_io_ompio_read_cache_prefetch;
+extern int mca_io_ompio_write_behind_size;
+extern int mca_io_ompio_adaptive_aggregators;
+extern int mca_io_ompio_stripe_aligned;
+extern int mca_io_ompio_compress;
 
 OMPI_DECLSPEC extern int mca_io_ompio_coll_timing_info;
 
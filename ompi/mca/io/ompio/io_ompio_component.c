@@ -30,11 +30,14 @@
 #include "opal/class/opal_list.h"
 #include "opal/threads/mutex.h"
 #include "opal/mca/base/base.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "ompi/mca/io/io.h"
 #include "ompi/mca/fs/base/base.h"
 #include "io_ompio.h"
 #include "ompi/mca/common/ompio/common_ompio_request.h"
 #include "ompi/mca/common/ompio/common_ompio_buffer.h"
+#include "ompi/mca/common/ompio/common_ompio_cache.h"
+#include "ompi/mca/common/ompio/common_ompio_tuner.h"
 
 #ifdef HAVE_IME_NATIVE_H
 #include "ompi/mca/fs/ime/fs_ime.h"
@@ -50,6 +53,13 @@ int mca_io_ompio_max_aggregators_ratio=8;
 int mca_io_ompio_aggregators_cutoff_threshold=3;
 int mca_io_ompio_overwrite_amode = 1;
 int mca_io_ompio_verbose_info_parsing = 0;
+int mca_io_ompio_read_cache_size = 0;
+int mca_io_ompio_read_cache_block_size = 65536;
+int mca_io_ompio_read_cache_prefetch = 4;
+int mca_io_ompio_write_behind_size = 0;
+int mca_io_ompio_adaptive_aggregators = 0;
+int mca_io_ompio_stripe_aligned = 1;
+int mca_io_ompio_compress = 0;
 
 int mca_io_ompio_grouping_option=5;
 
@@ -237,6 +247,45 @@ static int register_component(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_io_ompio_aggregators_cutoff_threshold);
 
+    mca_io_ompio_adaptive_aggregators = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "adaptive_aggregators",
+                                           "Choose the number of aggregators and the collective buffer size "
+                                           "of blocking collective operations based on the throughput "
+                                           "measured in earlier operations on the same file, instead of the "
+                                           "static cost model. Not used if the number of aggregators is set "
+                                           "explicitly or with grouping options 1-4. 0: disabled (default) 1: enabled",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_adaptive_aggregators);
+
+    mca_common_ompio_aggregator_profile = NULL;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "aggregator_profile",
+                                           "Directory for the profiles of the collective I/O throughput "
+                                           "per file system used by adaptive_aggregators. Profiles are read "
+                                           "when a file is opened and updated when it is closed, so that "
+                                           "measurements carry over to later files and runs. Empty: "
+                                           "measurements are kept per file only (default)",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_common_ompio_aggregator_profile);
+
+    mca_io_ompio_stripe_aligned = 1;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "stripe_aligned",
+                                           "Align the file domains of collective writes to the stripes "
+                                           "reported by the fs component, and choose the automatic number "
+                                           "of aggregators such that every stripe target (OST) is accessed "
+                                           "by a single aggregator. Only used for striped file systems. "
+                                           "1: enabled (default) 0: disabled",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_stripe_aligned);
+
     mca_io_ompio_overwrite_amode = 1;
     (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
                                            "overwrite_amode",
@@ -260,6 +309,92 @@ static int register_component(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_io_ompio_verbose_info_parsing);
 
+    mca_io_ompio_read_cache_size = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "read_cache_size",
+                                           "Size in bytes of the per-file cache used by individual read "
+                                           "operations. Can be overridden per file with the "
+                                           "ompio_read_cache_size info key. 0: disabled (default)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_read_cache_size);
+
+    mca_io_ompio_read_cache_block_size = 65536;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "read_cache_block_size",
+                                           "Size in bytes of a read cache block. Accesses of at least "
+                                           "this size bypass the cache",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_read_cache_block_size);
+
+    mca_io_ompio_read_cache_prefetch = 4;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "read_cache_prefetch",
+                                           "Number of blocks read ahead once a sequential access "
+                                           "pattern has been detected. 0: no read-ahead",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_read_cache_prefetch);
+
+    mca_io_ompio_write_behind_size = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "write_behind_size",
+                                           "Size in bytes of the window used to coalesce small individual "
+                                           "write operations. Buffered data is written in aligned pieces of "
+                                           "this size. Can be overridden per file with the "
+                                           "ompio_write_behind_size info key. 0: disabled (default)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_write_behind_size);
+
+    mca_io_ompio_compress = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "compress",
+                                           "Store the data of new and empty files compressed with the block "
+                                           "codec of the compress framework, one block per collective buffer "
+                                           "cycle, followed by an index. Files written this way have to be "
+                                           "opened with this option again to be read, existing plain files "
+                                           "are accessed as they are. Can be overridden per file with the "
+                                           "ompio_compress info key. 0: disabled (default)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_compress);
+
+    (void) mca_base_component_pvar_register(&mca_io_ompio_component.io_version,
+                                            "read_cache_hits",
+                                            "Number of read cache block lookups served from the cache",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL, &mca_common_ompio_read_cache_hits);
+
+    (void) mca_base_component_pvar_register(&mca_io_ompio_component.io_version,
+                                            "read_cache_misses",
+                                            "Number of read cache block lookups that required a read "
+                                            "from the file",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL, &mca_common_ompio_read_cache_misses);
+
+    (void) mca_base_component_pvar_register(&mca_io_ompio_component.io_version,
+                                            "read_cache_prefetches",
+                                            "Number of read cache blocks requested by the sequential "
+                                            "read-ahead",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL, &mca_common_ompio_read_cache_prefetches);
+
     return OMPI_SUCCESS;
 }
 
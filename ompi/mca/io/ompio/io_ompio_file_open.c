@@ -40,6 +40,9 @@
 #include <math.h>
 #include "io_ompio.h"
 #include "ompi/mca/common/ompio/common_ompio_request.h"
+#include "ompi/mca/common/ompio/common_ompio_cache.h"
+#include "ompi/mca/common/ompio/common_ompio_wbuf.h"
+#include "ompi/mca/common/ompio/common_ompio_compress.h"
 #include "ompi/mca/topo/topo.h"
 
 int mca_io_ompio_file_open (ompi_communicator_t *comm,
@@ -113,6 +116,10 @@ int mca_io_ompio_file_preallocate (ompi_file_t *fh,
     ompi_status_public_t *status = NULL;
 
     data = (mca_common_ompio_data_t *) fh->f_io_selected_data;
+    if ( mca_common_ompio_compress_in_use (&data->ompio_fh) ) {
+        /* the physical size has no relation to the logical one */
+        return MPI_ERR_UNSUPPORTED_OPERATION;
+    }
 
     OPAL_THREAD_LOCK(&fh->f_lock);
     tmp = diskspace;
@@ -230,6 +237,9 @@ int mca_io_ompio_file_set_size (ompi_file_t *fh,
     mca_common_ompio_data_t *data;
 
     data = (mca_common_ompio_data_t *) fh->f_io_selected_data;
+    if ( mca_common_ompio_compress_in_use (&data->ompio_fh) ) {
+        return MPI_ERR_UNSUPPORTED_OPERATION;
+    }
 
     tmp = size;
     OPAL_THREAD_LOCK(&fh->f_lock);
@@ -251,6 +261,12 @@ int mca_io_ompio_file_set_size (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
+    mca_common_ompio_cache_invalidate (&data->ompio_fh);
+    ret = mca_common_ompio_wbuf_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
     ret = data->ompio_fh.f_fs->fs_file_set_size (&data->ompio_fh, size);
     if ( OMPI_SUCCESS != ret ) {
         opal_output(1, ",mca_io_ompio_file_set_size: error in fs->set_size\n");
@@ -265,6 +281,10 @@ int mca_io_ompio_file_set_size (ompi_file_t *fh,
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return ret;
     }
+    if ( NULL != data->ompio_fh.f_fbtl->fbtl_sync ) {
+        /* the fbtl might have cached the old size */
+        ret = data->ompio_fh.f_fbtl->fbtl_sync (&data->ompio_fh);
+    }
     OPAL_THREAD_UNLOCK(&fh->f_lock);
 
     return ret;
@@ -278,6 +298,12 @@ int mca_io_ompio_file_get_size (ompi_file_t *fh,
 
     data = (mca_common_ompio_data_t *) fh->f_io_selected_data;
     OPAL_THREAD_LOCK(&fh->f_lock);
+    /* the size must include the data still in the write-behind buffer */
+    ret = mca_common_ompio_wbuf_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
     ret = mca_common_ompio_file_get_size(&data->ompio_fh,size);
     OPAL_THREAD_UNLOCK(&fh->f_lock);
 
@@ -311,7 +337,7 @@ int mca_io_ompio_file_get_type_extent (ompi_file_t *fh,
 int mca_io_ompio_file_set_atomicity (ompi_file_t *fh,
                                      int flag)
 {
-    int tmp;
+    int tmp, ret;
     mca_common_ompio_data_t *data;
 
     data = (mca_common_ompio_data_t *) fh->f_io_selected_data;
@@ -335,6 +361,12 @@ int mca_io_ompio_file_set_atomicity (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
+    mca_common_ompio_cache_invalidate (&data->ompio_fh);
+    ret = mca_common_ompio_wbuf_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
     data->ompio_fh.f_atomicity = flag;
     OPAL_THREAD_UNLOCK(&fh->f_lock);
 
@@ -363,6 +395,14 @@ int mca_io_ompio_file_sync (ompi_file_t *fh)
     data = (mca_common_ompio_data_t *) fh->f_io_selected_data;
 
     OPAL_THREAD_LOCK(&fh->f_lock);
+    /* drop cached data (and complete outstanding read-ahead) so that
+       subsequent reads observe writes of other processes */
+    mca_common_ompio_cache_invalidate (&data->ompio_fh);
+    ret = mca_common_ompio_wbuf_flush (&data->ompio_fh);
+    if ( OMPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
     if ( !opal_list_is_empty (&mca_common_ompio_pending_requests) ) {
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return MPI_ERR_OTHER;
@@ -379,6 +419,19 @@ int mca_io_ompio_file_sync (ompi_file_t *fh)
         OPAL_THREAD_UNLOCK(&fh->f_lock);
         return ret;
     }
+    /* make the blocks written by each process known to all of them */
+    ret = mca_common_ompio_compress_sync (&data->ompio_fh);
+    if ( MPI_SUCCESS != ret ) {
+        OPAL_THREAD_UNLOCK(&fh->f_lock);
+        return ret;
+    }
+    if ( NULL != data->ompio_fh.f_fbtl->fbtl_sync ) {
+        ret = data->ompio_fh.f_fbtl->fbtl_sync (&data->ompio_fh);
+        if ( OMPI_SUCCESS != ret ) {
+            OPAL_THREAD_UNLOCK(&fh->f_lock);
+            return ret;
+        }
+    }
     ret = data->ompio_fh.f_fs->fs_file_sync (&data->ompio_fh);
     OPAL_THREAD_UNLOCK(&fh->f_lock);
 
@@ -455,8 +508,8 @@ int mca_io_ompio_file_seek (ompi_file_t *fh,
         }
         break;
     case MPI_SEEK_END:
-        ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh,
-                                                     &temp_offset2);
+        ret = mca_common_ompio_file_get_size (&data->ompio_fh,
+                                              &temp_offset2);
         mca_io_ompio_file_get_eof_offset (&data->ompio_fh,
                                           temp_offset2, &temp_offset);
         offset += temp_offset;
@@ -316,6 +316,9 @@ OBJ_CLASS_DECLARATION(ompi_osc_pt2pt_receive_t);
 
 extern bool ompi_osc_pt2pt_no_locks;
 
+/* processes the pending operations and receives of the component */
+int ompi_osc_pt2pt_component_progress (void);
+
 int ompi_osc_pt2pt_attach(struct ompi_win_t *win, void *base, size_t len);
 int ompi_osc_pt2pt_detach(struct ompi_win_t *win, const void *base);
 
@@ -694,6 +697,7 @@ static inline void osc_pt2pt_add_pending (ompi_osc_pt2pt_pending_t *pending)
 {
     OPAL_THREAD_SCOPED_LOCK(&mca_osc_pt2pt_component.pending_operations_lock,
                             opal_list_append (&mca_osc_pt2pt_component.pending_operations, &pending->super));
+    opal_progress_backoff_wake (ompi_osc_pt2pt_component_progress);
 }
 
 #define OSC_PT2PT_FRAG_TAG   0x10000
@@ -151,7 +151,7 @@ static int component_register (void)
     return OMPI_SUCCESS;
 }
 
-static int component_progress (void)
+int ompi_osc_pt2pt_component_progress (void)
 {
     int pending_count = opal_list_get_size (&mca_osc_pt2pt_component.pending_operations);
     int recv_count = opal_list_get_size (&mca_osc_pt2pt_component.pending_receives);
@@ -261,7 +261,7 @@ component_finalize(void)
     size_t num_modules;
 
     if (mca_osc_pt2pt_component.progress_enable) {
-	opal_progress_unregister (component_progress);
+	opal_progress_unregister (ompi_osc_pt2pt_component_progress);
     }
 
     if (0 !=
@@ -432,7 +432,7 @@ component_select(struct ompi_win_t *win, void **base, size_t size, int disp_unit
     if (OMPI_SUCCESS != ret) goto cleanup;
 
     if (!mca_osc_pt2pt_component.progress_enable) {
-	opal_progress_register (component_progress);
+	opal_progress_register (ompi_osc_pt2pt_component_progress);
 	mca_osc_pt2pt_component.progress_enable = true;
     }
 
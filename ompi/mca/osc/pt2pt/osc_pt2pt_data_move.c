@@ -1620,6 +1620,7 @@ static int ompi_osc_pt2pt_callback (ompi_request_t *request)
     OPAL_THREAD_LOCK(&mca_osc_pt2pt_component.pending_receives_lock);
     opal_list_append (&mca_osc_pt2pt_component.pending_receives, &recv->super);
     OPAL_THREAD_UNLOCK(&mca_osc_pt2pt_component.pending_receives_lock);
+    opal_progress_backoff_wake (ompi_osc_pt2pt_component_progress);
 
     return OMPI_SUCCESS;
 }
@@ -15,11 +15,16 @@
 
 int mca_pml_monitoring_add_comm(struct ompi_communicator_t* comm)
 {
+    int ret = mca_common_monitoring_add_comm(comm);
+    if( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
     return pml_selected_module.pml_add_comm(comm);
 }
 
 int mca_pml_monitoring_del_comm(struct ompi_communicator_t* comm)
 {
     mca_common_monitoring_coll_cache_name(comm);
+    mca_common_monitoring_del_comm(comm);
     return pml_selected_module.pml_del_comm(comm);
 }
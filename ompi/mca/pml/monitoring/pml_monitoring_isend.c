@@ -40,11 +40,12 @@ int mca_pml_monitoring_isend(const void *buf,
      * If this fails the destination is not part of my MPI_COM_WORLD
      * Lookup its name in the rank hastable to get its MPI_COMM_WORLD rank
      */
-    if(OPAL_SUCCESS == mca_common_monitoring_get_world_rank(dst, comm->c_remote_group, &world_rank)) {
+    if(mca_common_monitoring_sample() &&
+       OPAL_SUCCESS == mca_common_monitoring_get_world_rank(dst, comm->c_remote_group, &world_rank)) {
         size_t type_size, data_size;
         ompi_datatype_type_size(datatype, &type_size);
         data_size = count*type_size;
-        mca_common_monitoring_record_pml(world_rank, data_size, tag);
+        mca_common_monitoring_record_pml(comm, dst, world_rank, data_size, tag);
     }
 
     return pml_selected_module.pml_isend(buf, count, datatype,
@@ -61,11 +62,12 @@ int mca_pml_monitoring_send(const void *buf,
 {
     int world_rank;
     /* Are we sending to a peer from my own MPI_COMM_WORLD? */
-    if(OPAL_SUCCESS == mca_common_monitoring_get_world_rank(dst, comm->c_remote_group, &world_rank)) {
+    if(mca_common_monitoring_sample() &&
+       OPAL_SUCCESS == mca_common_monitoring_get_world_rank(dst, comm->c_remote_group, &world_rank)) {
         size_t type_size, data_size;
         ompi_datatype_type_size(datatype, &type_size);
         data_size = count*type_size;
-        mca_common_monitoring_record_pml(world_rank, data_size, tag);
+        mca_common_monitoring_record_pml(comm, dst, world_rank, data_size, tag);
     }
 
     return pml_selected_module.pml_send(buf, count, datatype,
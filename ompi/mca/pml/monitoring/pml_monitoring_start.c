@@ -37,13 +37,15 @@ int mca_pml_monitoring_start(size_t count,
         /**
          * If this fails the destination is not part of my MPI_COM_WORLD
          */
-        if(OPAL_SUCCESS == mca_common_monitoring_get_world_rank(pml_request->req_peer,
+        if(mca_common_monitoring_sample() &&
+           OPAL_SUCCESS == mca_common_monitoring_get_world_rank(pml_request->req_peer,
                                                                 pml_request->req_comm->c_remote_group,
 								&world_rank)) {
             size_t type_size, data_size;
             ompi_datatype_type_size(pml_request->req_datatype, &type_size);
             data_size = pml_request->req_count * type_size;
-            mca_common_monitoring_record_pml(world_rank, data_size, 1);
+            mca_common_monitoring_record_pml(pml_request->req_comm, pml_request->req_peer,
+                                             world_rank, data_size, 1);
         }
     }
     return pml_selected_module.pml_start(count, requests);
@@ -57,8 +57,11 @@ static opal_atomic_int32_t mca_pml_ob1_progress_needed = 0;
 int mca_pml_ob1_enable_progress(int32_t count)
 {
     int32_t progress_count = OPAL_ATOMIC_ADD_FETCH32(&mca_pml_ob1_progress_needed, count);
-    if( 1 < progress_count )
-        return 0;  /* progress was already on */
+    if( 1 < progress_count ) {
+        /* progress was already on, but may be backed off */
+        opal_progress_backoff_wake(mca_pml_ob1_progress);
+        return 0;
+    }
 
     opal_progress_register(mca_pml_ob1_progress);
     return 1;
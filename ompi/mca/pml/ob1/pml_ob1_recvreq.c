@@ -127,6 +127,7 @@ static int mca_pml_ob1_recv_request_cancel(struct ompi_request_t* ompi_request,
      * to true. Otherwise, the request will never be freed.
      */
     request->req_recv.req_base.req_pml_complete = true;
+    recv_req_backoff_release(request);
     OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
 
     ompi_request->req_status._cancelled = true;
@@ -1085,7 +1086,6 @@ static inline void append_recv_req_to_queue(opal_list_t *queue,
 {
     opal_list_append(queue, (opal_list_item_t*)req);
 
-#if OMPI_WANT_PERUSE
     /**
      * We don't want to generate this kind of event for MPI_Probe.
      */
@@ -1094,7 +1094,6 @@ static inline void append_recv_req_to_queue(opal_list_t *queue,
         PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_REQ_INSERT_IN_POSTED_Q,
                                 &(req->req_recv.req_base), PERUSE_RECV);
     }
-#endif
 }
 
 /*
@@ -1249,6 +1248,7 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
     req->req_rdma_idx = 0;
     req->req_pending = false;
     req->req_ack_sent = false;
+    req->req_backoff_held = false;
 
     MCA_PML_BASE_RECV_START(&req->req_recv);
 
@@ -1309,6 +1309,10 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
 #else
             append_recv_req_to_queue(queue, req);
 #endif
+        recv_req_backoff_hold(req, (OMPI_ANY_SOURCE == req->req_recv.req_base.req_peer) ?
+                              NULL : req->req_recv.req_base.req_proc,
+                              (req->req_recv.req_base.req_type == MCA_PML_REQUEST_IPROBE ||
+                               req->req_recv.req_base.req_type == MCA_PML_REQUEST_IMPROBE) ? 0 : 1);
         req->req_match_received = false;
         OB1_MATCHING_UNLOCK(&ob1_comm->matching_lock);
     } else {
@@ -52,6 +52,8 @@ struct mca_pml_ob1_recv_request_t {
     bool req_pending;
     bool req_ack_sent; /**< whether ack was sent to the sender */
     bool req_match_received; /**< Prevent request to be completed prematurely */
+    bool req_backoff_held; /**< the btls of req_backoff_endpoint are never backed off */
+    struct mca_bml_base_endpoint_t *req_backoff_endpoint; /**< NULL for all btls */
     opal_mutex_t lock;
     mca_bml_base_btl_t *rdma_bml;
     mca_btl_base_registration_handle_t *local_handle;
@@ -147,6 +149,33 @@ static inline void mca_pml_ob1_recv_request_fini (mca_pml_ob1_recv_request_t *re
                                (opal_free_list_item_t*)(recvreq));      \
     }
 
+/**
+ * Keep polling the btls the message of an unmatched receive can come
+ * through, those of the peer or all of them for MPI_ANY_SOURCE, until
+ * the request completes (count 1). Called with the matching lock held,
+ * so that the request cannot be matched before it is held. A probe
+ * that found nothing only wakes them (count 0), it is called again.
+ */
+static inline void recv_req_backoff_hold(mca_pml_ob1_recv_request_t *req, ompi_proc_t *proc,
+                                         int32_t count)
+{
+    if (OPAL_UNLIKELY(0 < opal_progress_backoff_max)) {
+        /* all btls if the peer is not connected yet */
+        req->req_backoff_endpoint = (NULL == proc) ? NULL :
+            (struct mca_bml_base_endpoint_t *) proc->proc_endpoints[OMPI_PROC_ENDPOINT_TAG_BML];
+        mca_bml_base_backoff_hold(req->req_backoff_endpoint, count);
+        req->req_backoff_held = (0 != count);
+    }
+}
+
+static inline void recv_req_backoff_release(mca_pml_ob1_recv_request_t *req)
+{
+    if (OPAL_UNLIKELY(req->req_backoff_held)) {
+        req->req_backoff_held = false;
+        mca_bml_base_backoff_hold(req->req_backoff_endpoint, -1);
+    }
+}
+
 /**
  * Complete receive request. Request structure cannot be accessed after calling
  * this function any more.
@@ -160,6 +189,8 @@ recv_request_pml_complete(mca_pml_ob1_recv_request_t *recvreq)
 
     if(false == recvreq->req_recv.req_base.req_pml_complete){
 
+        recv_req_backoff_release(recvreq);
+
         if(recvreq->req_recv.req_bytes_packed > 0) {
             PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_XFER_END,
                     &recvreq->req_recv.req_base, PERUSE_RECV );
@@ -1043,10 +1043,8 @@ cannot_pack:
         ob1_hdr_hton(hdr, MCA_PML_OB1_HDR_TYPE_FRAG,
                 sendreq->req_send.req_base.req_proc);
 
-#if OMPI_WANT_PERUSE
          PERUSE_TRACE_COMM_OMPI_EVENT(PERUSE_COMM_REQ_XFER_CONTINUE,
                  &(sendreq->req_send.req_base), size, PERUSE_SEND);
-#endif  /* OMPI_WANT_PERUSE */
 
 #if OPAL_CUDA_SUPPORT /* CUDA_ASYNC_SEND */
          /* At this point, check to see if the BTL is doing an asynchronous
@@ -57,6 +57,29 @@ OMPI_DECLSPEC int mca_sharedfp_base_find_available(bool enable_progress_threads,
 OMPI_DECLSPEC int mca_sharedfp_base_init_file (struct ompio_file_t *file);
 
 OMPI_DECLSPEC int mca_sharedfp_base_get_param (struct ompio_file_t *file, int keyval);
+
+/* advance the shared file pointer of a component by bytes_requested bytes,
+ * returning its previous value in offset */
+typedef int (*mca_sharedfp_base_request_position_fn_t) (struct ompio_file_t *file,
+                                                         OMPI_MPI_OFFSET_TYPE bytes_requested,
+                                                         OMPI_MPI_OFFSET_TYPE *offset);
+
+/**
+ * Determine the position of this process in an ordered operation in
+ * which every process accesses bytes bytes. An exclusive prefix sum
+ * over the byte counts gives the position relative to the start of the
+ * operation. The last process advances the shared file pointer once by
+ * the total through request_position and broadcasts its old value.
+ *
+ * On return offset holds the byte offset of this process and, if end is
+ * not NULL, end the value of the shared file pointer after the
+ * operation. Collective.
+ */
+OMPI_DECLSPEC int mca_sharedfp_base_ordered_position (struct ompio_file_t *file,
+                                                      OMPI_MPI_OFFSET_TYPE bytes,
+                                                      mca_sharedfp_base_request_position_fn_t request_position,
+                                                      OMPI_MPI_OFFSET_TYPE *offset,
+                                                      OMPI_MPI_OFFSET_TYPE *end);
 /*
  * Globals
  */
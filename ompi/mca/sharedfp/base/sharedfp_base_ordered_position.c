@@ -0,0 +1,67 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "opal/util/output.h"
+#include "ompi/mca/mca.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/base/base.h"
+
+#include "ompi/mca/common/ompio/common_ompio.h"
+
+int mca_sharedfp_base_ordered_position (ompio_file_t *fh,
+                                        OMPI_MPI_OFFSET_TYPE bytes,
+                                        mca_sharedfp_base_request_position_fn_t request_position,
+                                        OMPI_MPI_OFFSET_TYPE *offset,
+                                        OMPI_MPI_OFFSET_TYPE *end)
+{
+    OMPI_MPI_OFFSET_TYPE prefix = 0;
+    /* start offset, total number of bytes and error code of the last process */
+    OMPI_MPI_OFFSET_TYPE result[3] = {0, 0, OMPI_SUCCESS};
+    int root = fh->f_size - 1;
+    int ret;
+
+    ret = fh->f_comm->c_coll->coll_exscan (&bytes, &prefix, 1, OMPI_OFFSET_DATATYPE,
+                                           MPI_SUM, fh->f_comm,
+                                           fh->f_comm->c_coll->coll_exscan_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    /* the result of an exclusive scan is undefined on the first process */
+    if (0 == fh->f_rank) {
+        prefix = 0;
+    }
+
+    if (root == fh->f_rank) {
+        /* the last process knows the total, one update of the pointer */
+        result[1] = prefix + bytes;
+        result[2] = request_position (fh, result[1], &result[0]);
+    }
+
+    ret = fh->f_comm->c_coll->coll_bcast (result, 3, OMPI_OFFSET_DATATYPE, root,
+                                          fh->f_comm, fh->f_comm->c_coll->coll_bcast_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    if (OMPI_SUCCESS != result[2]) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "mca_sharedfp_base_ordered_position: updating the shared file pointer "
+                    "failed on process %d\n", root);
+        return (int) result[2];
+    }
+
+    *offset = result[0] + prefix;
+    if (NULL != end) {
+        *end = result[0] + result[1];
+    }
+
+    return OMPI_SUCCESS;
+}
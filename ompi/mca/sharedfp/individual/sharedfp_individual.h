@@ -54,6 +54,9 @@ OMPI_MODULE_DECLSPEC extern mca_sharedfp_base_component_2_0_0_t mca_sharedfp_ind
 
 int mca_sharedfp_individual_get_position(ompio_file_t *fh,
 					 OMPI_MPI_OFFSET_TYPE * offset);
+int mca_sharedfp_individual_request_position (ompio_file_t *fh,
+                                             OMPI_MPI_OFFSET_TYPE bytes_requested,
+                                             OMPI_MPI_OFFSET_TYPE *offset);
 int mca_sharedfp_individual_seek (ompio_file_t *fh,
                                   OMPI_MPI_OFFSET_TYPE offset, int whence);
 int mca_sharedfp_individual_file_open (struct ompi_communicator_t *comm,
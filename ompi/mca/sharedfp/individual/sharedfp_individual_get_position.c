@@ -34,3 +34,18 @@ mca_sharedfp_individual_get_position(ompio_file_t *fh,
     opal_output(0,"mca_sharedfp_individual_get_position: NOT IMPLEMENTED\n");
     return OMPI_SUCCESS;
 }
+
+/* The global offset is identical on all processes once the data of the
+ * individual files has been collected, it is advanced locally. */
+int
+mca_sharedfp_individual_request_position(ompio_file_t *fh,
+                                         OMPI_MPI_OFFSET_TYPE bytes_requested,
+                                         OMPI_MPI_OFFSET_TYPE *offset)
+{
+    struct mca_sharedfp_base_data_t *sh = fh->f_sharedfp_data;
+
+    *offset = sh->global_offset;
+    sh->global_offset += bytes_requested;
+
+    return OMPI_SUCCESS;
+}
@@ -83,13 +83,10 @@ int mca_sharedfp_individual_write_ordered_begin(ompio_file_t *fh,
                                                 struct ompi_datatype_t *datatype)
 {
     int ret = OMPI_SUCCESS;
-    int i = 0;
     size_t numofbytes = 0;
     size_t totalbytes = 0;
-    OMPI_MPI_OFFSET_TYPE *offbuff=NULL;
     OMPI_MPI_OFFSET_TYPE global_offset = 0;
-    OMPI_MPI_OFFSET_TYPE prev_offset = 0;
-    OMPI_MPI_OFFSET_TYPE temp = 0, offset = 0;
+    OMPI_MPI_OFFSET_TYPE offset = 0;
     mca_sharedfp_individual_header_record *headnode = NULL;
     struct mca_sharedfp_base_data_t *sh = NULL;
 
@@ -125,69 +122,12 @@ int mca_sharedfp_individual_write_ordered_begin(ompio_file_t *fh,
 	return ret;
     }
 
-    if ( 0 == fh->f_rank )  {
-	offbuff = (OMPI_MPI_OFFSET_TYPE *)malloc ( sizeof(OMPI_MPI_OFFSET_TYPE) * fh->f_size);
-	if (NULL == offbuff ) {
-	    return OMPI_ERR_OUT_OF_RESOURCE;
-	}
-    }
-
-    /*collect the total bytes to be written*/
-    ret = fh->f_comm->c_coll->coll_gather ( &totalbytes, 
-                                            1, 
-                                            OMPI_OFFSET_DATATYPE,
-                                            offbuff, 
-                                            1, 
-                                            OMPI_OFFSET_DATATYPE, 
-                                            0,
-                                            fh->f_comm, 
-                                            fh->f_comm->c_coll->coll_gather_module );
-
-    if ( OMPI_SUCCESS != ret ) {
-	opal_output(0,"sharedfp_individual_write_ordered_begin: Error in gatherring offsets \n");
-        goto exit;
-    }
-    
-    if ( 0 == fh->f_rank ) {
-        prev_offset = offbuff[0];
-        offbuff[0]   = sh->global_offset;
-
-        for (i = 1; i < fh->f_size ; i++){
-            temp = offbuff[i];
-            offbuff[i] = offbuff[i - 1] + prev_offset;
-            prev_offset = temp;
-        }
-
-        for (i = 0; i < fh->f_size; i++){
-            global_offset = offbuff[fh->f_size - 1] + prev_offset;
-        }
-    }
-
-
-    /* Scatter the results to the other processes */
-    ret = fh->f_comm->c_coll->coll_scatter ( offbuff, 
-                                             1, 
-                                             OMPI_OFFSET_DATATYPE,
-                                             &offset, 
-                                             1, 
-                                             OMPI_OFFSET_DATATYPE, 
-                                             0,
-                                             fh->f_comm, 
-                                             fh->f_comm->c_coll->coll_scatter_module );
+    ret = mca_sharedfp_base_ordered_position (fh, (OMPI_MPI_OFFSET_TYPE) totalbytes,
+                                              mca_sharedfp_individual_request_position,
+                                              &offset, &global_offset);
     if ( OMPI_SUCCESS != ret )  {
-	opal_output(0,"sharedfp_individual_write_ordered_begin: Error in scattering offsets \n");
-	goto exit;
-    }
-
-    ret = fh->f_comm->c_coll->coll_bcast ( &global_offset, 
-                                           1, 
-                                           OMPI_OFFSET_DATATYPE,
-                                           0, 
-                                           fh->f_comm, 
-                                           fh->f_comm->c_coll->coll_bcast_module );
-    if ( OMPI_SUCCESS != ret )  {
-	opal_output(0,"sharedfp_individual_write_ordered_begin: Error while bcasting global offset \n");
-	goto exit;
+	opal_output(0,"sharedfp_individual_write_ordered_begin: Error while computing the offsets \n");
+	return ret;
     }
 
     sh->global_offset = global_offset;
@@ -200,11 +140,6 @@ int mca_sharedfp_individual_write_ordered_begin(ompio_file_t *fh,
 	opal_output(0,"sharedfp_individual_write_ordered_begin: Error while writing the datafile \n");
     }
 
-exit:
-    if ( NULL != offbuff ) {
-	free ( offbuff);
-    }
-
     return ret;
 }
 
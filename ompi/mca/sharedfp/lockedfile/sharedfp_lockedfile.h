@@ -118,8 +118,8 @@ struct mca_sharedfp_lockedfile_data
 typedef struct mca_sharedfp_lockedfile_data lockedfile_data;
 
 
-int mca_sharedfp_lockedfile_request_position (struct mca_sharedfp_base_data_t * sh,
-                                              int bytes_requested,
+int mca_sharedfp_lockedfile_request_position (ompio_file_t *fh,
+                                              OMPI_MPI_OFFSET_TYPE bytes_requested,
                                               OMPI_MPI_OFFSET_TYPE * offset);
 /*
  * ******************************************************************
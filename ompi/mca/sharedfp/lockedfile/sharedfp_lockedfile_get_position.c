@@ -34,7 +34,6 @@ mca_sharedfp_lockedfile_get_position(ompio_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_sharedfp_base_module_t * shared_fp_base_module;
-    struct mca_sharedfp_base_data_t *sh = NULL;
 
     if(fh->f_sharedfp_data==NULL){
 	opal_output(ompi_sharedfp_base_framework.framework_output,
@@ -51,13 +50,10 @@ mca_sharedfp_lockedfile_get_position(ompio_file_t *fh,
             return ret;
         }
     }
-    /*Retrieve the shared file data struct*/
-    sh = fh->f_sharedfp_data;
-
     /*Requesting the offset to write 0 bytes,
      *returns the current offset w/o updating it
      */
-    ret = mca_sharedfp_lockedfile_request_position(sh,0,offset);
+    ret = mca_sharedfp_lockedfile_request_position(fh,0,offset);
 
     return ret;
 }
@@ -30,8 +30,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
-int mca_sharedfp_lockedfile_request_position(struct mca_sharedfp_base_data_t * sh,
-                                             int bytes_requested,
+int mca_sharedfp_lockedfile_request_position(ompio_file_t *fh,
+                                             OMPI_MPI_OFFSET_TYPE bytes_requested,
                                              OMPI_MPI_OFFSET_TYPE *offset)
 {
     int ret = OMPI_SUCCESS;
@@ -44,6 +44,7 @@ int mca_sharedfp_lockedfile_request_position(struct mca_sharedfp_base_data_t * s
     OMPI_MPI_OFFSET_TYPE buf;
     /*int count = 1;*/
 
+    struct mca_sharedfp_base_data_t *sh = fh->f_sharedfp_data;
     struct mca_sharedfp_lockedfile_data * lockedfile_data = sh->selected_module_data;
     int handle = lockedfile_data->handle;
 
@@ -86,7 +87,7 @@ int mca_sharedfp_lockedfile_request_position(struct mca_sharedfp_base_data_t * s
     position = buf + bytes_requested;
     if ( mca_sharedfp_lockedfile_verbose ) {
         opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "sharedfp_lockedfile_request_position: old_offset=%lld, bytes_requested=%d, new offset=%lld!\n",
+                    "sharedfp_lockedfile_request_position: old_offset=%lld, bytes_requested=%lld, new offset=%lld!\n",
                     buf,bytes_requested,position);
     }
 
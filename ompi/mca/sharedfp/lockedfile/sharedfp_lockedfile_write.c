@@ -37,7 +37,6 @@ int mca_sharedfp_lockedfile_write (ompio_file_t *fh,
     OMPI_MPI_OFFSET_TYPE offset = 0;
     long bytesRequested = 0;
     size_t numofBytes;
-    struct mca_sharedfp_base_data_t *sh = NULL;
     int ret = OMPI_SUCCESS;
 
     if ( NULL == fh->f_sharedfp_data ){
@@ -54,11 +53,8 @@ int mca_sharedfp_lockedfile_write (ompio_file_t *fh,
                     "sharedfp_lockedfile_write: Bytes Requested is %ld\n",bytesRequested);
     }
 
-    /*Retrieve the shared file data struct*/
-    sh = fh->f_sharedfp_data;
-
     /* Request the offset to write bytesRequested bytes */
-    ret = mca_sharedfp_lockedfile_request_position ( sh, bytesRequested, &offset);
+    ret = mca_sharedfp_lockedfile_request_position ( fh, bytesRequested, &offset);
     offset /= fh->f_etype_size;
 
     if (-1 != ret )  {
@@ -81,102 +77,25 @@ int mca_sharedfp_lockedfile_write_ordered (ompio_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     OMPI_MPI_OFFSET_TYPE offset = 0;
-    long sendBuff = 0;
-    long *buff=NULL;
-    long offsetBuff;
-    OMPI_MPI_OFFSET_TYPE offsetReceived = 0;
-    long bytesRequested = 0;
-    int recvcnt = 1, sendcnt = 1;
+    OMPI_MPI_OFFSET_TYPE bytesRequested = 0;
     size_t numofBytes;
-    int rank, size, i;
-
-    struct mca_sharedfp_base_data_t *sh = NULL;
 
-    if( NULL == fh->f_sharedfp_data ) {
+    if ( NULL == fh->f_sharedfp_data ) {
         opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "sharedfp_lockedfile_write_ordered - framework not initialized\n");
+                    "sharedfp_lockedfile_write_ordered: module not initialized \n");
         return OMPI_ERROR;
     }
 
-    /*Retrieve the new communicator*/
-    sh = fh->f_sharedfp_data;
-
-    /* Calculate the number of bytes to write*/
+    /* Calculate the number of bytes to write */
     opal_datatype_type_size ( &datatype->super, &numofBytes);
-    sendBuff = count * numofBytes;
-
-    /* Get the ranks in the communicator */
-    rank = ompi_comm_rank ( fh->f_comm );
-    size = ompi_comm_size ( fh->f_comm );
-
-    if ( 0 == rank ) {
-        buff = (long*) malloc (sizeof(long) * size);
-        if ( NULL == buff ) {
-            return OMPI_ERR_OUT_OF_RESOURCE;
-	}
-    }
-
-    ret = fh->f_comm->c_coll->coll_gather ( &sendBuff, 
-                                            sendcnt, 
-                                            OMPI_OFFSET_DATATYPE, 
-                                            buff, 
-                                            recvcnt,
-                                            OMPI_OFFSET_DATATYPE, 
-                                            0, 
-                                            fh->f_comm,
-                                            fh->f_comm->c_coll->coll_gather_module );
-    if ( OMPI_SUCCESS != ret ) {
-	goto exit;
-    }
-
-    /* All the counts are present now in the recvBuff.
-       The size of recvBuff is sizeof_newComm
-     */
-    if (rank == 0) {
-        for ( i = 0; i < size ; i ++)  {
-            bytesRequested += buff[i];
-	    if ( mca_sharedfp_lockedfile_verbose ) {
-                opal_output(ompi_sharedfp_base_framework.framework_output,
-                            "sharedfp_lockedfile_write_ordered: Bytes requested are %ld\n",bytesRequested);
-	    }
-        }
-
-        /*Request the offset to write bytesRequested bytes
-          only the root process needs to do the request,
-          since the root process will then tell the other
-          processes at what offset they should write their
-          share of the data.
-         */
-        ret = mca_sharedfp_lockedfile_request_position(sh, bytesRequested,&offsetReceived);
-        if ( OMPI_SUCCESS != ret ){
-            goto exit;
-        }
-	if ( mca_sharedfp_lockedfile_verbose ) {
-            opal_output(ompi_sharedfp_base_framework.framework_output,
-                        "sharedfp_lockedfile_write_ordered: Offset received is %lld\n",offsetReceived);
-	}
-        buff[0] += offsetReceived;
-        for (i = 1 ; i < size; i++) {
-            buff[i] += buff[i-1];
-        }
-    }
+    bytesRequested = count * numofBytes;
 
-    /* Scatter the results to the other processes*/
-    ret = fh->f_comm->c_coll->coll_scatter ( buff, 
-                                             sendcnt, 
-                                             OMPI_OFFSET_DATATYPE,
-                                             &offsetBuff, 
-                                             recvcnt, 
-                                             OMPI_OFFSET_DATATYPE, 
-                                             0,
-                                             fh->f_comm, 
-                                             fh->f_comm->c_coll->coll_scatter_module );
+    ret = mca_sharedfp_base_ordered_position (fh, bytesRequested,
+                                              mca_sharedfp_lockedfile_request_position,
+                                              &offset, NULL);
     if ( OMPI_SUCCESS != ret ) {
-	goto exit;
+        return ret;
     }
-
-    /*Each process now has its own individual offset*/
-    offset = offsetBuff - sendBuff;
     offset /= fh->f_etype_size;
 
     if ( mca_sharedfp_lockedfile_verbose ) {
@@ -187,10 +106,5 @@ int mca_sharedfp_lockedfile_write_ordered (ompio_file_t *fh,
     /* write to the file */
     ret = mca_common_ompio_file_write_at_all(fh,offset,buf,count,datatype,status);
 
-exit:
-    if ( NULL != buff ) {
-	free ( buff);
-    }
-
     return ret;
 }
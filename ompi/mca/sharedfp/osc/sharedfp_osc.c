@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2006 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * These symbols are in a file by themselves to provide nice linker
+ * semantics. Since linkers generally pull in symbols by object fules,
+ * keeping these symbols as the only symbols in this file prevents
+ * utility programs such as "ompi_info" from having to import entire
+ * modules just to query their version and parameters
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/base/base.h"
+#include "ompi/mca/sharedfp/osc/sharedfp_osc.h"
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+ /* IMPORTANT: Update here when adding sharedfp component interface functions*/
+static mca_sharedfp_base_module_1_0_0_t osc =  {
+    mca_sharedfp_osc_module_init, /* initalise after being selected */
+    mca_sharedfp_osc_module_finalize, /* close a module on a communicator */
+    mca_sharedfp_osc_seek,
+    mca_sharedfp_osc_get_position,
+    mca_sharedfp_osc_read,
+    mca_sharedfp_osc_read_ordered,
+    mca_sharedfp_osc_read_ordered_begin,
+    mca_sharedfp_osc_read_ordered_end,
+    mca_sharedfp_osc_iread,
+    mca_sharedfp_osc_write,
+    mca_sharedfp_osc_write_ordered,
+    mca_sharedfp_osc_write_ordered_begin,
+    mca_sharedfp_osc_write_ordered_end,
+    mca_sharedfp_osc_iwrite,
+    mca_sharedfp_osc_file_open,
+    mca_sharedfp_osc_file_close
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+int mca_sharedfp_osc_component_init_query(bool enable_progress_threads,
+                                            bool enable_mpi_threads)
+{
+    /* Nothing to do */
+
+   return OMPI_SUCCESS;
+}
+
+struct mca_sharedfp_base_module_1_0_0_t * mca_sharedfp_osc_component_file_query(ompio_file_t *fh, int *priority)
+{
+    *priority = 0;
+
+    if ( OMPI_COMM_IS_INTER(fh->f_comm) ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "mca_sharedfp_osc_component_file_query: Disqualifying myself: (%d/%s) "
+                    "windows can not be created on an inter-communicator.",
+                    fh->f_comm->c_contextid, fh->f_comm->c_name);
+        return NULL;
+    }
+
+    /* This module can run on any set of processes, as long as an
+    ** osc component is available for the communicator. */
+    *priority = mca_sharedfp_osc_priority;
+    return &osc;
+}
+
+int mca_sharedfp_osc_component_file_unquery (ompio_file_t *file)
+{
+   /* This function might be needed for some purposes later. for now it
+    * does not have anything to do since there are no steps which need
+    * to be undone if this module is not selected */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_sharedfp_osc_module_init (ompio_file_t *file)
+{
+    return OMPI_SUCCESS;
+}
+
+
+int mca_sharedfp_osc_module_finalize (ompio_file_t *file)
+{
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_SHAREDFP_osc_H
+#define MCA_SHAREDFP_osc_H
+
+#include "ompi_config.h"
+#include "ompi/mca/mca.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/common/ompio/common_ompio.h"
+#include "ompi/win/win.h"
+
+BEGIN_C_DECLS
+
+int mca_sharedfp_osc_component_init_query(bool enable_progress_threads,
+                                                 bool enable_mpi_threads);
+struct mca_sharedfp_base_module_1_0_0_t *
+        mca_sharedfp_osc_component_file_query (ompio_file_t *file, int *priority);
+int mca_sharedfp_osc_component_file_unquery (ompio_file_t *file);
+
+int mca_sharedfp_osc_module_init (ompio_file_t *file);
+int mca_sharedfp_osc_module_finalize (ompio_file_t *file);
+
+extern int mca_sharedfp_osc_priority;
+extern int mca_sharedfp_osc_verbose;
+
+OMPI_MODULE_DECLSPEC extern mca_sharedfp_base_component_2_0_0_t mca_sharedfp_osc_component;
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */
+/*IMPORANT: Update here when implementing functions from sharedfp API*/
+int mca_sharedfp_osc_seek (ompio_file_t *fh,
+                                  OMPI_MPI_OFFSET_TYPE offset, int whence);
+int mca_sharedfp_osc_get_position (ompio_file_t *fh,
+                                          OMPI_MPI_OFFSET_TYPE * offset);
+int mca_sharedfp_osc_file_open (struct ompi_communicator_t *comm,
+                                       const char* filename,
+                                       int amode,
+                                       struct opal_info_t *info,
+                                       ompio_file_t *fh);
+int mca_sharedfp_osc_file_close (ompio_file_t *fh);
+int mca_sharedfp_osc_read (ompio_file_t *fh,
+                                  void *buf, int count, MPI_Datatype datatype, MPI_Status *status);
+int mca_sharedfp_osc_read_ordered (ompio_file_t *fh,
+                                          void *buf, int count, struct ompi_datatype_t *datatype,
+                                          ompi_status_public_t *status
+                                          );
+int mca_sharedfp_osc_read_ordered_begin (ompio_file_t *fh,
+                                                 void *buf,
+                                                 int count,
+                                                 struct ompi_datatype_t *datatype);
+int mca_sharedfp_osc_read_ordered_end (ompio_file_t *fh,
+                                               void *buf,
+                                               ompi_status_public_t *status);
+int mca_sharedfp_osc_iread (ompio_file_t *fh,
+                                    void *buf,
+                                    int count,
+                                    struct ompi_datatype_t *datatype,
+                                    ompi_request_t **request);
+int mca_sharedfp_osc_write (ompio_file_t *fh,
+                                   const void *buf,
+                                   int count,
+                                   struct ompi_datatype_t *datatype,
+                                   ompi_status_public_t *status);
+int mca_sharedfp_osc_write_ordered (ompio_file_t *fh,
+                                           const void *buf,
+                                           int count,
+                                           struct ompi_datatype_t *datatype,
+                                           ompi_status_public_t *status);
+int mca_sharedfp_osc_write_ordered_begin (ompio_file_t *fh,
+                                                 const void *buf,
+                                                 int count,
+                                                 struct ompi_datatype_t *datatype);
+int mca_sharedfp_osc_write_ordered_end (ompio_file_t *fh,
+                                               const void *buf,
+                                               ompi_status_public_t *status);
+int mca_sharedfp_osc_iwrite (ompio_file_t *fh,
+                                    const void *buf,
+                                    int count,
+                                    struct ompi_datatype_t *datatype,
+                                    ompi_request_t **request);
+/*--------------------------------------------------------------*
+ *Structures and definitions only for this component
+ *--------------------------------------------------------------*/
+/*This structure will hang off of the mca_sharedfp_base_data_t's
+ *selected_module_data attribute.
+ *
+ *The shared file pointer is a single offset exposed by rank 0 of the
+ *file communicator through an RMA window. It is updated with
+ *MPI_Fetch_and_op, so that no file locks or shared memory are required
+ *and the processes may be spread over several nodes. A passive target
+ *epoch on the window is kept open from file open to file close.
+ */
+struct mca_sharedfp_osc_data
+{
+    struct ompi_win_t *win;
+    OMPI_MPI_OFFSET_TYPE *offset_ptr;   /* window memory, valid on rank 0 only */
+};
+
+int mca_sharedfp_osc_request_position (ompio_file_t *fh,
+                                       OMPI_MPI_OFFSET_TYPE bytes_requested,
+                                       OMPI_MPI_OFFSET_TYPE * offset);
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */
+
+END_C_DECLS
+
+#endif /* MCA_SHAREDFP_osc_H */
@@ -0,0 +1,121 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_osc.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/base/base.h"
+#include "ompi/mca/osc/osc.h"
+#include "opal/util/info.h"
+
+int mca_sharedfp_osc_file_open (struct ompi_communicator_t *comm,
+                                const char* filename,
+                                int amode,
+                                struct opal_info_t *info,
+                                ompio_file_t *fh)
+{
+    int err = OMPI_SUCCESS;
+    struct mca_sharedfp_base_data_t* sh;
+    struct mca_sharedfp_osc_data * osc_data = NULL;
+    opal_info_t *win_info = NULL;
+    size_t win_size;
+
+    sh = (struct mca_sharedfp_base_data_t*)malloc(sizeof(struct mca_sharedfp_base_data_t));
+    if ( NULL == sh ) {
+        opal_output(0, "mca_sharedfp_osc_file_open: Error, unable to malloc f_sharedfp struct\n");
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    sh->global_offset = 0;
+    sh->selected_module_data = NULL;
+
+    osc_data = (struct mca_sharedfp_osc_data*) calloc (1, sizeof(struct mca_sharedfp_osc_data));
+    if ( NULL == osc_data ){
+        opal_output(0, "mca_sharedfp_osc_file_open: Error, unable to malloc osc_data struct\n");
+        free(sh);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* Only the first process exposes memory, one offset. The info
+    ** object of the file is not passed on, its hints are meant for the
+    ** file and not for the window. */
+    win_info = OBJ_NEW(opal_info_t);
+    if ( NULL == win_info ) {
+        free(osc_data);
+        free(sh);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    win_size = ( 0 == fh->f_rank ) ? sizeof(OMPI_MPI_OFFSET_TYPE) : 0;
+    err = ompi_win_allocate (win_size, sizeof(OMPI_MPI_OFFSET_TYPE), win_info, comm,
+                             &osc_data->offset_ptr, &osc_data->win);
+    OBJ_RELEASE(win_info);
+    if ( OMPI_SUCCESS != err ) {
+        opal_output(0, "mca_sharedfp_osc_file_open: Error, unable to create the window "
+                    "of the shared file pointer\n");
+        free(osc_data);
+        free(sh);
+        return err;
+    }
+
+    if ( 0 == fh->f_rank ) {
+        *osc_data->offset_ptr = 0;
+    }
+    /* the initial value has to be in place before the first update */
+    err = comm->c_coll->coll_barrier (comm, comm->c_coll->coll_barrier_module );
+    if ( OMPI_SUCCESS == err ) {
+        err = osc_data->win->w_osc_module->osc_lock_all (MPI_MODE_NOCHECK, osc_data->win);
+    }
+    if ( OMPI_SUCCESS != err ) {
+        opal_output(0,"mca_sharedfp_osc_file_open: Error, unable to start the access epoch\n");
+        ompi_win_free (osc_data->win);
+        free(osc_data);
+        free(sh);
+        return err;
+    }
+
+    if ( mca_sharedfp_osc_verbose ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "mca_sharedfp_osc_file_open: shared file pointer window created for %s\n",
+                    filename);
+    }
+
+    sh->selected_module_data = osc_data;
+    fh->f_sharedfp_data = sh;
+
+    return OMPI_SUCCESS;
+}
+
+int mca_sharedfp_osc_file_close (ompio_file_t *fh)
+{
+    int err = OMPI_SUCCESS;
+    struct mca_sharedfp_base_data_t *sh=NULL;
+    struct mca_sharedfp_osc_data * osc_data=NULL;
+
+    if( NULL == fh->f_sharedfp_data ){
+        return OMPI_SUCCESS;
+    }
+    sh = fh->f_sharedfp_data;
+
+    osc_data = (struct mca_sharedfp_osc_data *) sh->selected_module_data;
+    if ( NULL != osc_data ) {
+        /* completes all outstanding updates; freeing the window
+        ** synchronizes the processes */
+        err = osc_data->win->w_osc_module->osc_unlock_all (osc_data->win);
+        ompi_win_free (osc_data->win);
+        free(osc_data);
+    }
+
+    free(sh);
+    fh->f_sharedfp_data = NULL;
+
+    return err;
+}
@@ -0,0 +1,58 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_osc.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/base/base.h"
+#include "ompi/mca/osc/osc.h"
+
+int mca_sharedfp_osc_request_position(ompio_file_t *fh,
+                                      OMPI_MPI_OFFSET_TYPE bytes_requested,
+                                      OMPI_MPI_OFFSET_TYPE *offset)
+{
+    int ret;
+    OMPI_MPI_OFFSET_TYPE old_offset = 0;
+    struct mca_sharedfp_base_data_t *sh = NULL;
+    struct mca_sharedfp_osc_data * osc_data = NULL;
+    struct ompi_win_t *win;
+
+    sh = fh->f_sharedfp_data;
+    osc_data = sh->selected_module_data;
+    win = osc_data->win;
+
+    *offset = 0;
+
+    /* a single atomic operation on the first process; with zero bytes
+    ** the pointer is only read */
+    ret = win->w_osc_module->osc_fetch_and_op (&bytes_requested, &old_offset, OMPI_OFFSET_DATATYPE, 0, 0,
+                                               0 == bytes_requested ? MPI_NO_OP : MPI_SUM, win);
+    if ( OMPI_SUCCESS == ret ) {
+        ret = win->w_osc_module->osc_flush (0, win);
+    }
+    if ( OMPI_SUCCESS != ret ) {
+        opal_output(0, "mca_sharedfp_osc_request_position: Error %d updating the shared file pointer\n",
+                    ret);
+        return ret;
+    }
+
+    if ( mca_sharedfp_osc_verbose ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "old_offset=%lld, bytes_requested=%lld, new offset=%lld, rank=%d\n",
+                    old_offset,bytes_requested,old_offset+bytes_requested,fh->f_rank);
+    }
+
+    *offset = old_offset;
+
+    return OMPI_SUCCESS;
+}
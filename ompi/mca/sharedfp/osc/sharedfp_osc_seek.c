@@ -0,0 +1,120 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_osc.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/base/base.h"
+#include "ompi/mca/osc/osc.h"
+
+int
+mca_sharedfp_osc_seek (ompio_file_t *fh,
+                      OMPI_MPI_OFFSET_TYPE off, int whence)
+{
+    int status=0;
+    OMPI_MPI_OFFSET_TYPE offset, end_position=0;
+    int ret = OMPI_SUCCESS;
+    struct mca_sharedfp_base_data_t *sh = NULL;
+    struct mca_sharedfp_osc_data * osc_data = NULL;
+
+    if( NULL == fh->f_sharedfp_data ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "sharedfp_osc_seek: module not initialized \n");
+        return OMPI_ERROR;
+    }
+
+    sh = fh->f_sharedfp_data;
+    offset = off * fh->f_etype_size;
+
+    if( 0 == fh->f_rank ){
+        if ( MPI_SEEK_SET == whence){
+            /*no nothing*/
+            if ( offset < 0){
+                opal_output(0,"sharedfp_osc_seek - MPI_SEEK_SET, offset must be > 0, got offset=%lld.\n",offset);
+                ret = -1;
+            }
+            if ( mca_sharedfp_osc_verbose ) {
+                opal_output(ompi_sharedfp_base_framework.framework_output,
+                            "sharedfp_osc_seek: MPI_SEEK_SET new_offset=%lld\n",offset);
+            }
+        }
+        else if( MPI_SEEK_CUR == whence){
+            OMPI_MPI_OFFSET_TYPE current_position;
+            ret = mca_sharedfp_osc_get_position ( fh, &current_position);
+            if ( mca_sharedfp_osc_verbose ) {
+                opal_output(ompi_sharedfp_base_framework.framework_output,
+                            "sharedfp_osc_seek: MPI_SEEK_CUR: curr=%lld, offset=%lld, call status=%d\n",
+                            current_position,offset,status);
+            }
+            offset = current_position + offset;
+            if ( mca_sharedfp_osc_verbose ) {
+                opal_output(ompi_sharedfp_base_framework.framework_output,
+                            "sharedfp_osc_seek: MPI_SEEK_CUR: new_offset=%lld\n",offset);
+            }
+            if(offset < 0){
+                opal_output(0,"sharedfp_osc_seek - MPI_SEEK_CURE, offset must be > 0, got offset=%lld.\n",offset);
+                ret = -1;
+            }
+        }
+        else if( MPI_SEEK_END == whence){
+            end_position=0;
+            mca_common_ompio_file_get_size(fh,&end_position);
+
+            offset = end_position + offset;
+            if ( mca_sharedfp_osc_verbose ) {
+                opal_output(ompi_sharedfp_base_framework.framework_output,
+                            "sharedfp_osc_seek: MPI_SEEK_END: file_get_size=%lld\n",end_position);
+            }
+            if(offset < 0){
+                opal_output(0,"sharedfp_osc_seek - MPI_SEEK_CUR, offset must be > 0, got offset=%lld.\n",offset);
+                ret = -1;
+            }
+        }
+        else {
+            opal_output(0,"sharedfp_osc_seek - whence=%i is not supported\n",whence);
+            ret = -1;
+        }
+
+        /*-----------------------------------------------------*/
+        /* Set Shared file pointer                             */
+        /*-----------------------------------------------------*/
+        /* Only MPI_SUM and MPI_NO_OP are used on the window, the
+        ** new position is therefore applied as a difference. No other
+        ** process accesses the pointer during this collective call. */
+        osc_data = sh->selected_module_data;
+        if ( -1 != ret ) {
+            OMPI_MPI_OFFSET_TYPE current_position, delta, old_offset;
+
+            ret = mca_sharedfp_osc_get_position ( fh, &current_position);
+            if ( OMPI_SUCCESS == ret ) {
+                delta = offset - current_position;
+                ret = osc_data->win->w_osc_module->osc_fetch_and_op (&delta, &old_offset,
+                                                                     OMPI_OFFSET_DATATYPE, 0, 0,
+                                                                     MPI_SUM, osc_data->win);
+            }
+            if ( OMPI_SUCCESS == ret ) {
+                ret = osc_data->win->w_osc_module->osc_flush (0, osc_data->win);
+            }
+        }
+        if ( mca_sharedfp_osc_verbose ) {
+            opal_output(ompi_sharedfp_base_framework.framework_output,
+                        "sharedfp_osc_seek: shared file pointer set to %lld by rank=%d\n",offset,fh->f_rank);
+        }
+    }
+
+    /* since we are only letting process 0, update the current pointer
+     * all of the other processes need to wait before proceeding.
+     */
+    fh->f_comm->c_coll->coll_barrier ( fh->f_comm, fh->f_comm->c_coll->coll_barrier_module );
+
+    return ret;
+}
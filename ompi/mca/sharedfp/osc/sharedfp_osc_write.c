@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2017 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2013-2018 University of Houston. All rights reserved.
+ * Copyright (c) 2015-2018 Research Organization for Information Science
+ *                         and Technology (RIST). All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_osc.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/base/base.h"
+
+int mca_sharedfp_osc_write (ompio_file_t *fh,
+                           const void *buf,
+                           int count,
+                           struct ompi_datatype_t *datatype,
+                           ompi_status_public_t *status)
+{
+    int ret = OMPI_SUCCESS;
+    OMPI_MPI_OFFSET_TYPE offset = 0;
+    long bytesRequested = 0;
+    size_t numofBytes;
+
+    if( NULL == fh->f_sharedfp_data ){
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "sharedfp_osc_write:  module not initialized\n");
+        return OMPI_ERROR;
+    }
+
+    /* Calculate the number of bytes to write*/
+    opal_datatype_type_size ( &datatype->super, &numofBytes);
+    bytesRequested = count * numofBytes;
+
+    /*Retrieve the shared file data struct*/
+
+    if ( mca_sharedfp_osc_verbose ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "sharedfp_osc_write: Requested is %ld\n",bytesRequested);
+    }
+
+    /*Request the offset to write bytesRequested bytes*/
+    ret = mca_sharedfp_osc_request_position(fh, bytesRequested,&offset);
+    offset /= fh->f_etype_size;
+    if ( -1 != ret ) {
+        if ( mca_sharedfp_osc_verbose ) {
+            opal_output(ompi_sharedfp_base_framework.framework_output,
+                        "sharedfp_osc_write: fset received is %lld\n",offset);
+        }
+
+        /* Write to the file*/
+        ret = mca_common_ompio_file_write_at(fh,offset,buf,count,datatype,status);
+    }
+
+    return ret;
+}
+
+int mca_sharedfp_osc_write_ordered (ompio_file_t *fh,
+                                   const void *buf,
+                                   int count,
+                                   struct ompi_datatype_t *datatype,
+                                   ompi_status_public_t *status)
+{
+    int ret = OMPI_SUCCESS;
+    OMPI_MPI_OFFSET_TYPE offset = 0;
+    OMPI_MPI_OFFSET_TYPE bytesRequested = 0;
+    size_t numofBytes;
+
+    if ( NULL == fh->f_sharedfp_data ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "sharedfp_osc_write_ordered: module not initialized \n");
+        return OMPI_ERROR;
+    }
+
+    /* Calculate the number of bytes to write */
+    opal_datatype_type_size ( &datatype->super, &numofBytes);
+    bytesRequested = count * numofBytes;
+
+    ret = mca_sharedfp_base_ordered_position (fh, bytesRequested,
+                                              mca_sharedfp_osc_request_position,
+                                              &offset, NULL);
+    if ( OMPI_SUCCESS != ret ) {
+        return ret;
+    }
+    offset /= fh->f_etype_size;
+
+    if ( mca_sharedfp_osc_verbose ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "sharedfp_osc_write_ordered: Offset returned is %lld\n",offset);
+    }
+
+    /* write to the file */
+    ret = mca_common_ompio_file_write_at_all(fh,offset,buf,count,datatype,status);
+
+    return ret;
+}
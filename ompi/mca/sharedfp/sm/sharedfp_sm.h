@@ -28,6 +28,7 @@
 #include "ompi/mca/mca.h"
 #include "ompi/mca/sharedfp/sharedfp.h"
 #include "ompi/mca/common/ompio/common_ompio.h"
+#include "opal/sys/atomic.h"
 #include <semaphore.h>
 
 BEGIN_C_DECLS
@@ -104,9 +105,11 @@ int mca_sharedfp_sm_iwrite (ompio_file_t *fh,
 /*--------------------------------------------------------------*
  *Structures and definitions only for this component
  *--------------------------------------------------------------*/
+/* If 64 bit atomic operations are available, the shared file pointer
+ * is updated with a lock-free fetch-and-add and no semaphore is used. */
 struct mca_sharedfp_sm_offset{
     sem_t mutex;      /* the mutex: a POSIX memory-based unnamed semaphore */
-    long long offset;  /* and the shared file pointer offset */
+    opal_atomic_int64_t offset;  /* and the shared file pointer offset */
 };
 
 /*This structure will hang off of the mca_sharedfp_base_data_t's
@@ -120,7 +123,7 @@ struct mca_sharedfp_sm_data
     /* The mutex: it will either point to a POSIX memory-based named
        semaphore, or it will point to the a POSIX memory-based unnamed
        semaphore located in sm_offset_ptr->mutex. */
-    sem_t *mutex;
+    sem_t *mutex;      /* NULL if atomic operations are used */
     char *sem_name;    /* Name of the semaphore */
 };
 
@@ -128,8 +131,10 @@ typedef struct mca_sharedfp_sm_data sm_data;
 
 
 int mca_sharedfp_sm_request_position (ompio_file_t *fh,
-                                      int bytes_requested,
+                                      OMPI_MPI_OFFSET_TYPE bytes_requested,
                                       OMPI_MPI_OFFSET_TYPE * offset);
+void mca_sharedfp_sm_set_position (struct mca_sharedfp_sm_data *sm_data,
+                                   OMPI_MPI_OFFSET_TYPE offset);
 /*
  * ******************************************************************
  * ************ functions implemented in this module end ************
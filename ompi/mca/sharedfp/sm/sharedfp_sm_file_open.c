@@ -173,6 +173,12 @@ int mca_sharedfp_sm_file_open (struct ompi_communicator_t *comm,
         return OMPI_ERROR;
     }
 
+#if OPAL_HAVE_ATOMIC_MATH_64
+    /* The offset is updated with atomic operations directly in the      */
+    /* shared memory segment, no semaphore is needed.                    */
+    sm_data->mutex = NULL;
+    sm_data->sem_name = NULL;
+#else
     /* Initialize semaphore so that is shared between processes.           */
     /* the semaphore is shared by keeping it in the shared memory segment  */
 
@@ -186,34 +192,31 @@ int mca_sharedfp_sm_file_open (struct ompi_communicator_t *comm,
     snprintf(sm_data->sem_name,252,"OMPIO_%s",filename_basename);
 #endif
 
-    if( (sm_data->mutex = sem_open(sm_data->sem_name, O_CREAT, 0644, 1)) != SEM_FAILED ) {
+    if( (sm_data->mutex = sem_open(sm_data->sem_name, O_CREAT, 0644, 1)) == SEM_FAILED ) {
+        free(sm_data->sem_name);
 #elif defined(HAVE_SEM_INIT)
     sm_data->mutex = &sm_offset_ptr->mutex;
-    if(sem_init(&sm_offset_ptr->mutex, 1, 1) != -1){
+    if(sem_init(&sm_offset_ptr->mutex, 1, 1) == -1){
 #endif
-        /*If opening was successful*/
-        /*Store the new file handle*/
-        sm_data->sm_offset_ptr = sm_offset_ptr;
-        /* Assign the sm_data to sh->selected_module_data*/
-        sh->selected_module_data   = sm_data;
-        /*remember the shared file handle*/
-        fh->f_sharedfp_data = sh;
-
-        /*write initial zero*/
-        if(fh->f_rank==0){
-            MPI_Offset position=0;
-
-            sem_wait(sm_data->mutex);
-            sm_offset_ptr->offset=position;
-            sem_post(sm_data->mutex);
-        }
-    }else{
         free(sm_filename);
         free(sm_data);
         free(sh);
         munmap(sm_offset_ptr, sizeof(struct mca_sharedfp_sm_offset));
         return OMPI_ERROR;
     }
+#endif /* OPAL_HAVE_ATOMIC_MATH_64 */
+
+    /*Store the new file handle*/
+    sm_data->sm_offset_ptr = sm_offset_ptr;
+    /* Assign the sm_data to sh->selected_module_data*/
+    sh->selected_module_data   = sm_data;
+    /*remember the shared file handle*/
+    fh->f_sharedfp_data = sh;
+
+    /*write initial zero*/
+    if(fh->f_rank==0){
+        mca_sharedfp_sm_set_position (sm_data, 0);
+    }
 
     err = comm->c_coll->coll_barrier (comm, comm->c_coll->coll_barrier_module );
     if ( OMPI_SUCCESS != err ) {
@@ -225,7 +228,7 @@ int mca_sharedfp_sm_file_open (struct ompi_communicator_t *comm,
         return err;
     }
 
-#if defined(HAVE_SEM_OPEN)
+#if !OPAL_HAVE_ATOMIC_MATH_64 && defined(HAVE_SEM_OPEN)
     if ( 0 == fh->f_rank ) {
         sem_unlink ( sm_data->sem_name);
     }
@@ -258,7 +261,9 @@ int mca_sharedfp_sm_file_close (ompio_file_t *fh)
         /*Close sm handle*/
         if (file_data->sm_offset_ptr) {
             /* destroy semaphore */
-#if defined(HAVE_SEM_OPEN)
+#if OPAL_HAVE_ATOMIC_MATH_64
+            /* no semaphore when using atomic operations */
+#elif defined(HAVE_SEM_OPEN)
              sem_close ( file_data->mutex);
              free (file_data->sem_name);
 #elif defined(HAVE_SEM_INIT)
@@ -31,11 +31,10 @@
 #include <semaphore.h>
 
 int mca_sharedfp_sm_request_position(ompio_file_t *fh, 
-                                     int bytes_requested,
+                                     OMPI_MPI_OFFSET_TYPE bytes_requested,
                                      OMPI_MPI_OFFSET_TYPE *offset)
 {
     int ret = OMPI_SUCCESS;
-    OMPI_MPI_OFFSET_TYPE position = 0;
     OMPI_MPI_OFFSET_TYPE old_offset;
     struct mca_sharedfp_sm_data * sm_data = NULL;
     struct mca_sharedfp_sm_offset * sm_offset_ptr = NULL;
@@ -43,14 +42,25 @@ int mca_sharedfp_sm_request_position(ompio_file_t *fh,
 
     sh = fh->f_sharedfp_data;
     sm_data = sh->selected_module_data;
+    sm_offset_ptr = sm_data->sm_offset_ptr;
 
     *offset = 0;
+
+#if OPAL_HAVE_ATOMIC_MATH_64
+    /* a single fetch-and-add on the shared segment, no lock required */
+    old_offset = opal_atomic_fetch_add_64 (&sm_offset_ptr->offset, (int64_t) bytes_requested);
     if ( mca_sharedfp_sm_verbose ) {
         opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "Aquiring lock, rank=%d...",fh->f_rank);
+                    "old_offset=%lld, bytes_requested=%lld, new offset=%lld, rank=%d\n",
+                    old_offset,bytes_requested,old_offset+bytes_requested,fh->f_rank);
     }
+#else
+    OMPI_MPI_OFFSET_TYPE position = 0;
 
-    sm_offset_ptr = sm_data->sm_offset_ptr;
+    if ( mca_sharedfp_sm_verbose ) {
+        opal_output(ompi_sharedfp_base_framework.framework_output,
+                    "Aquiring lock, rank=%d...",fh->f_rank);
+    }
 
     /* Aquire an exclusive lock */
 
@@ -70,7 +80,7 @@ int mca_sharedfp_sm_request_position(ompio_file_t *fh,
     position = old_offset + bytes_requested;
     if ( mca_sharedfp_sm_verbose ) {
         opal_output(ompi_sharedfp_base_framework.framework_output,
-                    "old_offset=%lld, bytes_requested=%d, new offset=%lld!\n",old_offset,bytes_requested,position);
+                    "old_offset=%lld, bytes_requested=%lld, new offset=%lld!\n",old_offset,bytes_requested,position);
     }
     sm_offset_ptr->offset=position;
 
@@ -85,8 +95,21 @@ int mca_sharedfp_sm_request_position(ompio_file_t *fh,
         opal_output(ompi_sharedfp_base_framework.framework_output,
                     "Released lock! released lock.for rank=%d\n",fh->f_rank);
     }
+#endif
 
     *offset = old_offset;
 
     return ret;
 }
+
+void mca_sharedfp_sm_set_position (struct mca_sharedfp_sm_data *sm_data,
+                                   OMPI_MPI_OFFSET_TYPE offset)
+{
+#if OPAL_HAVE_ATOMIC_MATH_64
+    (void) opal_atomic_swap_64 (&sm_data->sm_offset_ptr->offset, (int64_t) offset);
+#else
+    sem_wait(sm_data->mutex);
+    sm_data->sm_offset_ptr->offset = offset;
+    sem_post(sm_data->mutex);
+#endif
+}
@@ -33,6 +33,7 @@
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -49,6 +50,7 @@ int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
                   MPI_Comm comm)
 {
     int err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_ALLGATHER, 1);
 
@@ -122,9 +124,13 @@ int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
 
     /* Invoke the coll component to perform the back-end operation */
 
+    SPC_HIST_START(OMPI_SPC_HIST_ALLGATHER, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_ALLGATHER, comm, -1);
     err = comm->c_coll->coll_allgather(sendbuf, sendcount, sendtype,
                                       recvbuf, recvcount, recvtype, comm,
                                       comm->c_coll->coll_allgather_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_ALLGATHER, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_ALLGATHER, &spc_timer);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
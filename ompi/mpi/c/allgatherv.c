@@ -33,6 +33,7 @@
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -49,6 +50,7 @@ int MPI_Allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
                    const int displs[], MPI_Datatype recvtype, MPI_Comm comm)
 {
     int i, size, err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_ALLGATHERV, 1);
 
@@ -143,10 +145,14 @@ int MPI_Allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
     OPAL_CR_ENTER_LIBRARY();
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HIST_START(OMPI_SPC_HIST_ALLGATHERV, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_ALLGATHERV, comm, -1);
     err = comm->c_coll->coll_allgatherv(sendbuf, sendcount, sendtype,
                                        recvbuf, (int *) recvcounts,
                                        (int *) displs, recvtype, comm,
                                        comm->c_coll->coll_allgatherv_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_ALLGATHERV, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_ALLGATHERV, &spc_timer);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
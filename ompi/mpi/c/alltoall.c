@@ -34,6 +34,7 @@
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -51,6 +52,7 @@ int MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
 {
     int err;
     size_t recvtype_size;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_ALLTOALL, 1);
 
@@ -107,9 +109,13 @@ int MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
     OPAL_CR_ENTER_LIBRARY();
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HIST_START(OMPI_SPC_HIST_ALLTOALL, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_ALLTOALL, comm, -1);
     err = comm->c_coll->coll_alltoall(sendbuf, sendcount, sendtype,
                                      recvbuf, recvcount, recvtype,
                                      comm, comm->c_coll->coll_alltoall_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_ALLTOALL, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_ALLTOALL, &spc_timer);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
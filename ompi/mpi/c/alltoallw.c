@@ -32,6 +32,7 @@
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -49,6 +50,7 @@ int MPI_Alltoallw(const void *sendbuf, const int sendcounts[],
                   const MPI_Datatype recvtypes[], MPI_Comm comm)
 {
     int i, size, err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_ALLTOALLW, 1);
 
@@ -121,9 +123,13 @@ int MPI_Alltoallw(const void *sendbuf, const int sendcounts[],
     OPAL_CR_ENTER_LIBRARY();
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HIST_START(OMPI_SPC_HIST_ALLTOALLW, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_ALLTOALLW, comm, -1);
     err = comm->c_coll->coll_alltoallw(sendbuf, sendcounts, sdispls, (ompi_datatype_t **) sendtypes,
                                       recvbuf, recvcounts, rdispls, (ompi_datatype_t **) recvtypes,
                                       comm, comm->c_coll->coll_alltoallw_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_ALLTOALLW, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_ALLTOALLW, &spc_timer);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
 
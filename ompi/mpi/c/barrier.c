@@ -26,6 +26,7 @@
 #include "ompi/errhandler/errhandler.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -40,6 +41,7 @@ static const char FUNC_NAME[] = "MPI_Barrier";
 int MPI_Barrier(MPI_Comm comm)
 {
   int err = MPI_SUCCESS;
+  opal_timer_t spc_timer = 0;
 
   SPC_RECORD(OMPI_SPC_BARRIER, 1);
 
@@ -61,6 +63,8 @@ int MPI_Barrier(MPI_Comm comm)
   /* Intracommunicators: Only invoke the back-end coll module barrier
      function if there's more than one process in the communicator */
 
+  SPC_HIST_START(OMPI_SPC_HIST_BARRIER, &spc_timer);
+  OMPI_TRACE_COLL_ENTER(OMPI_TRACE_BARRIER, comm, -1);
   if (OMPI_COMM_IS_INTRA(comm)) {
     if (ompi_comm_size(comm) > 1) {
       err = comm->c_coll->coll_barrier(comm, comm->c_coll->coll_barrier_module);
@@ -73,6 +77,8 @@ int MPI_Barrier(MPI_Comm comm)
   else {
       err = comm->c_coll->coll_barrier(comm, comm->c_coll->coll_barrier_module);
   }
+  OMPI_TRACE_COLL_EXIT(OMPI_TRACE_BARRIER, comm, -1);
+  SPC_HIST_STOP(OMPI_SPC_HIST_BARRIER, &spc_timer);
 
   /* All done */
 
@@ -27,6 +27,7 @@
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -42,6 +43,7 @@ int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype,
               int root, MPI_Comm comm)
 {
     int err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_BCAST, 1);
 
@@ -111,7 +113,11 @@ int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype,
 
     /* Invoke the coll component to perform the back-end operation */
 
+    SPC_HIST_START(OMPI_SPC_HIST_BCAST, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_BCAST, comm, root);
     err = comm->c_coll->coll_bcast(buffer, count, datatype, root, comm,
                                   comm->c_coll->coll_bcast_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_BCAST, comm, root);
+    SPC_HIST_STOP(OMPI_SPC_HIST_BCAST, &spc_timer);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
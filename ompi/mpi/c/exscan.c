@@ -31,6 +31,7 @@
 #include "ompi/op/op.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -46,6 +47,7 @@ int MPI_Exscan(const void *sendbuf, void *recvbuf, int count,
                MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_EXSCAN, 1);
 
@@ -91,9 +93,13 @@ int MPI_Exscan(const void *sendbuf, void *recvbuf, int count,
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HIST_START(OMPI_SPC_HIST_EXSCAN, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_EXSCAN, comm, -1);
     err = comm->c_coll->coll_exscan(sendbuf, recvbuf, count,
                                    datatype, op, comm,
                                    comm->c_coll->coll_exscan_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_EXSCAN, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_EXSCAN, &spc_timer);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
@@ -27,6 +27,7 @@
 #include "ompi/file/file.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
+#include "ompi/runtime/ompi_spc.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -43,6 +44,7 @@ int MPI_File_read_at_all(MPI_File fh, MPI_Offset offset, void *buf,
                          MPI_Status *status)
 {
     int rc;
+    opal_timer_t spc_timer = 0;
 
     MEMCHECKER(
         memchecker_datatype(datatype);
@@ -66,6 +68,7 @@ int MPI_File_read_at_all(MPI_File fh, MPI_Offset offset, void *buf,
 
     /* Call the back-end io component function */
 
+    SPC_HIST_START(OMPI_SPC_HIST_FILE_READ, &spc_timer);
     switch (fh->f_io_version) {
     case MCA_IO_BASE_V_2_0_0:
         rc = fh->f_io_selected_module.v2_0_0.
@@ -77,6 +80,7 @@ int MPI_File_read_at_all(MPI_File fh, MPI_Offset offset, void *buf,
         rc = MPI_ERR_INTERN;
         break;
     }
+    SPC_HIST_STOP(OMPI_SPC_HIST_FILE_READ, &spc_timer);
 
     /* All done */
 
@@ -30,6 +30,7 @@
 #include "ompi/file/file.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
+#include "ompi/runtime/ompi_spc.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -46,6 +47,7 @@ int MPI_File_write_at_all(MPI_File fh, MPI_Offset offset, const void *buf,
                           MPI_Status *status)
 {
     int rc;
+    opal_timer_t spc_timer = 0;
 
     MEMCHECKER(
         memchecker_datatype(datatype);
@@ -70,6 +72,7 @@ int MPI_File_write_at_all(MPI_File fh, MPI_Offset offset, const void *buf,
 
     /* Call the back-end io component function */
 
+    SPC_HIST_START(OMPI_SPC_HIST_FILE_WRITE, &spc_timer);
     switch (fh->f_io_version) {
     case MCA_IO_BASE_V_2_0_0:
         rc = fh->f_io_selected_module.v2_0_0.
@@ -81,6 +84,7 @@ int MPI_File_write_at_all(MPI_File fh, MPI_Offset offset, const void *buf,
         rc = MPI_ERR_INTERN;
         break;
     }
+    SPC_HIST_STOP(OMPI_SPC_HIST_FILE_WRITE, &spc_timer);
 
     /* All done */
 
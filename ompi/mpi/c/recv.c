@@ -43,6 +43,7 @@ int MPI_Recv(void *buf, int count, MPI_Datatype type, int source,
              int tag, MPI_Comm comm, MPI_Status *status)
 {
     int rc = MPI_SUCCESS;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_RECV, 1);
 
@@ -79,6 +80,8 @@ int MPI_Recv(void *buf, int count, MPI_Datatype type, int source,
 
     OPAL_CR_ENTER_LIBRARY();
 
+    SPC_HIST_START(OMPI_SPC_HIST_RECV, &spc_timer);
     rc = MCA_PML_CALL(recv(buf, count, type, source, tag, comm, status));
+    SPC_HIST_STOP(OMPI_SPC_HIST_RECV, &spc_timer);
     OMPI_ERRHANDLER_RETURN(rc, comm, rc, FUNC_NAME);
 }
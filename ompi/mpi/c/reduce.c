@@ -32,6 +32,7 @@
 #include "ompi/op/op.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -47,6 +48,7 @@ int MPI_Reduce(const void *sendbuf, void *recvbuf, int count,
                MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
 {
     int err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_REDUCE, 1);
 
@@ -136,9 +138,13 @@ int MPI_Reduce(const void *sendbuf, void *recvbuf, int count,
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HIST_START(OMPI_SPC_HIST_REDUCE, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_REDUCE, comm, root);
     err = comm->c_coll->coll_reduce(sendbuf, recvbuf, count,
                                    datatype, op, root, comm,
                                    comm->c_coll->coll_reduce_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_REDUCE, comm, root);
+    SPC_HIST_STOP(OMPI_SPC_HIST_REDUCE, &spc_timer);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
@@ -32,6 +32,7 @@
 #include "ompi/op/op.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -47,6 +48,7 @@ int MPI_Reduce_scatter(const void *sendbuf, void *recvbuf, const int recvcounts[
                        MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int i, err, size, count;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_REDUCE_SCATTER, 1);
 
@@ -131,9 +133,13 @@ int MPI_Reduce_scatter(const void *sendbuf, void *recvbuf, const int recvcounts[
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HIST_START(OMPI_SPC_HIST_REDUCE_SCATTER, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_REDUCE_SCATTER, comm, -1);
     err = comm->c_coll->coll_reduce_scatter(sendbuf, recvbuf, recvcounts,
                                            datatype, op, comm,
                                            comm->c_coll->coll_reduce_scatter_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_REDUCE_SCATTER, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_REDUCE_SCATTER, &spc_timer);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
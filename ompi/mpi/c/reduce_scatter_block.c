@@ -33,6 +33,7 @@
 #include "ompi/op/op.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -48,6 +49,7 @@ int MPI_Reduce_scatter_block(const void *sendbuf, void *recvbuf, int recvcount,
                              MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_REDUCE_SCATTER_BLOCK, 1);
 
@@ -100,9 +102,13 @@ int MPI_Reduce_scatter_block(const void *sendbuf, void *recvbuf, int recvcount,
     /* Invoke the coll component to perform the back-end operation */
 
     OBJ_RETAIN(op);
+    SPC_HIST_START(OMPI_SPC_HIST_REDUCE_SCATTER_BLOCK, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_REDUCE_SCATTER_BLOCK, comm, -1);
     err = comm->c_coll->coll_reduce_scatter_block(sendbuf, recvbuf, recvcount,
                                                  datatype, op, comm,
                                                  comm->c_coll->coll_reduce_scatter_block_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_REDUCE_SCATTER_BLOCK, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_REDUCE_SCATTER_BLOCK, &spc_timer);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
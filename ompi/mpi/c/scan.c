@@ -32,6 +32,7 @@
 #include "ompi/op/op.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -47,6 +48,7 @@ int MPI_Scan(const void *sendbuf, void *recvbuf, int count,
              MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
 {
     int err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_SCAN, 1);
 
@@ -105,9 +107,13 @@ int MPI_Scan(const void *sendbuf, void *recvbuf, int count,
     /* Call the coll component to actually perform the allgather */
 
     OBJ_RETAIN(op);
+    SPC_HIST_START(OMPI_SPC_HIST_SCAN, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_SCAN, comm, -1);
     err = comm->c_coll->coll_scan(sendbuf, recvbuf, count,
                                  datatype, op, comm,
                                  comm->c_coll->coll_scan_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_SCAN, comm, -1);
+    SPC_HIST_STOP(OMPI_SPC_HIST_SCAN, &spc_timer);
     OBJ_RELEASE(op);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
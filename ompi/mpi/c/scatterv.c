@@ -31,6 +31,7 @@
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/memchecker.h"
 #include "ompi/runtime/ompi_spc.h"
+#include "ompi/runtime/ompi_trace.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -47,6 +48,7 @@ int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[]
                  MPI_Datatype recvtype, int root, MPI_Comm comm)
 {
     int i, size, err;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_SCATTERV, 1);
 
@@ -193,8 +195,12 @@ int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[]
     OPAL_CR_ENTER_LIBRARY();
 
     /* Invoke the coll component to perform the back-end operation */
+    SPC_HIST_START(OMPI_SPC_HIST_SCATTERV, &spc_timer);
+    OMPI_TRACE_COLL_ENTER(OMPI_TRACE_SCATTERV, comm, root);
     err = comm->c_coll->coll_scatterv(sendbuf, sendcounts, displs,
                                      sendtype, recvbuf, recvcount, recvtype, root, comm,
                                      comm->c_coll->coll_scatterv_module);
+    OMPI_TRACE_COLL_EXIT(OMPI_TRACE_SCATTERV, comm, root);
+    SPC_HIST_STOP(OMPI_SPC_HIST_SCATTERV, &spc_timer);
     OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
 }
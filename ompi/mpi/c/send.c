@@ -46,6 +46,7 @@ int MPI_Send(const void *buf, int count, MPI_Datatype type, int dest,
              int tag, MPI_Comm comm)
 {
     int rc = MPI_SUCCESS;
+    opal_timer_t spc_timer = 0;
 
     SPC_RECORD(OMPI_SPC_SEND, 1);
 
@@ -78,6 +79,8 @@ int MPI_Send(const void *buf, int count, MPI_Datatype type, int dest,
     }
 
     OPAL_CR_ENTER_LIBRARY();
+    SPC_HIST_START(OMPI_SPC_HIST_SEND, &spc_timer);
     rc = MCA_PML_CALL(send(buf, count, type, dest, tag, MCA_PML_BASE_SEND_STANDARD, comm));
+    SPC_HIST_STOP(OMPI_SPC_HIST_SEND, &spc_timer);
     OMPI_ERRHANDLER_RETURN(rc, comm, rc, FUNC_NAME);
 }
@@ -29,6 +29,7 @@
 #include "ompi/info/info.h"
 #include "ompi/win/win.h"
 #include "ompi/memchecker.h"
+#include "ompi/runtime/ompi_spc.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -42,6 +43,7 @@ static const char FUNC_NAME[] = "MPI_Win_flush_local";
 int MPI_Win_flush_local(int rank, MPI_Win win)
 {
     int ret = MPI_SUCCESS;
+    opal_timer_t spc_timer = 0;
 
     /* argument checking */
     if (MPI_PARAM_CHECK) {
@@ -56,6 +58,8 @@ int MPI_Win_flush_local(int rank, MPI_Win win)
     OPAL_CR_ENTER_LIBRARY();
 
     /* create window and return */
+    SPC_HIST_START(OMPI_SPC_HIST_WIN_FLUSH, &spc_timer);
     ret = win->w_osc_module->osc_flush_local(rank, win);
+    SPC_HIST_STOP(OMPI_SPC_HIST_WIN_FLUSH, &spc_timer);
     OMPI_ERRHANDLER_RETURN(ret, win, ret, FUNC_NAME);
 }
@@ -19,6 +19,7 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/file/file.h"
 #include "ompi/win/win.h"
+#include "ompi/runtime/ompi_trace.h"
 
 BEGIN_C_DECLS
 
@@ -66,10 +67,38 @@ int ompi_peruse_finalize (void);
 
 /*
  * Global macros
+ *
+ * The events are recorded into the binary trace (ompi/runtime/ompi_trace.h)
+ * if it is turned on, and are passed to the PERUSE callbacks if PERUSE
+ * support is compiled in.
  */
 
-#if OMPI_WANT_PERUSE
 #define PERUSE_TRACE_COMM_EVENT(event, base_req, op)                                   \
+do {                                                                                   \
+    OMPI_TRACE_EVENT((event), (op), (base_req)->req_comm, (base_req)->req_peer,        \
+                     (base_req)->req_tag,                                              \
+                     NULL != (base_req)->req_datatype ?                                \
+                         (base_req)->req_count * (base_req)->req_datatype->super.size : 0, \
+                     (base_req));                                                      \
+    PERUSE_CALLBACK_COMM_EVENT(event, base_req, op);                                   \
+} while(0)
+
+#define PERUSE_TRACE_COMM_OMPI_EVENT(event, base_req, size, op)                        \
+do {                                                                                   \
+    OMPI_TRACE_EVENT((event), (op), (base_req)->req_comm, (base_req)->req_peer,        \
+                     (base_req)->req_tag, (size), (base_req));                         \
+    PERUSE_CALLBACK_COMM_OMPI_EVENT(event, base_req, size, op);                        \
+} while(0)
+
+#define PERUSE_TRACE_MSG_EVENT(event, comm_ptr, hdr_peer, hdr_tag, op)            \
+    do {                                                                          \
+        OMPI_TRACE_EVENT((event), (op), (ompi_communicator_t*) (comm_ptr),        \
+                         (hdr_peer), (hdr_tag), 0, NULL);                         \
+        PERUSE_CALLBACK_MSG_EVENT(event, comm_ptr, hdr_peer, hdr_tag, op);        \
+    } while(0)
+
+#if OMPI_WANT_PERUSE
+#define PERUSE_CALLBACK_COMM_EVENT(event, base_req, op)                                 \
 do {                                                                                   \
     if( NULL != (base_req)->req_comm->c_peruse_handles ) {                             \
         ompi_peruse_handle_t * _ptr = (base_req)->req_comm->c_peruse_handles[(event)]; \
@@ -87,7 +116,7 @@ do {
     }                                                                                  \
 } while(0)
 
-#define PERUSE_TRACE_COMM_OMPI_EVENT(event, base_req, size, op)                        \
+#define PERUSE_CALLBACK_COMM_OMPI_EVENT(event, base_req, size, op)                     \
 do {                                                                                   \
     if( NULL != (base_req)->req_comm->c_peruse_handles ) {                             \
         ompi_peruse_handle_t * _ptr = (base_req)->req_comm->c_peruse_handles[(event)]; \
@@ -105,7 +134,7 @@ do {
     }                                                                                  \
 } while(0)
 
-#define PERUSE_TRACE_MSG_EVENT(event, comm_ptr, hdr_peer, hdr_tag, op)            \
+#define PERUSE_CALLBACK_MSG_EVENT(event, comm_ptr, hdr_peer, hdr_tag, op)         \
     do {                                                                          \
         if( NULL != (comm_ptr)->c_peruse_handles ) {                              \
             ompi_peruse_handle_t * _ptr = (comm_ptr)->c_peruse_handles[(event)];  \
@@ -125,9 +154,9 @@ do {
 
 #else
 
-#define PERUSE_TRACE_COMM_EVENT(event, base_req, op)
-#define PERUSE_TRACE_COMM_OMPI_EVENT(event, base_req, size, op)
-#define PERUSE_TRACE_MSG_EVENT(event, comm_ptr, hdr_peer, hdr_tag, op)
+#define PERUSE_CALLBACK_COMM_EVENT(event, base_req, op)
+#define PERUSE_CALLBACK_COMM_OMPI_EVENT(event, base_req, size, op)
+#define PERUSE_CALLBACK_MSG_EVENT(event, comm_ptr, hdr_peer, hdr_tag, op)
 
 #endif
 
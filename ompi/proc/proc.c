@@ -39,6 +39,7 @@
 #include "opal/mca/hwloc/base/base.h"
 #include "opal/mca/pmix/pmix-internal.h"
 #include "opal/util/argv.h"
+#include "opal/util/timings.h"
 
 #include "ompi/proc/proc.h"
 #include "ompi/datatype/ompi_datatype.h"
@@ -194,6 +195,17 @@ opal_proc_t *ompi_proc_lookup (const opal_process_name_t proc_name)
     return NULL;
 }
 
+uint16_t ompi_proc_name_locality (const opal_process_name_t proc_name)
+{
+    uint16_t u16, *u16ptr = &u16;
+    int ret;
+
+    /* the locality of the peers on this node is always available locally */
+    OPAL_MODEX_RECV_VALUE_OPTIONAL(ret, PMIX_LOCALITY, &proc_name, &u16ptr, PMIX_UINT16);
+
+    return (OPAL_SUCCESS == ret) ? u16 : 0;
+}
+
 static ompi_proc_t *ompi_proc_for_name_nolock (const opal_process_name_t proc_name)
 {
     ompi_proc_t *proc = NULL;
@@ -212,6 +224,16 @@ static ompi_proc_t *ompi_proc_for_name_nolock (const opal_process_name_t proc_na
         goto exit;
     }
 
+    /* in lazy mode node-local peers were not allocated by ompi_proc_complete_init()
+     * so the locality has to be retrieved when the proc is first referenced */
+    if (ompi_mpi_lazy_procs) {
+        uint16_t u16, *u16ptr = &u16;
+        OPAL_MODEX_RECV_VALUE_OPTIONAL(ret, PMIX_LOCALITY, &proc->super.proc_name, &u16ptr, PMIX_UINT16);
+        if (OPAL_SUCCESS == ret) {
+            proc->super.proc_flags = u16;
+        }
+    }
+
     /* finish filling in the important proc data fields */
     ret = ompi_proc_complete_init_single (proc);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
@@ -241,8 +263,8 @@ opal_proc_t *ompi_proc_for_name (const opal_process_name_t proc_name)
 
 int ompi_proc_init(void)
 {
-    int opal_proc_hash_init_size = (ompi_process_info.num_procs < ompi_add_procs_cutoff) ? ompi_process_info.num_procs :
-        1024;
+    int opal_proc_hash_init_size = (!ompi_mpi_lazy_procs && ompi_process_info.num_procs < ompi_add_procs_cutoff) ?
+        ompi_process_info.num_procs : 1024;
     ompi_proc_t *proc;
     int ret;
 
@@ -302,6 +324,10 @@ static int ompi_proc_compare_vid (opal_list_item_t **a, opal_list_item_t **b)
  * This function is to be called __only__ after the modex exchange
  * has been performed, in order to allow the modex to carry the data
  * instead of requiring the runtime to provide it.
+ *
+ * If mpi_lazy_procs is set nothing is done here: node-local peers are
+ * not pre-allocated and every remote process is created (and its modex
+ * data retrieved) by ompi_proc_for_name() on first use.
  */
 int ompi_proc_complete_init(void)
 {
@@ -310,6 +336,16 @@ int ompi_proc_complete_init(void)
     int ret, errcode = OMPI_SUCCESS;
     char *val;
 
+    OPAL_TIMING_ENV_INIT(ompi_proc_complete_init);
+
+    /* in lazy mode every remote proc (including the node-local ones) is
+     * created by ompi_proc_for_name() on first use. the only proc in the
+     * list at this point is the local one which needs no completion. */
+    if (ompi_mpi_lazy_procs) {
+        OPAL_TIMING_ENV_NEXT(ompi_proc_complete_init, "lazy");
+        return OMPI_SUCCESS;
+    }
+
     opal_mutex_lock (&ompi_proc_lock);
 
     /* Add all local peers first */
@@ -341,6 +377,7 @@ int ompi_proc_complete_init(void)
         }
         opal_argv_free(peers);
     }
+    OPAL_TIMING_ENV_NEXT(ompi_proc_complete_init, "local_peers");
 
     /* Complete initialization of node-local procs */
     OPAL_LIST_FOREACH(proc, &ompi_proc_list, ompi_proc_t) {
@@ -350,6 +387,7 @@ int ompi_proc_complete_init(void)
             break;
         }
     }
+    OPAL_TIMING_ENV_NEXT(ompi_proc_complete_init, "complete_local");
 
     /* if cutoff is larger than # of procs - add all processes
      * NOTE that local procs will be automatically skipped as they
@@ -370,11 +408,13 @@ int ompi_proc_complete_init(void)
 
         /* acquire lock back for the next step - sort */
         opal_mutex_lock (&ompi_proc_lock);
+        OPAL_TIMING_ENV_NEXT(ompi_proc_complete_init, "add_all");
     }
 
     opal_list_sort (&ompi_proc_list, ompi_proc_compare_vid);
 
     opal_mutex_unlock (&ompi_proc_lock);
+    OPAL_TIMING_ENV_NEXT(ompi_proc_complete_init, "sort");
 
     return errcode;
 }
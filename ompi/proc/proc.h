@@ -376,6 +376,18 @@ OMPI_DECLSPEC opal_proc_t *ompi_proc_for_name (const opal_process_name_t proc_na
 
 OMPI_DECLSPEC opal_proc_t *ompi_proc_lookup (const opal_process_name_t proc_name);
 
+/**
+ * Get the locality of a process without creating its ompi_proc_t
+ *
+ * @param[in] proc_name opal process name
+ *
+ * @returns the locality flags of the process, 0 if they are not known
+ *
+ * Used for peers that are still represented by sentinels, which
+ * includes node-local peers when mpi_lazy_procs is set.
+ */
+OMPI_DECLSPEC uint16_t ompi_proc_name_locality (const opal_process_name_t proc_name);
+
 /**
  * Check if an ompi_proc_t is a sentinel
  */
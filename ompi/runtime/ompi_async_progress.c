@@ -0,0 +1,124 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <time.h>
+
+#include "ompi/runtime/ompi_async_progress.h"
+#include "ompi/runtime/params.h"
+#include "ompi/constants.h"
+
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/threads/threads.h"
+#include "opal/util/output.h"
+
+static opal_thread_t ompi_async_progress_thread;
+static volatile bool ompi_async_progress_active = false;
+opal_atomic_int32_t ompi_async_progress_busy = 0;
+
+/* Bind the calling thread to the requested core of the node */
+static void ompi_async_progress_bind (void)
+{
+    hwloc_obj_t core;
+
+    if (0 > ompi_mpi_async_progress_core || NULL == opal_hwloc_topology) {
+        return;
+    }
+
+    core = hwloc_get_obj_by_type (opal_hwloc_topology, HWLOC_OBJ_CORE,
+                                  (unsigned) ompi_mpi_async_progress_core);
+    if (NULL == core) {
+        opal_output (0, "mpi_async_progress_core: there is no core %d on this node, "
+                     "the progress thread is not bound", ompi_mpi_async_progress_core);
+        return;
+    }
+
+    if (0 != hwloc_set_cpubind (opal_hwloc_topology, core->cpuset, HWLOC_CPUBIND_THREAD)) {
+        opal_output (0, "mpi_async_progress_core: cannot bind the progress thread to core %d",
+                     ompi_mpi_async_progress_core);
+    }
+}
+
+static void *ompi_async_progress_engine (opal_object_t *obj)
+{
+    struct timespec delay = {.tv_sec = 0, .tv_nsec = 0};
+    long max_sleep = 1000L * ompi_mpi_async_progress_max_sleep;
+    int idle = 0;
+
+    ompi_async_progress_bind ();
+
+    while (ompi_async_progress_active) {
+        /* a non-blocking collective waiting for its round completes no
+           event, but has to start the next one as soon as it can */
+        if (opal_progress_run () > 0 || 0 < ompi_async_progress_busy) {
+            idle = 0;
+            delay.tv_nsec = 0;
+            continue;
+        }
+
+        if (++idle < opal_progress_spin_count || 0 >= max_sleep) {
+            continue;
+        }
+
+        /* nothing happened for a while, back off */
+        delay.tv_nsec = (0 == delay.tv_nsec) ? 1000 : 2 * delay.tv_nsec;
+        if (delay.tv_nsec > max_sleep) {
+            delay.tv_nsec = max_sleep;
+        }
+        nanosleep (&delay, NULL);
+    }
+
+    return OPAL_THREAD_CANCELLED;
+}
+
+int ompi_async_progress_init (void)
+{
+    int rc;
+
+    if (!ompi_mpi_async_progress) {
+        return OMPI_SUCCESS;
+    }
+
+    if (0 <= ompi_mpi_async_progress_core &&
+        OPAL_SUCCESS != opal_hwloc_base_get_topology ()) {
+        opal_output (0, "mpi_async_progress_core: no topology, the progress thread is not bound");
+    }
+
+    OBJ_CONSTRUCT(&ompi_async_progress_thread, opal_thread_t);
+    ompi_async_progress_thread.t_run = ompi_async_progress_engine;
+    ompi_async_progress_thread.t_arg = NULL;
+
+    ompi_async_progress_active = true;
+    opal_atomic_wmb ();
+
+    rc = opal_thread_start (&ompi_async_progress_thread);
+    if (OPAL_SUCCESS != rc) {
+        ompi_async_progress_active = false;
+        OBJ_DESTRUCT(&ompi_async_progress_thread);
+        return rc;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+int ompi_async_progress_fini (void)
+{
+    if (!ompi_async_progress_active) {
+        return OMPI_SUCCESS;
+    }
+
+    ompi_async_progress_active = false;
+    opal_atomic_wmb ();
+
+    opal_thread_join (&ompi_async_progress_thread, NULL);
+    OBJ_DESTRUCT(&ompi_async_progress_thread);
+
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef OMPI_ASYNC_PROGRESS_H
+#define OMPI_ASYNC_PROGRESS_H
+
+#include "ompi_config.h"
+
+#include "opal/sys/atomic.h"
+#include "opal/threads/thread_usage.h"
+#include "ompi/runtime/params.h"
+
+BEGIN_C_DECLS
+
+/*
+ * Asynchronous progress thread.
+ *
+ * If the mpi_async_progress MCA parameter is set, every process runs a
+ * thread that calls opal_progress() between MPI_Init and MPI_Finalize,
+ * so that the non-blocking collectives and the rendezvous protocols
+ * advance while the application computes.  The thread polls as long as
+ * the progress callbacks complete events; once they have been idle for
+ * opal_progress_spin_count polls it sleeps between two polls, doubling
+ * the sleep up to mpi_async_progress_max_sleep microseconds.  The
+ * thread can be bound to a core with mpi_async_progress_core.
+ *
+ * The thread does not sleep while ompi_async_progress_busy is not 0,
+ * i.e. while requests that only advance when they are polled, like the
+ * schedules of the non-blocking collectives, are active: their progress
+ * functions complete no event while a round is in flight.
+ *
+ * The thread calls into the library concurrently with the application,
+ * so enabling it forces MPI_THREAD_MULTIPLE: MPI_Init_thread provides
+ * that level whatever the application requested.
+ */
+
+/**
+ * Number of active requests the progress thread has to keep polling
+ * for. Only counted if mpi_async_progress is set, see
+ * ompi_async_progress_busy_add().
+ */
+OMPI_DECLSPEC extern opal_atomic_int32_t ompi_async_progress_busy;
+
+static inline void ompi_async_progress_busy_add(int32_t count)
+{
+    if (OPAL_UNLIKELY(ompi_mpi_async_progress)) {
+        (void) OPAL_THREAD_ADD_FETCH32(&ompi_async_progress_busy, count);
+    }
+}
+
+/**
+ * Start the progress thread if it is requested.  Called at the end of
+ * MPI_Init.
+ */
+int ompi_async_progress_init(void);
+
+/**
+ * Stop the progress thread.  Called at the beginning of MPI_Finalize.
+ */
+int ompi_async_progress_fini(void);
+
+END_C_DECLS
+
+#endif /* OMPI_ASYNC_PROGRESS_H */
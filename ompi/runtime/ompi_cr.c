@@ -131,7 +131,7 @@ notify_collectives(int msg)
     for (i = 0 ; i < max ; ++i) {
         ompi_communicator_t *comm =
             (ompi_communicator_t *)opal_pointer_array_get_item(&ompi_mpi_communicators, i);
-        if (NULL == comm) continue;
+        if (NULL == comm || OMPI_COMM_CID_RESERVED == (void *) comm) continue;
 
         SIGNAL(comm, modules, highest_module, msg, ret, allgather);
         SIGNAL(comm, modules, highest_module, msg, ret, allgatherv);
@@ -91,6 +91,8 @@
 #include "ompi/mca/crcp/base/base.h"
 #endif
 #include "ompi/runtime/ompi_cr.h"
+#include "ompi/runtime/ompi_trace.h"
+#include "ompi/runtime/ompi_async_progress.h"
 
 extern bool ompi_enable_timing;
 
@@ -139,6 +141,12 @@ int ompi_mpi_finalize(void)
     opal_atomic_wmb();
     opal_atomic_swap_32(&ompi_mpi_state, OMPI_MPI_STATE_FINALIZE_STARTED);
 
+    /* stop progressing in the background before anything is torn down */
+    (void)ompi_async_progress_fini();
+
+    /* write the trace before anything is torn down */
+    (void)ompi_trace_fini();
+
     ompi_mpiext_fini();
 
     /* Per MPI-2:4.8, we have to free MPI_COMM_SELF before doing
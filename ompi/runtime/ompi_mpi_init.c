@@ -102,6 +102,8 @@
 #include "ompi/mca/crcp/base/base.h"
 #endif
 #include "ompi/runtime/ompi_cr.h"
+#include "ompi/runtime/ompi_trace.h"
+#include "ompi/runtime/ompi_async_progress.h"
 
 /* newer versions of gcc have poisoned this deprecated feature */
 #ifdef HAVE___MALLOC_INITIALIZE_HOOK
@@ -450,6 +452,17 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         goto error;
     }
 
+    /* The progress thread enters the library concurrently with the
+       application: enabling it forces MPI_THREAD_MULTIPLE, whatever
+       level was requested. The components are set up for it, so every
+       communication takes the locks of that level, and the level is
+       reported to the application (provided, MPI_Query_thread). */
+    if (ompi_mpi_async_progress) {
+        opal_set_using_threads(true);
+        ompi_mpi_thread_multiple = true;
+        ompi_mpi_thread_provided = *provided = MPI_THREAD_MULTIPLE;
+    }
+
     if (OPAL_SUCCESS != (ret = opal_arch_set_fortran_logical_size(sizeof(ompi_fortran_logical_t)))) {
         error = "ompi_mpi_init: opal_arch_set_fortran_logical_size failed";
         goto error;
@@ -803,6 +816,8 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         goto error;
     }
 
+    OMPI_TIMING_NEXT("mpi-handles-init");
+
     /* identify the architectures of remote procs and setup
      * their datatype convertors, if required
      */
@@ -810,6 +825,8 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         error = "ompi_proc_complete_init failed";
         goto error;
     }
+    OMPI_TIMING_IMPORT_OPAL("ompi_proc_complete_init");
+    OMPI_TIMING_NEXT("proc-complete-init");
 
     /* start PML/BTL's */
     ret = MCA_PML_CALL(enable(true));
@@ -849,6 +866,8 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         goto error;
     }
 
+    OMPI_TIMING_NEXT("pml-add-procs");
+
     MCA_PML_CALL(add_comm(&ompi_mpi_comm_world.comm));
     MCA_PML_CALL(add_comm(&ompi_mpi_comm_self.comm));
 
@@ -895,6 +914,12 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
        time if so, then start the clock again */
     OMPI_TIMING_NEXT("barrier");
 
+    /* the trace files are aligned on the end of the barrier */
+    if (OMPI_SUCCESS != (ret = ompi_trace_init())) {
+        error = "ompi_trace_init() failed";
+        goto error;
+    }
+
 #if OPAL_ENABLE_PROGRESS_THREADS == 0
     /* Start setting up the event engine for MPI operations.  Don't
        block in the event library, so that communications don't take
@@ -990,6 +1015,11 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided,
         goto error;
     }
 
+    if (OMPI_SUCCESS != (ret = ompi_async_progress_init())) {
+        error = "ompi_async_progress_init() failed";
+        goto error;
+    }
+
     /* Fall through */
  error:
     if (ret != OMPI_SUCCESS) {
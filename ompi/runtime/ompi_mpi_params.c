@@ -28,6 +28,7 @@
 
 #include "ompi_config.h"
 
+#include <signal.h>
 #include <string.h>
 #include <time.h>
 
@@ -73,10 +74,21 @@ bool ompi_async_mpi_finalize = false;
 
 #define OMPI_ADD_PROCS_CUTOFF_DEFAULT 0
 uint32_t ompi_add_procs_cutoff = OMPI_ADD_PROCS_CUTOFF_DEFAULT;
+bool ompi_mpi_lazy_procs = false;
+int ompi_comm_cid_block_size = 8;
+int ompi_sparse_group_min_size = 1024;
 bool ompi_mpi_dynamics_enabled = true;
 
 char *ompi_mpi_spc_attach_string = NULL;
 bool ompi_mpi_spc_dump_enabled = false;
+char *ompi_mpi_spc_hist_attach_string = NULL;
+bool ompi_mpi_trace = false;
+char *ompi_mpi_trace_dir = NULL;
+int ompi_mpi_trace_records = 65536;
+int ompi_mpi_trace_signal = SIGUSR2;
+bool ompi_mpi_async_progress = false;
+int ompi_mpi_async_progress_core = -1;
+int ompi_mpi_async_progress_max_sleep = 50;
 
 static bool show_default_mca_params = false;
 static bool show_file_mca_params = false;
@@ -262,6 +274,14 @@ int ompi_mpi_register_params(void)
         ompi_use_sparse_group_storage = false;
     }
 
+    ompi_sparse_group_min_size = 1024;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "sparse_group_min_size",
+                                 "Smallest group for which a sparse storage format is considered. Smaller groups always store a list of process pointers (only relevant if mpi_use_sparse_group_storage is 1)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_sparse_group_min_size);
+
     value = mca_base_var_find ("opal", "opal", NULL, "cuda_support");
     if (0 <= value) {
         mca_base_var_register_synonym(value, "ompi", "mpi", NULL, "cuda_support",
@@ -288,6 +308,30 @@ int ompi_mpi_register_params(void)
                                   0, 0, OPAL_INFO_LVL_3, MCA_BASE_VAR_SCOPE_LOCAL,
                                   &ompi_add_procs_cutoff);
 
+    ompi_mpi_lazy_procs = false;
+    (void) mca_base_var_register ("ompi", "mpi", NULL, "lazy_procs",
+                                  "Defer creation of all remote process structures, including "
+                                  "node-local peers, until the first communication with each "
+                                  "peer. Modex lookups and BTL endpoints are then resolved on "
+                                  "demand instead of during MPI_Init. Ignored if the selected "
+                                  "PML requires all processes to be added at startup",
+                                  MCA_BASE_VAR_TYPE_BOOL, NULL,
+                                  0, 0, OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL,
+                                  &ompi_mpi_lazy_procs);
+
+    ompi_comm_cid_block_size = 8;
+    (void) mca_base_var_register ("ompi", "mpi", NULL, "comm_cid_block_size",
+                                  "Maximum number of communicator IDs reserved with a single "
+                                  "collective operation for communicators derived from the same "
+                                  "parent (duplicate, split, create). Creations served from a "
+                                  "reserved block require no agreement round. The first block of "
+                                  "a parent holds one ID and each following block twice as many. "
+                                  "0 disables the reservation and allocates every ID with the "
+                                  "iterative agreement protocol. Must be the same in all processes",
+                                  MCA_BASE_VAR_TYPE_INT, NULL,
+                                  0, 0, OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                  &ompi_comm_cid_block_size);
+
     ompi_mpi_dynamics_enabled = true;
     (void) mca_base_var_register("ompi", "mpi", NULL, "dynamics_enabled",
                                  "Is the MPI dynamic process functionality enabled (e.g., MPI_COMM_SPAWN)?  Default is yes, but certain transports and/or environments may disable it.",
@@ -324,9 +368,12 @@ int ompi_mpi_register_params(void)
                                       MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
     }
 
-    ompi_mpi_spc_attach_string = NULL;
+    ompi_mpi_spc_attach_string = "all";
     (void) mca_base_var_register("ompi", "mpi", NULL, "spc_attach",
-                                 "A comma delimeted string listing the software-based performance counters (SPCs) to enable.",
+                                 "A comma delimeted string listing the software-based performance counters (SPCs) to enable, "
+                                 "or \"all\" (default).  \"all\" leaves out the counters that slow down message matching "
+                                 "(OMPI_SPC_MATCH_TIME, the queue lengths and their maxima), which have to be "
+                                 "listed by name.  An empty string keeps all counters turned off until they are started through MPI_T.",
                                  MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
                                  OPAL_INFO_LVL_4,
                                  MCA_BASE_VAR_SCOPE_READONLY,
@@ -340,6 +387,86 @@ int ompi_mpi_register_params(void)
                                  MCA_BASE_VAR_SCOPE_READONLY,
                                  &ompi_mpi_spc_dump_enabled);
 
+    ompi_mpi_spc_hist_attach_string = NULL;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "spc_hist_attach",
+                                 "A comma delimited string listing the SPC latency histograms to enable, or \"all\". "
+                                 "Histograms can also be turned on by starting an MPI_T handle of their pvar.",
+                                 MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                 OPAL_INFO_LVL_4,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_spc_hist_attach_string);
+
+    ompi_mpi_trace = false;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "trace",
+                                 "Whether to record a binary trace of the point-to-point communication events "
+                                 "and the collective calls of every process (default: false).  The traces are "
+                                 "merged with the ompi_trace_merge tool.",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_4,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_trace);
+
+    ompi_mpi_trace_dir = NULL;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "trace_dir",
+                                 "Directory of the trace files ompi_trace.<jobid>.<rank> (default: the current working directory)",
+                                 MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                 OPAL_INFO_LVL_4,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_trace_dir);
+
+    ompi_mpi_trace_records = 65536;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "trace_records",
+                                 "Number of trace records buffered by each thread before they are written to the file",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_trace_records);
+    if (ompi_mpi_trace_records < 1) {
+        ompi_mpi_trace_records = 1;
+    }
+
+    ompi_mpi_trace_signal = SIGUSR2;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "trace_signal",
+                                 "Signal on which a traced process writes its buffered trace records to the file, "
+                                 "0 for none (default: SIGUSR2)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_trace_signal);
+
+    ompi_mpi_async_progress = false;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress",
+                                 "Whether to run a thread in every process that progresses the communications "
+                                 "in the background, e.g. the non-blocking collectives while the application "
+                                 "computes (default: false).  Enabling it forces MPI_THREAD_MULTIPLE: the library "
+                                 "takes the locks of that level and reports it, whatever level the application "
+                                 "requested.",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_4,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress);
+
+    ompi_mpi_async_progress_core = -1;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress_core",
+                                 "Logical index of the core of the node the progress thread is bound to, "
+                                 "-1 to keep the binding of the process (default: -1)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_4,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress_core);
+
+    ompi_mpi_async_progress_max_sleep = 50;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "async_progress_max_sleep",
+                                 "Longest time in microseconds the progress thread sleeps between two polls "
+                                 "once nothing happens, 0 to never sleep (default: 50)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_async_progress_max_sleep);
+    if (ompi_mpi_async_progress_max_sleep > 999999) {
+        ompi_mpi_async_progress_max_sleep = 999999;
+    }
+
     return OMPI_SUCCESS;
 }
 
@@ -17,6 +17,10 @@
 
 #include "ompi_spc.h"
 
+#include "opal/runtime/opal.h"
+#include "opal/threads/mutex.h"
+#include "opal/threads/tsd.h"
+
 opal_timer_t sys_clock_freq_mhz = 0;
 
 static void ompi_spc_dump(void);
@@ -145,12 +149,83 @@ static ompi_spc_event_t ompi_spc_events_names[OMPI_SPC_NUM_COUNTERS] = {
                                              "contained at once since the last reset of this counter. Note: This counter is reset each time it is read.")
 };
 
+#define SET_HIST_ARRAY(NAME, CALLS)   [NAME] = { .counter_name = #NAME, .counter_description = \
+    "Latency distribution of " CALLS ".  Element i counts the calls that took between 2^i and 2^(i+1) " \
+    "nanoseconds.  The first element also counts faster calls and the last element slower ones." }
+
+static ompi_spc_event_t ompi_spc_hist_names[OMPI_SPC_NUM_HISTOGRAMS] = {
+    SET_HIST_ARRAY(OMPI_SPC_HIST_SEND, "MPI_Send"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_RECV, "MPI_Recv"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_BARRIER, "MPI_Barrier"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_BCAST, "MPI_Bcast"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_REDUCE, "MPI_Reduce"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_ALLREDUCE, "MPI_Allreduce"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_REDUCE_SCATTER, "MPI_Reduce_scatter"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_REDUCE_SCATTER_BLOCK, "MPI_Reduce_scatter_block"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_SCAN, "MPI_Scan"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_EXSCAN, "MPI_Exscan"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_GATHER, "MPI_Gather"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_GATHERV, "MPI_Gatherv"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_SCATTER, "MPI_Scatter"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_SCATTERV, "MPI_Scatterv"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_ALLGATHER, "MPI_Allgather"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_ALLGATHERV, "MPI_Allgatherv"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_ALLTOALL, "MPI_Alltoall"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_ALLTOALLV, "MPI_Alltoallv"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_ALLTOALLW, "MPI_Alltoallw"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_WIN_FLUSH, "MPI_Win_flush, MPI_Win_flush_all, MPI_Win_flush_local and MPI_Win_flush_local_all"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_FILE_READ, "the blocking MPI_File_read functions"),
+    SET_HIST_ARRAY(OMPI_SPC_HIST_FILE_WRITE, "the blocking MPI_File_write functions")
+};
+
 /* An array of integer values to denote whether an event is activated (1) or not (0) */
-static uint32_t ompi_spc_attached_event[OMPI_SPC_NUM_COUNTERS / sizeof(uint32_t)] = { 0 };
+uint32_t ompi_spc_attached_event[OMPI_SPC_BITMAP_SIZE] = { 0 };
 /* An array of integer values to denote whether an event is timer-based (1) or not (0) */
-static uint32_t ompi_spc_timer_event[OMPI_SPC_NUM_COUNTERS / sizeof(uint32_t)] = { 0 };
-/* An array of event structures to store the event data (name and value) */
-static ompi_spc_t *ompi_spc_events = NULL;
+static uint32_t ompi_spc_timer_event[OMPI_SPC_BITMAP_SIZE] = { 0 };
+/* An array of integer values to denote whether an event is kept in the shared values (1) or not (0) */
+static uint32_t ompi_spc_shared_event[OMPI_SPC_BITMAP_SIZE] = { 0 };
+/* An array of integer values to denote whether a histogram is activated (1) or not (0) */
+uint32_t ompi_spc_attached_hist[(OMPI_SPC_NUM_HISTOGRAMS + 31) / 32] = { 0 };
+/* Number of reasons to keep a histogram activated: started MPI_T handles and the MCA parameter */
+static opal_atomic_int32_t ompi_spc_hist_users[OMPI_SPC_NUM_HISTOGRAMS] = { 0 };
+static double ompi_spc_ns_per_cycle = 0.0;
+
+/* Storage of the counter values.
+ *
+ * Every thread that records an event gets a shard of its own, i.e. an
+ * array with a value for every counter, padded to a multiple of the cache
+ * line size.  Only the owning thread writes to a shard, so no atomic
+ * operation is needed and the cache lines do not move between the cores.
+ * The value of a counter is the sum over all shards and the shared values
+ * and is computed when it is read.  The shard of a thread that exits is
+ * reused by the next thread that needs one, its counts are kept.
+ *
+ * The buckets of the latency histograms are stored the same way.
+ *
+ * The shared values are updated with atomic operations.  They are used
+ * by single threaded processes, if no shard can be allocated, and for the
+ * queue length counters and their watermarks, which have to be compared
+ * to each other.
+ */
+typedef struct ompi_spc_shard_t {
+    volatile size_t values[OMPI_SPC_NUM_COUNTERS];
+    volatile size_t hist[OMPI_SPC_NUM_HISTOGRAMS][OMPI_SPC_HIST_BUCKETS];
+    struct ompi_spc_shard_t *next;       /* all shards */
+    struct ompi_spc_shard_t *next_free;  /* shards of exited threads */
+} ompi_spc_shard_t;
+
+static ompi_spc_value_t *ompi_spc_shared = NULL;
+static ompi_spc_value_t *ompi_spc_shared_hist = NULL;
+static ompi_spc_shard_t *ompi_spc_shards = NULL;
+static ompi_spc_shard_t *ompi_spc_free_shards = NULL;
+static opal_mutex_t ompi_spc_shards_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_tsd_key_t ompi_spc_shard_key;
+static bool ompi_spc_shard_key_valid = false;
+/* Marks a thread for which no shard could be allocated */
+static ompi_spc_shard_t ompi_spc_no_shard;
+#if OPAL_HAVE_THREAD_LOCAL
+static opal_thread_local ompi_spc_shard_t *ompi_spc_local_shard = NULL;
+#endif
 
 static inline void SET_SPC_BIT(uint32_t* array, int32_t pos)
 {
@@ -170,6 +245,107 @@ static inline void CLEAR_SPC_BIT(uint32_t* array, int32_t pos)
     array[pos / (8 * sizeof(uint32_t))] &= ~(1U << (pos % (8 * sizeof(uint32_t))));
 }
 
+/* Called at the exit of a thread that owns a shard */
+static void ompi_spc_shard_release(void *value)
+{
+    ompi_spc_shard_t *shard = (ompi_spc_shard_t*)value;
+
+    if( NULL == shard || &ompi_spc_no_shard == shard ) {
+        return;
+    }
+    OPAL_THREAD_LOCK(&ompi_spc_shards_lock);
+    shard->next_free = ompi_spc_free_shards;
+    ompi_spc_free_shards = shard;
+    OPAL_THREAD_UNLOCK(&ompi_spc_shards_lock);
+}
+
+/* Assigns a shard to the calling thread on its first event */
+static ompi_spc_shard_t *ompi_spc_shard_attach(void)
+{
+    ompi_spc_shard_t *shard;
+    size_t size;
+
+    OPAL_THREAD_LOCK(&ompi_spc_shards_lock);
+    shard = ompi_spc_free_shards;
+    if( NULL != shard ) {
+        ompi_spc_free_shards = shard->next_free;
+    }
+    else {
+        size = (sizeof(ompi_spc_shard_t) + opal_cache_line_size - 1) /
+            opal_cache_line_size * opal_cache_line_size;
+        if( 0 == posix_memalign((void**)&shard, opal_cache_line_size, size) ) {
+            memset(shard, 0, size);
+            shard->next = ompi_spc_shards;
+            ompi_spc_shards = shard;
+        }
+        else {
+            shard = &ompi_spc_no_shard;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&ompi_spc_shards_lock);
+
+    (void)opal_tsd_setspecific(ompi_spc_shard_key, shard);
+#if OPAL_HAVE_THREAD_LOCAL
+    ompi_spc_local_shard = shard;
+#endif
+    return shard;
+}
+
+/* Returns the shard of the calling thread, NULL if the shared values have to be used */
+static inline ompi_spc_shard_t *ompi_spc_shard_get(void)
+{
+    ompi_spc_shard_t *shard;
+
+    if( !ompi_spc_shard_key_valid ) {
+        return NULL;
+    }
+#if OPAL_HAVE_THREAD_LOCAL
+    shard = ompi_spc_local_shard;
+#else
+    if( OPAL_SUCCESS != opal_tsd_getspecific(ompi_spc_shard_key, (void**)&shard) ) {
+        return NULL;
+    }
+#endif
+    if( OPAL_UNLIKELY(NULL == shard) ) {
+        shard = ompi_spc_shard_attach();
+    }
+    return (&ompi_spc_no_shard == shard) ? NULL : shard;
+}
+
+/* Adds up the value of a counter.  Values of other threads that are being
+ * updated concurrently might be missing.
+ */
+static size_t ompi_spc_value(int index)
+{
+    ompi_spc_shard_t *shard;
+    size_t value = ompi_spc_shared[index];
+
+    OPAL_THREAD_LOCK(&ompi_spc_shards_lock);
+    for(shard = ompi_spc_shards; NULL != shard; shard = shard->next) {
+        value += shard->values[index];
+    }
+    OPAL_THREAD_UNLOCK(&ompi_spc_shards_lock);
+    return value;
+}
+
+/* Adds up the buckets of a histogram */
+static void ompi_spc_hist_value(int index, unsigned long long *buckets)
+{
+    ompi_spc_shard_t *shard;
+    int i;
+
+    for(i = 0; i < OMPI_SPC_HIST_BUCKETS; i++) {
+        buckets[i] = ompi_spc_shared_hist[index * OMPI_SPC_HIST_BUCKETS + i];
+    }
+    OPAL_THREAD_LOCK(&ompi_spc_shards_lock);
+    for(shard = ompi_spc_shards; NULL != shard; shard = shard->next) {
+        for(i = 0; i < OMPI_SPC_HIST_BUCKETS; i++) {
+            buckets[i] += shard->hist[index][i];
+        }
+    }
+    OPAL_THREAD_UNLOCK(&ompi_spc_shards_lock);
+}
+
 /* ##############################################################
  * ################# Begin MPI_T Functions ######################
  * ##############################################################
@@ -206,6 +382,40 @@ static int ompi_spc_notify(mca_base_pvar_t *pvar, mca_base_pvar_event_t event, v
     return MPI_SUCCESS;
 }
 
+/* The histograms are not continuous, so that an MPI_T handle turns the
+ * histogram on while it is started.
+ */
+static int ompi_spc_hist_notify(mca_base_pvar_t *pvar, mca_base_pvar_event_t event, void *obj_handle, int *count)
+{
+    int index = (int)(uintptr_t)pvar->ctx;
+
+    if(MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = OMPI_SPC_HIST_BUCKETS;
+    }
+    else if(MCA_BASE_PVAR_HANDLE_START == event) {
+        if( 1 == OPAL_THREAD_ADD_FETCH32(&ompi_spc_hist_users[index], 1) ) {
+            SET_SPC_BIT(ompi_spc_attached_hist, index);
+        }
+    }
+    else if(MCA_BASE_PVAR_HANDLE_STOP == event) {
+        if( 0 == OPAL_THREAD_ADD_FETCH32(&ompi_spc_hist_users[index], -1) ) {
+            CLEAR_SPC_BIT(ompi_spc_attached_hist, index);
+        }
+    }
+
+    return MPI_SUCCESS;
+}
+
+static int ompi_spc_hist_get(const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    if( NULL == ompi_spc_shared_hist ) {
+        memset(value, 0, OMPI_SPC_HIST_BUCKETS * sizeof(unsigned long long));
+        return MPI_SUCCESS;
+    }
+    ompi_spc_hist_value((int)(uintptr_t)pvar->ctx, (unsigned long long*)value);
+    return MPI_SUCCESS;
+}
+
 /* ##############################################################
  * ################# Begin SPC Functions ########################
  * ##############################################################
@@ -231,14 +441,14 @@ static int ompi_spc_get_count(const struct mca_base_pvar_t *pvar, void *value, v
     /* Convert from MPI_T pvar index to SPC index */
     int index = (int)(uintptr_t)pvar->ctx;
     /* Set the counter value to the current SPC value */
-    *counter_value = (long long)ompi_spc_events[index].value;
+    *counter_value = (long long)ompi_spc_value(index);
     /* If this is a timer-based counter, convert from cycles to microseconds */
     if( IS_SPC_BIT_SET(ompi_spc_timer_event, index) ) {
         *counter_value /= sys_clock_freq_mhz;
     }
     /* If this is a high watermark counter, reset it after it has been read */
     if(index == OMPI_SPC_MAX_UNEXPECTED_IN_QUEUE || index == OMPI_SPC_MAX_OOS_IN_QUEUE) {
-        ompi_spc_events[index].value = 0;
+        ompi_spc_shared[index] = 0;
     }
 
     return MPI_SUCCESS;
@@ -249,21 +459,41 @@ void ompi_spc_events_init(void)
 {
     int i;
 
-    /* If the events data structure hasn't been allocated yet, allocate memory for it */
-    if(NULL == ompi_spc_events) {
-        ompi_spc_events = (ompi_spc_t*)malloc(OMPI_SPC_NUM_COUNTERS * sizeof(ompi_spc_t));
-        if(ompi_spc_events == NULL) {
+    /* If the shared values haven't been allocated yet, allocate memory for them */
+    if(NULL == ompi_spc_shared) {
+        ompi_spc_shared = (ompi_spc_value_t*)malloc(OMPI_SPC_NUM_COUNTERS * sizeof(ompi_spc_value_t));
+        ompi_spc_shared_hist = (ompi_spc_value_t*)malloc(OMPI_SPC_NUM_HISTOGRAMS * OMPI_SPC_HIST_BUCKETS *
+                                                         sizeof(ompi_spc_value_t));
+        if(ompi_spc_shared == NULL || ompi_spc_shared_hist == NULL) {
             opal_show_help("help-mpi-runtime.txt", "lib-call-fail", true,
                            "malloc", __FILE__, __LINE__);
+            free((void*)ompi_spc_shared); ompi_spc_shared = NULL;
+            free((void*)ompi_spc_shared_hist); ompi_spc_shared_hist = NULL;
             return;
         }
     }
-    /* The data structure has been allocated, so we simply initialize all of the counters
-     * with their names and an initial count of 0.
+    /* The shared values have been allocated, so we simply initialize all of the counters
+     * with an initial count of 0.
      */
     for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
-        ompi_spc_events[i].name = (char*)ompi_spc_events_names[i].counter_name;
-        ompi_spc_events[i].value = 0;
+        ompi_spc_shared[i] = 0;
+    }
+    for(i = 0; i < OMPI_SPC_NUM_HISTOGRAMS * OMPI_SPC_HIST_BUCKETS; i++) {
+        ompi_spc_shared_hist[i] = 0;
+    }
+
+    /* The queue lengths are incremented and decremented by different threads
+     * and compared to their watermarks, so they are not split into shards.
+     */
+    SET_SPC_BIT(ompi_spc_shared_event, OMPI_SPC_UNEXPECTED_IN_QUEUE);
+    SET_SPC_BIT(ompi_spc_shared_event, OMPI_SPC_OOS_IN_QUEUE);
+    SET_SPC_BIT(ompi_spc_shared_event, OMPI_SPC_MAX_UNEXPECTED_IN_QUEUE);
+    SET_SPC_BIT(ompi_spc_shared_event, OMPI_SPC_MAX_OOS_IN_QUEUE);
+
+    /* A single threaded process uses the shared values only */
+    if( opal_using_threads() && !ompi_spc_shard_key_valid ) {
+        ompi_spc_shard_key_valid =
+            (OPAL_SUCCESS == opal_tsd_key_create(&ompi_spc_shard_key, ompi_spc_shard_release));
     }
 
     ompi_comm_dup(&ompi_mpi_comm_world.comm, &ompi_spc_comm);
@@ -278,8 +508,12 @@ void ompi_spc_init(void)
 
     /* Initialize the clock frequency variable as the CPU's frequency in MHz */
     sys_clock_freq_mhz = opal_timer_base_get_freq() / 1000000;
+    ompi_spc_ns_per_cycle = 1.0e9 / (double)opal_timer_base_get_freq();
 
     ompi_spc_events_init();
+    if(NULL == ompi_spc_shared) {
+        return;
+    }
 
     /* Get the MCA params string of counters to turn on */
     char **arg_strings = opal_argv_split(ompi_mpi_spc_attach_string, ',');
@@ -297,7 +531,13 @@ void ompi_spc_init(void)
     for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
         /* Reset all timer-based counters */
         CLEAR_SPC_BIT(ompi_spc_timer_event, i);
-        matched = all_on;
+        /* 'all' leaves out the counters that are costly on the matching
+         * path: the queue lengths and their watermarks are shared atomics
+         * updated with a compare-and-swap loop, and the match time reads
+         * the timer on every match. They have to be named or started
+         * through MPI_T.
+         */
+        matched = all_on && !IS_SPC_BIT_SET(ompi_spc_shared_event, i) && OMPI_SPC_MATCH_TIME != i;
 
         if( !matched ) {
             /* Turn on only the counters that were specified in the MCA parameter */
@@ -311,7 +551,6 @@ void ompi_spc_init(void)
 
         if (matched) {
             SET_SPC_BIT(ompi_spc_attached_event, i);
-            mpi_t_enabled = true;
             found++;
         }
 
@@ -326,12 +565,41 @@ void ompi_spc_init(void)
             opal_show_help("help-mpi-runtime.txt", "spc: MPI_T disabled", true);
             break;
         }
+        /* Counters can be turned on through MPI_T once they are registered */
+        mpi_t_enabled = true;
     }
 
     /* If this is a timer event, set the corresponding timer_event entry */
     SET_SPC_BIT(ompi_spc_timer_event, OMPI_SPC_MATCH_TIME);
 
     opal_argv_free(arg_strings);
+
+    /* Turn on the histograms that were specified in the mpi_spc_hist_attach MCA parameter */
+    arg_strings = opal_argv_split(ompi_mpi_spc_hist_attach_string, ',');
+    num_args    = opal_argv_count(arg_strings);
+    all_on      = (1 == num_args && 0 == strcmp(arg_strings[0], "all"));
+
+    for(i = 0; i < OMPI_SPC_NUM_HISTOGRAMS; i++) {
+        matched = all_on;
+        for(j = 0; j < num_args && !matched; j++) {
+            matched = (0 == strcmp(ompi_spc_hist_names[i].counter_name, arg_strings[j]));
+        }
+        ompi_spc_hist_users[i] = matched;
+        if (matched) {
+            SET_SPC_BIT(ompi_spc_attached_hist, i);
+        }
+
+        ret = mca_base_pvar_register("ompi", "runtime", "spc", ompi_spc_hist_names[i].counter_name, ompi_spc_hist_names[i].counter_description,
+                                     OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_COUNTER,
+                                     MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL, MPI_T_BIND_NO_OBJECT,
+                                     MCA_BASE_PVAR_FLAG_READONLY,
+                                     ompi_spc_hist_get, NULL, ompi_spc_hist_notify, (void*)(uintptr_t)i);
+        if( ret < 0 ) {
+            break;
+        }
+    }
+
+    opal_argv_free(arg_strings);
 }
 
 /* Gathers all of the SPC data onto rank 0 of MPI_COMM_WORLD and prints out all
@@ -345,13 +613,6 @@ static void ompi_spc_dump(void)
     int rank = ompi_comm_rank(ompi_spc_comm);
     world_size = ompi_comm_size(ompi_spc_comm);
 
-    /* Convert from cycles to usecs before sending */
-    for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
-        if( IS_SPC_BIT_SET(ompi_spc_timer_event, i) ) {
-            SPC_CYCLES_TO_USECS(&ompi_spc_events[i].value);
-        }
-    }
-
     /* Aggregate all of the information on rank 0 using MPI_Gather on MPI_COMM_WORLD */
     send_buffer = (long long*)malloc(OMPI_SPC_NUM_COUNTERS * sizeof(long long));
     if (NULL == send_buffer) {
@@ -360,7 +621,11 @@ static void ompi_spc_dump(void)
         return;
     }
     for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
-        send_buffer[i] = (long long)ompi_spc_events[i].value;
+        send_buffer[i] = (long long)ompi_spc_value(i);
+        /* Convert from cycles to usecs before sending */
+        if( IS_SPC_BIT_SET(ompi_spc_timer_event, i) ) {
+            send_buffer[i] /= sys_clock_freq_mhz;
+        }
     }
     if( 0 == rank ) {
         recv_buffer = (long long*)malloc(world_size * OMPI_SPC_NUM_COUNTERS * sizeof(long long));
@@ -386,7 +651,7 @@ static void ompi_spc_dump(void)
                 if( 0 == recv_buffer[offset+i] ) {
                     continue;
                 }
-                opal_output(0, "%s -> %lld\n", ompi_spc_events[i].name, recv_buffer[offset+i]);
+                opal_output(0, "%s -> %lld\n", ompi_spc_events_names[i].counter_name, recv_buffer[offset+i]);
             }
             opal_output(0, "\n");
             offset += OMPI_SPC_NUM_COUNTERS;
@@ -405,20 +670,62 @@ static void ompi_spc_dump(void)
 /* Frees any dynamically alocated OMPI SPC data structures */
 void ompi_spc_fini(void)
 {
-    if (SPC_ENABLE == 1 && ompi_mpi_spc_dump_enabled) {
+    ompi_spc_shard_t *shard;
+    int i;
+
+    if (SPC_ENABLE == 1 && ompi_mpi_spc_dump_enabled && NULL != ompi_spc_shared) {
         ompi_spc_dump();
     }
 
-    free(ompi_spc_events); ompi_spc_events = NULL;
+    /* No more events are recorded, MPI cannot be initialized again */
+    for(i = 0; i < OMPI_SPC_NUM_COUNTERS; i++) {
+        CLEAR_SPC_BIT(ompi_spc_attached_event, i);
+    }
+    for(i = 0; i < OMPI_SPC_NUM_HISTOGRAMS; i++) {
+        CLEAR_SPC_BIT(ompi_spc_attached_hist, i);
+        ompi_spc_hist_users[i] = 0;
+    }
+    if( ompi_spc_shard_key_valid ) {
+        (void)opal_tsd_key_delete(ompi_spc_shard_key);
+        ompi_spc_shard_key_valid = false;
+    }
+    while( NULL != (shard = ompi_spc_shards) ) {
+        ompi_spc_shards = shard->next;
+        free(shard);
+    }
+    ompi_spc_free_shards = NULL;
+
+    free((void*)ompi_spc_shared); ompi_spc_shared = NULL;
+    free((void*)ompi_spc_shared_hist); ompi_spc_shared_hist = NULL;
     ompi_comm_free(&ompi_spc_comm);
 }
 
-/* Records an update to a counter using an atomic add operation. */
+/* Adds to a counter in the shard of the calling thread, or in the shared values
+ * using an atomic add operation.
+ */
+static inline void ompi_spc_add(unsigned int event_id, size_t value)
+{
+    ompi_spc_shard_t *shard = NULL;
+
+    if( !IS_SPC_BIT_SET(ompi_spc_shared_event, event_id) ) {
+        shard = ompi_spc_shard_get();
+    }
+    if( NULL != shard ) {
+        /* Only this thread writes to its shard */
+        shard->values[event_id] += value;
+    }
+    else {
+        OPAL_THREAD_ADD_FETCH_SIZE_T(&ompi_spc_shared[event_id], value);
+    }
+}
+
+/* Records an update to a counter.  The SPC_RECORD macro only calls this
+ * function for counters that are turned on.
+ */
 void ompi_spc_record(unsigned int event_id, ompi_spc_value_t value)
 {
-    /* Denoted unlikely because counters will often be turned off. */
-    if( OPAL_UNLIKELY(IS_SPC_BIT_SET(ompi_spc_attached_event, event_id)) ) {
-        OPAL_THREAD_ADD_FETCH_SIZE_T(&(ompi_spc_events[event_id].value), value);
+    if( IS_SPC_BIT_SET(ompi_spc_attached_event, event_id) ) {
+        ompi_spc_add(event_id, (size_t)value);
     }
 }
 
@@ -445,7 +752,7 @@ void ompi_spc_timer_stop(unsigned int event_id, opal_timer_t *cycles)
     /* This is denoted unlikely because the counters will often be turned off. */
     if( OPAL_UNLIKELY(IS_SPC_BIT_SET(ompi_spc_attached_event, event_id)) ) {
         *cycles = opal_timer_base_get_cycles() - *cycles;
-        OPAL_THREAD_ADD_FETCH_SIZE_T(&ompi_spc_events[event_id].value, (size_t) *cycles);
+        ompi_spc_add(event_id, (size_t) *cycles);
     }
 }
 
@@ -463,14 +770,21 @@ void ompi_spc_user_or_mpi(int tag, ompi_spc_value_t value, unsigned int user_enu
  */
 void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_enum)
 {
+    size_t value, watermark;
+
     /* Denoted unlikely because counters will often be turned off. */
     if( OPAL_UNLIKELY(IS_SPC_BIT_SET(ompi_spc_attached_event, watermark_enum) &&
                       IS_SPC_BIT_SET(ompi_spc_attached_event, value_enum)) ) {
-        /* WARNING: This assumes that this function was called while a lock has already been taken.
-         *          This function is NOT thread safe otherwise!
+        /* Both counters are kept in the shared values.  The queues of different
+         * communicators are protected by different locks, so the update is atomic.
          */
-        if(ompi_spc_events[value_enum].value > ompi_spc_events[watermark_enum].value) {
-            ompi_spc_events[watermark_enum].value = ompi_spc_events[value_enum].value;
+        value = ompi_spc_shared[value_enum];
+        watermark = ompi_spc_shared[watermark_enum];
+        while( value > watermark ) {
+            if( OPAL_THREAD_COMPARE_EXCHANGE_STRONG_PTR(&ompi_spc_shared[watermark_enum],
+                                                        &watermark, value) ) {
+                break;
+            }
         }
     }
 }
@@ -481,3 +795,37 @@ void ompi_spc_cycles_to_usecs(ompi_spc_value_t *cycles)
 {
     *cycles = *cycles / sys_clock_freq_mhz;
 }
+
+/* Records the duration of an operation in a latency histogram.
+ */
+void ompi_spc_hist_record(unsigned int hist_id, opal_timer_t cycles)
+{
+    uint64_t nsecs = (uint64_t)((double)cycles * ompi_spc_ns_per_cycle);
+    ompi_spc_shard_t *shard;
+    int bucket;
+
+    /* The bucket is the position of the highest bit set */
+    if( nsecs >= (1ULL << (OMPI_SPC_HIST_BUCKETS - 1)) ) {
+        bucket = OMPI_SPC_HIST_BUCKETS - 1;
+    }
+    else if( 0 == nsecs ) {
+        bucket = 0;
+    }
+    else {
+#if OPAL_C_HAVE_BUILTIN_CLZ
+        bucket = (8 * sizeof(unsigned int) - 1) - __builtin_clz((unsigned int)nsecs);
+#else
+        for(bucket = 0; nsecs > 1; nsecs >>= 1) {
+            bucket++;
+        }
+#endif
+    }
+
+    shard = ompi_spc_shard_get();
+    if( NULL != shard ) {
+        shard->hist[hist_id][bucket]++;
+    }
+    else {
+        OPAL_THREAD_ADD_FETCH_SIZE_T(&ompi_spc_shared_hist[hist_id * OMPI_SPC_HIST_BUCKETS + bucket], 1);
+    }
+}
@@ -163,16 +163,53 @@ typedef enum ompi_spc_counters {
     OMPI_SPC_NUM_COUNTERS /* This serves as the number of counters.  It must be last. */
 } ompi_spc_counters_t;
 
+/* Latency histograms.  Adding a histogram works like adding a counter, the
+ * names and descriptions are in the ompi_spc_hist_names array in ompi_spc.c.
+ */
+typedef enum ompi_spc_hist_id_t {
+    OMPI_SPC_HIST_SEND,
+    OMPI_SPC_HIST_RECV,
+    OMPI_SPC_HIST_BARRIER,
+    OMPI_SPC_HIST_BCAST,
+    OMPI_SPC_HIST_REDUCE,
+    OMPI_SPC_HIST_ALLREDUCE,
+    OMPI_SPC_HIST_REDUCE_SCATTER,
+    OMPI_SPC_HIST_REDUCE_SCATTER_BLOCK,
+    OMPI_SPC_HIST_SCAN,
+    OMPI_SPC_HIST_EXSCAN,
+    OMPI_SPC_HIST_GATHER,
+    OMPI_SPC_HIST_GATHERV,
+    OMPI_SPC_HIST_SCATTER,
+    OMPI_SPC_HIST_SCATTERV,
+    OMPI_SPC_HIST_ALLGATHER,
+    OMPI_SPC_HIST_ALLGATHERV,
+    OMPI_SPC_HIST_ALLTOALL,
+    OMPI_SPC_HIST_ALLTOALLV,
+    OMPI_SPC_HIST_ALLTOALLW,
+    OMPI_SPC_HIST_WIN_FLUSH,
+    OMPI_SPC_HIST_FILE_READ,
+    OMPI_SPC_HIST_FILE_WRITE,
+    OMPI_SPC_NUM_HISTOGRAMS /* This serves as the number of histograms.  It must be last. */
+} ompi_spc_hist_id_t;
+
+/* Bucket i of a histogram counts the operations that took between 2^i and
+ * 2^(i+1) nanoseconds.  The first bucket also counts faster operations and
+ * the last bucket slower ones.
+ */
+#define OMPI_SPC_HIST_BUCKETS 32
+
 /* There is currently no support for atomics on long long values so we will default to
  * size_t for now until support for such atomics is implemented.
  */
 typedef opal_atomic_size_t ompi_spc_value_t;
 
-/* A structure for storing the event data */
-typedef struct ompi_spc_s{
-    char *name;
-    ompi_spc_value_t value;
-} ompi_spc_t;
+/* Number of 32 bit words in the bitmaps of the counters */
+#define OMPI_SPC_BITMAP_SIZE ((OMPI_SPC_NUM_COUNTERS + 31) / 32)
+
+/* A bit for every counter that is turned on */
+OMPI_DECLSPEC extern uint32_t ompi_spc_attached_event[OMPI_SPC_BITMAP_SIZE];
+/* A bit for every histogram that is turned on */
+OMPI_DECLSPEC extern uint32_t ompi_spc_attached_hist[(OMPI_SPC_NUM_HISTOGRAMS + 31) / 32];
 
 /* Events data structure initialization function */
 void ompi_spc_events_init(void);
@@ -180,12 +217,26 @@ void ompi_spc_events_init(void);
 /* OMPI SPC utility functions */
 void ompi_spc_init(void);
 void ompi_spc_fini(void);
-void ompi_spc_record(unsigned int event_id, ompi_spc_value_t value);
-void ompi_spc_timer_start(unsigned int event_id, opal_timer_t *cycles);
-void ompi_spc_timer_stop(unsigned int event_id, opal_timer_t *cycles);
-void ompi_spc_user_or_mpi(int tag, ompi_spc_value_t value, unsigned int user_enum, unsigned int mpi_enum);
+OMPI_DECLSPEC void ompi_spc_record(unsigned int event_id, ompi_spc_value_t value);
+OMPI_DECLSPEC void ompi_spc_timer_start(unsigned int event_id, opal_timer_t *cycles);
+OMPI_DECLSPEC void ompi_spc_timer_stop(unsigned int event_id, opal_timer_t *cycles);
+OMPI_DECLSPEC void ompi_spc_user_or_mpi(int tag, ompi_spc_value_t value, unsigned int user_enum, unsigned int mpi_enum);
 void ompi_spc_cycles_to_usecs(ompi_spc_value_t *cycles);
-void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_enum);
+OMPI_DECLSPEC void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_enum);
+OMPI_DECLSPEC void ompi_spc_hist_record(unsigned int hist_id, opal_timer_t cycles);
+
+/* Checks whether a counter is turned on.  This is all the macros below do
+ * for a counter that is turned off, so the counters can stay compiled in.
+ */
+static inline bool ompi_spc_is_attached(unsigned int event_id)
+{
+    return !!(ompi_spc_attached_event[event_id / 32] & (1U << (event_id % 32)));
+}
+
+static inline bool ompi_spc_hist_is_attached(unsigned int hist_id)
+{
+    return !!(ompi_spc_attached_hist[hist_id / 32] & (1U << (hist_id % 32)));
+}
 
 /* Macros for using the SPC utility functions throughout the codebase.
  * If SPC_ENABLE is not 1, the macros become no-ops.
@@ -198,17 +249,29 @@ void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_e
 #define SPC_FINI()  \
     ompi_spc_fini()
 
-#define SPC_RECORD(event_id, value)  \
-    ompi_spc_record(event_id, value)
+#define SPC_RECORD(event_id, value)                 \
+    do {                                            \
+        if( ompi_spc_is_attached(event_id) ) {      \
+            ompi_spc_record(event_id, value);       \
+        }                                           \
+    } while (0)
 
-#define SPC_TIMER_START(event_id, usec)  \
-    ompi_spc_timer_start(event_id, usec)
+#define SPC_TIMER_START(event_id, usec)             \
+    do {                                            \
+        if( ompi_spc_is_attached(event_id) ) {      \
+            ompi_spc_timer_start(event_id, usec);   \
+        }                                           \
+    } while (0)
 
-#define SPC_TIMER_STOP(event_id, usec)  \
-    ompi_spc_timer_stop(event_id, usec)
+#define SPC_TIMER_STOP(event_id, usec)              \
+    do {                                            \
+        if( ompi_spc_is_attached(event_id) ) {      \
+            ompi_spc_timer_stop(event_id, usec);    \
+        }                                           \
+    } while (0)
 
-#define SPC_USER_OR_MPI(tag, value, enum_if_user, enum_if_mpi) \
-    ompi_spc_user_or_mpi(tag, value, enum_if_user, enum_if_mpi)
+#define SPC_USER_OR_MPI(tag, value, enum_if_user, enum_if_mpi)   \
+    SPC_RECORD(((tag) >= 0 ? (enum_if_user) : (enum_if_mpi)), value)
 
 #define SPC_CYCLES_TO_USECS(cycles) \
     ompi_spc_cycles_to_usecs(cycles)
@@ -216,6 +279,23 @@ void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_e
 #define SPC_UPDATE_WATERMARK(watermark_enum, value_enum) \
     ompi_spc_update_watermark(watermark_enum, value_enum)
 
+/* Time an operation for a latency histogram.  The 'cycles' argument has to
+ * be initialized to 0.
+ */
+#define SPC_HIST_START(hist_id, cycles)                                 \
+    do {                                                                \
+        if( ompi_spc_hist_is_attached(hist_id) ) {                      \
+            *(cycles) = opal_timer_base_get_cycles();                   \
+        }                                                               \
+    } while (0)
+
+#define SPC_HIST_STOP(hist_id, cycles)                                  \
+    do {                                                                \
+        if( 0 != *(cycles) && ompi_spc_hist_is_attached(hist_id) ) {    \
+            ompi_spc_hist_record(hist_id, opal_timer_base_get_cycles() - *(cycles)); \
+        }                                                               \
+    } while (0)
+
 #else /* SPCs are not enabled */
 
 #define SPC_INIT()  \
@@ -242,6 +322,12 @@ void ompi_spc_update_watermark(unsigned int watermark_enum, unsigned int value_e
 #define SPC_UPDATE_WATERMARK(watermark_enum, value_enum) \
     ((void)0)
 
+#define SPC_HIST_START(hist_id, cycles)  \
+    ((void)(cycles))
+
+#define SPC_HIST_STOP(hist_id, cycles)  \
+    ((void)(cycles))
+
 #endif
 
 #endif
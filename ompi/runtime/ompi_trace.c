@@ -0,0 +1,380 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ompi/runtime/ompi_trace.h"
+#include "ompi/runtime/params.h"
+#include "ompi/runtime/ompi_rte.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/group/group.h"
+#include "ompi/constants.h"
+
+#include "opal/class/opal_ring_buffer.h"
+#include "opal/mca/timer/timer.h"
+#include "opal/runtime/opal.h"
+#include "opal/threads/mutex.h"
+#include "opal/threads/tsd.h"
+#include "opal/util/output.h"
+#include "opal/util/proc.h"
+
+#include MCA_timer_IMPLEMENTATION_HEADER
+
+bool ompi_trace_enabled = false;
+
+/* Ring of a thread.  Only the owning thread appends records, the rings
+ * are emptied under ompi_trace_lock, by the owner when its ring is full
+ * and by any thread for a signal and in MPI_Finalize.  The ring of a
+ * thread that exits is reused by the next thread that needs one. */
+typedef struct ompi_trace_ring_t {
+    opal_record_ring_t ring;
+    uint32_t thread;
+    uint64_t seq;                         /* of the next record */
+    struct ompi_trace_ring_t *next;       /* all rings */
+    struct ompi_trace_ring_t *next_free;  /* rings of exited threads */
+} ompi_trace_ring_t;
+
+static ompi_trace_ring_t *ompi_trace_rings = NULL;
+static ompi_trace_ring_t *ompi_trace_free_rings = NULL;
+static uint32_t ompi_trace_num_rings = 0;
+static opal_mutex_t ompi_trace_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_tsd_key_t ompi_trace_ring_key;
+static bool ompi_trace_ring_key_valid = false;
+/* Marks a thread for which no ring could be allocated */
+static ompi_trace_ring_t ompi_trace_no_ring;
+#if OPAL_HAVE_THREAD_LOCAL
+static opal_thread_local ompi_trace_ring_t *ompi_trace_local_ring = NULL;
+#endif
+/* Ring of the thread that called MPI_Init, used if there are no threads */
+static ompi_trace_ring_t *ompi_trace_main_ring = NULL;
+
+static int ompi_trace_fd = -1;
+static char *ompi_trace_path = NULL;
+static opal_atomic_size_t ompi_trace_dropped = 0;
+
+static volatile sig_atomic_t ompi_trace_flush_requested = 0;
+static struct sigaction ompi_trace_old_action;
+static bool ompi_trace_signal_installed = false;
+
+static void ompi_trace_signal_handler(int sig)
+{
+    ompi_trace_flush_requested = 1;
+}
+
+static int ompi_trace_write(const void *buf, size_t len)
+{
+    const char *ptr = (const char*)buf;
+    ssize_t ret;
+
+    while( len > 0 ) {
+        ret = write(ompi_trace_fd, ptr, len);
+        if( -1 == ret ) {
+            if( EINTR == errno ) {
+                continue;
+            }
+            return OMPI_ERROR;
+        }
+        ptr += ret;
+        len -= ret;
+    }
+    return OMPI_SUCCESS;
+}
+
+/* Write the records of a ring to the file.  Called with ompi_trace_lock held. */
+static void ompi_trace_flush_ring(ompi_trace_ring_t *tr)
+{
+    void *records;
+    size_t count;
+
+    while( NULL != (records = opal_record_ring_peek(&tr->ring, &count)) ) {
+        if( -1 != ompi_trace_fd &&
+            OMPI_SUCCESS != ompi_trace_write(records, count * sizeof(ompi_trace_record_t)) ) {
+            opal_output(0, "mpi_trace: writing %s failed: %s, the trace is turned off",
+                        ompi_trace_path, strerror(errno));
+            close(ompi_trace_fd);
+            ompi_trace_fd = -1;
+            ompi_trace_enabled = false;
+        }
+        opal_record_ring_release(&tr->ring, count);
+    }
+}
+
+static void ompi_trace_flush_all(void)
+{
+    ompi_trace_ring_t *tr;
+
+    OPAL_THREAD_LOCK(&ompi_trace_lock);
+    for( tr = ompi_trace_rings; NULL != tr; tr = tr->next ) {
+        ompi_trace_flush_ring(tr);
+    }
+    OPAL_THREAD_UNLOCK(&ompi_trace_lock);
+}
+
+/* Called at the exit of a thread that owns a ring */
+static void ompi_trace_ring_release(void *value)
+{
+    ompi_trace_ring_t *tr = (ompi_trace_ring_t*)value;
+
+    if( NULL == tr || &ompi_trace_no_ring == tr ) {
+        return;
+    }
+    OPAL_THREAD_LOCK(&ompi_trace_lock);
+    tr->next_free = ompi_trace_free_rings;
+    ompi_trace_free_rings = tr;
+    OPAL_THREAD_UNLOCK(&ompi_trace_lock);
+}
+
+/* Assigns a ring to the calling thread on its first event */
+static ompi_trace_ring_t *ompi_trace_ring_attach(void)
+{
+    ompi_trace_ring_t *tr;
+
+    OPAL_THREAD_LOCK(&ompi_trace_lock);
+    tr = ompi_trace_free_rings;
+    if( NULL != tr ) {
+        ompi_trace_free_rings = tr->next_free;
+    }
+    else {
+        tr = (ompi_trace_ring_t*)malloc(sizeof(ompi_trace_ring_t));
+        if( NULL != tr ) {
+            OBJ_CONSTRUCT(&tr->ring, opal_record_ring_t);
+            if( OPAL_SUCCESS != opal_record_ring_init(&tr->ring, sizeof(ompi_trace_record_t),
+                                                      (size_t)ompi_mpi_trace_records) ) {
+                OBJ_DESTRUCT(&tr->ring);
+                free(tr);
+                tr = NULL;
+            }
+        }
+        if( NULL != tr ) {
+            tr->thread = ompi_trace_num_rings++;
+            tr->seq = 0;
+            tr->next = ompi_trace_rings;
+            tr->next_free = NULL;
+            ompi_trace_rings = tr;
+        }
+        else {
+            tr = &ompi_trace_no_ring;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&ompi_trace_lock);
+
+    (void)opal_tsd_setspecific(ompi_trace_ring_key, tr);
+#if OPAL_HAVE_THREAD_LOCAL
+    ompi_trace_local_ring = tr;
+#endif
+    return tr;
+}
+
+/* Returns the ring of the calling thread, NULL if there is none */
+static inline ompi_trace_ring_t *ompi_trace_ring_get(void)
+{
+    ompi_trace_ring_t *tr;
+
+    if( !opal_using_threads() ) {
+        return ompi_trace_main_ring;
+    }
+#if OPAL_HAVE_THREAD_LOCAL
+    tr = ompi_trace_local_ring;
+#else
+    if( OPAL_SUCCESS != opal_tsd_getspecific(ompi_trace_ring_key, (void**)&tr) ) {
+        return NULL;
+    }
+#endif
+    if( OPAL_UNLIKELY(NULL == tr) ) {
+        tr = ompi_trace_ring_attach();
+    }
+    return (&ompi_trace_no_ring == tr) ? NULL : tr;
+}
+
+void ompi_trace_record(int event, int op, struct ompi_communicator_t *comm,
+                       int peer, int tag, size_t bytes, const void *req)
+{
+    ompi_trace_ring_t *tr = ompi_trace_ring_get();
+    ompi_trace_record_t *rec;
+
+    if( OPAL_UNLIKELY(ompi_trace_flush_requested) ) {
+        ompi_trace_flush_requested = 0;
+        ompi_trace_flush_all();
+    }
+    if( OPAL_UNLIKELY(NULL == tr) ) {
+        (void)OPAL_THREAD_ADD_FETCH_SIZE_T(&ompi_trace_dropped, 1);
+        return;
+    }
+
+    rec = (ompi_trace_record_t*)opal_record_ring_reserve(&tr->ring);
+    if( OPAL_UNLIKELY(NULL == rec) ) {
+        OPAL_THREAD_LOCK(&ompi_trace_lock);
+        ompi_trace_flush_ring(tr);
+        OPAL_THREAD_UNLOCK(&ompi_trace_lock);
+        rec = (ompi_trace_record_t*)opal_record_ring_reserve(&tr->ring);
+        if( NULL == rec ) {
+            (void)OPAL_THREAD_ADD_FETCH_SIZE_T(&ompi_trace_dropped, 1);
+            return;
+        }
+    }
+
+    rec->time = (uint64_t)opal_timer_base_get_cycles();
+    rec->req = (uint64_t)(uintptr_t)req;
+    rec->bytes = (uint64_t)bytes;
+    rec->cid = 0;
+    rec->peer = peer;
+    rec->world_peer = -1;
+    rec->tag = tag;
+    rec->event = (uint16_t)event;
+    rec->op = (uint16_t)op;
+    rec->thread = tr->thread;
+    rec->seq = tr->seq++;
+
+    if( NULL != comm ) {
+        rec->cid = comm->c_contextid;
+        if( 0 <= peer && peer < ompi_comm_remote_size(comm) ) {
+            opal_process_name_t name = ompi_group_get_proc_name(comm->c_remote_group, peer);
+            if( name.jobid == OMPI_PROC_MY_NAME->jobid ) {
+                rec->world_peer = (int32_t)name.vpid;
+            }
+        }
+    }
+
+    opal_record_ring_commit(&tr->ring);
+}
+
+int ompi_trace_init(void)
+{
+    ompi_trace_header_t header;
+    struct timespec now;
+    const char *dir;
+    int ret;
+
+    if( !ompi_mpi_trace ) {
+        return OMPI_SUCCESS;
+    }
+
+    dir = (NULL != ompi_mpi_trace_dir && '\0' != ompi_mpi_trace_dir[0]) ? ompi_mpi_trace_dir : ".";
+    if( 0 > asprintf(&ompi_trace_path, "%s/ompi_trace.%u.%d", dir,
+                     (unsigned)OMPI_PROC_MY_NAME->jobid,
+                     ompi_comm_rank(&ompi_mpi_comm_world.comm)) ) {
+        ompi_trace_path = NULL;
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    ompi_trace_fd = open(ompi_trace_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if( -1 == ompi_trace_fd ) {
+        opal_output(0, "mpi_trace: cannot create %s: %s, the trace is turned off",
+                    ompi_trace_path, strerror(errno));
+        free(ompi_trace_path);
+        ompi_trace_path = NULL;
+        return OMPI_SUCCESS;
+    }
+
+    if( OPAL_SUCCESS != opal_tsd_key_create(&ompi_trace_ring_key, ompi_trace_ring_release) ) {
+        ret = OMPI_ERROR;
+        goto error;
+    }
+    ompi_trace_ring_key_valid = true;
+    ompi_trace_main_ring = ompi_trace_ring_attach();
+    if( &ompi_trace_no_ring == ompi_trace_main_ring ) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto error;
+    }
+
+    /* the synchronization point: all processes left the barrier of MPI_Init */
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OMPI_TRACE_MAGIC, sizeof(header.magic));
+    header.version = OMPI_TRACE_VERSION;
+    header.record_size = sizeof(ompi_trace_record_t);
+    header.world_rank = ompi_comm_rank(&ompi_mpi_comm_world.comm);
+    header.world_size = ompi_comm_size(&ompi_mpi_comm_world.comm);
+    header.ticks_per_sec = (uint64_t)opal_timer_base_get_freq();
+    header.sync_ticks = (uint64_t)opal_timer_base_get_cycles();
+    clock_gettime(CLOCK_REALTIME, &now);
+    header.sync_wtime_ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    if( NULL != opal_process_info.nodename ) {
+        strncpy(header.hostname, opal_process_info.nodename, sizeof(header.hostname) - 1);
+    }
+    if( OMPI_SUCCESS != ompi_trace_write(&header, sizeof(header)) ) {
+        opal_output(0, "mpi_trace: writing %s failed: %s, the trace is turned off",
+                    ompi_trace_path, strerror(errno));
+        ret = OMPI_SUCCESS;
+        goto error;
+    }
+
+    if( 0 < ompi_mpi_trace_signal ) {
+        struct sigaction act;
+
+        memset(&act, 0, sizeof(act));
+        act.sa_handler = ompi_trace_signal_handler;
+        act.sa_flags = SA_RESTART;
+        sigemptyset(&act.sa_mask);
+        if( 0 == sigaction(ompi_mpi_trace_signal, &act, &ompi_trace_old_action) ) {
+            ompi_trace_signal_installed = true;
+        }
+        else {
+            opal_output(0, "mpi_trace: cannot install a handler for signal %d: %s",
+                        ompi_mpi_trace_signal, strerror(errno));
+        }
+    }
+
+    ompi_trace_enabled = true;
+    return OMPI_SUCCESS;
+
+  error:
+    ompi_trace_fini();
+    return ret;
+}
+
+int ompi_trace_fini(void)
+{
+    ompi_trace_ring_t *tr;
+
+    ompi_trace_enabled = false;
+    opal_atomic_mb();
+
+    if( ompi_trace_signal_installed ) {
+        sigaction(ompi_mpi_trace_signal, &ompi_trace_old_action, NULL);
+        ompi_trace_signal_installed = false;
+    }
+
+    ompi_trace_flush_all();
+    if( -1 != ompi_trace_fd ) {
+        close(ompi_trace_fd);
+        ompi_trace_fd = -1;
+    }
+    if( 0 < ompi_trace_dropped ) {
+        opal_output(0, "mpi_trace: %lu events of %s were lost",
+                    (unsigned long)ompi_trace_dropped, ompi_trace_path);
+    }
+
+    if( ompi_trace_ring_key_valid ) {
+        opal_tsd_key_delete(ompi_trace_ring_key);
+        ompi_trace_ring_key_valid = false;
+    }
+    while( NULL != (tr = ompi_trace_rings) ) {
+        ompi_trace_rings = tr->next;
+        OBJ_DESTRUCT(&tr->ring);
+        free(tr);
+    }
+    ompi_trace_free_rings = NULL;
+    ompi_trace_main_ring = NULL;
+#if OPAL_HAVE_THREAD_LOCAL
+    ompi_trace_local_ring = NULL;
+#endif
+    ompi_trace_num_rings = 0;
+    ompi_trace_dropped = 0;
+    free(ompi_trace_path);
+    ompi_trace_path = NULL;
+
+    return OMPI_SUCCESS;
+}
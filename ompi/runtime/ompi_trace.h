@@ -0,0 +1,132 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef OMPI_TRACE_H
+#define OMPI_TRACE_H
+
+#include "ompi_config.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+BEGIN_C_DECLS
+
+/*
+ * Binary event trace.
+ *
+ * If the mpi_trace MCA parameter is set, every thread records the PERUSE
+ * communication events of the PML and the entry and exit of the blocking
+ * collectives as fixed size records into a ring buffer of its own.  The
+ * rings are written to one file per process in MPI_Finalize, when a ring
+ * is full, and when the process receives the mpi_trace_signal signal.
+ * The ompi_trace_merge tool merges the files of a job into a timeline.
+ *
+ * A trace file consists of an ompi_trace_header_t followed by the
+ * records.  Integers are stored in the byte order of the writing host.
+ * The records of a thread are in time order, the records of different
+ * threads are not.  Records with the same timestamp are ordered by
+ * thread and sequence number.
+ */
+
+#define OMPI_TRACE_MAGIC    "OMPITRC1"
+#define OMPI_TRACE_VERSION  2
+
+/* Events in addition to the PERUSE_COMM_* events of ompi/peruse/peruse.h */
+enum {
+    OMPI_TRACE_COLL_BEGIN = 64,
+    OMPI_TRACE_COLL_END,
+    OMPI_TRACE_MAX_EVENT
+};
+
+/* Operation of the OMPI_TRACE_COLL_* events */
+typedef enum ompi_trace_coll_t {
+    OMPI_TRACE_BARRIER,
+    OMPI_TRACE_BCAST,
+    OMPI_TRACE_REDUCE,
+    OMPI_TRACE_ALLREDUCE,
+    OMPI_TRACE_REDUCE_SCATTER,
+    OMPI_TRACE_REDUCE_SCATTER_BLOCK,
+    OMPI_TRACE_SCAN,
+    OMPI_TRACE_EXSCAN,
+    OMPI_TRACE_GATHER,
+    OMPI_TRACE_GATHERV,
+    OMPI_TRACE_SCATTER,
+    OMPI_TRACE_SCATTERV,
+    OMPI_TRACE_ALLGATHER,
+    OMPI_TRACE_ALLGATHERV,
+    OMPI_TRACE_ALLTOALL,
+    OMPI_TRACE_ALLTOALLV,
+    OMPI_TRACE_ALLTOALLW,
+    OMPI_TRACE_NUM_COLLS
+} ompi_trace_coll_t;
+
+typedef struct ompi_trace_header_t {
+    char     magic[8];        /* OMPI_TRACE_MAGIC, not terminated */
+    uint32_t version;
+    uint32_t record_size;     /* sizeof(ompi_trace_record_t) */
+    int32_t  world_rank;
+    int32_t  world_size;
+    uint64_t ticks_per_sec;   /* frequency of the timestamps */
+    uint64_t sync_ticks;      /* timestamp at the end of MPI_Init ... */
+    uint64_t sync_wtime_ns;   /* ... and the wall clock time at the same moment */
+    char     hostname[64];
+} ompi_trace_header_t;
+
+typedef struct ompi_trace_record_t {
+    uint64_t time;            /* timestamp in ticks */
+    uint64_t req;             /* address of the request, 0 if none */
+    uint64_t bytes;           /* size of the buffer of the request */
+    uint32_t cid;             /* context id of the communicator */
+    int32_t  peer;            /* rank in the communicator, root of a collective, -1 if none */
+    int32_t  world_peer;      /* rank of the peer in MPI_COMM_WORLD, -1 if none or unknown */
+    int32_t  tag;
+    uint16_t event;           /* PERUSE_COMM_* or OMPI_TRACE_COLL_* */
+    uint16_t op;              /* PERUSE_SEND, PERUSE_RECV or ompi_trace_coll_t */
+    uint32_t thread;          /* index of the recording thread */
+    uint64_t seq;             /* number of the record in its thread */
+} ompi_trace_record_t;
+
+OMPI_DECLSPEC extern bool ompi_trace_enabled;
+
+struct ompi_communicator_t;
+
+/**
+ * Set up the trace if it is requested.  Called at the end of MPI_Init,
+ * the time of the call is the synchronization point of the files.
+ */
+int ompi_trace_init(void);
+
+/**
+ * Write the remaining records and close the trace file.
+ */
+int ompi_trace_fini(void);
+
+/**
+ * Append a record to the ring of the calling thread.  Use
+ * OMPI_TRACE_EVENT(), which does not evaluate its arguments if the trace
+ * is off.
+ */
+OMPI_DECLSPEC void ompi_trace_record(int event, int op, struct ompi_communicator_t *comm,
+                                     int peer, int tag, size_t bytes, const void *req);
+
+#define OMPI_TRACE_EVENT(event, op, comm, peer, tag, bytes, req)               \
+    do {                                                                       \
+        if( OPAL_UNLIKELY(ompi_trace_enabled) ) {                              \
+            ompi_trace_record((event), (op), (comm), (peer), (tag), (bytes), (req)); \
+        }                                                                      \
+    } while(0)
+
+#define OMPI_TRACE_COLL_ENTER(coll, comm, root) \
+    OMPI_TRACE_EVENT(OMPI_TRACE_COLL_BEGIN, (coll), (comm), (root), 0, 0, NULL)
+
+#define OMPI_TRACE_COLL_EXIT(coll, comm, root) \
+    OMPI_TRACE_EVENT(OMPI_TRACE_COLL_END, (coll), (comm), (root), 0, 0, NULL)
+
+END_C_DECLS
+
+#endif /* OMPI_TRACE_H */
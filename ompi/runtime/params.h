@@ -124,11 +124,29 @@ OMPI_DECLSPEC extern bool ompi_have_sparse_group_storage;
  */
 OMPI_DECLSPEC extern bool ompi_use_sparse_group_storage;
 
+/**
+ * Minimum number of processes in a group before a sparse storage
+ * format is considered.
+ */
+OMPI_DECLSPEC extern int ompi_sparse_group_min_size;
+
 /**
  * Cutoff point for calling add_procs for all processes
  */
 OMPI_DECLSPEC extern uint32_t ompi_add_procs_cutoff;
 
+/**
+ * Whether all ompi_proc_t objects (including node-local peers) should
+ * be created on first use instead of during MPI_Init
+ */
+OMPI_DECLSPEC extern bool ompi_mpi_lazy_procs;
+
+/**
+ * Maximum number of CIDs reserved at once for communicators derived
+ * from a parent communicator (0 disables the reservation)
+ */
+OMPI_DECLSPEC extern int ompi_comm_cid_block_size;
+
 /**
  * Whether anything in the code base has disabled MPI dynamic process
  * functionality or not
@@ -143,8 +161,8 @@ OMPI_DECLSPEC extern bool ompi_async_mpi_finalize;
 
 /**
  * A comma delimited list of SPC counters to turn on or 'attach'.  To turn
- * all counters on, the string can be simply "all".  An empty string will
- * keep all counters turned off.
+ * all counters on, the string can be simply "all", which is the default.
+ * An empty string will keep all counters turned off.
  */
 OMPI_DECLSPEC extern char * ompi_mpi_spc_attach_string;
 
@@ -154,6 +172,51 @@ OMPI_DECLSPEC extern char * ompi_mpi_spc_attach_string;
  */
 OMPI_DECLSPEC extern bool ompi_mpi_spc_dump_enabled;
 
+/**
+ * A comma delimited list of SPC latency histograms to turn on, or "all".
+ * Histograms are also turned on while an MPI_T handle of theirs is started.
+ */
+OMPI_DECLSPEC extern char * ompi_mpi_spc_hist_attach_string;
+
+/**
+ * Whether (true) or not (false) to record the binary event trace
+ * (see ompi/runtime/ompi_trace.h).
+ */
+OMPI_DECLSPEC extern bool ompi_mpi_trace;
+
+/**
+ * Directory of the trace files, NULL for the current working directory.
+ */
+OMPI_DECLSPEC extern char * ompi_mpi_trace_dir;
+
+/**
+ * Number of records of the trace ring buffer of each thread.
+ */
+OMPI_DECLSPEC extern int ompi_mpi_trace_records;
+
+/**
+ * Signal that makes a process write its trace buffers, 0 for none.
+ */
+OMPI_DECLSPEC extern int ompi_mpi_trace_signal;
+
+/**
+ * Whether (true) or not (false) to run an asynchronous progress thread
+ * (see ompi/runtime/ompi_async_progress.h).
+ */
+OMPI_DECLSPEC extern bool ompi_mpi_async_progress;
+
+/**
+ * Logical index of the core the progress thread is bound to, -1 to
+ * keep the binding of the process.
+ */
+OMPI_DECLSPEC extern int ompi_mpi_async_progress_core;
+
+/**
+ * Longest sleep of the idle progress thread between two polls, in
+ * microseconds.
+ */
+OMPI_DECLSPEC extern int ompi_mpi_async_progress_max_sleep;
+
 
 /**
  * Register MCA parameters used by the MPI layer.
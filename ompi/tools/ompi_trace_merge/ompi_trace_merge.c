@@ -0,0 +1,445 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Merge the binary event traces written with the mpi_trace MCA parameter
+ * into a single timeline, and report the time posted receives waited for
+ * their message (late senders).
+ *
+ * The times of the processes are aligned on the end of the barrier of
+ * MPI_Init, which all processes leave at about the same moment, or with
+ * -w on the wall clock of their hosts.
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ompi/peruse/peruse.h"
+#include "ompi/runtime/ompi_trace.h"
+
+typedef struct trace_file_t {
+    const char *path;
+    ompi_trace_header_t header;
+    ompi_trace_record_t *records;
+    size_t num_records;
+    size_t next;                /* merge position */
+    double origin_ns;           /* time of the synchronization point in ns */
+} trace_file_t;
+
+static const char *event_names[OMPI_TRACE_MAX_EVENT] = {
+    [PERUSE_COMM_REQ_ACTIVATE] = "REQ_ACTIVATE",
+    [PERUSE_COMM_REQ_MATCH_UNEX] = "REQ_MATCH_UNEX",
+    [PERUSE_COMM_REQ_INSERT_IN_POSTED_Q] = "REQ_INSERT_IN_POSTED_Q",
+    [PERUSE_COMM_REQ_REMOVE_FROM_POSTED_Q] = "REQ_REMOVE_FROM_POSTED_Q",
+    [PERUSE_COMM_REQ_XFER_BEGIN] = "REQ_XFER_BEGIN",
+    [PERUSE_COMM_REQ_XFER_CONTINUE] = "REQ_XFER_CONTINUE",
+    [PERUSE_COMM_REQ_XFER_END] = "REQ_XFER_END",
+    [PERUSE_COMM_REQ_COMPLETE] = "REQ_COMPLETE",
+    [PERUSE_COMM_REQ_NOTIFY] = "REQ_NOTIFY",
+    [PERUSE_COMM_MSG_ARRIVED] = "MSG_ARRIVED",
+    [PERUSE_COMM_MSG_INSERT_IN_UNEX_Q] = "MSG_INSERT_IN_UNEX_Q",
+    [PERUSE_COMM_MSG_REMOVE_FROM_UNEX_Q] = "MSG_REMOVE_FROM_UNEX_Q",
+    [PERUSE_COMM_MSG_MATCH_POSTED_REQ] = "MSG_MATCH_POSTED_REQ",
+    [PERUSE_COMM_SEARCH_POSTED_Q_BEGIN] = "SEARCH_POSTED_Q_BEGIN",
+    [PERUSE_COMM_SEARCH_POSTED_Q_END] = "SEARCH_POSTED_Q_END",
+    [PERUSE_COMM_SEARCH_UNEX_Q_BEGIN] = "SEARCH_UNEX_Q_BEGIN",
+    [PERUSE_COMM_SEARCH_UNEX_Q_END] = "SEARCH_UNEX_Q_END",
+    [OMPI_TRACE_COLL_BEGIN] = "COLL_BEGIN",
+    [OMPI_TRACE_COLL_END] = "COLL_END",
+};
+
+static const char *coll_names[OMPI_TRACE_NUM_COLLS] = {
+    [OMPI_TRACE_BARRIER] = "barrier",
+    [OMPI_TRACE_BCAST] = "bcast",
+    [OMPI_TRACE_REDUCE] = "reduce",
+    [OMPI_TRACE_ALLREDUCE] = "allreduce",
+    [OMPI_TRACE_REDUCE_SCATTER] = "reduce_scatter",
+    [OMPI_TRACE_REDUCE_SCATTER_BLOCK] = "reduce_scatter_block",
+    [OMPI_TRACE_SCAN] = "scan",
+    [OMPI_TRACE_EXSCAN] = "exscan",
+    [OMPI_TRACE_GATHER] = "gather",
+    [OMPI_TRACE_GATHERV] = "gatherv",
+    [OMPI_TRACE_SCATTER] = "scatter",
+    [OMPI_TRACE_SCATTERV] = "scatterv",
+    [OMPI_TRACE_ALLGATHER] = "allgather",
+    [OMPI_TRACE_ALLGATHERV] = "allgatherv",
+    [OMPI_TRACE_ALLTOALL] = "alltoall",
+    [OMPI_TRACE_ALLTOALLV] = "alltoallv",
+    [OMPI_TRACE_ALLTOALLW] = "alltoallw",
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-w] [-l] [-q] [-o output] trace_file ...\n"
+            "  -w         align the processes on the wall clock instead of MPI_Init\n"
+            "  -l         print the late sender report\n"
+            "  -q         do not print the timeline\n"
+            "  -o output  write to output instead of stdout\n", prog);
+}
+
+static int cmp_time(const void *a, const void *b)
+{
+    const ompi_trace_record_t *ra = (const ompi_trace_record_t*)a;
+    const ompi_trace_record_t *rb = (const ompi_trace_record_t*)b;
+
+    if (ra->time != rb->time) {
+        return ra->time < rb->time ? -1 : 1;
+    }
+    if (ra->thread != rb->thread) {
+        return ra->thread < rb->thread ? -1 : 1;
+    }
+    /* the records of a thread are numbered in order */
+    return ra->seq < rb->seq ? -1 : (ra->seq > rb->seq);
+}
+
+static int load(trace_file_t *tf, const char *path)
+{
+    FILE *fp;
+    long size;
+
+    memset(tf, 0, sizeof(*tf));
+    tf->path = path;
+
+    if (NULL == (fp = fopen(path, "rb"))) {
+        perror(path);
+        return -1;
+    }
+    if (1 != fread(&tf->header, sizeof(tf->header), 1, fp) ||
+        0 != memcmp(tf->header.magic, OMPI_TRACE_MAGIC, sizeof(tf->header.magic))) {
+        fprintf(stderr, "%s: not an Open MPI trace file\n", path);
+        fclose(fp);
+        return -1;
+    }
+    if (OMPI_TRACE_VERSION != tf->header.version ||
+        sizeof(ompi_trace_record_t) != tf->header.record_size) {
+        fprintf(stderr, "%s: unsupported version %u of the trace format\n",
+                path, tf->header.version);
+        fclose(fp);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp) - (long) sizeof(tf->header);
+    fseek(fp, (long) sizeof(tf->header), SEEK_SET);
+    tf->num_records = (size_t) size / sizeof(ompi_trace_record_t);
+    if (0 < tf->num_records) {
+        tf->records = (ompi_trace_record_t*) malloc(tf->num_records * sizeof(ompi_trace_record_t));
+        if (NULL == tf->records) {
+            fprintf(stderr, "%s: out of memory\n", path);
+            fclose(fp);
+            return -1;
+        }
+        tf->num_records = fread(tf->records, sizeof(ompi_trace_record_t), tf->num_records, fp);
+        qsort(tf->records, tf->num_records, sizeof(ompi_trace_record_t), cmp_time);
+    }
+    fclose(fp);
+    return 0;
+}
+
+static inline double record_ns(const trace_file_t *tf, const ompi_trace_record_t *rec)
+{
+    return tf->origin_ns + ((double) rec->time - (double) tf->header.sync_ticks) * 1.0e9 /
+        (double) tf->header.ticks_per_sec;
+}
+
+static void print_record(FILE *out, const trace_file_t *tf, const ompi_trace_record_t *rec)
+{
+    const char *name = rec->event < OMPI_TRACE_MAX_EVENT ? event_names[rec->event] : NULL;
+    bool coll = OMPI_TRACE_COLL_BEGIN == rec->event || OMPI_TRACE_COLL_END == rec->event;
+    char peer[32];
+
+    if (0 > rec->peer) {
+        /* no root, or a receive from MPI_ANY_SOURCE */
+        snprintf(peer, sizeof(peer), "%s", coll ? "-" : "any");
+    } else if (0 <= rec->world_peer) {
+        snprintf(peer, sizeof(peer), "%d(w%d)", rec->peer, rec->world_peer);
+    } else {
+        snprintf(peer, sizeof(peer), "%d", rec->peer);
+    }
+
+    fprintf(out, "%16.3f %6d %3u %-24s ", record_ns(tf, rec) / 1000.0,
+            tf->header.world_rank, rec->thread, NULL != name ? name : "?");
+    if (coll) {
+        fprintf(out, "%-5s cid %-5u root %-10s\n",
+                rec->op < OMPI_TRACE_NUM_COLLS ? coll_names[rec->op] : "?", rec->cid, peer);
+    } else {
+        fprintf(out, "%-5s cid %-5u peer %-10s tag %-8d bytes %-10llu req 0x%llx\n",
+                PERUSE_SEND == rec->op ? "send" : "recv", rec->cid, peer, rec->tag,
+                (unsigned long long) rec->bytes, (unsigned long long) rec->req);
+    }
+}
+
+/* k-way merge of the sorted files, with a heap of the files ordered by
+   the time of their next record */
+static double heap_key(trace_file_t **heap, size_t i)
+{
+    return record_ns(heap[i], &heap[i]->records[heap[i]->next]);
+}
+
+static void heap_down(trace_file_t **heap, size_t n, size_t i)
+{
+    for (;;) {
+        size_t l = 2 * i + 1, r = l + 1, min = i;
+        trace_file_t *tmp;
+
+        if (l < n && heap_key(heap, l) < heap_key(heap, min)) {
+            min = l;
+        }
+        if (r < n && heap_key(heap, r) < heap_key(heap, min)) {
+            min = r;
+        }
+        if (min == i) {
+            return;
+        }
+        tmp = heap[i];
+        heap[i] = heap[min];
+        heap[min] = tmp;
+        i = min;
+    }
+}
+
+static void print_timeline(FILE *out, trace_file_t *files, int num_files)
+{
+    trace_file_t **heap;
+    size_t n = 0;
+
+    heap = (trace_file_t**) malloc(num_files * sizeof(trace_file_t*));
+    if (NULL == heap) {
+        fprintf(stderr, "out of memory\n");
+        return;
+    }
+    for (int i = 0 ; i < num_files ; ++i) {
+        files[i].next = 0;
+        if (0 < files[i].num_records) {
+            heap[n++] = &files[i];
+        }
+    }
+    for (size_t i = n ; i-- > 0 ; ) {
+        heap_down(heap, n, i);
+    }
+
+    fprintf(out, "%16s %6s %3s %-24s\n", "time (us)", "rank", "thr", "event");
+    while (0 < n) {
+        trace_file_t *tf = heap[0];
+
+        print_record(out, tf, &tf->records[tf->next]);
+        if (++tf->next == tf->num_records) {
+            heap[0] = heap[--n];
+        }
+        heap_down(heap, n, 0);
+    }
+    free(heap);
+}
+
+/*
+ * Late senders: a receive that was posted before its message arrived
+ * (REQ_ACTIVATE ... MSG_MATCH_POSTED_REQ) waited for the sender for the
+ * time in between, a receive that found its message in the unexpected
+ * queue (REQ_MATCH_UNEX) did not wait.
+ */
+typedef struct late_stat_t {
+    int rank;
+    int peer;                   /* world rank, -1 for wildcard or unknown */
+    unsigned long recvs;
+    unsigned long late;
+    double wait_ns;
+    double max_ns;
+} late_stat_t;
+
+static int cmp_req(const void *a, const void *b)
+{
+    const ompi_trace_record_t *ra = *(const ompi_trace_record_t* const*)a;
+    const ompi_trace_record_t *rb = *(const ompi_trace_record_t* const*)b;
+
+    if (ra->req != rb->req) {
+        return ra->req < rb->req ? -1 : 1;
+    }
+    return ra < rb ? -1 : (ra > rb);
+}
+
+static int cmp_wait(const void *a, const void *b)
+{
+    const late_stat_t *sa = (const late_stat_t*)a;
+    const late_stat_t *sb = (const late_stat_t*)b;
+
+    if (sa->wait_ns != sb->wait_ns) {
+        return sa->wait_ns > sb->wait_ns ? -1 : 1;
+    }
+    return sa->rank != sb->rank ? sa->rank - sb->rank : sa->peer - sb->peer;
+}
+
+static void print_late_senders(FILE *out, trace_file_t *files, int num_files)
+{
+    late_stat_t *stats = NULL;
+    size_t num_stats = 0;
+
+    for (int f = 0 ; f < num_files ; ++f) {
+        trace_file_t *tf = &files[f];
+        int world_size = tf->header.world_size;
+        late_stat_t *rs;
+        ompi_trace_record_t **recv;
+        size_t n = 0;
+
+        rs = (late_stat_t*) calloc(world_size + 1, sizeof(late_stat_t));
+        recv = (ompi_trace_record_t**) malloc((tf->num_records + 1) * sizeof(ompi_trace_record_t*));
+        if (NULL == rs || NULL == recv) {
+            fprintf(stderr, "out of memory\n");
+            free(rs);
+            free(recv);
+            free(stats);
+            return;
+        }
+
+        for (size_t i = 0 ; i < tf->num_records ; ++i) {
+            ompi_trace_record_t *rec = &tf->records[i];
+
+            if (PERUSE_RECV == rec->op && 0 != rec->req &&
+                (PERUSE_COMM_REQ_ACTIVATE == rec->event ||
+                 PERUSE_COMM_REQ_MATCH_UNEX == rec->event ||
+                 PERUSE_COMM_MSG_MATCH_POSTED_REQ == rec->event)) {
+                recv[n++] = rec;
+            }
+        }
+        /* group by request, in time order within a request */
+        qsort(recv, n, sizeof(ompi_trace_record_t*), cmp_req);
+
+        for (size_t i = 0 ; i < n ; ++i) {
+            ompi_trace_record_t *rec = recv[i], *posted;
+            late_stat_t *s;
+            double wait;
+
+            if (PERUSE_COMM_REQ_ACTIVATE == rec->event || 0 == i ||
+                recv[i - 1]->req != rec->req ||
+                PERUSE_COMM_REQ_ACTIVATE != recv[i - 1]->event) {
+                continue;
+            }
+            posted = recv[i - 1];
+            s = &rs[(0 <= rec->world_peer && rec->world_peer < world_size) ?
+                    rec->world_peer : world_size];
+            s->recvs++;
+            if (PERUSE_COMM_MSG_MATCH_POSTED_REQ == rec->event) {
+                wait = record_ns(tf, rec) - record_ns(tf, posted);
+                s->late++;
+                s->wait_ns += wait;
+                if (wait > s->max_ns) {
+                    s->max_ns = wait;
+                }
+            }
+        }
+
+        for (int p = 0 ; p <= world_size ; ++p) {
+            late_stat_t *tmp;
+
+            if (0 == rs[p].recvs) {
+                continue;
+            }
+            tmp = (late_stat_t*) realloc(stats, (num_stats + 1) * sizeof(late_stat_t));
+            if (NULL == tmp) {
+                fprintf(stderr, "out of memory\n");
+                break;
+            }
+            stats = tmp;
+            stats[num_stats] = rs[p];
+            stats[num_stats].rank = tf->header.world_rank;
+            stats[num_stats].peer = p < world_size ? p : -1;
+            num_stats++;
+        }
+        free(rs);
+        free(recv);
+    }
+
+    qsort(stats, num_stats, sizeof(late_stat_t), cmp_wait);
+
+    fprintf(out, "\nLate senders: time posted receives waited for their message\n");
+    fprintf(out, "%6s %6s %10s %10s %16s %16s\n", "rank", "from", "recvs", "late",
+            "total wait (us)", "max wait (us)");
+    for (size_t i = 0 ; i < num_stats ; ++i) {
+        char peer[16];
+
+        if (0 <= stats[i].peer) {
+            snprintf(peer, sizeof(peer), "%d", stats[i].peer);
+        } else {
+            snprintf(peer, sizeof(peer), "any");
+        }
+        fprintf(out, "%6d %6s %10lu %10lu %16.3f %16.3f\n", stats[i].rank, peer,
+                stats[i].recvs, stats[i].late, stats[i].wait_ns / 1000.0,
+                stats[i].max_ns / 1000.0);
+    }
+    free(stats);
+}
+
+int main(int argc, char **argv)
+{
+    bool wall = false, late = false, timeline = true;
+    const char *output = NULL;
+    trace_file_t *files;
+    FILE *out = stdout;
+    double min_wall = 0.0;
+    int c, num_files, ret = 0;
+
+    while (-1 != (c = getopt(argc, argv, "wlqo:h"))) {
+        switch (c) {
+        case 'w': wall = true; break;
+        case 'l': late = true; break;
+        case 'q': timeline = false; break;
+        case 'o': output = optarg; break;
+        default:
+            usage(argv[0]);
+            return 'h' == c ? 0 : 1;
+        }
+    }
+    num_files = argc - optind;
+    if (0 == num_files) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    files = (trace_file_t*) calloc(num_files, sizeof(trace_file_t));
+    if (NULL == files) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 0 ; i < num_files ; ++i) {
+        if (0 != load(&files[i], argv[optind + i])) {
+            return 1;
+        }
+        if (0 == i || (double) files[i].header.sync_wtime_ns < min_wall) {
+            min_wall = (double) files[i].header.sync_wtime_ns;
+        }
+    }
+    for (int i = 0 ; i < num_files ; ++i) {
+        files[i].origin_ns = wall ? (double) files[i].header.sync_wtime_ns - min_wall : 0.0;
+    }
+
+    if (NULL != output && NULL == (out = fopen(output, "w"))) {
+        perror(output);
+        return 1;
+    }
+
+    if (timeline) {
+        print_timeline(out, files, num_files);
+    }
+    if (late) {
+        print_late_senders(out, files, num_files);
+    }
+
+    if (stdout != out && 0 != fclose(out)) {
+        perror(output);
+        ret = 1;
+    }
+    for (int i = 0 ; i < num_files ; ++i) {
+        free(files[i].records);
+    }
+    free(files);
+    return ret;
+}
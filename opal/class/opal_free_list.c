@@ -31,9 +31,26 @@
 #include "opal/mca/mpool/base/base.h"
 #include "opal/mca/rcache/rcache.h"
 #include "opal/util/sys_limits.h"
+#include "opal/threads/tsd.h"
 
 typedef struct opal_free_list_item_t opal_free_list_memory_t;
 
+int opal_free_list_magazine_size = 0;
+
+#if OPAL_HAVE_THREAD_LOCAL
+opal_thread_local int opal_free_list_thread_slot = -1;
+
+/* the slot of a thread is released when it exits. its magazines, and
+ * the items in them, go to the next thread that takes the slot. */
+static opal_mutex_t opal_free_list_slot_lock = OPAL_MUTEX_STATIC_INIT;
+static bool opal_free_list_slot_key_created = false;
+static opal_tsd_key_t opal_free_list_slot_key;
+static bool opal_free_list_slot_used[OPAL_FREE_LIST_MAGAZINE_THREADS];
+
+/* the thread has no slot and does not try to get one again */
+#define OPAL_FREE_LIST_NO_SLOT -2
+#endif
+
 OBJ_CLASS_INSTANCE(opal_free_list_item_t,
                    opal_list_item_t,
                    NULL, NULL);
@@ -57,7 +74,10 @@ static void opal_free_list_construct(opal_free_list_t* fl)
     fl->fl_rcache_reg_flags = MCA_RCACHE_FLAGS_CACHE_BYPASS |
         MCA_RCACHE_FLAGS_CUDA_REGISTER_MEM;
     fl->ctx = NULL;
+    fl->fl_magazines = NULL;
+    fl->fl_magazine_size = 0;
     OBJ_CONSTRUCT(&(fl->fl_allocations), opal_list_t);
+    OBJ_CONSTRUCT(&fl->fl_depot, opal_lifo_t);
 }
 
 static void opal_free_list_allocation_release (opal_free_list_t *fl, opal_free_list_memory_t *fl_mem)
@@ -77,11 +97,41 @@ static void opal_free_list_allocation_release (opal_free_list_t *fl, opal_free_l
     free(fl_mem);
 }
 
+#if OPAL_HAVE_THREAD_LOCAL
+/* return the items of a magazine to the lifo */
+static void opal_free_list_magazine_drain (opal_free_list_t *fl, opal_list_item_t *item)
+{
+    opal_list_item_t *next;
+
+    for ( ; NULL != item ; item = next) {
+        next = (opal_list_item_t *) item->opal_list_prev;
+        item->opal_list_prev = NULL;
+        opal_lifo_push_st (&fl->super, item);
+    }
+}
+#endif
+
 static void opal_free_list_destruct(opal_free_list_t *fl)
 {
     opal_list_item_t *item;
     opal_free_list_item_t *fl_item;
 
+#if OPAL_HAVE_THREAD_LOCAL
+    /* the free list is no longer used by any thread, collect the items of
+     * all the magazines so that they are destructed below */
+    if (NULL != fl->fl_magazines) {
+        for (int i = 0 ; i < OPAL_FREE_LIST_MAGAZINE_THREADS ; ++i) {
+            opal_free_list_magazine_drain (fl, fl->fl_magazines[i].loaded);
+            opal_free_list_magazine_drain (fl, fl->fl_magazines[i].previous);
+        }
+        while (NULL != (item = opal_lifo_pop_st (&fl->fl_depot))) {
+            opal_free_list_magazine_drain (fl, item);
+        }
+        free (fl->fl_magazines);
+        fl->fl_magazines = NULL;
+    }
+#endif
+
 #if 0 && OPAL_ENABLE_DEBUG
     if(opal_list_get_size(&fl->super) != fl->fl_num_allocated) {
         opal_output(0, "opal_free_list: %d allocated %d returned: %s:%d\n",
@@ -104,6 +154,7 @@ static void opal_free_list_destruct(opal_free_list_t *fl)
     }
 
     OBJ_DESTRUCT(&fl->fl_allocations);
+    OBJ_DESTRUCT(&fl->fl_depot);
     OBJ_DESTRUCT(&fl->fl_condition);
     OBJ_DESTRUCT(&fl->fl_lock);
 }
@@ -154,6 +205,23 @@ int opal_free_list_init (opal_free_list_t *flist, size_t frag_size, size_t frag_
     flist->fl_rcache_reg_flags |= rcache_reg_flags;
     flist->ctx = ctx;
 
+#if OPAL_HAVE_THREAD_LOCAL
+    /* a thread waiting for an item of a bounded free list could wait
+     * forever for the items cached in the magazines of another thread */
+    if (0 < opal_free_list_magazine_size &&
+        (0 == flist->fl_max_to_alloc || (size_t) -1 == flist->fl_max_to_alloc) &&
+        NULL == flist->fl_magazines) {
+        void *magazines;
+
+        if (0 == posix_memalign (&magazines, 64, OPAL_FREE_LIST_MAGAZINE_THREADS *
+                                 sizeof (opal_free_list_magazine_t))) {
+            memset (magazines, 0, OPAL_FREE_LIST_MAGAZINE_THREADS * sizeof (opal_free_list_magazine_t));
+            flist->fl_magazines = (opal_free_list_magazine_t *) magazines;
+            flist->fl_magazine_size = opal_free_list_magazine_size;
+        }
+    }
+#endif
+
     if (num_elements_to_alloc) {
         return opal_free_list_grow_st (flist, num_elements_to_alloc, NULL);
     }
@@ -315,3 +383,96 @@ int opal_free_list_resize_mt(opal_free_list_t *flist, size_t size)
 
     return ret;
 }
+
+#if OPAL_HAVE_THREAD_LOCAL
+
+static void opal_free_list_thread_slot_release (void *value)
+{
+    intptr_t slot = (intptr_t) value - 1;
+
+    if (0 <= slot) {
+        opal_mutex_lock (&opal_free_list_slot_lock);
+        opal_free_list_slot_used[slot] = false;
+        opal_mutex_unlock (&opal_free_list_slot_lock);
+    }
+    opal_free_list_thread_slot = -1;
+}
+
+int opal_free_list_thread_slot_acquire (void)
+{
+    int slot = opal_free_list_thread_slot;
+
+    if (-1 != slot) {
+        return slot;
+    }
+
+    opal_mutex_lock (&opal_free_list_slot_lock);
+    if (!opal_free_list_slot_key_created) {
+        if (OPAL_SUCCESS != opal_tsd_key_create (&opal_free_list_slot_key,
+                                                 opal_free_list_thread_slot_release)) {
+            opal_mutex_unlock (&opal_free_list_slot_lock);
+            opal_free_list_thread_slot = OPAL_FREE_LIST_NO_SLOT;
+            return OPAL_FREE_LIST_NO_SLOT;
+        }
+        opal_free_list_slot_key_created = true;
+    }
+
+    slot = OPAL_FREE_LIST_NO_SLOT;
+    for (int i = 0 ; i < OPAL_FREE_LIST_MAGAZINE_THREADS ; ++i) {
+        if (!opal_free_list_slot_used[i]) {
+            opal_free_list_slot_used[i] = true;
+            slot = i;
+            break;
+        }
+    }
+    opal_mutex_unlock (&opal_free_list_slot_lock);
+
+    if (0 <= slot) {
+        (void) opal_tsd_setspecific (opal_free_list_slot_key, (void *) (intptr_t) (slot + 1));
+    }
+    opal_free_list_thread_slot = slot;
+
+    return slot;
+}
+
+/* the loaded magazine is empty: swap it with the previous one if that is
+ * full, otherwise take a full magazine from the depot */
+bool opal_free_list_magazine_load (opal_free_list_t *flist, opal_free_list_magazine_t *mag)
+{
+    opal_list_item_t *item;
+
+    if (0 < mag->previous_count) {
+        mag->loaded = mag->previous;
+        mag->loaded_count = mag->previous_count;
+        mag->previous = NULL;
+        mag->previous_count = 0;
+        return true;
+    }
+
+    item = opal_lifo_pop_atomic (&flist->fl_depot);
+    if (NULL == item) {
+        return false;
+    }
+
+    /* the depot only holds full magazines */
+    mag->loaded = item;
+    mag->loaded_count = flist->fl_magazine_size;
+
+    return true;
+}
+
+/* the loaded magazine is full: swap it with the previous one if that is
+ * empty, otherwise move the previous one to the depot */
+void opal_free_list_magazine_unload (opal_free_list_t *flist, opal_free_list_magazine_t *mag)
+{
+    if (0 != mag->previous_count) {
+        (void) opal_lifo_push_atomic (&flist->fl_depot, mag->previous);
+    }
+
+    mag->previous = mag->loaded;
+    mag->previous_count = mag->loaded_count;
+    mag->loaded = NULL;
+    mag->loaded_count = 0;
+}
+
+#endif /* OPAL_HAVE_THREAD_LOCAL */
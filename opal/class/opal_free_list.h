@@ -53,6 +53,32 @@ struct opal_free_list_item_t;
 typedef int (*opal_free_list_item_init_fn_t) (
         struct opal_free_list_item_t *item, void *ctx);
 
+/** maximum number of threads with magazines, the others use the lifo */
+#define OPAL_FREE_LIST_MAGAZINE_THREADS 64
+
+/**
+ * Magazines of a thread. A magazine is a stack of at most
+ * fl_magazine_size items chained through their opal_list_prev pointer.
+ * Items are taken from and returned to the loaded magazine without
+ * atomics. A full magazine moves to or from the depot of the free list
+ * as a whole, with a single lifo operation.
+ */
+struct opal_free_list_magazine_t {
+    /** items taken and returned first */
+    opal_list_item_t *loaded;
+    /** a full or an empty magazine, swapped with the loaded one to
+     * avoid going to the depot on every boundary */
+    opal_list_item_t *previous;
+    int loaded_count;
+    int previous_count;
+    /** one cache line per thread */
+    char pad[64 - 2 * sizeof (void *) - 2 * sizeof (int)];
+};
+typedef struct opal_free_list_magazine_t opal_free_list_magazine_t;
+
+/** number of items in a full magazine, 0 disables the magazines */
+OPAL_DECLSPEC extern int opal_free_list_magazine_size;
+
 struct opal_free_list_t {
     /** Items in a free list are stored last-in first-out */
     opal_lifo_t super;
@@ -92,6 +118,12 @@ struct opal_free_list_t {
     opal_free_list_item_init_fn_t item_init;
     /** Initialization function context */
     void *ctx;
+    /** Magazines indexed by thread slot, NULL if the free list has none */
+    opal_free_list_magazine_t *fl_magazines;
+    /** Number of items in a full magazine */
+    int fl_magazine_size;
+    /** Full magazines, pushed by their first item */
+    opal_lifo_t fl_depot;
 };
 typedef struct opal_free_list_t opal_free_list_t;
 OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_free_list_t);
@@ -182,6 +214,77 @@ OPAL_DECLSPEC int opal_free_list_grow_st (opal_free_list_t *flist, size_t num_el
 OPAL_DECLSPEC int opal_free_list_resize_mt (opal_free_list_t *flist, size_t size);
 
 
+#if OPAL_HAVE_THREAD_LOCAL
+
+/** magazine slot of the calling thread, -1 before the first use */
+OPAL_DECLSPEC extern opal_thread_local int opal_free_list_thread_slot;
+
+/* internal functions for the magazines, see opal_free_list.c */
+OPAL_DECLSPEC int opal_free_list_thread_slot_acquire (void);
+OPAL_DECLSPEC bool opal_free_list_magazine_load (opal_free_list_t *flist, opal_free_list_magazine_t *mag);
+OPAL_DECLSPEC void opal_free_list_magazine_unload (opal_free_list_t *flist, opal_free_list_magazine_t *mag);
+
+static inline opal_free_list_magazine_t *opal_free_list_magazine (opal_free_list_t *flist)
+{
+    int slot = opal_free_list_thread_slot;
+
+    if (OPAL_UNLIKELY(slot < 0)) {
+        slot = opal_free_list_thread_slot_acquire ();
+        if (slot < 0) {
+            return NULL;
+        }
+    }
+
+    return flist->fl_magazines + slot;
+}
+
+/* take an item from the magazines of the calling thread, NULL if they
+ * and the depot are empty */
+static inline opal_free_list_item_t *opal_free_list_magazine_get (opal_free_list_t *flist)
+{
+    opal_free_list_magazine_t *mag = opal_free_list_magazine (flist);
+    opal_list_item_t *item;
+
+    if (OPAL_UNLIKELY(NULL == mag)) {
+        return NULL;
+    }
+
+    if (OPAL_UNLIKELY(0 == mag->loaded_count) && !opal_free_list_magazine_load (flist, mag)) {
+        return NULL;
+    }
+
+    item = mag->loaded;
+    mag->loaded = (opal_list_item_t *) item->opal_list_prev;
+    mag->loaded_count--;
+    item->opal_list_prev = NULL;
+    item->opal_list_next = NULL;
+
+    return (opal_free_list_item_t *) item;
+}
+
+/* put an item into the magazines of the calling thread, false if the
+ * thread has none */
+static inline bool opal_free_list_magazine_return (opal_free_list_t *flist, opal_free_list_item_t *item)
+{
+    opal_free_list_magazine_t *mag = opal_free_list_magazine (flist);
+
+    if (OPAL_UNLIKELY(NULL == mag)) {
+        return false;
+    }
+
+    if (OPAL_UNLIKELY(flist->fl_magazine_size == mag->loaded_count)) {
+        opal_free_list_magazine_unload (flist, mag);
+    }
+
+    item->super.opal_list_prev = mag->loaded;
+    mag->loaded = &item->super;
+    mag->loaded_count++;
+
+    return true;
+}
+
+#endif /* OPAL_HAVE_THREAD_LOCAL */
+
 /**
  * Attemp to obtain an item from a free list.
  *
@@ -197,8 +300,18 @@ OPAL_DECLSPEC int opal_free_list_resize_mt (opal_free_list_t *flist, size_t size
  */
 static inline opal_free_list_item_t *opal_free_list_get_mt (opal_free_list_t *flist)
 {
-    opal_free_list_item_t *item =
-        (opal_free_list_item_t*) opal_lifo_pop_atomic (&flist->super);
+    opal_free_list_item_t *item;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    if (NULL != flist->fl_magazines) {
+        item = opal_free_list_magazine_get (flist);
+        if (OPAL_LIKELY(NULL != item)) {
+            return item;
+        }
+    }
+#endif
+
+    item = (opal_free_list_item_t*) opal_lifo_pop_atomic (&flist->super);
 
     if (OPAL_UNLIKELY(NULL == item)) {
         opal_mutex_lock (&flist->fl_lock);
@@ -252,8 +365,21 @@ static inline opal_free_list_item_t *opal_free_list_get (opal_free_list_t *flist
 
 static inline opal_free_list_item_t *opal_free_list_wait_mt (opal_free_list_t *fl)
 {
-    opal_free_list_item_t *item =
-        (opal_free_list_item_t *) opal_lifo_pop_atomic (&fl->super);
+    opal_free_list_item_t *item;
+
+#if OPAL_HAVE_THREAD_LOCAL
+    /* only free lists without a maximum have magazines, so the wait
+     * below only happens if the list can not grow. items are not put in
+     * the magazines while a thread waits. */
+    if (NULL != fl->fl_magazines) {
+        item = opal_free_list_magazine_get (fl);
+        if (OPAL_LIKELY(NULL != item)) {
+            return item;
+        }
+    }
+#endif
+
+    item = (opal_free_list_item_t *) opal_lifo_pop_atomic (&fl->super);
 
     while (NULL == item) {
         if (!opal_mutex_trylock (&fl->fl_lock)) {
@@ -327,6 +453,14 @@ static inline void opal_free_list_return_mt (opal_free_list_t *flist,
 {
     opal_list_item_t* original;
 
+#if OPAL_HAVE_THREAD_LOCAL
+    /* waiting threads only look at the lifo, give the item to them */
+    if (NULL != flist->fl_magazines && 0 == flist->fl_num_waiting &&
+        opal_free_list_magazine_return (flist, item)) {
+        return;
+    }
+#endif
+
     original = opal_lifo_push_atomic (&flist->super, &item->super);
     if (&flist->super.opal_lifo_ghost == original) {
         if (flist->fl_num_waiting > 0) {
@@ -86,7 +86,7 @@ static void opal_interval_tree_construct (opal_interval_tree_t *tree)
     /* set all reader epochs to UINT_MAX. this value is used to simplfy
      * checks against the current epoch. */
     for (int i = 0 ; i < OPAL_INTERVAL_TREE_MAX_READERS ; ++i) {
-        tree->reader_epochs[i] = UINT_MAX;
+        tree->readers[i].epoch = UINT_MAX;
     }
 }
 
@@ -111,6 +111,16 @@ OBJ_CLASS_INSTANCE(opal_interval_tree_t, opal_object_t, opal_interval_tree_const
 
 typedef int32_t opal_interval_tree_token_t;
 
+#if OPAL_HAVE_THREAD_LOCAL
+/* each thread reads through the same slot of every tree, the next slots
+ * are used by the reads nested in a traversal. a slot shared between
+ * threads only happens with more than OPAL_INTERVAL_TREE_MAX_READERS
+ * threads. */
+static opal_atomic_int32_t opal_interval_tree_next_reader;
+static opal_thread_local int32_t opal_interval_tree_reader_slot = -1;
+static opal_thread_local int32_t opal_interval_tree_reader_depth;
+#endif
+
 /**
  * @brief pick and return a reader slot
  */
@@ -120,10 +130,20 @@ static opal_interval_tree_token_t opal_interval_tree_reader_get_token (opal_inte
 
     if (token < 0) {
         int32_t reader_count = tree->reader_count;
+#if OPAL_HAVE_THREAD_LOCAL
+        /* a shared counter would be written by every read */
+        if (OPAL_UNLIKELY(opal_interval_tree_reader_slot < 0)) {
+            opal_interval_tree_reader_slot = opal_atomic_fetch_add_32 (&opal_interval_tree_next_reader, 1) %
+                OPAL_INTERVAL_TREE_MAX_READERS;
+        }
+        token = (opal_interval_tree_reader_slot + opal_interval_tree_reader_depth++) %
+            OPAL_INTERVAL_TREE_MAX_READERS;
+#else
         /* NTH: could have used an atomic here but all we are after is some distribution of threads
          * across the reader slots. with high thread counts i see no real performance difference
          * using atomics. */
         token = tree->reader_id++ % OPAL_INTERVAL_TREE_MAX_READERS;
+#endif
         while (OPAL_UNLIKELY(reader_count <= token)) {
             if (opal_atomic_compare_exchange_strong_32 (&tree->reader_count, &reader_count, token + 1)) {
                 break;
@@ -131,7 +151,7 @@ static opal_interval_tree_token_t opal_interval_tree_reader_get_token (opal_inte
         }
     }
 
-    while (!OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32((opal_atomic_int32_t *) &tree->reader_epochs[token],
+    while (!OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32((opal_atomic_int32_t *) &tree->readers[token].epoch,
                                                    &(int32_t) {UINT_MAX}, tree->epoch));
 
     return token;
@@ -139,7 +159,10 @@ static opal_interval_tree_token_t opal_interval_tree_reader_get_token (opal_inte
 
 static void opal_interval_tree_reader_return_token (opal_interval_tree_t *tree, opal_interval_tree_token_t token)
 {
-    tree->reader_epochs[token] = UINT_MAX;
+    tree->readers[token].epoch = UINT_MAX;
+#if OPAL_HAVE_THREAD_LOCAL
+    --opal_interval_tree_reader_depth;
+#endif
 }
 
 /* Create the tree */
@@ -309,7 +332,7 @@ static void opal_interval_tree_gc_clean (opal_interval_tree_t *tree)
     }
 
     for (int i = 0 ; i < tree->reader_count ; ++i) {
-        oldest_epoch = (oldest_epoch < tree->reader_epochs[i]) ? oldest_epoch : tree->reader_epochs[i];
+        oldest_epoch = (oldest_epoch < tree->readers[i].epoch) ? oldest_epoch : tree->readers[i].epoch;
     }
 
     OPAL_LIST_FOREACH_SAFE(node, next, &tree->gc_list, opal_interval_tree_node_t) {
@@ -455,7 +478,7 @@ static inline void rp_wait_for_readers (opal_interval_tree_t *tree)
 
     /* wait for all readers to see the new tree version */
     for (int i = 0 ; i < tree->reader_count ; ++i) {
-        while (tree->reader_epochs[i] < epoch_id);
+        while (tree->readers[i].epoch < epoch_id);
     }
 }
 
@@ -70,6 +70,16 @@ typedef struct opal_interval_tree_node_t opal_interval_tree_node_t;
 /** maximum number of simultaneous readers */
 #define OPAL_INTERVAL_TREE_MAX_READERS 128
 
+/**
+  * epoch of a reader slot. each slot has a cache line of its own so that
+  * concurrent readers do not invalidate each other's line.
+  */
+struct opal_interval_tree_reader_t {
+    opal_atomic_uint32_t epoch;
+    char pad[60];
+};
+typedef struct opal_interval_tree_reader_t opal_interval_tree_reader_t;
+
 /**
   * the data structure that holds all the needed information about the tree.
   */
@@ -86,8 +96,8 @@ struct opal_interval_tree_t {
     opal_atomic_size_t tree_size;    /**< the current size of the tree */
     opal_atomic_int32_t lock;        /**< update lock */
     opal_atomic_int32_t reader_count;    /**< current highest reader slot to check */
-    volatile uint32_t reader_id;  /**< next reader slot to check */
-    opal_atomic_uint32_t reader_epochs[OPAL_INTERVAL_TREE_MAX_READERS];
+    volatile uint32_t reader_id;  /**< next reader slot to check (without thread local storage) */
+    opal_interval_tree_reader_t readers[OPAL_INTERVAL_TREE_MAX_READERS];
 };
 typedef struct opal_interval_tree_t opal_interval_tree_t;
 
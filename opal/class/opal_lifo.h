@@ -28,6 +28,7 @@
 
 #include "opal_config.h"
 #include <time.h>
+#include <assert.h>
 #include "opal/class/opal_list.h"
 
 #include "opal/sys/atomic.h"
@@ -86,6 +87,24 @@ static inline void opal_read_counted_pointer (volatile opal_counted_pointer_t *
 
 #endif
 
+/*
+ * With --enable-lifo-tagged-pointers the head of the LIFO is a single 64-bit
+ * word on x86_64: the item pointer in the low 48 bits, which is all a user
+ * space address uses, and a counter incremented by every pop in the high 16
+ * bits. Push and pop then use a 64-bit compare-and-swap instead of the slower
+ * 128-bit one. The counter only protects against the ABA problem as long as
+ * fewer than 65536 pops complete while a thread is between reading the head
+ * and swapping it, which is why this is not the default.
+ */
+#if OPAL_ENABLE_LIFO_TAGGED_POINTERS && defined(__x86_64__) && SIZEOF_VOID_P == 8
+#define OPAL_LIFO_TAGGED_POINTERS 1
+#define OPAL_LIFO_TAG_SHIFT 48
+#define OPAL_LIFO_POINTER_MASK ((intptr_t) ((UINT64_C(1) << OPAL_LIFO_TAG_SHIFT) - 1))
+#else
+#define OPAL_LIFO_TAGGED_POINTERS 0
+#define OPAL_LIFO_POINTER_MASK ((intptr_t) -1)
+#endif
+
 /**
  * @brief Helper function for lifo/fifo to sleep this thread if excessive contention is detected
  */
@@ -126,17 +145,80 @@ typedef struct opal_lifo_t opal_lifo_t;
 OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_lifo_t);
 
 
+/* Item pointer of a head value, without the counter of the tagged pointers */
+static inline opal_list_item_t *opal_lifo_untag (intptr_t head)
+{
+    return (opal_list_item_t *) (head & OPAL_LIFO_POINTER_MASK);
+}
+
+/* First item of the LIFO, the ghost if the LIFO is empty */
+static inline opal_list_item_t *opal_lifo_head_item (opal_lifo_t *lifo)
+{
+    return opal_lifo_untag (lifo->opal_lifo_head.data.item);
+}
+
 /* The ghost pointer will never change. The head will change via an atomic
  * compare-and-swap. On most architectures the reading of a pointer is an
  * atomic operation so we don't have to protect it.
  */
 static inline bool opal_lifo_is_empty( opal_lifo_t* lifo )
 {
-    return (opal_list_item_t *) lifo->opal_lifo_head.data.item == &lifo->opal_lifo_ghost;
+    return opal_lifo_head_item (lifo) == &lifo->opal_lifo_ghost;
 }
 
 
-#if OPAL_HAVE_ATOMIC_COMPARE_EXCHANGE_128
+#if OPAL_LIFO_TAGGED_POINTERS
+
+/* Add one element to the LIFO. We will return the last head of the list
+ * to allow the upper level to detect if this element is the first one in the
+ * list (if the list was empty before this operation).
+ */
+static inline opal_list_item_t *opal_lifo_push_atomic (opal_lifo_t *lifo,
+                                                       opal_list_item_t *item)
+{
+    intptr_t head = lifo->opal_lifo_head.data.item;
+    opal_list_item_t *next;
+
+    assert (0 == ((intptr_t) item & ~OPAL_LIFO_POINTER_MASK));
+
+    do {
+        next = opal_lifo_untag (head);
+        item->opal_list_next = next;
+        opal_atomic_wmb ();
+
+        /* as with the counted pointers it is sufficient to only update the counter in pop */
+        if (opal_atomic_compare_exchange_strong_ptr (&lifo->opal_lifo_head.data.item, &head,
+                                                     (head & ~OPAL_LIFO_POINTER_MASK) | (intptr_t) item)) {
+            return next;
+        }
+    } while (1);
+}
+
+/* Retrieve one element from the LIFO. If we reach the ghost element then the LIFO
+ * is empty so we return NULL.
+ */
+static inline opal_list_item_t *opal_lifo_pop_atomic (opal_lifo_t* lifo)
+{
+    intptr_t head = lifo->opal_lifo_head.data.item, new_head;
+    opal_list_item_t *item;
+
+    do {
+        item = opal_lifo_untag (head);
+        if (item == &lifo->opal_lifo_ghost) {
+            return NULL;
+        }
+
+        new_head = (intptr_t) ((((uintptr_t) head >> OPAL_LIFO_TAG_SHIFT) + 1) << OPAL_LIFO_TAG_SHIFT) |
+            (intptr_t) item->opal_list_next;
+        if (opal_atomic_compare_exchange_strong_ptr (&lifo->opal_lifo_head.data.item, &head, new_head)) {
+            opal_atomic_wmb ();
+            item->opal_list_next = NULL;
+            return item;
+        }
+    } while (1);
+}
+
+#elif OPAL_HAVE_ATOMIC_COMPARE_EXCHANGE_128
 
 /* Add one element to the LIFO. We will return the last head of the list
  * to allow the upper level to detect if this element is the first one in the
@@ -287,13 +369,13 @@ static inline opal_list_item_t *opal_lifo_pop_atomic (opal_lifo_t* lifo)
 
 #endif /* OPAL_HAVE_ATOMIC_LLSC_PTR */
 
-#endif
+#endif /* OPAL_LIFO_TAGGED_POINTERS */
 
 /* single-threaded versions of the lifo functions */
 static inline opal_list_item_t *opal_lifo_push_st (opal_lifo_t *lifo,
                                                    opal_list_item_t *item)
 {
-    item->opal_list_next = (opal_list_item_t *) lifo->opal_lifo_head.data.item;
+    item->opal_list_next = opal_lifo_head_item (lifo);
     item->item_free = 0;
     lifo->opal_lifo_head.data.item = (intptr_t) item;
     return (opal_list_item_t *) item->opal_list_next;
@@ -302,7 +384,7 @@ static inline opal_list_item_t *opal_lifo_push_st (opal_lifo_t *lifo,
 static inline opal_list_item_t *opal_lifo_pop_st (opal_lifo_t *lifo)
 {
     opal_list_item_t *item;
-    item = (opal_list_item_t *) lifo->opal_lifo_head.data.item;
+    item = opal_lifo_head_item (lifo);
     lifo->opal_lifo_head.data.item = (intptr_t) item->opal_list_next;
     if (item == &lifo->opal_lifo_ghost) {
         return NULL;
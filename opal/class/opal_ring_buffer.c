@@ -35,6 +35,13 @@ OBJ_CLASS_INSTANCE(opal_ring_buffer_t, opal_object_t,
                    opal_ring_buffer_construct,
                    opal_ring_buffer_destruct);
 
+static void opal_record_ring_construct(opal_record_ring_t *);
+static void opal_record_ring_destruct(opal_record_ring_t *);
+
+OBJ_CLASS_INSTANCE(opal_record_ring_t, opal_object_t,
+                   opal_record_ring_construct,
+                   opal_record_ring_destruct);
+
 /*
  * opal_ring_buffer constructor
  */
@@ -163,3 +170,47 @@ void* opal_ring_buffer_pop(opal_ring_buffer_t *ring)
     OPAL_RELEASE_THREAD(&(ring->lock), &(ring->cond), &(ring->in_use));
     return (void*)p;
 }
+
+/*
+ * opal_record_ring constructor
+ */
+static void opal_record_ring_construct(opal_record_ring_t *ring)
+{
+    ring->records = NULL;
+    ring->record_size = 0;
+    ring->mask = 0;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+/*
+ * opal_record_ring destructor
+ */
+static void opal_record_ring_destruct(opal_record_ring_t *ring)
+{
+    free(ring->records);
+    ring->records = NULL;
+}
+
+int opal_record_ring_init(opal_record_ring_t *ring, size_t record_size, size_t count)
+{
+    size_t n = 1;
+
+    if (NULL == ring || 0 == record_size || 0 == count) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    while (n < count) {
+        n <<= 1;
+    }
+    ring->records = (char *) malloc(n * record_size);
+    if (NULL == ring->records) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    ring->record_size = record_size;
+    ring->mask = n - 1;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return OPAL_SUCCESS;
+}
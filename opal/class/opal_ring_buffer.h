@@ -28,6 +28,7 @@
 
 #include "opal/threads/threads.h"
 #include "opal/class/opal_object.h"
+#include "opal/sys/atomic.h"
 #include "opal/util/output.h"
 
 BEGIN_C_DECLS
@@ -100,6 +101,125 @@ OPAL_DECLSPEC void* opal_ring_buffer_pop(opal_ring_buffer_t *ring);
  */
 OPAL_DECLSPEC void* opal_ring_buffer_poke(opal_ring_buffer_t *ring, int i);
 
+/**
+ * Lock-free ring of fixed size records with a single producer and a
+ * single consumer.
+ *
+ * The producer fills the slot returned by opal_record_ring_reserve() and
+ * publishes it with opal_record_ring_commit(). The consumer gets the
+ * oldest records with opal_record_ring_peek() and hands their slots back
+ * with opal_record_ring_release(). Producer and consumer may be different
+ * threads; several producers or several consumers have to be serialized
+ * by the caller.
+ */
+struct opal_record_ring_t {
+    /** base class */
+    opal_object_t super;
+    /** storage of the records */
+    char *records;
+    /** size of a record in bytes */
+    size_t record_size;
+    /** number of records - 1, the number of records is a power of 2 */
+    size_t mask;
+    /** number of records committed, only written by the producer */
+    opal_atomic_size_t head;
+    char pad[64];
+    /** number of records released, only written by the consumer */
+    opal_atomic_size_t tail;
+};
+/**
+ * Convenience typedef
+ */
+typedef struct opal_record_ring_t opal_record_ring_t;
+/**
+ * Class declaration
+ */
+OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_record_ring_t);
+
+/**
+ * Initialize the record ring.
+ *
+ * @param ring Pointer to a record ring (IN/OUT)
+ * @param record_size Size of a record in bytes (IN)
+ * @param count Minimum number of records in the ring, rounded up to a
+ *              power of 2 (IN)
+ *
+ * @return OPAL_SUCCESS or OPAL_ERR_OUT_OF_RESOURCE
+ */
+OPAL_DECLSPEC int opal_record_ring_init(opal_record_ring_t *ring, size_t record_size,
+                                        size_t count);
+
+/**
+ * Get the slot of the next record (producer)
+ *
+ * @return A pointer to record_size bytes, or NULL if the ring is full.
+ */
+static inline void *opal_record_ring_reserve(opal_record_ring_t *ring)
+{
+    size_t head = ring->head;
+
+    if (head - ring->tail > ring->mask) {
+        return NULL;
+    }
+    return ring->records + (head & ring->mask) * ring->record_size;
+}
+
+/**
+ * Publish the record written into the slot returned by the last call to
+ * opal_record_ring_reserve() (producer)
+ */
+static inline void opal_record_ring_commit(opal_record_ring_t *ring)
+{
+    size_t head = ring->head;
+
+    /* the record has to be visible before the new head */
+    opal_atomic_wmb();
+    ring->head = head + 1;
+}
+
+/**
+ * Get the oldest records (consumer)
+ *
+ * @param count Number of records at the returned address, which are
+ *              contiguous in memory. More records may follow at the start
+ *              of the ring (OUT)
+ *
+ * @return A pointer to the oldest record, NULL if the ring is empty.
+ */
+static inline void *opal_record_ring_peek(opal_record_ring_t *ring, size_t *count)
+{
+    size_t tail = ring->tail;
+    size_t head = ring->head;
+    size_t n;
+
+    if (head == tail) {
+        *count = 0;
+        return NULL;
+    }
+    /* do not read the records before the head */
+    opal_atomic_rmb();
+
+    n = head - tail;
+    if (n > ring->mask + 1 - (tail & ring->mask)) {
+        n = ring->mask + 1 - (tail & ring->mask);
+    }
+    *count = n;
+    return ring->records + (tail & ring->mask) * ring->record_size;
+}
+
+/**
+ * Hand the slots of the oldest count records back to the producer
+ * (consumer)
+ */
+static inline void opal_record_ring_release(opal_record_ring_t *ring, size_t count)
+{
+    size_t tail = ring->tail;
+
+    /* the records have to be read before the producer reuses them */
+    opal_atomic_mb();
+    ring->tail = tail + count;
+}
+
 END_C_DECLS
 
 #endif /* OPAL_RING_BUFFER_H */
@@ -46,7 +46,10 @@ opal_compress_base_module_t opal_compress = {
     NULL, /* decompress       */
     NULL,  /* decompress_nb    */
     compress_block,
-    decompress_block
+    decompress_block,
+    NULL, /* block_bound      */
+    NULL, /* block_compress   */
+    NULL  /* block_decompress */
 };
 opal_compress_base_t opal_compress_base = {0};
 
@@ -96,6 +96,30 @@ typedef bool (*opal_compress_base_module_compress_string_fn_t)(uint8_t *inbytes,
 typedef bool (*opal_compress_base_module_decompress_string_fn_t)(uint8_t **outbytes, size_t olen,
                                                                  uint8_t *inbytes, size_t len);
 
+/**
+ * Block codec
+ *
+ * Compress or decompress a buffer into storage provided by the caller,
+ * without any size threshold. Meant for data paths that work on
+ * buffers of a known size, e.g. the cycle buffers of collective I/O,
+ * and are therefore run with a fast setting of the codec.
+ *
+ * block_bound returns the output size that is always sufficient to
+ * compress inlen bytes.
+ *
+ * Arguments:
+ *   in    = input buffer
+ *   inlen = length of the input
+ *   out   = output buffer
+ *   olen  = in: size of the output buffer, out: length of the output
+ * Returns:
+ *   OPAL_SUCCESS on success, OPAL_ERR_TEMP_OUT_OF_RESOURCE if the output
+ *   buffer is too small, ow OPAL_ERROR
+ */
+typedef size_t (*opal_compress_base_module_block_bound_fn_t)(size_t inlen);
+typedef int (*opal_compress_base_module_block_codec_fn_t)(const uint8_t *in, size_t inlen,
+                                                          uint8_t *out, size_t *olen);
+
 
 /**
  * Structure for COMPRESS components.
@@ -136,6 +160,11 @@ struct opal_compress_base_module_1_0_0_t {
     /* COMPRESS STRING */
     opal_compress_base_module_compress_string_fn_t      compress_block;
     opal_compress_base_module_decompress_string_fn_t    decompress_block;
+
+    /* BLOCK CODEC, NULL if not provided by the component */
+    opal_compress_base_module_block_bound_fn_t          block_bound;
+    opal_compress_base_module_block_codec_fn_t          block_compress;
+    opal_compress_base_module_block_codec_fn_t          block_decompress;
 };
 typedef struct opal_compress_base_module_1_0_0_t opal_compress_base_module_1_0_0_t;
 typedef struct opal_compress_base_module_1_0_0_t opal_compress_base_module_t;
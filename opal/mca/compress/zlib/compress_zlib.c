@@ -131,3 +131,48 @@ bool opal_compress_zlib_uncompress_block(uint8_t **outbytes, size_t olen,
                         "\tINSIZE: %d OUTSIZE %d", (int)len, (int)olen);
     return true;
 }
+
+size_t opal_compress_zlib_block_bound(size_t inlen)
+{
+    return (size_t) compressBound ((uLong) inlen);
+}
+
+int opal_compress_zlib_block_compress(const uint8_t *in, size_t inlen,
+                                      uint8_t *out, size_t *olen)
+{
+    uLongf len = (uLongf) *olen;
+    int rc;
+
+    rc = compress2 ((Bytef *) out, &len, (const Bytef *) in, (uLong) inlen,
+                    mca_compress_zlib_component.block_level);
+    if (Z_BUF_ERROR == rc) {
+        return OPAL_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+    if (Z_OK != rc) {
+        return OPAL_ERROR;
+    }
+
+    *olen = (size_t) len;
+    return OPAL_SUCCESS;
+}
+
+int opal_compress_zlib_block_decompress(const uint8_t *in, size_t inlen,
+                                        uint8_t *out, size_t *olen)
+{
+    uLongf len = (uLongf) *olen;
+    int rc;
+
+    rc = uncompress ((Bytef *) out, &len, (const Bytef *) in, (uLong) inlen);
+    if (Z_BUF_ERROR == rc) {
+        /* either the output does not fit or the input is truncated */
+        return OPAL_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+    if (Z_OK != rc) {
+        opal_output_verbose(2, opal_compress_base_framework.framework_output,
+                            "\tBLOCK DECOMPRESS FAILED: %d", rc);
+        return OPAL_ERROR;
+    }
+
+    *olen = (size_t) len;
+    return OPAL_SUCCESS;
+}
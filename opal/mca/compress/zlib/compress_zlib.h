@@ -37,6 +37,8 @@ extern "C" {
     struct opal_compress_zlib_component_t {
         opal_compress_base_component_t super;  /** Base COMPRESS component */
 
+        /** Compression level of the block codec */
+        int block_level;
     };
     typedef struct opal_compress_zlib_component_t opal_compress_zlib_component_t;
     extern opal_compress_zlib_component_t mca_compress_zlib_component;
@@ -59,6 +61,12 @@ extern "C" {
     bool opal_compress_zlib_uncompress_block(uint8_t **outbytes, size_t olen,
                                              uint8_t *inbytes, size_t len);
 
+    size_t opal_compress_zlib_block_bound(size_t inlen);
+    int opal_compress_zlib_block_compress(const uint8_t *in, size_t inlen,
+                                          uint8_t *out, size_t *olen);
+    int opal_compress_zlib_block_decompress(const uint8_t *in, size_t inlen,
+                                            uint8_t *out, size_t *olen);
+
 #if defined(c_plusplus) || defined(__cplusplus)
 }
 #endif
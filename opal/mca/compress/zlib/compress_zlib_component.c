@@ -80,6 +80,11 @@ static opal_compress_base_module_t loc_module = {
 
     /** Decompress Function */
     .decompress_block = opal_compress_zlib_uncompress_block,
+
+    /** Block codec */
+    .block_bound = opal_compress_zlib_block_bound,
+    .block_compress = opal_compress_zlib_block_compress,
+    .block_decompress = opal_compress_zlib_block_decompress,
 };
 
 static int compress_zlib_register (void)
@@ -97,6 +102,17 @@ static int compress_zlib_register (void)
         return ret;
     }
 
+    mca_compress_zlib_component.block_level = 1;
+    ret = mca_base_component_var_register (&mca_compress_zlib_component.super.base_version,
+                                           "block_level", "Compression level (1-9) of the block codec "
+                                           "used on I/O data paths (default: 1, fastest)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                           &mca_compress_zlib_component.block_level);
+    if (0 > ret) {
+        return ret;
+    }
+
     mca_compress_zlib_component.super.verbose = 0;
     ret = mca_base_component_var_register (&mca_compress_zlib_component.super.base_version,
                                            "verbose",
@@ -45,6 +45,7 @@
 #include "opal/mca/base/mca_base_var.h"
 #include "opal/runtime/opal_params.h"
 #include "opal/dss/dss.h"
+#include "opal/class/opal_free_list.h"
 #include "opal/util/opal_environ.h"
 #include "opal/util/show_help.h"
 #include "opal/util/timings.h"
@@ -172,6 +173,66 @@ int opal_register_params(void)
                                  &opal_progress_yield_when_idle);
 #endif
 
+    opal_progress_profile = false;
+    ret = mca_base_var_register ("opal", "opal", "progress", "profile",
+                                 "Account the calls, completed events and time of every progress "
+                                 "callback. The statistics are available as performance variables "
+                                 "and printed by each process at finalize",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY,
+                                 &opal_progress_profile);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_progress_backoff_max = 0;
+    ret = mca_base_var_register ("opal", "opal", "progress", "backoff_max",
+                                 "Poll the progress callbacks that repeatedly complete no event "
+                                 "less often: after progress_backoff_threshold empty calls the "
+                                 "interval between two calls doubles, up to 2^backoff_max "
+                                 "iterations of the progress engine. The interval is reset when "
+                                 "the callback completes an event or a send is posted to its "
+                                 "component. The BTLs a posted receive can be matched through, and "
+                                 "libnbc while a nonblocking collective is active, are never backed "
+                                 "off. 0 polls every callback on every iteration (default 0)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &opal_progress_backoff_max);
+    if (0 > ret) {
+        return ret;
+    }
+    if (opal_progress_backoff_max > 16) {
+        opal_progress_backoff_max = 16;
+    }
+
+    opal_progress_backoff_threshold = 8;
+    ret = mca_base_var_register ("opal", "opal", "progress", "backoff_threshold",
+                                 "Number of consecutive calls without events after which a progress "
+                                 "callback is backed off (see progress_backoff_max)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &opal_progress_backoff_threshold);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_free_list_magazine_size = 0;
+    ret = mca_base_var_register ("opal", "opal", "free_list", "magazine_size",
+                                 "Number of items in the per-thread magazines of the free lists "
+                                 "without a maximum size. The threads take and return items to "
+                                 "their magazines without atomics, and exchange full magazines "
+                                 "with a single atomic operation. Only the free lists created "
+                                 "after this parameter is set have magazines. 0 disables them (default 0)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &opal_free_list_magazine_size);
+    if (0 > ret) {
+        return ret;
+    }
+    if (opal_free_list_magazine_size < 0) {
+        opal_free_list_magazine_size = 0;
+    }
+
 #if OPAL_ENABLE_DEBUG
     opal_progress_debug = false;
     ret = mca_base_var_register ("opal", "opal", "progress", "debug",
@@ -28,12 +28,18 @@
 #ifdef HAVE_SCHED_H
 #include <sched.h>
 #endif
+#include <ctype.h>
+#include <string.h>
+#if OPAL_HAVE_DLADDR
+#include <dlfcn.h>
+#endif
 
 #include "opal/runtime/opal_progress.h"
 #include "opal/mca/event/event.h"
 #include "opal/mca/base/mca_base_var.h"
 #include "opal/constants.h"
 #include "opal/mca/timer/base/base.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/util/output.h"
 #include "opal/runtime/opal_params.h"
 
@@ -68,6 +74,52 @@ static size_t callbacks_lp_size = 0;
 /* do we want to call sched_yield() if nothing happened */
 bool opal_progress_yield_when_idle = false;
 
+/* account the calls of each callback */
+bool opal_progress_profile = false;
+
+/* Adaptive polling: a callback that returned no event in
+   opal_progress_backoff_threshold consecutive calls is called only once
+   every 2, 4, ... up to 2^opal_progress_backoff_max iterations, until it
+   returns events again or is woken by opal_progress_backoff_wake(). A
+   callback held with opal_progress_backoff_hold(), e.g. a btl an
+   unmatched receive waits on, is called on every iteration until it is
+   released. */
+int opal_progress_backoff_max = 0;
+int opal_progress_backoff_threshold = 8;
+
+typedef struct opal_progress_backoff_t {
+    int32_t skip;       /* iterations left before the next call */
+    opal_atomic_int32_t holds; /* see opal_progress_backoff_hold() */
+    uint16_t misses;    /* consecutive calls without events */
+    uint16_t level;     /* log2 of the current polling interval */
+} opal_progress_backoff_t;
+
+/* The state of the callback in slot i of callbacks (callbacks_lp) is in
+   slot i of callbacks_backoff (callbacks_lp_backoff). The arrays are
+   static so that a thread in opal_progress() never sees them freed; the
+   callbacks behind the last slot are always called. */
+#define OPAL_PROGRESS_BACKOFF_SLOTS 32
+
+static opal_progress_backoff_t callbacks_backoff[OPAL_PROGRESS_BACKOFF_SLOTS];
+static opal_progress_backoff_t callbacks_lp_backoff[OPAL_PROGRESS_BACKOFF_SLOTS];
+
+/* Statistics of a progress callback. The entries are never removed, so
+   that the callbacks unregistered before the end still appear in the
+   summary; an entry is reused if its callback is registered again. */
+typedef struct opal_progress_profile_entry_t {
+    opal_progress_callback_t cb;
+    char name[64];
+    bool lp;
+    opal_atomic_size_t calls;
+    opal_atomic_size_t events;
+    opal_atomic_size_t ticks;
+} opal_progress_profile_entry_t;
+
+#define OPAL_PROGRESS_PROFILE_MAX 64
+
+static opal_progress_profile_entry_t profile_entries[OPAL_PROGRESS_PROFILE_MAX];
+static volatile size_t profile_entries_len = 0;
+
 #if OPAL_PROGRESS_USE_TIMERS
 static opal_timer_t event_progress_last_time = 0;
 static opal_timer_t event_progress_delta = 0;
@@ -96,10 +148,314 @@ static int debug_output = -1;
 static int fake_cb(void) { return 0; }
 
 static int _opal_progress_unregister (opal_progress_callback_t cb, volatile opal_progress_callback_t *callback_array,
-                                      size_t *callback_array_len);
+                                      size_t *callback_array_len, opal_progress_backoff_t *backoff);
+static int opal_progress_events(void);
+
+static inline opal_timer_t opal_progress_profile_ticks (void)
+{
+#if OPAL_PROGRESS_ONLY_USEC_NATIVE
+    return opal_timer_base_get_usec();
+#else
+    return opal_timer_base_get_cycles();
+#endif
+}
+
+static double opal_progress_profile_seconds (size_t ticks)
+{
+#if OPAL_PROGRESS_ONLY_USEC_NATIVE
+    return (double) ticks / 1000000.0;
+#else
+    opal_timer_t freq = opal_timer_base_get_freq();
+    return (0 == freq) ? 0.0 : (double) ticks / (double) freq;
+#endif
+}
+
+static int opal_progress_profile_get_calls (const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    opal_progress_profile_entry_t *entry = (opal_progress_profile_entry_t *) pvar->ctx;
+    *(unsigned long long *) value = (unsigned long long) entry->calls;
+    return OPAL_SUCCESS;
+}
+
+static int opal_progress_profile_get_events (const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    opal_progress_profile_entry_t *entry = (opal_progress_profile_entry_t *) pvar->ctx;
+    *(unsigned long long *) value = (unsigned long long) entry->events;
+    return OPAL_SUCCESS;
+}
+
+static int opal_progress_profile_get_time (const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    opal_progress_profile_entry_t *entry = (opal_progress_profile_entry_t *) pvar->ctx;
+    *(double *) value = opal_progress_profile_seconds (entry->ticks);
+    return OPAL_SUCCESS;
+}
+
+/* Name of a callback, usable in the name of a performance variable */
+static void opal_progress_profile_name (opal_progress_callback_t cb, char *name, size_t len)
+{
+    bool named = false;
+
+#if OPAL_HAVE_DLADDR
+    Dl_info info;
+
+    if (0 != dladdr ((void *)(intptr_t) cb, &info)) {
+        if (NULL != info.dli_sname && info.dli_saddr == (void *)(intptr_t) cb) {
+            snprintf (name, len, "%s", info.dli_sname);
+            named = true;
+        } else if (NULL != info.dli_fname) {
+            /* not exported, name it by its library and offset */
+            const char *base = strrchr (info.dli_fname, '/');
+            base = (NULL == base) ? info.dli_fname : base + 1;
+            snprintf (name, len, "%.*s_%lx", (int) strcspn (base, "."), base,
+                      (unsigned long) ((intptr_t) cb - (intptr_t) info.dli_fbase));
+            named = true;
+        }
+    }
+#endif
+    if (!named) {
+        snprintf (name, len, "cb_%lx", (unsigned long)(intptr_t) cb);
+    }
+
+    for (char *c = name ; '\0' != *c ; ++c) {
+        if (!isalnum ((unsigned char) *c)) {
+            *c = '_';
+        }
+    }
+
+    /* the names have to be unique */
+    for (size_t i = 0 ; i < profile_entries_len ; ++i) {
+        if (0 == strcmp (profile_entries[i].name, name)) {
+            size_t used = strlen (name);
+            snprintf (name + used, len - used, "_%d", (int) profile_entries_len);
+            break;
+        }
+    }
+}
+
+/* Find or create the statistics of a callback. Called with progress_lock
+   held. */
+static opal_progress_profile_entry_t *opal_progress_profile_add (opal_progress_callback_t cb, const char *name,
+                                                                 bool lp)
+{
+    opal_progress_profile_entry_t *entry;
+    char pvar_name[128], desc[160];
+
+    for (size_t i = 0 ; i < profile_entries_len ; ++i) {
+        if (profile_entries[i].cb == cb) {
+            profile_entries[i].lp = lp;
+            return profile_entries + i;
+        }
+    }
+
+    if (OPAL_PROGRESS_PROFILE_MAX == profile_entries_len) {
+        return NULL;
+    }
+
+    entry = profile_entries + profile_entries_len;
+    entry->cb = cb;
+    entry->lp = lp;
+    if (NULL != name) {
+        snprintf (entry->name, sizeof (entry->name), "%s", name);
+    } else {
+        opal_progress_profile_name (cb, entry->name, sizeof (entry->name));
+    }
+    entry->calls = entry->events = entry->ticks = 0;
+
+    /* the callback is found by opal_progress() only once it is complete */
+    opal_atomic_wmb ();
+    ++profile_entries_len;
+
+    /* performance variables */
+    snprintf (pvar_name, sizeof (pvar_name), "%s_calls", entry->name);
+    snprintf (desc, sizeof (desc), "Number of calls of the %s progress callback", entry->name);
+    (void) mca_base_pvar_register ("opal", "opal", "progress", pvar_name, desc, OPAL_INFO_LVL_5,
+                                   MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                                   NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+                                   MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                   opal_progress_profile_get_calls, NULL, NULL, entry);
+
+    snprintf (pvar_name, sizeof (pvar_name), "%s_events", entry->name);
+    snprintf (desc, sizeof (desc), "Number of events completed by the %s progress callback", entry->name);
+    (void) mca_base_pvar_register ("opal", "opal", "progress", pvar_name, desc, OPAL_INFO_LVL_5,
+                                   MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                                   NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+                                   MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                   opal_progress_profile_get_events, NULL, NULL, entry);
+
+    snprintf (pvar_name, sizeof (pvar_name), "%s_time", entry->name);
+    snprintf (desc, sizeof (desc), "Time spent in the %s progress callback (seconds)", entry->name);
+    (void) mca_base_pvar_register ("opal", "opal", "progress", pvar_name, desc, OPAL_INFO_LVL_5,
+                                   MCA_BASE_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE,
+                                   NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+                                   MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                   opal_progress_profile_get_time, NULL, NULL, entry);
+    return entry;
+}
+
+/* Call a progress callback and account for it */
+static int opal_progress_call_profiled (opal_progress_callback_t cb)
+{
+    opal_progress_profile_entry_t *entry = NULL;
+    opal_timer_t start;
+    int events;
+
+    for (size_t i = 0 ; i < profile_entries_len ; ++i) {
+        if (profile_entries[i].cb == cb) {
+            entry = profile_entries + i;
+            break;
+        }
+    }
+
+    if (NULL == entry) {
+        return cb ();
+    }
+
+    start = opal_progress_profile_ticks ();
+    events = cb ();
+    OPAL_THREAD_ADD_FETCH_SIZE_T(&entry->ticks, (size_t)(opal_progress_profile_ticks () - start));
+    OPAL_THREAD_ADD_FETCH_SIZE_T(&entry->calls, 1);
+    if (events > 0) {
+        OPAL_THREAD_ADD_FETCH_SIZE_T(&entry->events, (size_t) events);
+    }
+
+    return events;
+}
+
+static inline int opal_progress_call (opal_progress_callback_t cb)
+{
+    if (OPAL_LIKELY(!opal_progress_profile)) {
+        return cb ();
+    }
+    return opal_progress_call_profiled (cb);
+}
+
+/* Call a callback unless it is backed off */
+static inline int opal_progress_poll (opal_progress_callback_t cb, opal_progress_backoff_t *backoff, size_t slot)
+{
+    opal_progress_backoff_t *state;
+    int32_t skip;
+    int events;
+
+    if (OPAL_LIKELY(0 >= opal_progress_backoff_max) || slot >= OPAL_PROGRESS_BACKOFF_SLOTS) {
+        return opal_progress_call (cb);
+    }
+
+    /* the state is only a hint, races between threads only change when
+       the callback is called next. skip is read once so that it never
+       drops below 0. */
+    state = backoff + slot;
+    if (0 < state->holds) {
+        /* a component waits for an event from this callback */
+        if (OPAL_UNLIKELY(0 != state->level)) {
+            state->skip = 0;
+            state->misses = 0;
+            state->level = 0;
+        }
+        return opal_progress_call (cb);
+    }
+
+    skip = state->skip;
+    if (skip > 0) {
+        state->skip = skip - 1;
+        return 0;
+    }
+
+    events = opal_progress_call (cb);
+    if (events > 0) {
+        state->misses = 0;
+        state->level = 0;
+    } else if (state->level > 0 || ++state->misses >= opal_progress_backoff_threshold) {
+        if (state->level < opal_progress_backoff_max) {
+            ++state->level;
+        }
+        state->misses = 0;
+        state->skip = (1 << state->level) - 1;
+    }
+
+    return events;
+}
+
+static opal_progress_backoff_t *_opal_progress_backoff_find (opal_progress_callback_t cb,
+                                                              volatile opal_progress_callback_t *cbs,
+                                                              size_t cbs_len, opal_progress_backoff_t *backoff)
+{
+    for (size_t i = 0 ; i < cbs_len && i < OPAL_PROGRESS_BACKOFF_SLOTS ; ++i) {
+        if (cbs[i] == cb) {
+            return backoff + i;
+        }
+    }
+
+    return NULL;
+}
+
+/* The state of a registered callback, NULL if it is not registered or
+   behind the last slot (never backed off) */
+static opal_progress_backoff_t *opal_progress_backoff_find (opal_progress_callback_t cb)
+{
+    opal_progress_backoff_t *state;
+
+    state = _opal_progress_backoff_find (cb, callbacks, callbacks_len, callbacks_backoff);
+    if (NULL == state) {
+        state = _opal_progress_backoff_find (cb, callbacks_lp, callbacks_lp_len, callbacks_lp_backoff);
+    }
+
+    return state;
+}
+
+void opal_progress_backoff_wake_cb (opal_progress_callback_t cb)
+{
+    opal_progress_backoff_t *state = opal_progress_backoff_find (cb);
+
+    if (NULL != state && 0 != state->level) {
+        state->skip = 0;
+        state->misses = 0;
+        state->level = 0;
+    }
+}
+
+void opal_progress_backoff_hold_cb (opal_progress_callback_t cb, int32_t count)
+{
+    opal_progress_backoff_t *state = opal_progress_backoff_find (cb);
+
+    /* a release racing with the unregistration of another callback may
+       land on a neighbouring slot, a negative count counts as no hold */
+    if (NULL != state) {
+        (void) OPAL_THREAD_ADD_FETCH32(&state->holds, count);
+    }
+}
+
+/* Print where the time of opal_progress() went */
+static void opal_progress_profile_summary (void)
+{
+    double total = 0.0, t;
+
+    for (size_t i = 0 ; i < profile_entries_len ; ++i) {
+        total += opal_progress_profile_seconds (profile_entries[i].ticks);
+    }
+
+    opal_output (0, "progress profile: %-40s %4s %12s %12s %12s %10s %6s",
+                 "callback", "prio", "calls", "events", "time (s)", "us/call", "time%");
+    for (size_t i = 0 ; i < profile_entries_len ; ++i) {
+        opal_progress_profile_entry_t *entry = profile_entries + i;
+
+        if (0 == entry->calls) {
+            continue;
+        }
+        t = opal_progress_profile_seconds (entry->ticks);
+        opal_output (0, "progress profile: %-40s %4s %12zu %12zu %12.6f %10.3f %5.1f%%",
+                     entry->name, entry->lp ? "low" : "high", (size_t) entry->calls,
+                     (size_t) entry->events, t, 1e6 * t / (double) entry->calls,
+                     (total > 0.0) ? 100.0 * t / total : 0.0);
+    }
+}
 
 static void opal_progress_finalize (void)
 {
+    if (opal_progress_profile) {
+        opal_progress_profile_summary ();
+    }
+
     /* free memory associated with the callbacks */
     opal_atomic_lock(&progress_lock);
 
@@ -154,6 +510,11 @@ opal_progress_init(void)
         callbacks_lp[i] = fake_cb;
     }
 
+    if (opal_progress_profile) {
+        /* the event library is accounted as a low priority callback */
+        (void) opal_progress_profile_add (opal_progress_events, "libevent", true);
+    }
+
     OPAL_OUTPUT((debug_output, "progress: initialized event flag to: %x",
                  opal_progress_event_flag));
     OPAL_OUTPUT((debug_output, "progress: initialized yield_when_idle to: %s",
@@ -218,8 +579,8 @@ static int opal_progress_events(void)
  * care, as the cost of that happening is far outweighed by the cost
  * of the if checks (they were resulting in bad pipe stalling behavior)
  */
-void
-opal_progress(void)
+static inline int
+_opal_progress(void)
 {
     static uint32_t num_calls = 0;
     size_t i;
@@ -227,7 +588,7 @@ opal_progress(void)
 
     /* progress all registered callbacks */
     for (i = 0 ; i < callbacks_len ; ++i) {
-        events += (callbacks[i])();
+        events += opal_progress_poll (callbacks[i], callbacks_backoff, i);
     }
 
     /* Run low priority callbacks and events once every 8 calls to opal_progress().
@@ -238,15 +599,23 @@ opal_progress(void)
      */
     if (((num_calls++) & 0x7) == 0) {
         for (i = 0 ; i < callbacks_lp_len ; ++i) {
-            events += (callbacks_lp[i])();
+            events += opal_progress_poll (callbacks_lp[i], callbacks_lp_backoff, i);
         }
 
-        opal_progress_events();
+        opal_progress_call (opal_progress_events);
     } else if (num_event_users > 0) {
-        opal_progress_events();
+        opal_progress_call (opal_progress_events);
     }
 
+    return events;
+}
+
+void
+opal_progress(void)
+{
 #if OPAL_HAVE_SCHED_YIELD
+    int events = _opal_progress();
+
     if (opal_progress_yield_when_idle && events <= 0) {
         /* If there is nothing to do - yield the processor - otherwise
          * we could consume the processor for the entire time slice. If
@@ -255,9 +624,17 @@ opal_progress(void)
          */
         sched_yield();
     }
+#else
+    (void) _opal_progress();
 #endif  /* defined(HAVE_SCHED_YIELD) */
 }
 
+int
+opal_progress_run(void)
+{
+    return _opal_progress();
+}
+
 
 int
 opal_progress_set_event_flag(int flag)
@@ -380,7 +757,7 @@ static int opal_progress_find_cb (opal_progress_callback_t cb, volatile opal_pro
 }
 
 static int _opal_progress_register (opal_progress_callback_t cb, volatile opal_progress_callback_t **cbs,
-                                    size_t *cbs_size, size_t *cbs_len)
+                                    size_t *cbs_size, size_t *cbs_len, opal_progress_backoff_t *backoff)
 {
     int ret = OPAL_SUCCESS;
 
@@ -417,6 +794,11 @@ static int _opal_progress_register (opal_progress_callback_t cb, volatile opal_p
         *cbs_size *= 2;
     }
 
+    if (*cbs_len < OPAL_PROGRESS_BACKOFF_SLOTS) {
+        backoff[*cbs_len] = (opal_progress_backoff_t) {.skip = 0, .holds = 0,
+                                                        .misses = 0, .level = 0};
+    }
+
     cbs[0][*cbs_len] = cb;
     ++*cbs_len;
 
@@ -431,9 +813,13 @@ int opal_progress_register (opal_progress_callback_t cb)
 
     opal_atomic_lock(&progress_lock);
 
-    (void) _opal_progress_unregister (cb, callbacks_lp, &callbacks_lp_len);
+    (void) _opal_progress_unregister (cb, callbacks_lp, &callbacks_lp_len, callbacks_lp_backoff);
+
+    ret = _opal_progress_register (cb, &callbacks, &callbacks_size, &callbacks_len, callbacks_backoff);
 
-    ret = _opal_progress_register (cb, &callbacks, &callbacks_size, &callbacks_len);
+    if (opal_progress_profile && OPAL_SUCCESS == ret) {
+        (void) opal_progress_profile_add (cb, NULL, false);
+    }
 
     opal_atomic_unlock(&progress_lock);
 
@@ -446,9 +832,13 @@ int opal_progress_register_lp (opal_progress_callback_t cb)
 
     opal_atomic_lock(&progress_lock);
 
-    (void) _opal_progress_unregister (cb, callbacks, &callbacks_len);
+    (void) _opal_progress_unregister (cb, callbacks, &callbacks_len, callbacks_backoff);
+
+    ret = _opal_progress_register (cb, &callbacks_lp, &callbacks_lp_size, &callbacks_lp_len, callbacks_lp_backoff);
 
-    ret = _opal_progress_register (cb, &callbacks_lp, &callbacks_lp_size, &callbacks_lp_len);
+    if (opal_progress_profile && OPAL_SUCCESS == ret) {
+        (void) opal_progress_profile_add (cb, NULL, true);
+    }
 
     opal_atomic_unlock(&progress_lock);
 
@@ -456,7 +846,7 @@ int opal_progress_register_lp (opal_progress_callback_t cb)
 }
 
 static int _opal_progress_unregister (opal_progress_callback_t cb, volatile opal_progress_callback_t *callback_array,
-                                      size_t *callback_array_len)
+                                      size_t *callback_array_len, opal_progress_backoff_t *backoff)
 {
     int ret = opal_progress_find_cb (cb, callback_array, *callback_array_len);
     if (OPAL_ERR_NOT_FOUND == ret) {
@@ -471,6 +861,9 @@ static int _opal_progress_unregister (opal_progress_callback_t cb, volatile opal
         /* copy callbacks atomically since another thread may be in
          * opal_progress(). */
         (void) opal_atomic_swap_ptr ((opal_atomic_intptr_t *) (callback_array + i), (intptr_t) callback_array[i+1]);
+        if (i + 1 < OPAL_PROGRESS_BACKOFF_SLOTS) {
+            backoff[i] = backoff[i+1];
+        }
     }
 
     callback_array[*callback_array_len] = fake_cb;
@@ -485,12 +878,12 @@ int opal_progress_unregister (opal_progress_callback_t cb)
 
     opal_atomic_lock(&progress_lock);
 
-    ret = _opal_progress_unregister (cb, callbacks, &callbacks_len);
+    ret = _opal_progress_unregister (cb, callbacks, &callbacks_len, callbacks_backoff);
 
     if (OPAL_SUCCESS != ret) {
         /* if not in the high-priority array try to remove from the lp array.
          * a callback will never be in both. */
-        ret = _opal_progress_unregister (cb, callbacks_lp, &callbacks_lp_len);
+        ret = _opal_progress_unregister (cb, callbacks_lp, &callbacks_lp_len, callbacks_lp_backoff);
     }
 
     opal_atomic_unlock(&progress_lock);
@@ -59,6 +59,16 @@ OPAL_DECLSPEC int opal_progress_init(void);
  */
 OPAL_DECLSPEC void opal_progress(void);
 
+/**
+ * Progress all pending events once
+ *
+ * Same as opal_progress(), without yielding the processor, for the
+ * loops that decide themselves when to wait.
+ *
+ * @return         Number of events the callbacks progressed
+ */
+OPAL_DECLSPEC int opal_progress_run(void);
+
 
 /**
  * Control how the event library is called
@@ -172,6 +182,57 @@ OPAL_DECLSPEC extern int opal_progress_spin_count;
 /* do we want to call sched_yield() if nothing happened */
 OPAL_DECLSPEC extern bool opal_progress_yield_when_idle;
 
+/* account the time spent in each progress callback */
+OPAL_DECLSPEC extern bool opal_progress_profile;
+
+/* maximum log2 of the polling interval of idle callbacks, 0 to call
+   every callback on every iteration */
+OPAL_DECLSPEC extern int opal_progress_backoff_max;
+OPAL_DECLSPEC extern int opal_progress_backoff_threshold;
+
+OPAL_DECLSPEC void opal_progress_backoff_wake_cb (opal_progress_callback_t cb);
+OPAL_DECLSPEC void opal_progress_backoff_hold_cb (opal_progress_callback_t cb, int32_t count);
+
+/**
+ * Poll a callback on the next iteration again
+ *
+ * Callbacks that did not progress any event for a while are polled
+ * less often. Components call this when they expect an event from
+ * the callback, e.g. when a send is posted to a BTL, so that the
+ * completion is not delayed.
+ */
+static inline void opal_progress_backoff_wake (opal_progress_callback_t cb)
+{
+    if (OPAL_UNLIKELY(0 < opal_progress_backoff_max) && NULL != cb) {
+        opal_progress_backoff_wake_cb (cb);
+    }
+}
+
+/**
+ * Poll a callback on every iteration until the matching release
+ *
+ * For components that wait for an event from the callback for an
+ * unknown time, e.g. the BTLs a posted receive may be matched through.
+ * Holds are counted. Returns whether the hold was taken, which has to
+ * be passed to opal_progress_backoff_release() so that the count stays
+ * balanced if the backoff is turned on or off in between.
+ */
+static inline bool opal_progress_backoff_hold (opal_progress_callback_t cb)
+{
+    if (OPAL_LIKELY(0 >= opal_progress_backoff_max) || NULL == cb) {
+        return false;
+    }
+    opal_progress_backoff_hold_cb (cb, 1);
+    return true;
+}
+
+static inline void opal_progress_backoff_release (opal_progress_callback_t cb, bool held)
+{
+    if (held) {
+        opal_progress_backoff_hold_cb (cb, -1);
+    }
+}
+
 /**
  * Progress until flag is true or poll iterations completed
  */
@@ -18,8 +18,23 @@
 #include "oshmem/mca/memheap/base/base.h"
 #include "opal/class/opal_hash_table.h"
 #include "opal/class/opal_object.h"
+#include "opal/mca/timer/base/base.h"
 
 static int buddy_init(mca_memheap_buddy_module_t* buddy);
+static int slab_init(mca_memheap_buddy_module_t* buddy);
+static void slab_cleanup(mca_memheap_buddy_module_t* buddy);
+
+/* Size classes of the slab caches, every class keeps 8 byte alignment
+ * as MEMHEAP_BASE_MIN_ORDER does for the buddy allocator.
+ */
+static const size_t slab_class_sizes[MEMHEAP_BUDDY_SLAB_MAX_CLASSES] = {
+    8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048
+};
+
+OBJ_CLASS_INSTANCE(mca_memheap_buddy_slab_t,
+                   opal_list_item_t,
+                   NULL,
+                   NULL);
 
 mca_memheap_buddy_module_t memheap_buddy = {
     {
@@ -188,6 +203,7 @@ int mca_memheap_buddy_module_init(memheap_context_t *context)
 
     /* Construct a mutex object */
     OBJ_CONSTRUCT(&memheap_buddy.lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&memheap_buddy.slab_lock, opal_mutex_t);
 
     memheap_buddy.heap.max_order = memheap_log2(context->user_size);
     memheap_buddy.heap.min_order = MEMHEAP_BASE_MIN_ORDER;
@@ -217,6 +233,12 @@ int mca_memheap_buddy_module_init(memheap_context_t *context)
         goto err;
     }
 
+    /* Initialize slab caches for small allocations */
+    if (OSHMEM_SUCCESS != slab_init(&memheap_buddy)) {
+        MEMHEAP_ERROR("Failed to setup MEMHEAP slab caches");
+        goto err;
+    }
+
     return OSHMEM_SUCCESS;
 
     err: mca_memheap_buddy_finalize();
@@ -430,6 +452,291 @@ static int buddy_private_free(mca_memheap_buddy_module_t* buddy,
     return _buddy_free(buddy, seg, order, &buddy->private_heap);
 }
 
+/*
+ * Slab caches.
+ * Small allocations are served from slabs: buddy blocks of slab_order
+ * split into objects of one size class. This bounds internal
+ * fragmentation by the class spacing instead of a power of two and
+ * replaces the bitmap scan with a free list pop. The allocator is
+ * deterministic, so allocations stay symmetric as long as all PEs make
+ * the same sequence of calls.
+ */
+static int slab_init(mca_memheap_buddy_module_t* buddy)
+{
+    int i;
+    size_t slab_bytes;
+    mca_memheap_buddy_slab_class_t *cls;
+
+    buddy->slab_num_classes = 0;
+    buddy->slab_hashtable = NULL;
+
+    if (0 == buddy->slab_max_size) {
+        return OSHMEM_SUCCESS;
+    }
+
+    buddy->slab_order = memheap_buddy_find_order(buddy->slab_size);
+    if (buddy->slab_order < buddy->heap.min_order) {
+        buddy->slab_order = buddy->heap.min_order;
+    }
+    if (buddy->slab_order >= buddy->heap.max_order) {
+        MEMHEAP_VERBOSE(5, "symmetric heap is too small for slab caches");
+        buddy->slab_max_size = 0;
+        return OSHMEM_SUCCESS;
+    }
+    slab_bytes = 1UL << buddy->slab_order;
+
+    for (i = 0; i < MEMHEAP_BUDDY_SLAB_MAX_CLASSES; i++) {
+        /* a slab should hold at least two objects to be of any use */
+        if ((slab_class_sizes[i] > buddy->slab_max_size) ||
+            (slab_class_sizes[i] > (slab_bytes >> 1))) {
+            break;
+        }
+
+        cls = &buddy->slab_classes[buddy->slab_num_classes++];
+        cls->obj_size = slab_class_sizes[i];
+        cls->num_objs = slab_bytes / cls->obj_size;
+        OBJ_CONSTRUCT(&cls->partial, opal_list_t);
+        OBJ_CONSTRUCT(&cls->full, opal_list_t);
+    }
+
+    if (0 == buddy->slab_num_classes) {
+        buddy->slab_max_size = 0;
+        return OSHMEM_SUCCESS;
+    }
+    buddy->slab_max_size =
+            buddy->slab_classes[buddy->slab_num_classes - 1].obj_size;
+
+    buddy->slab_hashtable = OBJ_NEW(opal_hash_table_t);
+    if (NULL == buddy->slab_hashtable) {
+        MEMHEAP_ERROR("Opal failed to allocate hashtable object");
+        return OSHMEM_ERROR;
+    }
+    opal_hash_table_init(buddy->slab_hashtable, DEFAULT_HASHTABLE_SIZE);
+
+    MEMHEAP_VERBOSE(5,
+                    "slab caches: %d classes up to %llu bytes, slab size %llu bytes",
+                    buddy->slab_num_classes,
+                    (unsigned long long)buddy->slab_max_size,
+                    (unsigned long long)slab_bytes);
+
+    return OSHMEM_SUCCESS;
+}
+
+static void slab_cleanup(mca_memheap_buddy_module_t* buddy)
+{
+    int i;
+    opal_list_item_t *item;
+    mca_memheap_buddy_slab_class_t *cls;
+
+    for (i = 0; i < buddy->slab_num_classes; i++) {
+        cls = &buddy->slab_classes[i];
+        while (NULL != (item = opal_list_remove_first(&cls->partial))) {
+            OBJ_RELEASE(item);
+        }
+        while (NULL != (item = opal_list_remove_first(&cls->full))) {
+            OBJ_RELEASE(item);
+        }
+        OBJ_DESTRUCT(&cls->partial);
+        OBJ_DESTRUCT(&cls->full);
+    }
+    buddy->slab_num_classes = 0;
+
+    if (NULL != buddy->slab_hashtable) {
+        OBJ_RELEASE(buddy->slab_hashtable);
+        buddy->slab_hashtable = NULL;
+    }
+
+    OBJ_DESTRUCT(&buddy->slab_lock);
+}
+
+static inline mca_memheap_buddy_slab_class_t *slab_find_class(size_t size)
+{
+    int i;
+
+    for (i = 0; i < memheap_buddy.slab_num_classes; i++) {
+        if (size <= memheap_buddy.slab_classes[i].obj_size) {
+            return &memheap_buddy.slab_classes[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Should be called with slab_lock held */
+static mca_memheap_buddy_slab_t *slab_find(unsigned long addr)
+{
+    unsigned long base = (unsigned long) memheap_buddy.heap.symmetric_heap;
+    unsigned long offset;
+    void *slab;
+
+    if ((NULL == memheap_buddy.slab_hashtable) || (addr < base) ||
+        (addr >= base + (1UL << memheap_buddy.heap.max_order))) {
+        return NULL;
+    }
+
+    /* buddy blocks are aligned to their size, so is every slab */
+    offset = (addr - base) & ~((1UL << memheap_buddy.slab_order) - 1);
+    if (OPAL_SUCCESS !=
+            opal_hash_table_get_value_uint64(memheap_buddy.slab_hashtable,
+                                             base + offset,
+                                             &slab)) {
+        return NULL;
+    }
+
+    return (mca_memheap_buddy_slab_t *) slab;
+}
+
+/* Should be called with slab_lock held */
+static mca_memheap_buddy_slab_t *slab_create(mca_memheap_buddy_slab_class_t *cls)
+{
+    mca_memheap_buddy_slab_t *slab;
+    uint32_t offset;
+
+    if (OSHMEM_SUCCESS != _buddy_alloc(memheap_buddy.slab_order,
+                                       &offset,
+                                       &memheap_buddy.heap)) {
+        MEMHEAP_VERBOSE(5, "Buddy Allocator failed to return a slab");
+        return NULL;
+    }
+
+    slab = OBJ_NEW(mca_memheap_buddy_slab_t);
+    if (NULL == slab) {
+        goto alloc_error;
+    }
+
+    slab->base = (unsigned long) memheap_buddy.heap.symmetric_heap + offset;
+    slab->free_list = NULL;
+    slab->next_unused = 0;
+    slab->num_used = 0;
+    slab->cls = cls;
+
+    if (OPAL_SUCCESS !=
+            opal_hash_table_set_value_uint64(memheap_buddy.slab_hashtable,
+                                             slab->base,
+                                             slab)) {
+        MEMHEAP_VERBOSE(5, "Failed to insert slab to hashtable");
+        OBJ_RELEASE(slab);
+        goto alloc_error;
+    }
+
+    opal_list_append(&cls->partial, &slab->super);
+    OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.slab_bytes,
+                            1LL << memheap_buddy.slab_order);
+    MCA_SPML_CALL(memuse_hook((void *) slab->base,
+                              1ULL << memheap_buddy.slab_order));
+
+    MEMHEAP_VERBOSE(20,
+                    "new slab 0x%lx for objects of %d bytes",
+                    slab->base, (int)cls->obj_size);
+    return slab;
+
+    alloc_error: _buddy_free(&memheap_buddy,
+                             offset,
+                             memheap_buddy.slab_order,
+                             &memheap_buddy.heap);
+    return NULL;
+}
+
+/* Should be called with slab_lock held */
+static void slab_destroy(mca_memheap_buddy_slab_t *slab)
+{
+    unsigned long base = (unsigned long) memheap_buddy.heap.symmetric_heap;
+
+    MEMHEAP_VERBOSE(20, "release slab 0x%lx", slab->base);
+
+    opal_list_remove_item(&slab->cls->partial, &slab->super);
+    opal_hash_table_remove_value_uint64(memheap_buddy.slab_hashtable,
+                                        slab->base);
+    _buddy_free(&memheap_buddy,
+                (uint32_t) (slab->base - base),
+                memheap_buddy.slab_order,
+                &memheap_buddy.heap);
+    OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.slab_bytes,
+                            -(1LL << memheap_buddy.slab_order));
+    OBJ_RELEASE(slab);
+}
+
+static int slab_alloc(size_t size, void **p_buff, size_t *allocated)
+{
+    mca_memheap_buddy_slab_class_t *cls;
+    mca_memheap_buddy_slab_t *slab;
+    void *obj;
+
+    cls = slab_find_class(size);
+    if (NULL == cls) {
+        return OSHMEM_ERROR;
+    }
+
+    OPAL_THREAD_LOCK(&memheap_buddy.slab_lock);
+    if (opal_list_is_empty(&cls->partial)) {
+        if (NULL == slab_create(cls)) {
+            OPAL_THREAD_UNLOCK(&memheap_buddy.slab_lock);
+            return OSHMEM_ERROR;
+        }
+    }
+
+    slab = (mca_memheap_buddy_slab_t *) opal_list_get_first(&cls->partial);
+    if (NULL != slab->free_list) {
+        obj = slab->free_list;
+        slab->free_list = *(void **) obj;
+    } else {
+        obj = (void *) (slab->base + slab->next_unused * cls->obj_size);
+        slab->next_unused++;
+    }
+
+    if (++slab->num_used == cls->num_objs) {
+        opal_list_remove_item(&cls->partial, &slab->super);
+        opal_list_append(&cls->full, &slab->super);
+    }
+    OPAL_THREAD_UNLOCK(&memheap_buddy.slab_lock);
+
+    *p_buff = obj;
+    *allocated = cls->obj_size;
+    return OSHMEM_SUCCESS;
+}
+
+/* Should be called with slab_lock held */
+static int slab_free(mca_memheap_buddy_slab_t *slab, void *ptr)
+{
+    mca_memheap_buddy_slab_class_t *cls = slab->cls;
+    unsigned long offset = (unsigned long) ptr - slab->base;
+
+    if ((offset % cls->obj_size) ||
+        (offset / cls->obj_size >= slab->next_unused)) {
+        MEMHEAP_VERBOSE(5, "address %p is not a slab object", ptr);
+        return OSHMEM_ERROR;
+    }
+
+    *(void **) ptr = slab->free_list;
+    slab->free_list = ptr;
+
+    if (slab->num_used-- == cls->num_objs) {
+        opal_list_remove_item(&cls->full, &slab->super);
+        opal_list_append(&cls->partial, &slab->super);
+    }
+
+    /* keep a single empty slab per class to avoid buddy round trips */
+    if ((0 == slab->num_used) && (opal_list_get_size(&cls->partial) > 1)) {
+        slab_destroy(slab);
+    }
+
+    return OSHMEM_SUCCESS;
+}
+
+static inline void _account_alloc(size_t requested,
+                                  size_t allocated,
+                                  opal_timer_t start)
+{
+    OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.requested_bytes,
+                            (int64_t) requested);
+    OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.allocated_bytes,
+                            (int64_t) allocated);
+    OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.in_use_bytes,
+                            (int64_t) allocated);
+    OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.alloc_cycles,
+                            (int64_t) (opal_timer_base_get_cycles() - start));
+}
+
 static int _do_alloc(uint32_t order,
                      void **p_buff,
                      mca_memheap_buddy_heap_t *heap)
@@ -488,16 +795,41 @@ static int do_private_alloc(uint32_t order, void **p_buff)
 
 /**
  * Allocate size bytes on the symmetric heap.
- * The allocated variable is aligned to its size.
+ * Buddy allocations are aligned to their size rounded up to a power of two.
+ * Small allocations get the alignment of their slab class: the class size
+ * for power of two classes, and the largest power of two dividing the class
+ * size otherwise, i.e. 8 bytes for 24, 16 for 48, 32 for 96 and so on up to
+ * 512 for 1536 byte objects. Use shmem_align() for a stronger guarantee.
  */
 int mca_memheap_buddy_alloc(size_t size, void** p_buff)
 {
-
+    int rc;
     uint32_t order;
+    size_t allocated;
+    opal_timer_t start = opal_timer_base_get_cycles();
+
+    if ((0 < size) && (size <= memheap_buddy.slab_max_size)) {
+        rc = slab_alloc(size, p_buff, &allocated);
+        if (OSHMEM_SUCCESS == rc) {
+            OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.slab_allocs, 1);
+            _account_alloc(size, allocated, start);
+            return OSHMEM_SUCCESS;
+        }
+        /* no room for a new slab, try the buddy allocator */
+    }
 
     order = memheap_buddy_find_order(size);
+    if (order < memheap_buddy.heap.min_order) {
+        order = memheap_buddy.heap.min_order;
+    }
+
+    rc = do_alloc(order, p_buff);
+    if (OSHMEM_SUCCESS == rc) {
+        OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.buddy_allocs, 1);
+        _account_alloc(size, 1UL << order, start);
+    }
 
-    return do_alloc(order, p_buff);
+    return rc;
 }
 
 int mca_memheap_buddy_private_alloc(size_t size, void** p_buff)
@@ -548,7 +880,9 @@ int mca_memheap_buddy_private_free(void* ptr)
 
 int mca_memheap_buddy_align(size_t align, size_t size, void **p_buff)
 {
+    int rc;
     uint32_t order;
+    opal_timer_t start = opal_timer_base_get_cycles();
 
     if (align == 0) {
         *p_buff = 0;
@@ -564,8 +898,16 @@ int mca_memheap_buddy_align(size_t align, size_t size, void **p_buff)
     order = memheap_buddy_find_order(size);
     if ((unsigned long) align > (1UL << order))
         order = memheap_buddy_find_order(align);
+    if (order < memheap_buddy.heap.min_order)
+        order = memheap_buddy.heap.min_order;
+
+    rc = do_alloc(order, p_buff);
+    if (OSHMEM_SUCCESS == rc) {
+        OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.buddy_allocs, 1);
+        _account_alloc(size, 1UL << order, start);
+    }
 
-    return do_alloc(order, p_buff);
+    return rc;
 }
 
 int mca_memheap_buddy_realloc(size_t new_size, void *p_buff, void **p_new_buff)
@@ -575,6 +917,7 @@ int mca_memheap_buddy_realloc(size_t new_size, void *p_buff, void **p_new_buff)
     void *order;
     size_t old_size;
     char *tmp_buf;
+    mca_memheap_buddy_slab_t *slab;
 
     /* equiv to alloc if old ptr is null */
     if (NULL == p_buff)
@@ -582,13 +925,21 @@ int mca_memheap_buddy_realloc(size_t new_size, void *p_buff, void **p_new_buff)
 
     addr = (unsigned long) p_buff;
 
-    rc =
-            opal_hash_table_get_value_uint64(memheap_buddy.heap.symmetric_heap_hashtable,
-                                             addr,
-                                             &order);
-    if (OPAL_SUCCESS != rc) {
-        *p_new_buff = NULL;
-        return OSHMEM_ERROR;
+    OPAL_THREAD_LOCK(&memheap_buddy.slab_lock);
+    slab = slab_find(addr);
+    old_size = (slab ? slab->cls->obj_size : 0);
+    OPAL_THREAD_UNLOCK(&memheap_buddy.slab_lock);
+
+    if (!old_size) {
+        rc =
+                opal_hash_table_get_value_uint64(memheap_buddy.heap.symmetric_heap_hashtable,
+                                                 addr,
+                                                 &order);
+        if (OPAL_SUCCESS != rc) {
+            *p_new_buff = NULL;
+            return OSHMEM_ERROR;
+        }
+        old_size = 1UL << (unsigned long) order;
     }
 
     /* equiv to free if new_size is 0 */
@@ -597,8 +948,6 @@ int mca_memheap_buddy_realloc(size_t new_size, void *p_buff, void **p_new_buff)
         return mca_memheap_buddy_free(p_buff);
     }
 
-    old_size = 1UL << (unsigned long) order;
-
     /* do nothing if new size is less then current size */
     if (new_size <= old_size) {
         *p_new_buff = p_buff;
@@ -653,11 +1002,27 @@ int mca_memheap_buddy_free(void* ptr)
     unsigned long addr;
     unsigned long base;
     void *order;
+    mca_memheap_buddy_slab_t *slab;
+    size_t obj_size;
 
     base = (unsigned long) memheap_buddy.heap.symmetric_heap;
     addr = (unsigned long) ptr;
     offset = addr - base;
 
+    OPAL_THREAD_LOCK(&memheap_buddy.slab_lock);
+    slab = slab_find(addr);
+    if (NULL != slab) {
+        obj_size = slab->cls->obj_size;
+        rc = slab_free(slab, ptr);
+        OPAL_THREAD_UNLOCK(&memheap_buddy.slab_lock);
+        if (OSHMEM_SUCCESS == rc) {
+            OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.in_use_bytes,
+                                    -(int64_t) obj_size);
+        }
+        return rc;
+    }
+    OPAL_THREAD_UNLOCK(&memheap_buddy.slab_lock);
+
     rc =
             opal_hash_table_get_value_uint64(memheap_buddy.heap.symmetric_heap_hashtable,
                                              addr,
@@ -669,6 +1034,8 @@ int mca_memheap_buddy_free(void* ptr)
     buddy_free(&memheap_buddy, offset, (unsigned) (unsigned long) order);
     opal_hash_table_remove_value_uint64(memheap_buddy.heap.symmetric_heap_hashtable,
                                         addr);
+    OPAL_THREAD_ADD_FETCH64(&memheap_buddy.stats.in_use_bytes,
+                            -(1LL << (unsigned long) order));
 
     return OSHMEM_SUCCESS;
 }
@@ -689,6 +1056,7 @@ int mca_memheap_buddy_finalize()
         OBJ_RELEASE(memheap_buddy.private_heap.symmetric_heap_hashtable);
     }
 
+    slab_cleanup(&memheap_buddy);
     buddy_cleanup(&memheap_buddy);
 
     return OSHMEM_SUCCESS;
@@ -52,6 +52,43 @@ struct mca_memheap_buddy_heap_t {
 };
 typedef struct mca_memheap_buddy_heap_t mca_memheap_buddy_heap_t;
 
+#define MEMHEAP_BUDDY_SLAB_MAX_CLASSES   16
+
+struct mca_memheap_buddy_slab_class_t;
+
+/* Slab of equally sized objects carved from a single buddy block */
+struct mca_memheap_buddy_slab_t {
+    opal_list_item_t super;
+    unsigned long base; /** Address of the buddy block */
+    void *free_list; /** Freed objects linked through their first word */
+    unsigned next_unused; /** Index of the first object never handed out */
+    unsigned num_used; /** Number of objects in use */
+    struct mca_memheap_buddy_slab_class_t *cls;
+};
+typedef struct mca_memheap_buddy_slab_t mca_memheap_buddy_slab_t;
+OBJ_CLASS_DECLARATION(mca_memheap_buddy_slab_t);
+
+/* Cache of slabs serving one size class */
+struct mca_memheap_buddy_slab_class_t {
+    size_t obj_size; /** Size of the objects of the class */
+    unsigned num_objs; /** Number of objects per slab */
+    opal_list_t partial; /** Slabs with at least one free object */
+    opal_list_t full; /** Slabs without free objects */
+};
+typedef struct mca_memheap_buddy_slab_class_t mca_memheap_buddy_slab_class_t;
+
+/* Statistics of the symmetric heap exposed as performance variables */
+struct mca_memheap_buddy_stats_t {
+    opal_atomic_int64_t requested_bytes; /** Bytes requested by the user (cumulative) */
+    opal_atomic_int64_t allocated_bytes; /** Bytes handed out to the user (cumulative) */
+    opal_atomic_int64_t in_use_bytes; /** Bytes currently handed out to the user */
+    opal_atomic_int64_t slab_bytes; /** Bytes of the heap owned by the slab caches */
+    opal_atomic_int64_t slab_allocs; /** Number of allocations served by the slab caches */
+    opal_atomic_int64_t buddy_allocs; /** Number of allocations served by the buddy allocator */
+    opal_atomic_int64_t alloc_cycles; /** Time spent in allocation (timer cycles) */
+};
+typedef struct mca_memheap_buddy_stats_t mca_memheap_buddy_stats_t;
+
 /* Structure for managing shmem symmetric heap */
 struct mca_memheap_buddy_module_t {
     mca_memheap_base_module_t super;
@@ -60,6 +97,15 @@ struct mca_memheap_buddy_module_t {
     mca_memheap_buddy_heap_t heap;
     mca_memheap_buddy_heap_t private_heap;
     opal_mutex_t lock; /** Part of the buddy allocator */
+
+    size_t slab_max_size; /** Largest allocation served by the slab caches, 0 - disabled */
+    size_t slab_size; /** Size of a slab, rounded up to a power of two */
+    unsigned slab_order; /** Log2 of the slab size */
+    int slab_num_classes; /** Number of slab size classes in use */
+    mca_memheap_buddy_slab_class_t slab_classes[MEMHEAP_BUDDY_SLAB_MAX_CLASSES];
+    opal_hash_table_t* slab_hashtable; /** Slab base address to slab lookup */
+    opal_mutex_t slab_lock; /** Protects the slab caches */
+    mca_memheap_buddy_stats_t stats;
 };
 typedef struct mca_memheap_buddy_module_t mca_memheap_buddy_module_t;
 OSHMEM_DECLSPEC extern mca_memheap_buddy_module_t memheap_buddy;
@@ -12,6 +12,7 @@
  */
 #include "oshmem_config.h"
 #include "opal/util/output.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "oshmem/mca/memheap/memheap.h"
 #include "oshmem/mca/memheap/base/base.h"
 #include "oshmem/mca/memheap/buddy/memheap_buddy.h"
@@ -21,6 +22,7 @@ static int mca_memheap_buddy_component_close(void);
 static int mca_memheap_buddy_component_query(mca_base_module_t **module, int *priority);
 
 static int _basic_open(void);
+static int _basic_register(void);
 
 mca_memheap_base_component_t mca_memheap_buddy_component = {
     .memheap_version = {
@@ -31,6 +33,7 @@ mca_memheap_base_component_t mca_memheap_buddy_component = {
                               OSHMEM_RELEASE_VERSION),
 
         .mca_open_component = _basic_open,
+        .mca_register_component_params = _basic_register,
         .mca_close_component = mca_memheap_buddy_component_close,
         .mca_query_component = mca_memheap_buddy_component_query,
     },
@@ -41,6 +44,115 @@ mca_memheap_base_component_t mca_memheap_buddy_component = {
     .memheap_init = mca_memheap_buddy_module_init
 };
 
+static int _fragmentation_read(const struct mca_base_pvar_t *pvar,
+                               void *value,
+                               void *obj)
+{
+    double requested = (double) memheap_buddy.stats.requested_bytes;
+    double allocated = (double) memheap_buddy.stats.allocated_bytes;
+
+    *(double *) value = (allocated > 0.0 ? 1.0 - requested / allocated : 0.0);
+
+    return OSHMEM_SUCCESS;
+}
+
+/* Register component parameters and performance variables */
+static int _basic_register(void)
+{
+    mca_base_component_t *comp = &mca_memheap_buddy_component.memheap_version;
+
+    memheap_buddy.slab_max_size = 2048;
+    (void) mca_base_component_var_register(comp,
+                                           "slab_max_size",
+                                           "Allocations up to this size (in bytes) are served from per size class slab caches carved from buddy blocks (0 - disabled)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &memheap_buddy.slab_max_size);
+
+    memheap_buddy.slab_size = 65536;
+    (void) mca_base_component_var_register(comp,
+                                           "slab_size",
+                                           "Size (in bytes) of a buddy block used as a slab, rounded up to a power of two",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &memheap_buddy.slab_size);
+
+    (void) mca_base_component_pvar_register(comp, "requested_bytes",
+                                            "Number of bytes requested by symmetric heap allocations",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &memheap_buddy.stats.requested_bytes);
+
+    (void) mca_base_component_pvar_register(comp, "allocated_bytes",
+                                            "Number of bytes handed out by symmetric heap allocations, including rounding",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &memheap_buddy.stats.allocated_bytes);
+
+    (void) mca_base_component_pvar_register(comp, "fragmentation",
+                                            "Internal fragmentation of the symmetric heap: share of allocated bytes not requested by the user",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_PERCENTAGE,
+                                            MCA_BASE_VAR_TYPE_DOUBLE, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            _fragmentation_read, NULL, NULL, NULL);
+
+    (void) mca_base_component_pvar_register(comp, "in_use_bytes",
+                                            "Number of symmetric heap bytes currently handed out to the user",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_SIZE,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &memheap_buddy.stats.in_use_bytes);
+
+    (void) mca_base_component_pvar_register(comp, "slab_bytes",
+                                            "Number of symmetric heap bytes owned by the slab caches",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_SIZE,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &memheap_buddy.stats.slab_bytes);
+
+    (void) mca_base_component_pvar_register(comp, "slab_allocs",
+                                            "Number of allocations served by the slab caches",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &memheap_buddy.stats.slab_allocs);
+
+    (void) mca_base_component_pvar_register(comp, "buddy_allocs",
+                                            "Number of allocations served by the buddy allocator",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &memheap_buddy.stats.buddy_allocs);
+
+    (void) mca_base_component_pvar_register(comp, "alloc_time",
+                                            "Time spent in symmetric heap allocations (in timer cycles, divide by slab_allocs + buddy_allocs for the average latency)",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_TIMER,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG, NULL,
+                                            MCA_BASE_VAR_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL,
+                                            (void *) &memheap_buddy.stats.alloc_cycles);
+
+    return OSHMEM_SUCCESS;
+}
+
 /* Open component */
 static int _basic_open(void)
 {
@@ -40,6 +40,10 @@ OSHMEM_DECLSPEC extern int mca_scoll_basic_param_barrier_algorithm;
 extern int mca_scoll_basic_param_broadcast_algorithm;
 extern int mca_scoll_basic_param_collect_algorithm;
 extern int mca_scoll_basic_param_reduce_algorithm;
+extern size_t mca_scoll_basic_param_reduce_rabenseifner_threshold;
+extern size_t mca_scoll_basic_param_reduce_ring_threshold;
+extern size_t mca_scoll_basic_param_reduce_segment_size;
+extern size_t mca_scoll_basic_param_collect_ring_threshold;
 
 /* API functions */
 
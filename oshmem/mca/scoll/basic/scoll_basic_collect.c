@@ -75,6 +75,16 @@ int mca_scoll_basic_collect(struct oshmem_group_t *group,
 
             alg = (alg == SCOLL_DEFAULT_ALG ?
                     mca_scoll_basic_param_collect_algorithm : alg);
+            if (alg == SCOLL_ALG_COLLECT_ADAPTIVE) {
+                /* Recursive Doubling needs log2(NP) steps but moves whole
+                 * collected parts, Ring moves every part once in NP-1
+                 * nearest neighbour steps and is preferable for large data
+                 */
+                alg = ((nlong * group->proc_count) <
+                       mca_scoll_basic_param_collect_ring_threshold ?
+                        SCOLL_ALG_COLLECT_RECURSIVE_DOUBLING :
+                        SCOLL_ALG_COLLECT_RING);
+            }
             switch (alg) {
             case SCOLL_ALG_COLLECT_CENTRAL_COUNTER:
                 {
@@ -30,9 +30,12 @@ const char *mca_scoll_basic_component_version_string =
 int mca_scoll_basic_priority_param = -1;
 int mca_scoll_basic_param_barrier_algorithm = SCOLL_ALG_BARRIER_ADAPTIVE;
 int mca_scoll_basic_param_broadcast_algorithm = SCOLL_ALG_BROADCAST_BINOMIAL;
-int mca_scoll_basic_param_collect_algorithm =
-        SCOLL_ALG_COLLECT_RECURSIVE_DOUBLING;
-int mca_scoll_basic_param_reduce_algorithm = SCOLL_ALG_REDUCE_RECURSIVE_DOUBLING;
+int mca_scoll_basic_param_collect_algorithm = SCOLL_ALG_COLLECT_ADAPTIVE;
+int mca_scoll_basic_param_reduce_algorithm = SCOLL_ALG_REDUCE_ADAPTIVE;
+size_t mca_scoll_basic_param_reduce_rabenseifner_threshold = 16384;
+size_t mca_scoll_basic_param_reduce_ring_threshold = 4194304;
+size_t mca_scoll_basic_param_reduce_segment_size = 1048576;
+size_t mca_scoll_basic_param_collect_ring_threshold = 65536;
 
 /*
  * Local function
@@ -118,11 +121,12 @@ static int basic_register(void)
                                            &mca_scoll_basic_param_broadcast_algorithm);
 
     sprintf(help_msg,
-            "Algorithm selection for Collect (%d - Central Counter, %d - Tournament, %d - Recursive Doubling, %d - Ring)",
+            "Algorithm selection for Collect (%d - Central Counter, %d - Tournament, %d - Recursive Doubling, %d - Ring, %d - Adaptive)",
             SCOLL_ALG_COLLECT_CENTRAL_COUNTER,
             SCOLL_ALG_COLLECT_TOURNAMENT,
             SCOLL_ALG_COLLECT_RECURSIVE_DOUBLING,
-            SCOLL_ALG_COLLECT_RING);
+            SCOLL_ALG_COLLECT_RING,
+            SCOLL_ALG_COLLECT_ADAPTIVE);
     (void) mca_base_component_var_register(comp,
                                            "collect_alg",
                                            help_msg,
@@ -132,12 +136,15 @@ static int basic_register(void)
                                            &mca_scoll_basic_param_collect_algorithm);
 
     sprintf(help_msg,
-            "Algorithm selection for Reduce (%d - Central Counter, %d - Tournament, %d - Recursive Doubling %d - Linear %d - Log)",
+            "Algorithm selection for Reduce (%d - Central Counter, %d - Tournament, %d - Recursive Doubling %d - Linear %d - Log %d - Rabenseifner %d - Ring %d - Adaptive)",
             SCOLL_ALG_REDUCE_CENTRAL_COUNTER,
             SCOLL_ALG_REDUCE_TOURNAMENT,
             SCOLL_ALG_REDUCE_RECURSIVE_DOUBLING,
             SCOLL_ALG_REDUCE_LEGACY_LINEAR,
-            SCOLL_ALG_REDUCE_LEGACY_LOG);
+            SCOLL_ALG_REDUCE_LEGACY_LOG,
+            SCOLL_ALG_REDUCE_RABENSEIFNER,
+            SCOLL_ALG_REDUCE_RING,
+            SCOLL_ALG_REDUCE_ADAPTIVE);
     (void) mca_base_component_var_register(comp,
                                            "reduce_alg",
                                            help_msg,
@@ -146,6 +153,38 @@ static int basic_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_scoll_basic_param_reduce_algorithm);
 
+    (void) mca_base_component_var_register(comp,
+                                           "reduce_rabenseifner_threshold",
+                                           "Message size (in bytes) starting from which the adaptive Reduce switches from Recursive Doubling to Rabenseifner",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_scoll_basic_param_reduce_rabenseifner_threshold);
+
+    (void) mca_base_component_var_register(comp,
+                                           "reduce_ring_threshold",
+                                           "Message size (in bytes) starting from which the adaptive Reduce switches from Rabenseifner to Ring",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_scoll_basic_param_reduce_ring_threshold);
+
+    (void) mca_base_component_var_register(comp,
+                                           "reduce_segment_size",
+                                           "Segment size (in bytes) used by the Ring Reduce algorithm, segments are never larger than half of the vector (the pWrk capacity), 0 uses that size",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_scoll_basic_param_reduce_segment_size);
+
+    (void) mca_base_component_var_register(comp,
+                                           "collect_ring_threshold",
+                                           "Total collected size (in bytes) starting from which the adaptive Collect switches from Recursive Doubling to Ring",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_scoll_basic_param_collect_ring_threshold);
+
     return OSHMEM_SUCCESS;
 }
 
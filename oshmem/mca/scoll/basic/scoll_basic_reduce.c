@@ -56,6 +56,23 @@ static int _algorithm_log(struct oshmem_group_t *group,
                            size_t nlong,
                            long *pSync,
                            void *pWrk);
+static int _algorithm_rabenseifner(struct oshmem_group_t *group,
+                                    struct oshmem_op_t *op,
+                                    void *target,
+                                    const void *source,
+                                    size_t nlong,
+                                    long *pSync,
+                                    void *pWrk);
+static int _algorithm_ring(struct oshmem_group_t *group,
+                            struct oshmem_op_t *op,
+                            void *target,
+                            const void *source,
+                            size_t nlong,
+                            long *pSync,
+                            void *pWrk);
+static int _algorithm_adaptive(struct oshmem_group_t *group,
+                                struct oshmem_op_t *op,
+                                size_t nlong);
 
 int mca_scoll_basic_reduce(struct oshmem_group_t *group,
                            struct oshmem_op_t *op,
@@ -86,6 +103,9 @@ int mca_scoll_basic_reduce(struct oshmem_group_t *group,
         if (pSync) {
             alg = (alg == SCOLL_DEFAULT_ALG ?
                     mca_scoll_basic_param_reduce_algorithm : alg);
+            if (alg == SCOLL_ALG_REDUCE_ADAPTIVE) {
+                alg = _algorithm_adaptive(group, op, nlong);
+            }
             switch (alg) {
             case SCOLL_ALG_REDUCE_CENTRAL_COUNTER:
                 {
@@ -142,6 +162,28 @@ int mca_scoll_basic_reduce(struct oshmem_group_t *group,
                                          pWrk);
                     break;
                 }
+            case SCOLL_ALG_REDUCE_RABENSEIFNER:
+                {
+                    rc = _algorithm_rabenseifner(group,
+                                                  op,
+                                                  target,
+                                                  source,
+                                                  nlong,
+                                                  pSync,
+                                                  pWrk);
+                    break;
+                }
+            case SCOLL_ALG_REDUCE_RING:
+                {
+                    rc = _algorithm_ring(group,
+                                          op,
+                                          target,
+                                          source,
+                                          nlong,
+                                          pSync,
+                                          pWrk);
+                    break;
+                }
             default:
                 {
                     rc = _algorithm_central_counter(group,
@@ -817,3 +859,444 @@ static int _algorithm_log(struct oshmem_group_t *group,
     /* All done */
     return rc;
 }
+
+/*
+ Choose an algorithm by message size in the same spirit as the coll/tuned
+ decision functions: Recursive Doubling is latency optimal and is kept for
+ short vectors, Rabenseifner moves only 2*(NP-1)/NP of the data per PE in
+ log2(NP) steps and Ring does the same in NP-1 nearest neighbour steps,
+ which behaves better for very long vectors.
+ */
+static int _algorithm_adaptive(struct oshmem_group_t *group,
+                                struct oshmem_op_t *op,
+                                size_t nlong)
+{
+    size_t count = nlong / op->dt_size;
+
+    if ((group->proc_count < 2) ||
+        (count < (size_t) group->proc_count) ||
+        (nlong < mca_scoll_basic_param_reduce_rabenseifner_threshold)) {
+        return SCOLL_ALG_REDUCE_RECURSIVE_DOUBLING;
+    }
+
+    if (nlong < mca_scoll_basic_param_reduce_ring_threshold) {
+        return SCOLL_ALG_REDUCE_RABENSEIFNER;
+    }
+
+    return SCOLL_ALG_REDUCE_RING;
+}
+
+/*
+ One step of a pairwise exchange: wait until the peer announces that it is
+ ready for the step by setting its pSync[0] to the expected value, deliver
+ the data directly into the peer target buffer and signal the peer. Then
+ wait for the symmetric signal from the PE that sends to us in this step.
+ */
+static int _exchange_step(struct oshmem_group_t *group,
+                          int peer_pe,
+                          long expected,
+                          void *remote,
+                          void *local,
+                          size_t size,
+                          long *pSync)
+{
+    int rc = OSHMEM_SUCCESS;
+    long value = SHMEM_SYNC_INIT;
+
+    do {
+        MCA_SPML_CALL(get(oshmem_ctx_default, (void*)pSync, sizeof(value), (void*)&value, peer_pe));
+    } while (value != expected);
+
+    SCOLL_VERBOSE(14,
+                  "[#%d] step = %ld send data (%d bytes) to #%d",
+                  group->my_pe, expected, (int)size, peer_pe);
+    if (size) {
+        rc = MCA_SPML_CALL(put(oshmem_ctx_default, remote, size, local, peer_pe));
+    }
+
+    MCA_SPML_CALL(fence(oshmem_ctx_default));
+
+    SCOLL_VERBOSE(14,
+                  "[#%d] step = %ld signals to #%d",
+                  group->my_pe, expected, peer_pe);
+    value = SHMEM_SYNC_RUN;
+    rc = MCA_SPML_CALL(put(oshmem_ctx_default, (void*)pSync, sizeof(value), (void*)&value, peer_pe));
+
+    SCOLL_VERBOSE(14, "[#%d] step = %ld wait", group->my_pe, expected);
+    value = SHMEM_SYNC_RUN;
+    rc = MCA_SPML_CALL(wait((void*)pSync, SHMEM_CMP_EQ, (void*)&value, SHMEM_LONG));
+
+    return rc;
+}
+
+/*
+ The Rabenseifner algorithm.
+ Reduce-scatter is done by recursive halving: in every round a PE keeps one
+ half of its current range and hands the other half to its peer, so after
+ log2(NP) rounds each PE owns a fully reduced 1/NP part of the vector.
+ The parts are collected back by recursive doubling over the same pairs.
+ PEs above the largest power of two are folded in as in Recursive Doubling,
+ except that the partner in the basic group fetches the data of the extra PE
+ piece by piece. Partial results never exceed half of the vector, so pWrk
+ (nreduce/2 + 1 elements) is the only scratch space needed.
+ Outlay:
+ 2*log2(NP) steps, each PE sends and reduces about 2*nlong*(NP-1)/NP bytes.
+ */
+static int _algorithm_rabenseifner(struct oshmem_group_t *group,
+                                    struct oshmem_op_t *op,
+                                    void *target,
+                                    const void *source,
+                                    size_t nlong,
+                                    long *pSync,
+                                    void *pWrk)
+{
+    int rc = OSHMEM_SUCCESS;
+    int round = 0;
+    int floor2_proc = 0;
+    int nsteps = 0;
+    long value = SHMEM_SYNC_INIT;
+    int my_id = oshmem_proc_group_find_id(group, group->my_pe);
+    int peer_id = 0;
+    int peer_pe = 0;
+    int i = 0;
+    size_t dt_size = op->dt_size;
+    size_t count = nlong / dt_size;
+    size_t wrk_count = count / 2 + 1;
+    size_t offset = 0;
+    size_t len = 0;
+    size_t base = 0;
+    size_t lo = 0;
+    size_t hi = count;
+    size_t lo_level[sizeof(int) * 8];
+    size_t hi_level[sizeof(int) * 8];
+
+    floor2_proc = 1;
+    i = group->proc_count;
+    i >>= 1;
+    while (i) {
+        i >>= 1;
+        floor2_proc <<= 1;
+    }
+    nsteps = scoll_log2(floor2_proc);
+
+    /* Every PE of the basic group should own at least one element */
+    if ((NULL == pWrk) || (nsteps < 1) || (count < (size_t) floor2_proc)) {
+        return _algorithm_recursive_doubling(group,
+                                              op,
+                                              target,
+                                              source,
+                                              nlong,
+                                              pSync,
+                                              pWrk);
+    }
+
+    SCOLL_VERBOSE(12,
+                  "[#%d] Reduce algorithm: Rabenseifner",
+                  group->my_pe);
+    SCOLL_VERBOSE(15,
+                  "[#%d] pSync[0] = %ld floor2_proc = %d",
+                  group->my_pe, pSync[0], floor2_proc);
+
+    if (my_id >= floor2_proc) {
+        /* I am in extra group, my partner is node (my_id-y) in basic group */
+        peer_id = my_id - floor2_proc;
+        peer_pe = oshmem_proc_pe(group->proc_array[peer_id]);
+
+        /* The source stays untouched until the partner delivers the result,
+         * so it can be fetched even if it is the same buffer as the target.
+         */
+        SCOLL_VERBOSE(14,
+                      "[#%d] is extra and signal to #%d that data is ready",
+                      group->my_pe, peer_pe);
+        value = SHMEM_SYNC_WAIT;
+        rc = MCA_SPML_CALL(put(oshmem_ctx_default, (void*)pSync, sizeof(value), (void*)&value, peer_pe));
+
+        SCOLL_VERBOSE(14, "[#%d] wait", group->my_pe);
+        value = SHMEM_SYNC_RUN;
+        rc = MCA_SPML_CALL(wait((void*)pSync, SHMEM_CMP_EQ, (void*)&value, SHMEM_LONG));
+    } else {
+        if (source != target) {
+            memcpy(target, (void *) source, nlong);
+        }
+
+        /* Wait for a peer from extra group */
+        if ((group->proc_count - floor2_proc) > my_id) {
+            /* I am in basic group, my partner is node (my_id+y) in extra group */
+            peer_id = my_id + floor2_proc;
+            peer_pe = oshmem_proc_pe(group->proc_array[peer_id]);
+
+            SCOLL_VERBOSE(14,
+                          "[#%d] wait a signal from #%d",
+                          group->my_pe, peer_pe);
+            value = SHMEM_SYNC_WAIT;
+            rc = MCA_SPML_CALL(wait((void*)pSync, SHMEM_CMP_EQ, (void*)&value, SHMEM_LONG));
+
+            /* Fetch and reduce the peer data in pWrk sized pieces */
+            for (offset = 0; (offset < count) && (rc == OSHMEM_SUCCESS);
+                    offset += len) {
+                len = count - offset;
+                if (len > wrk_count) {
+                    len = wrk_count;
+                }
+                rc = MCA_SPML_CALL(get(oshmem_ctx_default,
+                                       (void*)((unsigned char*)source + offset * dt_size),
+                                       len * dt_size,
+                                       pWrk,
+                                       peer_pe));
+                if (rc == OSHMEM_SUCCESS) {
+                    op->o_func.c_fn(pWrk,
+                                    (void*)((unsigned char*)target + offset * dt_size),
+                                    len);
+                }
+            }
+        }
+
+        /* Reduce-scatter by recursive halving, the partial result of the
+         * range I keep is accumulated in pWrk starting from element 'base'
+         */
+        for (i = 0; (i < nsteps) && (rc == OSHMEM_SUCCESS); i++) {
+            size_t mid = lo + (hi - lo) / 2;
+            size_t send_lo = 0;
+            size_t send_hi = 0;
+
+            peer_id = my_id ^ (floor2_proc >> (i + 1));
+            peer_pe = oshmem_proc_pe(group->proc_array[peer_id]);
+
+            lo_level[i] = lo;
+            hi_level[i] = hi;
+            if (my_id < peer_id) {
+                send_lo = mid;
+                send_hi = hi;
+                hi = mid;
+            } else {
+                send_lo = lo;
+                send_hi = mid;
+                lo = mid;
+            }
+
+            /* The peer writes into the half I keep as soon as pSync[0]
+             * announces the first round, so my data is saved before.
+             */
+            if (0 == i) {
+                base = lo;
+                memcpy(pWrk,
+                       (void*)((unsigned char*)target + lo * dt_size),
+                       (hi - lo) * dt_size);
+            }
+
+            pSync[0] = round;
+            round++;
+            rc = _exchange_step(group,
+                                peer_pe,
+                                round - 1,
+                                (void*)((unsigned char*)target + send_lo * dt_size),
+                                (0 == i) ?
+                                (void*)((unsigned char*)target + send_lo * dt_size) :
+                                (void*)((unsigned char*)pWrk + (send_lo - base) * dt_size),
+                                (send_hi - send_lo) * dt_size,
+                                pSync);
+
+            /* Do reduction operation on the half I keep */
+            if (rc == OSHMEM_SUCCESS) {
+                op->o_func.c_fn((void*)((unsigned char*)target + lo * dt_size),
+                                (void*)((unsigned char*)pWrk + (lo - base) * dt_size),
+                                hi - lo);
+            }
+        }
+
+        pSync[0] = round;
+
+        memcpy((void*)((unsigned char*)target + lo * dt_size),
+               (void*)((unsigned char*)pWrk + (lo - base) * dt_size),
+               (hi - lo) * dt_size);
+
+        /* Allgather by recursive doubling in the reverse order */
+        for (i = nsteps - 1; (i >= 0) && (rc == OSHMEM_SUCCESS); i--) {
+            peer_id = my_id ^ (floor2_proc >> (i + 1));
+            peer_pe = oshmem_proc_pe(group->proc_array[peer_id]);
+
+            round++;
+            rc = _exchange_step(group,
+                                peer_pe,
+                                round - 1,
+                                (void*)((unsigned char*)target + lo * dt_size),
+                                (void*)((unsigned char*)target + lo * dt_size),
+                                (hi - lo) * dt_size,
+                                pSync);
+
+            lo = lo_level[i];
+            hi = hi_level[i];
+
+            pSync[0] = round;
+        }
+
+        /* Notify a peer from extra group */
+        if ((rc == OSHMEM_SUCCESS) && ((group->proc_count - floor2_proc) > my_id)) {
+            /* I am in basic group, my partner is node (my_id+y) in extra group */
+            peer_id = my_id + floor2_proc;
+            peer_pe = oshmem_proc_pe(group->proc_array[peer_id]);
+
+            SCOLL_VERBOSE(14,
+                          "[#%d] is extra send data to #%d",
+                          group->my_pe, peer_pe);
+            rc = MCA_SPML_CALL(put(oshmem_ctx_default, target, nlong, target, peer_pe));
+
+            MCA_SPML_CALL(fence(oshmem_ctx_default));
+
+            SCOLL_VERBOSE(14, "[#%d] signals to #%d", group->my_pe, peer_pe);
+            value = SHMEM_SYNC_RUN;
+            rc = MCA_SPML_CALL(put(oshmem_ctx_default, (void*)pSync, sizeof(value), (void*)&value, peer_pe));
+        }
+    }
+
+    SCOLL_VERBOSE(15, "[#%d] pSync[0] = %ld", group->my_pe, pSync[0]);
+
+    return rc;
+}
+
+/* Bounds of block 'index' when 'count' elements are split into 'nblocks' */
+static inline void _block_range(size_t count,
+                                int nblocks,
+                                int index,
+                                size_t *offset,
+                                size_t *len)
+{
+    size_t base = count / nblocks;
+    size_t rem = count % nblocks;
+
+    *offset = index * base + ((size_t) index < rem ? (size_t) index : rem);
+    *len = base + ((size_t) index < rem ? 1 : 0);
+}
+
+/*
+ The Ring algorithm.
+ The vector is processed in segments of reduce_segment_size bytes. Every
+ segment is split into NP blocks which travel around the ring twice: first
+ accumulating the reduction (reduce-scatter), then distributing the fully
+ reduced blocks (allgather). Data is delivered straight into the target
+ buffer of the right neighbour and the partial results of a segment are
+ accumulated in pWrk, so a segment never exceeds the nreduce/2 + 1 elements
+ pWrk is guaranteed to hold.
+ Outlay:
+ 2*(NP-1) nearest neighbour steps per segment, each PE sends and reduces
+ about 2*nlong*(NP-1)/NP bytes.
+ */
+static int _algorithm_ring(struct oshmem_group_t *group,
+                            struct oshmem_op_t *op,
+                            void *target,
+                            const void *source,
+                            size_t nlong,
+                            long *pSync,
+                            void *pWrk)
+{
+    int rc = OSHMEM_SUCCESS;
+    long step = 0;
+    int my_id = oshmem_proc_group_find_id(group, group->my_pe);
+    int proc_count = group->proc_count;
+    int peer_pe = 0;
+    int i = 0;
+    int block = 0;
+    size_t dt_size = op->dt_size;
+    size_t count = nlong / dt_size;
+    size_t seg_count = count / 2 + 1;
+    size_t seg_offset = 0;
+    size_t seg_len = 0;
+    size_t block_offset = 0;
+    size_t block_len = 0;
+    unsigned char *seg_target = NULL;
+
+    /* Every PE should own at least one element of a segment */
+    if ((NULL == pWrk) || (proc_count < 2) || (seg_count < (size_t) proc_count)) {
+        return _algorithm_recursive_doubling(group,
+                                              op,
+                                              target,
+                                              source,
+                                              nlong,
+                                              pSync,
+                                              pWrk);
+    }
+
+    if (mca_scoll_basic_param_reduce_segment_size &&
+            (mca_scoll_basic_param_reduce_segment_size / dt_size < seg_count)) {
+        seg_count = mca_scoll_basic_param_reduce_segment_size / dt_size;
+        if (seg_count < (size_t) proc_count) {
+            seg_count = proc_count;
+        }
+    }
+
+    peer_pe = oshmem_proc_pe(group->proc_array[(my_id + 1) % proc_count]);
+
+    SCOLL_VERBOSE(12, "[#%d] Reduce algorithm: Ring", group->my_pe);
+    SCOLL_VERBOSE(15,
+                  "[#%d] pSync[0] = %ld segment = %d elements",
+                  group->my_pe, pSync[0], (int)seg_count);
+
+    for (seg_offset = 0; (seg_offset < count) && (rc == OSHMEM_SUCCESS);
+            seg_offset += seg_len) {
+        seg_len = count - seg_offset;
+        if (seg_len > seg_count) {
+            seg_len = seg_count;
+        }
+        seg_target = (unsigned char*) target + seg_offset * dt_size;
+
+        /* The left neighbour may write into this segment as soon as
+         * pSync[0] announces the next step, so the source (which can be
+         * the same buffer as the target) is saved first.
+         */
+        memcpy(pWrk,
+               (void*)((unsigned char*) source + seg_offset * dt_size),
+               seg_len * dt_size);
+
+        /* Reduce-scatter: send the block accumulated in the previous step */
+        for (i = 0; (i < (proc_count - 1)) && (rc == OSHMEM_SUCCESS);
+                i++, step++) {
+            pSync[0] = step;
+
+            block = (my_id - i + proc_count) % proc_count;
+            _block_range(seg_len, proc_count, block, &block_offset, &block_len);
+            rc = _exchange_step(group,
+                                peer_pe,
+                                step,
+                                (void*)(seg_target + block_offset * dt_size),
+                                (void*)((unsigned char*)pWrk + block_offset * dt_size),
+                                block_len * dt_size,
+                                pSync);
+
+            /* Do reduction operation on the block from the left neighbour */
+            if (rc == OSHMEM_SUCCESS) {
+                block = (my_id - i - 1 + proc_count) % proc_count;
+                _block_range(seg_len, proc_count, block, &block_offset, &block_len);
+                op->o_func.c_fn((void*)(seg_target + block_offset * dt_size),
+                                (void*)((unsigned char*)pWrk + block_offset * dt_size),
+                                block_len);
+            }
+        }
+
+        /* This PE owns the fully reduced block (my_id + 1) now */
+        block = (my_id + 1) % proc_count;
+        _block_range(seg_len, proc_count, block, &block_offset, &block_len);
+        memcpy((void*)(seg_target + block_offset * dt_size),
+               (void*)((unsigned char*)pWrk + block_offset * dt_size),
+               block_len * dt_size);
+
+        /* Allgather: forward the block received in the previous step */
+        for (i = 0; (i < (proc_count - 1)) && (rc == OSHMEM_SUCCESS);
+                i++, step++) {
+            pSync[0] = step;
+
+            block = (my_id + 1 - i + proc_count) % proc_count;
+            _block_range(seg_len, proc_count, block, &block_offset, &block_len);
+            rc = _exchange_step(group,
+                                peer_pe,
+                                step,
+                                (void*)(seg_target + block_offset * dt_size),
+                                (void*)(seg_target + block_offset * dt_size),
+                                block_len * dt_size,
+                                pSync);
+        }
+    }
+
+    SCOLL_VERBOSE(15, "[#%d] pSync[0] = %ld", group->my_pe, pSync[0]);
+
+    return rc;
+}
@@ -106,12 +106,16 @@ typedef int
 #define SCOLL_ALG_COLLECT_TOURNAMENT            1
 #define SCOLL_ALG_COLLECT_RECURSIVE_DOUBLING    2
 #define SCOLL_ALG_COLLECT_RING                  3
+#define SCOLL_ALG_COLLECT_ADAPTIVE              4
 
 #define SCOLL_ALG_REDUCE_CENTRAL_COUNTER        0
 #define SCOLL_ALG_REDUCE_TOURNAMENT             1
 #define SCOLL_ALG_REDUCE_RECURSIVE_DOUBLING     2
 #define SCOLL_ALG_REDUCE_LEGACY_LINEAR          3   /* Based linear algorithm from OMPI coll:basic */
 #define SCOLL_ALG_REDUCE_LEGACY_LOG             4   /* Based log algorithm from OMPI coll:basic */
+#define SCOLL_ALG_REDUCE_RABENSEIFNER           5   /* Reduce-scatter (recursive halving) + allgather */
+#define SCOLL_ALG_REDUCE_RING                   6   /* Segmented ring reduce-scatter + allgather */
+#define SCOLL_ALG_REDUCE_ADAPTIVE               7
 
 typedef int (*mca_scoll_base_module_barrier_fn_t)(struct oshmem_group_t *group,
                                                   long *pSync,
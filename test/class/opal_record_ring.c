@@ -0,0 +1,161 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+#include <assert.h>
+
+#include "support.h"
+#include "opal/class/opal_ring_buffer.h"
+#include "opal/runtime/opal.h"
+#include "opal/constants.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define RING_SIZE 100
+#define ITERATIONS 1000000
+
+struct record_t {
+    uint64_t seq;
+    uint64_t check;
+};
+
+static volatile bool consumer_failed = false;
+
+static void *consumer (void *arg)
+{
+    opal_record_ring_t *ring = (opal_record_ring_t *) arg;
+    uint64_t expected = 0;
+
+    while (expected < ITERATIONS) {
+        struct record_t *rec;
+        size_t count;
+
+        rec = (struct record_t *) opal_record_ring_peek (ring, &count);
+        for (size_t i = 0 ; i < count ; ++i) {
+            if (rec[i].seq != expected || rec[i].check != ~expected) {
+                consumer_failed = true;
+            }
+            ++expected;
+        }
+        if (count > 0) {
+            opal_record_ring_release (ring, count);
+        } else {
+            sched_yield ();
+        }
+    }
+
+    return NULL;
+}
+
+int main (int argc, char *argv[])
+{
+    opal_record_ring_t ring;
+    struct record_t *rec;
+    pthread_t thread;
+    size_t count, total;
+    bool success;
+    int rc;
+
+    rc = opal_init_util (&argc, &argv);
+    test_verify_int(OPAL_SUCCESS, rc);
+    if (OPAL_SUCCESS != rc) {
+        test_finalize();
+        exit (1);
+    }
+
+    test_init("opal_record_ring_t");
+
+    OBJ_CONSTRUCT(&ring, opal_record_ring_t);
+    rc = opal_record_ring_init (&ring, sizeof (struct record_t), RING_SIZE);
+    test_verify_int(OPAL_SUCCESS, rc);
+    /* rounded up to a power of 2 */
+    test_verify_int(127, (int) ring.mask);
+
+    if (NULL == opal_record_ring_peek (&ring, &count) && 0 == count) {
+        test_success ();
+    } else {
+        test_failure (" opal_record_ring_peek on empty ring");
+    }
+
+    /* fill the ring, the last reserve has to fail */
+    for (total = 0 ; NULL != (rec = opal_record_ring_reserve (&ring)) ; ++total) {
+        rec->seq = total;
+        rec->check = ~total;
+        opal_record_ring_commit (&ring);
+    }
+    test_verify_int(128, (int) total);
+
+    /* release part of it and wrap around */
+    rec = (struct record_t *) opal_record_ring_peek (&ring, &count);
+    test_verify_int(128, (int) count);
+    opal_record_ring_release (&ring, 100);
+    for (int i = 0 ; i < 50 ; ++i, ++total) {
+        rec = opal_record_ring_reserve (&ring);
+        if (NULL == rec) {
+            break;
+        }
+        rec->seq = total;
+        rec->check = ~total;
+        opal_record_ring_commit (&ring);
+    }
+    test_verify_int(178, (int) total);
+
+    /* the records up to the end of the storage come first, then the
+       records at the start */
+    success = true;
+    for (uint64_t expected = 100 ; expected < total ; ) {
+        rec = (struct record_t *) opal_record_ring_peek (&ring, &count);
+        if (NULL == rec || 0 == count) {
+            success = false;
+            break;
+        }
+        for (size_t i = 0 ; i < count ; ++i, ++expected) {
+            if (rec[i].seq != expected || rec[i].check != ~expected) {
+                success = false;
+            }
+        }
+        opal_record_ring_release (&ring, count);
+    }
+    if (success && NULL == opal_record_ring_peek (&ring, &count)) {
+        test_success ();
+    } else {
+        test_failure (" opal_record_ring wrap around");
+    }
+
+    /* one producer and one consumer thread */
+    pthread_create (&thread, NULL, consumer, &ring);
+    for (uint64_t seq = 0 ; seq < ITERATIONS ; ) {
+        rec = opal_record_ring_reserve (&ring);
+        if (NULL == rec) {
+            sched_yield ();
+            continue;
+        }
+        rec->seq = seq;
+        rec->check = ~seq;
+        opal_record_ring_commit (&ring);
+        ++seq;
+    }
+    pthread_join (thread, NULL);
+
+    if (!consumer_failed) {
+        test_success ();
+    } else {
+        test_failure (" opal_record_ring producer/consumer threads");
+    }
+
+    OBJ_DESTRUCT(&ring);
+
+    opal_finalize_util ();
+
+    return test_finalize ();
+}
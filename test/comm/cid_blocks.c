@@ -0,0 +1,180 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Communicator IDs reserved in blocks per parent
+ * (mpi_comm_cid_block_size).
+ *
+ * The test creates communicators in patterns that draw from the blocks
+ * in different ways and checks every new communicator with an
+ * allreduce, which fails or hangs if the processes disagree on its ID:
+ *
+ *   mixed  MPI_Comm_dup, MPI_Comm_split and MPI_Comm_split_type of the
+ *          same parent, mixed with MPI_Comm_idup, which does not use the
+ *          blocks, and frees
+ *   flat   duplicates of MPI_COMM_WORLD until no ID is left
+ *   chain  every communicator duplicated from the previous one, so every
+ *          parent reserves a block, until no ID is left
+ *
+ * Running out of IDs must fail in the same creation on all processes,
+ * and the IDs must be available again once the communicators are freed.
+ * The chain must reach nearly as many communicators as the flat case.
+ *
+ * Usage: mpirun -np N cid_blocks [iterations [max_comms]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static int rank, errors = 0;
+
+static void check_comm(MPI_Comm comm, const char *what)
+{
+    int size, sum = 0, expected;
+
+    MPI_Comm_size(comm, &size);
+    expected = size * (size + 1) / 2;
+    MPI_Comm_rank(comm, &sum);
+    ++sum;
+    MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_INT, MPI_SUM, comm);
+    if (sum != expected) {
+        fprintf(stderr, "[%d] %s: allreduce returned %d instead of %d\n", rank, what, sum,
+                expected);
+        ++errors;
+    }
+}
+
+static void mixed(int iterations)
+{
+    MPI_Comm dup, split, shared, idup;
+    MPI_Comm *kept = malloc(iterations * sizeof(MPI_Comm));
+    MPI_Request req;
+    int num_kept = 0;
+
+    for (int i = 0 ; i < iterations ; ++i) {
+        MPI_Comm_dup(MPI_COMM_WORLD, &dup);
+        MPI_Comm_idup(MPI_COMM_WORLD, &idup, &req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        MPI_Comm_split(MPI_COMM_WORLD, rank % 2, rank, &split);
+        MPI_Comm_split_type(dup, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shared);
+
+        check_comm(dup, "dup");
+        check_comm(idup, "idup");
+        check_comm(split, "split");
+        check_comm(shared, "split_type");
+
+        /* keep some of them so that blocks of several parents are in use */
+        MPI_Comm_free(&idup);
+        MPI_Comm_free(&shared);
+        if (i % 3) {
+            MPI_Comm_free(&split);
+        } else {
+            kept[num_kept++] = split;
+        }
+        MPI_Comm_free(&dup);
+    }
+
+    for (int i = 0 ; i < num_kept ; ++i) {
+        MPI_Comm_free(kept + i);
+    }
+    free(kept);
+}
+
+/* create communicators until it fails, returns how many were created */
+static int exhaust(MPI_Comm *comms, int max_comms, int chain)
+{
+    int count = 0, min, max;
+
+    while (count < max_comms) {
+        MPI_Comm parent = (chain && count > 0) ? comms[count - 1] : MPI_COMM_WORLD;
+
+        if (MPI_SUCCESS != MPI_Comm_dup(parent, comms + count)) {
+            break;
+        }
+        MPI_Comm_set_errhandler(comms[count], MPI_ERRORS_RETURN);
+        ++count;
+    }
+
+    MPI_Allreduce(&count, &min, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce(&count, &max, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (min != max) {
+        fprintf(stderr, "[%d] %s: ran out of IDs after %d to %d communicators\n", rank,
+                chain ? "chain" : "flat", min, max);
+        ++errors;
+    }
+
+    if (count > 0) {
+        check_comm(comms[count - 1], chain ? "last of chain" : "last dup");
+    }
+
+    /* free the children before their parents */
+    for (int i = count - 1 ; i >= 0 ; --i) {
+        MPI_Comm_free(comms + i);
+    }
+
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 1000, max_comms = 100000, flat, chain, total;
+    MPI_Comm *comms;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_set_errhandler(MPI_COMM_WORLD, MPI_ERRORS_RETURN);
+
+    if (argc > 1) {
+        iterations = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        max_comms = atoi(argv[2]);
+    }
+    if (iterations < 0 || max_comms < 1) {
+        if (0 == rank) {
+            fprintf(stderr, "usage: %s [iterations [max_comms]]\n", argv[0]);
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    comms = malloc(max_comms * sizeof(MPI_Comm));
+    if (NULL == comms) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    mixed(iterations);
+
+    flat = exhaust(comms, max_comms, 0);
+    chain = exhaust(comms, max_comms, 1);
+    /* the IDs of the chain must have been released */
+    if (flat != exhaust(comms, max_comms, 0)) {
+        if (0 == rank) {
+            fprintf(stderr, "IDs not released after the chain\n");
+        }
+        ++errors;
+    }
+    /* a parent of the chain may only hold a few unused IDs */
+    if (chain < flat - flat / 10) {
+        if (0 == rank) {
+            fprintf(stderr, "chain of %d communicators, %d with a single parent\n", chain, flat);
+        }
+        ++errors;
+    }
+
+    MPI_Allreduce(&errors, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("cid_blocks: %d flat, %d chained communicators: %s\n", flat, chain,
+               total ? "FAILED" : "OK");
+    }
+
+    free(comms);
+    MPI_Finalize();
+    return total ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Measure the memory footprint and the rank translation cost of MPI groups
+ * built from MPI_COMM_WORLD with different rank patterns:
+ *
+ *   contiguous: a block of consecutive ranks (strided, stride 1)
+ *   strided:    every other rank (strided)
+ *   blocks:     short runs of consecutive ranks (sporadic)
+ *   random:     a random ascending subset of half the ranks (bitmap)
+ *
+ * Run the same job with --mca mpi_use_sparse_group_storage 0 and 1 to
+ * compare against a dense list of process pointers, and adjust
+ * mpi_sparse_group_min_size to move the threshold.
+ *
+ * Usage: mpirun -np N group_footprint [groups_per_pattern [translations]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define NUM_PATTERNS 4
+
+static const char *pattern_names[NUM_PATTERNS] = {"contiguous", "strided", "blocks", "random"};
+
+/* resident set size in bytes, 0 if unknown */
+static long resident_bytes(void)
+{
+    long pages = 0, resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+
+    if (NULL == fp) {
+        return 0;
+    }
+    if (2 != fscanf(fp, "%ld %ld", &pages, &resident)) {
+        resident = 0;
+    }
+    fclose(fp);
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+static int build_ranks(int pattern, int size, int seed, int *ranks)
+{
+    int n = 0;
+
+    switch (pattern) {
+    case 0:
+        for (int i = 0 ; i < size - (seed % 2) ; ++i) {
+            ranks[n++] = i + (seed % 2);
+        }
+        break;
+    case 1:
+        for (int i = seed % 2 ; i < size ; i += 2) {
+            ranks[n++] = i;
+        }
+        break;
+    case 2:
+        for (int i = 0 ; i < size ; ++i) {
+            if ((i / 4) % 2 == seed % 2) {
+                ranks[n++] = i;
+            }
+        }
+        break;
+    default:
+        srand(seed);
+        for (int i = 0 ; i < size ; ++i) {
+            if (rand() % 2) {
+                ranks[n++] = i;
+            }
+        }
+        break;
+    }
+
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    int rank, size, ngroups = 256, ntranslations = 100, *ranks, *in_ranks, *out_ranks;
+    MPI_Group world_group, *groups;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1) {
+        ngroups = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        ntranslations = atoi(argv[2]);
+    }
+    if (ngroups < 1 || ntranslations < 1) {
+        fprintf(stderr, "usage: %s [groups_per_pattern [translations]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    ranks = (int *) malloc(size * sizeof(int));
+    in_ranks = (int *) malloc(size * sizeof(int));
+    out_ranks = (int *) malloc(size * sizeof(int));
+    groups = (MPI_Group *) malloc(ngroups * sizeof(MPI_Group));
+    if (NULL == ranks || NULL == in_ranks || NULL == out_ranks || NULL == groups) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+
+    if (0 == rank) {
+        printf("%d processes, %d groups per pattern\n", size, ngroups);
+        printf("%-12s %10s %14s %16s %16s\n", "pattern", "members", "bytes/group",
+               "to world (ns)", "from world (ns)");
+    }
+
+    for (int pattern = 0 ; pattern < NUM_PATTERNS ; ++pattern) {
+        double to_world = 0.0, from_world = 0.0, start;
+        long rss_before, rss_after, max_delta;
+        int n = 0, group_size;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        rss_before = resident_bytes();
+
+        for (int i = 0 ; i < ngroups ; ++i) {
+            n = build_ranks(pattern, size, i, ranks);
+            MPI_Group_incl(world_group, n, ranks, groups + i);
+        }
+
+        rss_after = resident_bytes();
+
+        MPI_Group_size(groups[0], &group_size);
+        for (int i = 0 ; i < group_size ; ++i) {
+            in_ranks[i] = i;
+        }
+
+        /* group -> MPI_COMM_WORLD */
+        start = MPI_Wtime();
+        for (int iter = 0 ; iter < ntranslations ; ++iter) {
+            MPI_Group_translate_ranks(groups[0], group_size, in_ranks, world_group, out_ranks);
+        }
+        to_world = (MPI_Wtime() - start) * 1.0e9 / ((double) ntranslations * group_size);
+
+        /* MPI_COMM_WORLD -> group */
+        for (int i = 0 ; i < size ; ++i) {
+            in_ranks[i] = i;
+        }
+        start = MPI_Wtime();
+        for (int iter = 0 ; iter < ntranslations ; ++iter) {
+            MPI_Group_translate_ranks(world_group, size, in_ranks, groups[0], out_ranks);
+        }
+        from_world = (MPI_Wtime() - start) * 1.0e9 / ((double) ntranslations * size);
+
+        for (int i = 0 ; i < ngroups ; ++i) {
+            MPI_Group_free(groups + i);
+        }
+
+        max_delta = rss_after - rss_before;
+        MPI_Allreduce(MPI_IN_PLACE, &max_delta, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+            printf("%-12s %10d %14.1f %16.2f %16.2f\n", pattern_names[pattern], group_size,
+                   (double) max_delta / ngroups, to_world, from_world);
+        }
+    }
+
+    MPI_Group_free(&world_group);
+    free(groups);
+    free(out_ranks);
+    free(in_ranks);
+    free(ranks);
+
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
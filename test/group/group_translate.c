@@ -0,0 +1,320 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Check the rank translation of the strided, sporadic and bitmap group
+ * storage formats.
+ *
+ * A dense parent group of parent_size members is built from sentinel
+ * process pointers, so that large groups can be tested in a single
+ * process. Groups are created from it in every format with rank
+ * patterns the format supports (contiguous, strided, runs of
+ * consecutive ranks, random ascending subsets, and descending and
+ * shuffled runs for the sporadic format). For every group the test
+ * compares with the ranks it was created from:
+ *
+ *   - the child to parent translation (ompi_group_sparse_rank_to_parent
+ *     and ompi_group_translate_ranks)
+ *   - the parent to child translation of every parent rank
+ *   - the process pointer of every member
+ *   - the rank of the local process
+ *   - a group included from the sparse group, which refers to the
+ *     dense parent directly
+ *
+ * Usage: group_translate [parent_size [trials]]
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "ompi/group/group.h"
+#include "ompi/proc/proc.h"
+
+enum {
+    FORMAT_STRIDED,
+    FORMAT_SPORADIC,
+    FORMAT_BITMAP,
+    NUM_FORMATS
+};
+
+static const char *format_names[NUM_FORMATS] = {"strided", "sporadic", "bitmap"};
+
+enum {
+    PATTERN_CONTIGUOUS,
+    PATTERN_STRIDED,
+    PATTERN_RUNS,
+    PATTERN_ASCENDING,
+    PATTERN_DESCENDING,
+    PATTERN_SHUFFLED,
+    NUM_PATTERNS
+};
+
+static const char *pattern_names[NUM_PATTERNS] = {"contiguous", "strided", "runs", "ascending",
+                                                  "descending", "shuffled"};
+
+/* patterns each format can store: strided groups need a constant
+ * stride, bitmap groups keep the ranks in ascending order */
+static const int format_patterns[NUM_FORMATS] = {
+    (1 << PATTERN_CONTIGUOUS) | (1 << PATTERN_STRIDED),
+    (1 << NUM_PATTERNS) - 1,
+    (1 << PATTERN_CONTIGUOUS) | (1 << PATTERN_STRIDED) | (1 << PATTERN_RUNS) | (1 << PATTERN_ASCENDING),
+};
+
+static int errors = 0;
+
+static void check(bool cond, const char *format, const char *pattern, const char *what, int rank)
+{
+    if (!cond && errors < 20) {
+        fprintf(stderr, "group_translate: %s group, %s pattern: %s (rank %d)\n", format, pattern,
+                what, rank);
+    }
+    errors += !cond;
+}
+
+static ompi_group_t *parent_create(int size)
+{
+    ompi_group_t *parent = ompi_group_allocate(size);
+    opal_process_name_t name = *OMPI_PROC_MY_NAME;
+
+    if (NULL == parent) {
+        return NULL;
+    }
+
+    /* no process behind them: the pointers only have to be unique. the
+     * vpids are beyond the job so the sentinels are never replaced. */
+    for (int i = 0 ; i < size ; ++i) {
+        name.vpid = (1 << 24) + i;
+        parent->grp_proc_pointers[i] = (ompi_proc_t *) ompi_proc_name_to_sentinel(name);
+    }
+    parent->grp_my_rank = 0;
+
+    return parent;
+}
+
+static int create(int format, ompi_group_t *parent, int n, const int *ranks, ompi_group_t **group)
+{
+    switch (format) {
+    case FORMAT_STRIDED:
+        return ompi_group_incl_strided(parent, n, ranks, group);
+    case FORMAT_SPORADIC:
+        return ompi_group_incl_spor(parent, n, ranks, group);
+    default:
+        return ompi_group_incl_bmap(parent, n, ranks, group);
+    }
+}
+
+static bool has_format(int format, ompi_group_t *group)
+{
+    switch (format) {
+    case FORMAT_STRIDED:
+        return OMPI_GROUP_IS_STRIDED(group);
+    case FORMAT_SPORADIC:
+        return OMPI_GROUP_IS_SPORADIC(group);
+    default:
+        return OMPI_GROUP_IS_BITMAP(group);
+    }
+}
+
+static void check_group(int format, const char *pattern, ompi_group_t *parent, int n,
+                        const int *ranks, int *scratch, int *out, int *child_of)
+{
+    const char *fname = format_names[format];
+    int psize = parent->grp_proc_count, m = 0;
+    ompi_group_t *group, *sub;
+
+    if (OMPI_SUCCESS != create(format, parent, n, ranks, &group)) {
+        check(false, fname, pattern, "creation failed", 0);
+        return;
+    }
+
+    check(has_format(format, group), fname, pattern, "wrong storage format", 0);
+    check(group->grp_proc_count == n, fname, pattern, "wrong size", n);
+
+    for (int i = 0 ; i < psize ; ++i) {
+        child_of[i] = MPI_UNDEFINED;
+    }
+    for (int i = 0 ; i < n ; ++i) {
+        child_of[ranks[i]] = i;
+    }
+    check(group->grp_my_rank == child_of[0], fname, pattern, "wrong local rank",
+          group->grp_my_rank);
+
+    /* child to parent */
+    for (int i = 0 ; i < n ; ++i) {
+        check(ompi_group_sparse_rank_to_parent(group, i) == ranks[i], fname, pattern,
+              "wrong parent rank", i);
+        check(ompi_group_get_proc_ptr_raw(group, i) == parent->grp_proc_pointers[ranks[i]],
+              fname, pattern, "wrong process", i);
+        scratch[i] = i;
+    }
+    ompi_group_translate_ranks(group, n, scratch, parent, out);
+    for (int i = 0 ; i < n ; ++i) {
+        check(out[i] == ranks[i], fname, pattern, "wrong translation to the parent", i);
+    }
+
+    /* parent to child */
+    for (int i = 0 ; i < psize ; ++i) {
+        scratch[i] = i;
+    }
+    ompi_group_translate_ranks(parent, psize, scratch, group, out);
+    for (int i = 0 ; i < psize ; ++i) {
+        check(out[i] == child_of[i], fname, pattern, "wrong translation from the parent", i);
+    }
+    scratch[0] = MPI_PROC_NULL;
+    ompi_group_translate_ranks(parent, 1, scratch, group, out);
+    check(MPI_PROC_NULL == out[0], fname, pattern, "MPI_PROC_NULL not preserved", 0);
+
+    /* every third member, in reverse order */
+    for (int i = n - 1 ; i >= 0 ; i -= 3) {
+        scratch[m++] = i;
+    }
+    if (OMPI_SUCCESS != ompi_group_incl(group, m, scratch, &sub)) {
+        check(false, fname, pattern, "inclusion failed", 0);
+    } else {
+        check(OMPI_GROUP_IS_DENSE(sub) || sub->grp_parent_group_ptr == parent, fname, pattern,
+              "included group does not refer to the dense parent", 0);
+        for (int j = 0 ; j < m ; ++j) {
+            check(ompi_group_get_proc_ptr_raw(sub, j) ==
+                  parent->grp_proc_pointers[ranks[scratch[j]]], fname, pattern,
+                  "wrong process in the included group", j);
+        }
+        OBJ_RELEASE(sub);
+    }
+
+    OBJ_RELEASE(group);
+}
+
+static int pick(int *ranks, int psize, int pattern)
+{
+    int n = 0, stride, offset, len, gap;
+
+    switch (pattern) {
+    case PATTERN_CONTIGUOUS:
+        offset = rand() % (psize / 2);
+        n = 1 + rand() % (psize - offset);
+        for (int i = 0 ; i < n ; ++i) {
+            ranks[i] = offset + i;
+        }
+        break;
+    case PATTERN_STRIDED:
+        stride = 2 + rand() % 17;
+        offset = rand() % stride;
+        for (int r = offset ; r < psize ; r += stride) {
+            ranks[n++] = r;
+        }
+        break;
+    case PATTERN_RUNS:
+        len = 1 + rand() % 40;
+        gap = 1 + rand() % 40;
+        for (int r = rand() % gap ; r < psize ; r += gap) {
+            for (int i = 0 ; i < len && r < psize ; ++i) {
+                ranks[n++] = r++;
+            }
+        }
+        break;
+    case PATTERN_ASCENDING:
+        for (int r = 0 ; r < psize ; ++r) {
+            if (rand() % 3) {
+                ranks[n++] = r;
+            }
+        }
+        break;
+    case PATTERN_DESCENDING:
+        for (int r = psize - 1 - rand() % 7 ; r >= 0 ; r -= 1 + (rand() % 4 ? 0 : 3)) {
+            ranks[n++] = r;
+        }
+        break;
+    default:
+        /* runs of len ranks in random order */
+        len = 1 + rand() % 40;
+        for (int r = 0 ; r < psize ; ++r) {
+            ranks[n++] = r;
+        }
+        for (int b = n / len - 1 ; b > 0 ; --b) {
+            int other = rand() % (b + 1);
+            for (int i = 0 ; i < len ; ++i) {
+                int tmp = ranks[b * len + i];
+                ranks[b * len + i] = ranks[other * len + i];
+                ranks[other * len + i] = tmp;
+            }
+        }
+        break;
+    }
+
+    return n;
+}
+
+int main(int argc, char *argv[])
+{
+    int rank, psize = 5000, trials = 50, *ranks, *scratch, *out, *child_of, total;
+    ompi_group_t *parent;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    if (argc > 1) {
+        psize = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        trials = atoi(argv[2]);
+    }
+    if (psize < 2 || trials < 1) {
+        fprintf(stderr, "usage: %s [parent_size [trials]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+#if !OMPI_GROUP_SPARSE
+    fprintf(stderr, "group_translate: sparse groups are disabled, skipped\n");
+    MPI_Finalize();
+    return 77;
+#endif
+
+    parent = parent_create(psize);
+    ranks = malloc(psize * sizeof(int));
+    scratch = malloc(psize * sizeof(int));
+    out = malloc(psize * sizeof(int));
+    child_of = malloc(psize * sizeof(int));
+    if (NULL == parent || NULL == ranks || NULL == scratch || NULL == out || NULL == child_of) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    srand(1);
+    for (int t = 0 ; t < trials ; ++t) {
+        for (int f = 0 ; f < NUM_FORMATS ; ++f) {
+            for (int p = 0 ; p < NUM_PATTERNS ; ++p) {
+                int n;
+
+                if (!(format_patterns[f] & (1 << p))) {
+                    continue;
+                }
+                n = pick(ranks, psize, p);
+                if (n > 0) {
+                    check_group(f, pattern_names[p], parent, n, ranks, scratch, out, child_of);
+                }
+            }
+        }
+    }
+
+    OBJ_RELEASE(parent);
+    free(ranks);
+    free(scratch);
+    free(out);
+    free(child_of);
+
+    MPI_Allreduce(&errors, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("group_translate: %s (%d errors)\n", total ? "FAILED" : "passed", total);
+    }
+
+    MPI_Finalize();
+    return total ? 1 : 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Data written with the ompio_compress info key must read back as
+ * written.
+ *
+ * Every process owns num_records records of record_size bytes,
+ * interleaved with the records of the other processes. The file is
+ * created with a small collective buffer, so that it consists of many
+ * compressed blocks, and goes through the following steps:
+ *
+ *   1. all records but one in the middle (a hole) are written with
+ *      MPI_File_write_at_all
+ *   2. every process reads its own records before any sync
+ *   3. the middle half of the odd records is overwritten with
+ *      MPI_File_write_at and read back before any sync
+ *   4. after sync, barrier, sync every process reads the records of the
+ *      next process with MPI_File_read_at_all, and the size is checked
+ *   5. the file is closed, reopened, the even records are overwritten
+ *      with MPI_File_write_at_all and the file is closed again
+ *   6. the file is reopened read-only and checked as in 4.
+ *
+ * The hole must read as zeros. Rank 0 finally prints the size of the
+ * file on disk, opened without compression, against the logical size.
+ *
+ * Usage: mpirun -np N compress_roundtrip [path [record_size [num_records]]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int rank, size, errors = 0;
+static long record_size = 100000, num_records = 40;
+
+/* runs of equal bytes, so that the data compresses */
+static char record_byte(int owner, long r, long i, int version)
+{
+    return (char) ((owner * 7 + r * 3 + version * 11 + i / 64) & 0x7f);
+}
+
+/* content of byte i of record r of owner after the given step */
+static char expected(int owner, long r, long i, int step)
+{
+    if (num_records / 2 == r) {
+        return 0;
+    }
+    if (step >= 5 && 0 == r % 2) {
+        return record_byte(owner, r, i, 2);
+    }
+    if (step >= 3 && 1 == r % 2 && i >= record_size / 4 && i < 3 * record_size / 4) {
+        return record_byte(owner, r, i, 1);
+    }
+    return record_byte(owner, r, i, 0);
+}
+
+static MPI_Offset record_offset(int owner, long r)
+{
+    return ((MPI_Offset) r * size + owner) * record_size;
+}
+
+static MPI_File open_file(const char *path, int amode, const char *compress)
+{
+    MPI_File fh;
+    MPI_Info info;
+
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "ompio_compress", compress);
+    MPI_Info_set(info, "cb_buffer_size", "262144");
+    if (MPI_SUCCESS != MPI_File_open(MPI_COMM_WORLD, path, amode, info, &fh)) {
+        fprintf(stderr, "[%d] cannot open %s\n", rank, path);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Info_free(&info);
+
+    return fh;
+}
+
+static void check_records(MPI_File fh, int owner, int step, int collective, char *record)
+{
+    MPI_Status status;
+    int count, failed = 0;
+
+    for (long r = 0 ; r < num_records ; ++r) {
+        memset(record, 0x55, record_size);
+        if (collective) {
+            MPI_File_read_at_all(fh, record_offset(owner, r), record, (int) record_size, MPI_BYTE,
+                                 &status);
+        } else {
+            MPI_File_read_at(fh, record_offset(owner, r), record, (int) record_size, MPI_BYTE,
+                             &status);
+        }
+        MPI_Get_count(&status, MPI_BYTE, &count);
+        if (count != record_size) {
+            fprintf(stderr, "[%d] step %d: read %d bytes of record %ld of rank %d\n", rank, step,
+                    count, r, owner);
+            ++failed;
+            continue;
+        }
+        for (long i = 0 ; i < record_size ; ++i) {
+            if (record[i] != expected(owner, r, i, step)) {
+                fprintf(stderr, "[%d] step %d: mismatch at byte %ld of record %ld of rank %d\n",
+                        rank, step, i, r, owner);
+                ++failed;
+                break;
+            }
+        }
+    }
+
+    errors += failed;
+}
+
+static void check_size(MPI_File fh, int step)
+{
+    MPI_Offset fsize;
+
+    MPI_File_get_size(fh, &fsize);
+    if (fsize != (MPI_Offset) num_records * size * record_size) {
+        fprintf(stderr, "[%d] step %d: size %lld instead of %lld\n", rank, step,
+                (long long) fsize, (long long) num_records * size * record_size);
+        ++errors;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "compress_roundtrip.out";
+    int next, total;
+    long quarter;
+    char *record;
+    MPI_File fh;
+    MPI_Offset disk_size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    next = (rank + 1) % size;
+
+    if (argc > 1) {
+        path = argv[1];
+    }
+    if (argc > 2) {
+        record_size = atol(argv[2]);
+    }
+    if (argc > 3) {
+        num_records = atol(argv[3]);
+    }
+    if (record_size < 4 || record_size > 1024L * 1024 * 1024 || num_records < 3) {
+        fprintf(stderr, "usage: %s [path [record_size [num_records]]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    record = (char *) malloc(record_size);
+    if (NULL == record) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    quarter = record_size / 4;
+
+    if (0 == rank) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    /* 1. */
+    fh = open_file(path, MPI_MODE_CREATE | MPI_MODE_RDWR, "true");
+    for (long r = 0 ; r < num_records ; ++r) {
+        int count = (num_records / 2 == r) ? 0 : (int) record_size;
+
+        for (long i = 0 ; i < count ; ++i) {
+            record[i] = record_byte(rank, r, i, 0);
+        }
+        MPI_File_write_at_all(fh, record_offset(rank, r), record, count, MPI_BYTE,
+                              MPI_STATUS_IGNORE);
+    }
+
+    /* 2. */
+    check_records(fh, rank, 2, 0, record);
+
+    /* 3. */
+    for (long r = 1 ; r < num_records ; r += 2) {
+        for (long i = quarter ; i < 3 * quarter ; ++i) {
+            record[i] = record_byte(rank, r, i, 1);
+        }
+        if (num_records / 2 != r) {
+            MPI_File_write_at(fh, record_offset(rank, r) + quarter, record + quarter,
+                              (int) (2 * quarter), MPI_BYTE, MPI_STATUS_IGNORE);
+        }
+    }
+    check_records(fh, rank, 3, 0, record);
+
+    /* 4. */
+    MPI_File_sync(fh);
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_File_sync(fh);
+    check_records(fh, next, 4, 1, record);
+    check_size(fh, 4);
+    MPI_File_close(&fh);
+
+    /* 5. */
+    fh = open_file(path, MPI_MODE_RDWR, "true");
+    check_records(fh, next, 4, 1, record);
+    for (long r = 0 ; r < num_records ; r += 2) {
+        int count = (num_records / 2 == r) ? 0 : (int) record_size;
+
+        for (long i = 0 ; i < count ; ++i) {
+            record[i] = record_byte(rank, r, i, 2);
+        }
+        MPI_File_write_at_all(fh, record_offset(rank, r), record, count, MPI_BYTE,
+                              MPI_STATUS_IGNORE);
+    }
+    MPI_File_close(&fh);
+
+    /* 6. */
+    fh = open_file(path, MPI_MODE_RDONLY, "true");
+    check_records(fh, next, 6, 1, record);
+    check_size(fh, 6);
+    MPI_File_close(&fh);
+
+    fh = open_file(path, MPI_MODE_RDONLY, "false");
+    MPI_File_get_size(fh, &disk_size);
+    MPI_File_close(&fh);
+
+    MPI_Allreduce(&errors, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("compress_roundtrip: %lld bytes, %lld on disk: %s\n",
+               (long long) num_records * size * record_size, (long long) disk_size,
+               total ? "FAILED" : "OK");
+    }
+
+    free(record);
+    MPI_Finalize();
+    return total ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Files growing under the mmap fbtl (ompio_mmap info key).
+ *
+ * Every process appends num_records records of record_size bytes to its
+ * own file with MPI_File_write, and reads back an earlier record every
+ * few records, so that the file is mapped while it grows. The time of
+ * every quarter of the appends is measured: it must not grow with the
+ * size of the file, a last quarter more than ten times slower than the
+ * first one is reported as a failure. Every record is then partly
+ * overwritten through the mapping, and the whole file is checked.
+ *
+ * Then all processes write interleaved records of a shared file with
+ * MPI_File_write_at, which grows the file behind the mappings of the
+ * other processes, and after sync, barrier, sync every process checks
+ * the records of the next one.
+ *
+ * Usage: mpirun -np N mmap_append [path [record_size [num_records]]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int rank, size, errors = 0;
+
+static char record_byte(int owner, long r, long i, int version)
+{
+    return (char) ((owner * 31 + r * 7 + i + version * 13) & 0x7f);
+}
+
+static MPI_File open_file(MPI_Comm comm, const char *path)
+{
+    MPI_File fh;
+    MPI_Info info;
+
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "ompio_mmap", "true");
+    if (MPI_SUCCESS != MPI_File_open(comm, path, MPI_MODE_CREATE | MPI_MODE_RDWR, info, &fh)) {
+        fprintf(stderr, "[%d] cannot open %s\n", rank, path);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Info_free(&info);
+
+    return fh;
+}
+
+static void check_record(MPI_File fh, MPI_Offset offset, char *record, long record_size,
+                         int owner, long r, int version, const char *what)
+{
+    MPI_Status status;
+    int count;
+
+    memset(record, 0, record_size);
+    MPI_File_read_at(fh, offset, record, (int) record_size, MPI_BYTE, &status);
+    MPI_Get_count(&status, MPI_BYTE, &count);
+    for (long i = 0 ; i < record_size ; ++i) {
+        /* the first 8 bytes of version 1 records have been overwritten */
+        int v = (version && i < 8) ? 1 : 0;
+
+        if (count != record_size || record[i] != record_byte(owner, r, i, v)) {
+            fprintf(stderr, "[%d] %s: record %ld of rank %d differs (%d bytes read)\n", rank,
+                    what, r, owner, count);
+            ++errors;
+            return;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "mmap_append.out";
+    char own[1024], *record;
+    long record_size = 1000, num_records = 100000, quarter;
+    double times[4], start;
+    int next, total;
+    MPI_File fh;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    next = (rank + 1) % size;
+
+    if (argc > 1) {
+        path = argv[1];
+    }
+    if (argc > 2) {
+        record_size = atol(argv[2]);
+    }
+    if (argc > 3) {
+        num_records = atol(argv[3]);
+    }
+    if (record_size < 8 || record_size > 1024L * 1024 * 1024 || num_records < 4) {
+        fprintf(stderr, "usage: %s [path [record_size [num_records]]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    quarter = num_records / 4;
+
+    record = (char *) malloc(record_size);
+    if (NULL == record) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    /* appends to a file of this process */
+    snprintf(own, sizeof(own), "%s.%d", path, rank);
+    MPI_File_delete(own, MPI_INFO_NULL);
+    fh = open_file(MPI_COMM_SELF, own);
+    for (int q = 0 ; q < 4 ; ++q) {
+        start = MPI_Wtime();
+        for (long r = q * quarter ; r < (q + 1) * quarter ; ++r) {
+            for (long i = 0 ; i < record_size ; ++i) {
+                record[i] = record_byte(rank, r, i, 0);
+            }
+            MPI_File_write(fh, record, (int) record_size, MPI_BYTE, MPI_STATUS_IGNORE);
+            if (0 == r % 16) {
+                check_record(fh, (r / 2) * record_size, record, record_size, rank, r / 2, 0,
+                             "append");
+            }
+        }
+        times[q] = MPI_Wtime() - start;
+    }
+    if (times[3] > 10.0 * times[0]) {
+        fprintf(stderr, "[%d] append: last quarter took %.3f s, first one %.3f s\n", rank,
+                times[3], times[0]);
+        ++errors;
+    }
+
+    for (long r = 0 ; r < 4 * quarter ; ++r) {
+        for (long i = 0 ; i < 8 ; ++i) {
+            record[i] = record_byte(rank, r, i, 1);
+        }
+        MPI_File_write_at(fh, r * record_size, record, 8, MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    for (long r = 0 ; r < 4 * quarter ; ++r) {
+        check_record(fh, r * record_size, record, record_size, rank, r, 1, "overwrite");
+    }
+    MPI_File_close(&fh);
+    MPI_File_delete(own, MPI_INFO_NULL);
+
+    /* a shared file growing behind the mappings of the other processes */
+    if (0 == rank) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    fh = open_file(MPI_COMM_WORLD, path);
+    for (long r = 0 ; r < quarter ; ++r) {
+        for (long i = 0 ; i < record_size ; ++i) {
+            record[i] = record_byte(rank, r, i, 0);
+        }
+        MPI_File_write_at(fh, (r * size + rank) * record_size, record, (int) record_size,
+                          MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+    MPI_File_sync(fh);
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_File_sync(fh);
+    for (long r = 0 ; r < quarter ; ++r) {
+        check_record(fh, (r * size + next) * record_size, record, record_size, next, r, 0,
+                     "shared");
+    }
+    MPI_File_close(&fh);
+
+    MPI_Allreduce(&errors, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("mmap_append: quarters of the appends %.3f %.3f %.3f %.3f s: %s\n", times[0],
+               times[1], times[2], times[3], total ? "FAILED" : "OK");
+    }
+
+    free(record);
+    MPI_Finalize();
+    return total ? 1 : 0;
+}
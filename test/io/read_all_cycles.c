@@ -0,0 +1,145 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Collective reads that need many cycles of the fcoll components.
+ *
+ * The file is made of blocks of block_size bytes that are distributed
+ * round robin over the processes with a file view, so that every cycle
+ * of an aggregator holds data of all the processes. It is written with
+ * MPI_File_write_all and read back with MPI_File_read_all, and every
+ * process checks the data it got.
+ *
+ * Unless set otherwise in the environment, the buffer of an aggregator
+ * is set to 64 KB so that a few megabytes of data need many cycles, and
+ * the vulcan and dynamic_gen2 components read ahead with asynchronous
+ * reads (fcoll_<component>_async_io = 1). Run it with
+ * --mca fcoll_vulcan_pipeline_depth <n> to use more stages, or with
+ * --mca fcoll_vulcan_async_io 2 to compare with synchronous reads.
+ *
+ * Usage: mpirun -np N read_all_cycles [path [block_size [num_blocks]]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char file_byte(MPI_Offset offset)
+{
+    return (char) (offset % 251);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "read_all_cycles.out";
+    int rank, size, block_size = 1000, num_blocks = 1000, errors = 0, ret;
+    MPI_Datatype filetype;
+    MPI_Status status;
+    MPI_File fh;
+    char *buf;
+    double start, elapsed;
+    int count;
+
+    setenv("OMPI_MCA_io_ompio_bytes_per_agg", "65536", 0);
+    setenv("OMPI_MCA_fcoll_vulcan_async_io", "1", 0);
+    setenv("OMPI_MCA_fcoll_dynamic_gen2_async_io", "1", 0);
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1) {
+        path = argv[1];
+    }
+    if (argc > 2) {
+        block_size = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        num_blocks = atoi(argv[3]);
+    }
+    if (block_size < 1 || num_blocks < 1) {
+        fprintf(stderr, "usage: %s [path [block_size [num_blocks]]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    buf = malloc((size_t) block_size * num_blocks);
+    if (NULL == buf) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    /* block b of this process is at file offset ((b * size) + rank) * block_size */
+    MPI_Type_vector(num_blocks, block_size, block_size * size, MPI_BYTE, &filetype);
+    MPI_Type_commit(&filetype);
+
+    for (int b = 0 ; b < num_blocks ; ++b) {
+        MPI_Offset offset = ((MPI_Offset) b * size + rank) * block_size;
+        for (int i = 0 ; i < block_size ; ++i) {
+            buf[(size_t) b * block_size + i] = file_byte(offset + i);
+        }
+    }
+
+    if (0 == rank) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    MPI_File_set_view(fh, (MPI_Offset) rank * block_size, MPI_BYTE, filetype, "native", MPI_INFO_NULL);
+    ret = MPI_File_write_all(fh, buf, block_size * num_blocks, MPI_BYTE, MPI_STATUS_IGNORE);
+    if (MPI_SUCCESS != ret) {
+        fprintf(stderr, "[%d] MPI_File_write_all failed\n", rank);
+        errors++;
+    }
+    MPI_File_close(&fh);
+
+    memset(buf, 0, (size_t) block_size * num_blocks);
+
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+    MPI_File_set_view(fh, (MPI_Offset) rank * block_size, MPI_BYTE, filetype, "native", MPI_INFO_NULL);
+    MPI_Barrier(MPI_COMM_WORLD);
+    start = MPI_Wtime();
+    ret = MPI_File_read_all(fh, buf, block_size * num_blocks, MPI_BYTE, &status);
+    elapsed = MPI_Wtime() - start;
+    if (MPI_SUCCESS != ret) {
+        fprintf(stderr, "[%d] MPI_File_read_all failed\n", rank);
+        errors++;
+    }
+    MPI_Get_count(&status, MPI_BYTE, &count);
+    if (count != block_size * num_blocks) {
+        fprintf(stderr, "[%d] read %d bytes instead of %d\n", rank, count, block_size * num_blocks);
+        errors++;
+    }
+    MPI_File_close(&fh);
+
+    for (int b = 0 ; b < num_blocks && 0 == errors ; ++b) {
+        MPI_Offset offset = ((MPI_Offset) b * size + rank) * block_size;
+        for (int i = 0 ; i < block_size ; ++i) {
+            if (buf[(size_t) b * block_size + i] != file_byte(offset + i)) {
+                fprintf(stderr, "[%d] wrong data at offset %lld\n", rank, (long long) (offset + i));
+                errors++;
+                break;
+            }
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("read %lld bytes in %.3f s: %s\n",
+               (long long) block_size * num_blocks * size, elapsed, errors ? "FAILED" : "OK");
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+
+    MPI_Type_free(&filetype);
+    free(buf);
+
+    MPI_Finalize();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Sequential reads through the ompio read cache with read-ahead.
+ *
+ * Every process writes its own region of a file, then reopens it with
+ * the ompio_read_cache_size info key set and reads the region back in
+ * small records, so that the cache detects the sequential pattern and
+ * keeps read-ahead requests in flight. Every sync_interval records both
+ * that file and a second, unrelated file are synced: MPI_File_sync must
+ * succeed while read-ahead is pending, and the data read after the
+ * cache has been dropped by the sync must still be correct.
+ *
+ * Usage: mpirun -np N read_prefetch [path [record_size [num_records [sync_interval]]]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char file_byte(MPI_Offset offset)
+{
+    return (char) (offset % 251);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "read_prefetch.out";
+    char other[1024], *buf;
+    int rank, size, record_size = 1000, sync_interval = 500, errors = 0, ret;
+    long num_records = 20000;
+    MPI_Offset disp, region;
+    MPI_File fh, ofh;
+    MPI_Info info;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1) {
+        path = argv[1];
+    }
+    if (argc > 2) {
+        record_size = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        num_records = atol(argv[3]);
+    }
+    if (argc > 4) {
+        sync_interval = atoi(argv[4]);
+    }
+    if (record_size < 1 || num_records < 1 || sync_interval < 1) {
+        fprintf(stderr, "usage: %s [path [record_size [num_records [sync_interval]]]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+    snprintf(other, sizeof(other), "%s.other", path);
+
+    region = (MPI_Offset) record_size * num_records;
+    disp = (MPI_Offset) rank * region;
+    buf = (char *) malloc(region);
+    if (NULL == buf) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    /* write the content to be read back without any cache */
+    for (MPI_Offset i = 0 ; i < region ; ++i) {
+        buf[i] = file_byte(disp + i);
+    }
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    MPI_File_write_at(fh, disp, buf, (int) region, MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+    memset(buf, 0, region);
+
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "ompio_read_cache_size", "1048576");
+
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_RDWR, info, &fh);
+    MPI_File_open(MPI_COMM_WORLD, other, MPI_MODE_CREATE | MPI_MODE_RDWR, MPI_INFO_NULL, &ofh);
+    MPI_File_set_view(fh, disp, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+
+    for (long r = 0 ; r < num_records ; ++r) {
+        MPI_File_read(fh, buf + r * record_size, record_size, MPI_BYTE, MPI_STATUS_IGNORE);
+
+        if (0 == (r + 1) % sync_interval) {
+            ret = MPI_File_sync(ofh);
+            if (MPI_SUCCESS != ret) {
+                fprintf(stderr, "[%d] sync of the other file failed after record %ld\n", rank, r);
+                errors++;
+            }
+            ret = MPI_File_sync(fh);
+            if (MPI_SUCCESS != ret) {
+                fprintf(stderr, "[%d] sync of the file being read failed after record %ld\n", rank, r);
+                errors++;
+            }
+        }
+    }
+
+    for (MPI_Offset i = 0 ; i < region ; ++i) {
+        if (buf[i] != file_byte(disp + i)) {
+            fprintf(stderr, "[%d] mismatch at offset %lld\n", rank, (long long) (disp + i));
+            errors++;
+            break;
+        }
+    }
+
+    MPI_File_close(&ofh);
+    MPI_File_close(&fh);
+    MPI_Info_free(&info);
+    free(buf);
+
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+        MPI_File_delete(other, MPI_INFO_NULL);
+        printf("read_prefetch: %d processes, %ld records of %d bytes: %s\n",
+               size, num_records, record_size, errors ? "FAILED" : "passed");
+    }
+
+    MPI_Finalize();
+
+    return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,224 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Write and read throughput of ompio with different values of an info
+ * key.
+ *
+ * By default, every process appends num_records records of record_size
+ * bytes to its own region of a shared file, one MPI_File_write per
+ * record, with the ompio_write_behind_size info key set to 0 (disabled)
+ * and to each of the given window sizes. A second file is synced while
+ * the last window may still be written behind, which must not fail.
+ *
+ * With -d, the records of the processes are interleaved and written with
+ * MPI_File_write_at_all, with the ompio_direct_io info key set to false
+ * and to true. A record size that is not a multiple of the block size
+ * exercises the read-modify-write of partial blocks. Run on a local file
+ * system that supports O_DIRECT (e.g. ext4 or xfs on NVMe), otherwise
+ * both runs are buffered. The buffered read usually hits the page cache
+ * filled by the write; drop the caches between the phases for a
+ * comparison of the device.
+ *
+ * In both cases the file is recreated for every run, synced and closed,
+ * then read back with the same kind of operation and checked.
+ *
+ * Usage: mpirun -np N small_writes [-d] [path [record_size [num_records]]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *key;
+    const char **values;
+    int num_values;
+    long record_size;
+    long num_records;
+    int collective;
+} test_mode_t;
+
+static const char *window_sizes[] = {"0", "65536", "1048576", "4194304"};
+static const char *direct_modes[] = {"false", "true"};
+
+#define NUM_VALUES(_v) (int) (sizeof (_v) / sizeof ((_v)[0]))
+
+static test_mode_t write_behind = {"ompio_write_behind_size", window_sizes, NUM_VALUES(window_sizes),
+                                   64, 100000, 0};
+static test_mode_t direct_io = {"ompio_direct_io", direct_modes, NUM_VALUES(direct_modes),
+                                4 * 1024 * 1024, 64, 1};
+
+static char record_byte(int rank, long record, long i)
+{
+    return (char) ((rank * 31 + record * 7 + i) & 0x7f);
+}
+
+static MPI_Offset record_offset(const test_mode_t *mode, int rank, int size, long r)
+{
+    if (mode->collective) {
+        return ((MPI_Offset) r * size + rank) * mode->record_size;
+    }
+    return ((MPI_Offset) rank * mode->num_records + r) * mode->record_size;
+}
+
+static int run(const char *path, const test_mode_t *mode, const char *value,
+               double *write_time, double *read_time)
+{
+    MPI_File fh, ofh;
+    MPI_Info info;
+    char other[1024];
+    char *record;
+    int rank, size, count = (int) mode->record_size, errors = 0;
+    double start;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    record = (char *) malloc(mode->record_size);
+    if (NULL == record) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    MPI_Info_create(&info);
+    MPI_Info_set(info, mode->key, value);
+
+    /* do not check data left behind by the previous run */
+    snprintf(other, sizeof(other), "%s.other", path);
+    if (0 == rank) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+    MPI_File_open(MPI_COMM_WORLD, other, MPI_MODE_CREATE | MPI_MODE_RDWR, MPI_INFO_NULL, &ofh);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    start = MPI_Wtime();
+
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
+    if (!mode->collective) {
+        MPI_File_set_view(fh, record_offset(mode, rank, size, 0), MPI_BYTE, MPI_BYTE,
+                          "native", info);
+    }
+
+    for (long r = 0 ; r < mode->num_records ; ++r) {
+        for (long i = 0 ; i < mode->record_size ; ++i) {
+            record[i] = record_byte(rank, r, i);
+        }
+        if (mode->collective) {
+            MPI_File_write_at_all(fh, record_offset(mode, rank, size, r), record, count,
+                                  MPI_BYTE, MPI_STATUS_IGNORE);
+        } else {
+            MPI_File_write(fh, record, count, MPI_BYTE, MPI_STATUS_IGNORE);
+        }
+    }
+
+    if (MPI_SUCCESS != MPI_File_sync(ofh)) {
+        fprintf(stderr, "[%d] %s %s: sync of another file failed\n", rank, mode->key, value);
+        errors++;
+    }
+    MPI_File_sync(fh);
+    MPI_File_close(&fh);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    *write_time = MPI_Wtime() - start;
+    MPI_File_close(&ofh);
+
+    /* verify what ended up in the file */
+    start = MPI_Wtime();
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_RDONLY, info, &fh);
+    for (long r = 0 ; r < mode->num_records && (mode->collective || 0 == errors) ; ++r) {
+        MPI_Offset offset = record_offset(mode, rank, size, r);
+
+        memset(record, 0, mode->record_size);
+        if (mode->collective) {
+            MPI_File_read_at_all(fh, offset, record, count, MPI_BYTE, MPI_STATUS_IGNORE);
+        } else {
+            MPI_File_read_at(fh, offset, record, count, MPI_BYTE, MPI_STATUS_IGNORE);
+        }
+        for (long i = 0 ; i < mode->record_size && 0 == errors ; ++i) {
+            if (record[i] != record_byte(rank, r, i)) {
+                fprintf(stderr, "[%d] %s %s: mismatch in record %ld\n", rank, mode->key, value, r);
+                errors++;
+            }
+        }
+    }
+    MPI_File_close(&fh);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    *read_time = MPI_Wtime() - start;
+
+    MPI_Info_free(&info);
+    free(record);
+
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "small_writes.out";
+    test_mode_t *mode = &write_behind;
+    int rank, size, errors = 0;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1 && 0 == strcmp(argv[1], "-d")) {
+        mode = &direct_io;
+        argc--;
+        argv++;
+    }
+    if (argc > 1) {
+        path = argv[1];
+    }
+    if (argc > 2) {
+        mode->record_size = atol(argv[2]);
+    }
+    if (argc > 3) {
+        mode->num_records = atol(argv[3]);
+    }
+    if (mode->record_size < 1 || mode->record_size > 1024L * 1024 * 1024 || mode->num_records < 1) {
+        fprintf(stderr, "usage: %s [-d] [path [record_size [num_records]]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    if (0 == rank) {
+        printf("%d processes, %ld records of %ld bytes per process, file %s\n",
+               size, mode->num_records, mode->record_size, path);
+        printf("%24s %10s %10s %12s %10s %10s\n", mode->key, "write (s)", "write MB/s",
+               "records/s", "read (s)", "read MB/s");
+    }
+
+    for (int v = 0 ; v < mode->num_values ; ++v) {
+        double write_time, read_time;
+
+        errors += run(path, mode, mode->values[v], &write_time, &read_time);
+
+        if (0 == rank) {
+            double records = (double) mode->num_records * size;
+            double bytes = records * mode->record_size;
+            printf("%24s %10.3f %10.2f %12.0f %10.3f %10.2f\n", mode->values[v], write_time,
+                   bytes / write_time / 1.0e6, records / write_time, read_time,
+                   bytes / read_time / 1.0e6);
+        }
+    }
+
+    if (0 == rank) {
+        char other[1024];
+
+        snprintf(other, sizeof(other), "%s.other", path);
+        MPI_File_delete(path, MPI_INFO_NULL);
+        MPI_File_delete(other, MPI_INFO_NULL);
+    }
+
+    MPI_Finalize();
+
+    return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
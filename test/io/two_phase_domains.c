@@ -0,0 +1,131 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Collective I/O of the two_phase component with stripe aligned file
+ * domains that do not split evenly over the aggregators.
+ *
+ * Every process is an aggregator (cb_nodes) and the file reports a
+ * stripe size through fs_ufs_stripe_size, so the file domains are
+ * rounded up to whole stripes. Process r writes a contiguous block of (r + 1) * block
+ * + 7 bytes, the total is not a multiple of the stripe size and the last
+ * aggregators end up with a partial or an empty domain. The file is
+ * written with MPI_File_write_at_all and read back with
+ * MPI_File_read_at_all, and every process checks its data.
+ *
+ * The components and parameters are only set if they are not already
+ * set in the environment.
+ *
+ * Usage: mpirun -np N two_phase_domains [path [block [stripe_size]]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char file_byte(MPI_Offset offset)
+{
+    return (char) (offset % 251);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "two_phase_domains.out";
+    const char *stripe_size = "4096";
+    char value[32];
+    int rank, size, block = 1000, errors = 0, ret, len;
+    MPI_Offset disp;
+    MPI_Info info;
+    MPI_File fh;
+    char *buf;
+
+    if (argc > 3) {
+        stripe_size = argv[3];
+    }
+    setenv("OMPI_MCA_fcoll", "two_phase", 0);
+    setenv("OMPI_MCA_fs_ufs_stripe_size", stripe_size, 0);
+    stripe_size = getenv("OMPI_MCA_fs_ufs_stripe_size");
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1) {
+        path = argv[1];
+    }
+    if (argc > 2) {
+        block = atoi(argv[2]);
+    }
+    if (block < 1) {
+        fprintf(stderr, "usage: %s [path [block [stripe_size]]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    len = (rank + 1) * block + 7;
+    disp = 0;
+    for (int r = 0 ; r < rank ; ++r) {
+        disp += (MPI_Offset) (r + 1) * block + 7;
+    }
+
+    buf = malloc(len);
+    if (NULL == buf) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (int i = 0 ; i < len ; ++i) {
+        buf[i] = file_byte(disp + i);
+    }
+
+    if (0 == rank) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    /* every process is an aggregator */
+    MPI_Info_create(&info);
+    snprintf(value, sizeof(value), "%d", size);
+    MPI_Info_set(info, "cb_nodes", value);
+
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
+    ret = MPI_File_write_at_all(fh, disp, buf, len, MPI_BYTE, MPI_STATUS_IGNORE);
+    if (MPI_SUCCESS != ret) {
+        fprintf(stderr, "[%d] MPI_File_write_at_all failed\n", rank);
+        errors++;
+    }
+    MPI_File_close(&fh);
+
+    memset(buf, 0, len);
+
+    MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_RDONLY, info, &fh);
+    ret = MPI_File_read_at_all(fh, disp, buf, len, MPI_BYTE, MPI_STATUS_IGNORE);
+    if (MPI_SUCCESS != ret) {
+        fprintf(stderr, "[%d] MPI_File_read_at_all failed\n", rank);
+        errors++;
+    }
+    MPI_File_close(&fh);
+
+    for (int i = 0 ; i < len && 0 == errors ; ++i) {
+        if (buf[i] != file_byte(disp + i)) {
+            fprintf(stderr, "[%d] wrong data at offset %lld\n", rank, (long long) (disp + i));
+            errors++;
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("%d processes, stripe size %s: %s\n", size, stripe_size, errors ? "FAILED" : "OK");
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+
+    MPI_Info_free(&info);
+    free(buf);
+
+    MPI_Finalize();
+    return errors ? 1 : 0;
+}
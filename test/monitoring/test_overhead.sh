@@ -30,6 +30,9 @@
 #   - MPI_Put
 #   - MPI_Get
 #
+# The optional second argument N runs the monitored case with
+# pml_monitoring_sampling set to N, i.e. recording one in N messages.
+#
 
 exe=test_overhead
 
@@ -39,6 +42,10 @@ then
     mfile="-machinefile $1"
 fi
 common_opt="$mfile --bind-to core"
+if [ $# -ge 2 ]
+then
+    sampling_opt="--mca pml_monitoring_sampling $2"
+fi
 
 # dir
 resdir=res
@@ -59,7 +66,7 @@ function no_monitoring() {
 
 # monitoring(nb_nodes, exe_name, output_filename, error_filename)
 function monitoring() {
-    mpiexec -n $1 $common_opt --mca pml_monitoring_enable 1 --mca pml_monitoring_enable_output 3 --mca pml_monitoring_filename "prof/toto" $2 2> $4 > $3
+    mpiexec -n $1 $common_opt --mca pml_monitoring_enable 1 --mca pml_monitoring_enable_output 3 --mca pml_monitoring_filename "prof/toto" $sampling_opt $2 2> $4 > $3
 }
 
 # filter_output(filenames_list)
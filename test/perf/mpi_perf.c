@@ -0,0 +1,618 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Micro-benchmarks of the point-to-point, collective, one-sided and
+ * file operations, with the results written as JSON so that two runs
+ * can be compared.
+ *
+ * Suites:
+ *   pt2pt  latency (ping-pong between ranks 0 and 1), bandwidth and
+ *          message rate (windows of non-blocking sends from 0 to 1)
+ *   coll   every collective with every coll/tuned algorithm, forced
+ *          through the coll_tuned_<coll>_algorithm control variables
+ *          on a duplicate of MPI_COMM_WORLD. Forcing an algorithm needs
+ *          --mca coll_tuned_use_dynamic_rules 1; without it only the
+ *          default decision is measured.
+ *   osc    MPI_Put, MPI_Get and MPI_Accumulate latency and bandwidth
+ *          from rank 0 to rank 1 in a passive target epoch
+ *   io     MPI_File_write_at_all and MPI_File_read_at_all bandwidth on
+ *          a file shared by all processes
+ *
+ * Every result is reported by rank 0, as the slowest process for the
+ * collectives and the file operations. The JSON document is
+ *   {"benchmark": "mpi_perf", "nprocs": N, "hostname": "...",
+ *    "max_bytes": M, "iterations": I,
+ *    "results": [{"suite": "coll", "test": "allreduce",
+ *                 "algorithm": "ring", "bytes": 1024,
+ *                 "metric": "time", "value": 12.5, "unit": "us"}, ...]}
+ * where "algorithm" only appears for the collectives.
+ *
+ * Usage: mpirun -np N mpi_perf [-s suite,...] [-m max_bytes] [-i iterations]
+ *                              [-d directory] [-o output.json]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PERF_WINDOW 64
+#define PERF_MIN_ITERATIONS 5
+/* above this size the number of iterations is divided by 10 */
+#define PERF_LARGE 65536
+
+static int rank, nprocs;
+static long max_bytes = 1024 * 1024;
+static int iterations = 1000;
+static const char *directory = ".";
+static FILE *out = NULL;
+static int num_results = 0;
+static char *sbuf, *rbuf;
+
+/* Write one result, rank 0 only */
+static void perf_report(const char *suite, const char *test, const char *algorithm,
+                        long bytes, const char *metric, double value, const char *unit)
+{
+    if (0 != rank) {
+        return;
+    }
+
+    fprintf(out, "%s\n    {\"suite\": \"%s\", \"test\": \"%s\", ", (0 == num_results) ? "" : ",",
+            suite, test);
+    if (NULL != algorithm) {
+        fprintf(out, "\"algorithm\": \"%s\", ", algorithm);
+    }
+    fprintf(out, "\"bytes\": %ld, \"metric\": \"%s\", \"value\": %.6g, \"unit\": \"%s\"}",
+            bytes, metric, value, unit);
+    num_results++;
+}
+
+static int perf_iterations(long bytes)
+{
+    int n = (bytes > PERF_LARGE) ? iterations / 10 : iterations;
+    return (n < PERF_MIN_ITERATIONS) ? PERF_MIN_ITERATIONS : n;
+}
+
+/* Slowest time of all processes */
+static double perf_max(MPI_Comm comm, double t)
+{
+    MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, comm);
+    return t;
+}
+
+/*
+ * Point-to-point
+ */
+
+static void perf_pt2pt(void)
+{
+    MPI_Request reqs[PERF_WINDOW];
+    double t;
+
+    if (nprocs < 2) {
+        if (0 == rank) {
+            fprintf(stderr, "mpi_perf: pt2pt needs 2 processes, skipped\n");
+        }
+        return;
+    }
+
+    for (long bytes = 1 ; bytes <= max_bytes ; bytes *= 4) {
+        int n = perf_iterations(bytes);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (rank < 2) {
+            int peer = 1 - rank;
+
+            t = MPI_Wtime();
+            for (int i = 0 ; i < n ; ++i) {
+                if (0 == rank) {
+                    MPI_Send(sbuf, (int) bytes, MPI_BYTE, peer, 1, MPI_COMM_WORLD);
+                    MPI_Recv(rbuf, (int) bytes, MPI_BYTE, peer, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                } else {
+                    MPI_Recv(rbuf, (int) bytes, MPI_BYTE, peer, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                    MPI_Send(sbuf, (int) bytes, MPI_BYTE, peer, 1, MPI_COMM_WORLD);
+                }
+            }
+            t = MPI_Wtime() - t;
+            perf_report("pt2pt", "latency", NULL, bytes, "time", 1.0e6 * t / (2.0 * n), "us");
+
+            /* windows of messages, acknowledged by a zero byte message */
+            n = n / 10 + 1;
+            t = MPI_Wtime();
+            for (int i = 0 ; i < n ; ++i) {
+                for (int w = 0 ; w < PERF_WINDOW ; ++w) {
+                    if (0 == rank) {
+                        MPI_Isend(sbuf, (int) bytes, MPI_BYTE, peer, 2, MPI_COMM_WORLD, reqs + w);
+                    } else {
+                        MPI_Irecv(rbuf, (int) bytes, MPI_BYTE, peer, 2, MPI_COMM_WORLD, reqs + w);
+                    }
+                }
+                MPI_Waitall(PERF_WINDOW, reqs, MPI_STATUSES_IGNORE);
+                if (0 == rank) {
+                    MPI_Recv(NULL, 0, MPI_BYTE, peer, 3, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                } else {
+                    MPI_Send(NULL, 0, MPI_BYTE, peer, 3, MPI_COMM_WORLD);
+                }
+            }
+            t = MPI_Wtime() - t;
+            perf_report("pt2pt", "bandwidth", NULL, bytes, "bandwidth",
+                        (double) bytes * PERF_WINDOW * n / t / 1.0e6, "MB/s");
+            perf_report("pt2pt", "message_rate", NULL, bytes, "rate",
+                        (double) PERF_WINDOW * n / t, "msg/s");
+        }
+    }
+}
+
+/*
+ * Collectives
+ */
+
+typedef void (*perf_coll_fn_t)(MPI_Comm comm, long bytes);
+
+static int *counts, *displs;
+
+static void perf_set_counts(long bytes)
+{
+    for (int p = 0 ; p < nprocs ; ++p) {
+        counts[p] = (int) bytes;
+        displs[p] = (int) (p * bytes);
+    }
+}
+
+static void coll_allgather(MPI_Comm comm, long bytes)
+{
+    MPI_Allgather(sbuf, (int) bytes, MPI_BYTE, rbuf, (int) bytes, MPI_BYTE, comm);
+}
+
+static void coll_allgatherv(MPI_Comm comm, long bytes)
+{
+    MPI_Allgatherv(sbuf, (int) bytes, MPI_BYTE, rbuf, counts, displs, MPI_BYTE, comm);
+}
+
+static void coll_allreduce(MPI_Comm comm, long bytes)
+{
+    MPI_Allreduce(sbuf, rbuf, (int) (bytes / sizeof(float)), MPI_FLOAT, MPI_SUM, comm);
+}
+
+static void coll_alltoall(MPI_Comm comm, long bytes)
+{
+    MPI_Alltoall(sbuf, (int) bytes, MPI_BYTE, rbuf, (int) bytes, MPI_BYTE, comm);
+}
+
+static void coll_alltoallv(MPI_Comm comm, long bytes)
+{
+    MPI_Alltoallv(sbuf, counts, displs, MPI_BYTE, rbuf, counts, displs, MPI_BYTE, comm);
+}
+
+static void coll_barrier(MPI_Comm comm, long bytes)
+{
+    MPI_Barrier(comm);
+}
+
+static void coll_bcast(MPI_Comm comm, long bytes)
+{
+    MPI_Bcast(sbuf, (int) bytes, MPI_BYTE, 0, comm);
+}
+
+static void coll_exscan(MPI_Comm comm, long bytes)
+{
+    MPI_Exscan(sbuf, rbuf, (int) (bytes / sizeof(float)), MPI_FLOAT, MPI_SUM, comm);
+}
+
+static void coll_gather(MPI_Comm comm, long bytes)
+{
+    MPI_Gather(sbuf, (int) bytes, MPI_BYTE, rbuf, (int) bytes, MPI_BYTE, 0, comm);
+}
+
+static void coll_reduce(MPI_Comm comm, long bytes)
+{
+    MPI_Reduce(sbuf, rbuf, (int) (bytes / sizeof(float)), MPI_FLOAT, MPI_SUM, 0, comm);
+}
+
+static void coll_reduce_scatter(MPI_Comm comm, long bytes)
+{
+    for (int p = 0 ; p < nprocs ; ++p) {
+        counts[p] = (int) (bytes / sizeof(float));
+    }
+    MPI_Reduce_scatter(sbuf, rbuf, counts, MPI_FLOAT, MPI_SUM, comm);
+    perf_set_counts(bytes);
+}
+
+static void coll_reduce_scatter_block(MPI_Comm comm, long bytes)
+{
+    MPI_Reduce_scatter_block(sbuf, rbuf, (int) (bytes / sizeof(float)), MPI_FLOAT, MPI_SUM, comm);
+}
+
+static void coll_scan(MPI_Comm comm, long bytes)
+{
+    MPI_Scan(sbuf, rbuf, (int) (bytes / sizeof(float)), MPI_FLOAT, MPI_SUM, comm);
+}
+
+static void coll_scatter(MPI_Comm comm, long bytes)
+{
+    MPI_Scatter(sbuf, (int) bytes, MPI_BYTE, rbuf, (int) bytes, MPI_BYTE, 0, comm);
+}
+
+static const struct {
+    const char *name;
+    perf_coll_fn_t fn;
+    int per_peer;       /* buffers hold one block per process */
+    int reduction;      /* bytes is a number of floats */
+} perf_colls[] = {
+    {"allgather", coll_allgather, 1, 0},
+    {"allgatherv", coll_allgatherv, 1, 0},
+    {"allreduce", coll_allreduce, 0, 1},
+    {"alltoall", coll_alltoall, 1, 0},
+    {"alltoallv", coll_alltoallv, 1, 0},
+    {"barrier", coll_barrier, 0, 0},
+    {"bcast", coll_bcast, 0, 0},
+    {"exscan", coll_exscan, 0, 1},
+    {"gather", coll_gather, 1, 0},
+    {"reduce", coll_reduce, 0, 1},
+    {"reduce_scatter", coll_reduce_scatter, 1, 1},
+    {"reduce_scatter_block", coll_reduce_scatter_block, 1, 1},
+    {"scan", coll_scan, 0, 1},
+    {"scatter", coll_scatter, 1, 0},
+};
+#define PERF_NUM_COLLS (int) (sizeof(perf_colls) / sizeof(perf_colls[0]))
+
+/* Index of a control variable, -1 if it does not exist */
+static int perf_cvar_index(const char *name)
+{
+    int index;
+
+    if (MPI_SUCCESS != MPI_T_cvar_get_index(name, &index)) {
+        return -1;
+    }
+    return index;
+}
+
+static int perf_cvar_read(int index, int *value)
+{
+    MPI_T_cvar_handle handle;
+    int count, ret;
+
+    if (MPI_SUCCESS != MPI_T_cvar_handle_alloc(index, NULL, &handle, &count)) {
+        return MPI_ERR_OTHER;
+    }
+    ret = MPI_T_cvar_read(handle, value);
+    MPI_T_cvar_handle_free(&handle);
+    return ret;
+}
+
+static int perf_cvar_write(int index, int value)
+{
+    MPI_T_cvar_handle handle;
+    int count, ret;
+
+    if (MPI_SUCCESS != MPI_T_cvar_handle_alloc(index, NULL, &handle, &count)) {
+        return MPI_ERR_OTHER;
+    }
+    ret = MPI_T_cvar_write(handle, &value);
+    MPI_T_cvar_handle_free(&handle);
+    return ret;
+}
+
+/* Name of the value of an enumerated control variable */
+static void perf_cvar_enum_name(int index, int value, char *name, int len)
+{
+    char cvar_name[256], desc[1024];
+    int name_len = sizeof(cvar_name), desc_len = sizeof(desc);
+    int verbosity, bind, scope, num, item_value;
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype = MPI_T_ENUM_NULL;
+
+    snprintf(name, len, "%d", value);
+    if (MPI_SUCCESS != MPI_T_cvar_get_info(index, cvar_name, &name_len, &verbosity, &datatype,
+                                           &enumtype, desc, &desc_len, &bind, &scope) ||
+        MPI_T_ENUM_NULL == enumtype) {
+        return;
+    }
+
+    name_len = sizeof(cvar_name);
+    MPI_T_enum_get_info(enumtype, &num, cvar_name, &name_len);
+    for (int i = 0 ; i < num ; ++i) {
+        int item_len = len;
+        if (MPI_SUCCESS == MPI_T_enum_get_item(enumtype, i, &item_value, name, &item_len) &&
+            item_value == value) {
+            return;
+        }
+    }
+    snprintf(name, len, "%d", value);
+}
+
+static void perf_coll_run(int c, const char *algorithm)
+{
+    MPI_Comm comm;
+    double t;
+
+    /* the forced algorithms are read when a communicator is created */
+    MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+
+    for (long bytes = 4 ; bytes <= max_bytes ; bytes *= 4) {
+        int n = perf_iterations(bytes * (perf_colls[c].per_peer ? nprocs : 1));
+
+        if (perf_colls[c].per_peer && bytes * nprocs > max_bytes * 4) {
+            break;
+        }
+        perf_set_counts(bytes);
+
+        perf_colls[c].fn(comm, bytes);     /* warm up */
+        MPI_Barrier(comm);
+        t = MPI_Wtime();
+        for (int i = 0 ; i < n ; ++i) {
+            perf_colls[c].fn(comm, bytes);
+        }
+        t = perf_max(comm, (MPI_Wtime() - t) / n);
+        perf_report("coll", perf_colls[c].name, algorithm, bytes, "time", 1.0e6 * t, "us");
+
+        if (0 == strcmp(perf_colls[c].name, "barrier")) {
+            break;
+        }
+    }
+
+    MPI_Comm_free(&comm);
+}
+
+static void perf_coll(void)
+{
+    char cvar[128], algorithm[64];
+    int dynamic = 0, index, count_index, count, alg_index;
+
+    index = perf_cvar_index("coll_tuned_use_dynamic_rules");
+    if (index < 0 || MPI_SUCCESS != perf_cvar_read(index, &dynamic)) {
+        dynamic = 0;
+    }
+    if (!dynamic && 0 == rank) {
+        fprintf(stderr, "mpi_perf: coll_tuned_use_dynamic_rules is not set, "
+                "only the default algorithms are measured\n");
+    }
+
+    for (int c = 0 ; c < PERF_NUM_COLLS ; ++c) {
+        perf_coll_run(c, "default");
+        if (!dynamic) {
+            continue;
+        }
+
+        snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm", perf_colls[c].name);
+        alg_index = perf_cvar_index(cvar);
+        snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm_count", perf_colls[c].name);
+        count_index = perf_cvar_index(cvar);
+        if (alg_index < 0 || count_index < 0 ||
+            MPI_SUCCESS != perf_cvar_read(count_index, &count)) {
+            continue;
+        }
+
+        /* algorithm 0 lets the decision function choose, measured above */
+        for (int alg = 1 ; alg < count ; ++alg) {
+            if (MPI_SUCCESS != perf_cvar_write(alg_index, alg)) {
+                break;
+            }
+            perf_cvar_enum_name(alg_index, alg, algorithm, sizeof(algorithm));
+            perf_coll_run(c, algorithm);
+        }
+        perf_cvar_write(alg_index, 0);
+    }
+}
+
+/*
+ * One-sided
+ */
+
+static void perf_osc(void)
+{
+    MPI_Win win;
+    double t;
+
+    if (nprocs < 2) {
+        if (0 == rank) {
+            fprintf(stderr, "mpi_perf: osc needs 2 processes, skipped\n");
+        }
+        return;
+    }
+
+    MPI_Win_create(rbuf, max_bytes, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &win);
+    MPI_Win_lock_all(0, win);
+
+    for (int op = 0 ; op < 3 ; ++op) {
+        const char *name = (0 == op) ? "put" : (1 == op) ? "get" : "accumulate";
+
+        for (long bytes = 8 ; bytes <= max_bytes ; bytes *= 4) {
+            int n = perf_iterations(bytes), count = (int) (bytes / sizeof(double));
+
+            MPI_Barrier(MPI_COMM_WORLD);
+            if (0 != rank) {
+                continue;
+            }
+
+            /* latency: one operation completed at a time */
+            t = MPI_Wtime();
+            for (int i = 0 ; i < n ; ++i) {
+                if (0 == op) {
+                    MPI_Put(sbuf, (int) bytes, MPI_BYTE, 1, 0, (int) bytes, MPI_BYTE, win);
+                } else if (1 == op) {
+                    MPI_Get(sbuf, (int) bytes, MPI_BYTE, 1, 0, (int) bytes, MPI_BYTE, win);
+                } else {
+                    MPI_Accumulate(sbuf, count, MPI_DOUBLE, 1, 0, count, MPI_DOUBLE, MPI_SUM, win);
+                }
+                MPI_Win_flush(1, win);
+            }
+            t = MPI_Wtime() - t;
+            perf_report("osc", name, NULL, bytes, "time", 1.0e6 * t / n, "us");
+
+            /* bandwidth: windows of operations completed together */
+            n = n / 10 + 1;
+            t = MPI_Wtime();
+            for (int i = 0 ; i < n ; ++i) {
+                for (int w = 0 ; w < PERF_WINDOW ; ++w) {
+                    if (0 == op) {
+                        MPI_Put(sbuf, (int) bytes, MPI_BYTE, 1, 0, (int) bytes, MPI_BYTE, win);
+                    } else if (1 == op) {
+                        MPI_Get(sbuf, (int) bytes, MPI_BYTE, 1, 0, (int) bytes, MPI_BYTE, win);
+                    } else {
+                        MPI_Accumulate(sbuf, count, MPI_DOUBLE, 1, 0, count, MPI_DOUBLE, MPI_SUM, win);
+                    }
+                }
+                MPI_Win_flush(1, win);
+            }
+            t = MPI_Wtime() - t;
+            perf_report("osc", name, NULL, bytes, "bandwidth",
+                        (double) bytes * PERF_WINDOW * n / t / 1.0e6, "MB/s");
+        }
+    }
+
+    MPI_Win_unlock_all(win);
+    MPI_Win_free(&win);
+}
+
+/*
+ * File I/O
+ */
+
+static void perf_io(void)
+{
+    char path[1024];
+    MPI_File fh;
+    double t;
+
+    snprintf(path, sizeof(path), "%s/mpi_perf.%d.tmp", directory, (int) getpid());
+    MPI_Bcast(path, sizeof(path), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    if (MPI_SUCCESS != MPI_File_open(MPI_COMM_WORLD, path, MPI_MODE_CREATE | MPI_MODE_RDWR,
+                                     MPI_INFO_NULL, &fh)) {
+        if (0 == rank) {
+            fprintf(stderr, "mpi_perf: cannot create %s, io skipped\n", path);
+        }
+        return;
+    }
+
+    for (long bytes = 4096 ; bytes <= max_bytes ; bytes *= 4) {
+        int n = perf_iterations(bytes) / 10 + 1;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t = MPI_Wtime();
+        for (int i = 0 ; i < n ; ++i) {
+            MPI_Offset offset = ((MPI_Offset) i * nprocs + rank) * bytes;
+            MPI_File_write_at_all(fh, offset, sbuf, (int) bytes, MPI_BYTE, MPI_STATUS_IGNORE);
+        }
+        MPI_File_sync(fh);
+        t = perf_max(MPI_COMM_WORLD, MPI_Wtime() - t);
+        perf_report("io", "write_at_all", NULL, bytes, "bandwidth",
+                    (double) bytes * nprocs * n / t / 1.0e6, "MB/s");
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t = MPI_Wtime();
+        for (int i = 0 ; i < n ; ++i) {
+            MPI_Offset offset = ((MPI_Offset) i * nprocs + rank) * bytes;
+            MPI_File_read_at_all(fh, offset, rbuf, (int) bytes, MPI_BYTE, MPI_STATUS_IGNORE);
+        }
+        t = perf_max(MPI_COMM_WORLD, MPI_Wtime() - t);
+        perf_report("io", "read_at_all", NULL, bytes, "bandwidth",
+                    (double) bytes * nprocs * n / t / 1.0e6, "MB/s");
+    }
+
+    MPI_File_close(&fh);
+    if (0 == rank) {
+        MPI_File_delete(path, MPI_INFO_NULL);
+    }
+}
+
+static void usage(const char *prog)
+{
+    if (0 == rank) {
+        fprintf(stderr, "usage: %s [-s pt2pt,coll,osc,io] [-m max_bytes] [-i iterations] "
+                "[-d directory] [-o output.json]\n", prog);
+    }
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv)
+{
+    const char *suites = "pt2pt,coll,osc,io", *output = NULL;
+    char hostname[256];
+    size_t buffer_size;
+    int opt, provided;
+
+    MPI_Init(&argc, &argv);
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    while (-1 != (opt = getopt(argc, argv, "s:m:i:d:o:"))) {
+        switch (opt) {
+        case 's': suites = optarg; break;
+        case 'm': max_bytes = atol(optarg); break;
+        case 'i': iterations = atoi(optarg); break;
+        case 'd': directory = optarg; break;
+        case 'o': output = optarg; break;
+        default: usage(argv[0]);
+        }
+    }
+    if (max_bytes < 8 || max_bytes > (1L << 30) || iterations < 1) {
+        usage(argv[0]);
+    }
+
+    /* the collectives with a block per process use up to 4 * max_bytes */
+    buffer_size = (size_t) max_bytes * 4 + (size_t) max_bytes * nprocs;
+    sbuf = (char *) malloc(buffer_size);
+    rbuf = (char *) malloc(buffer_size);
+    counts = (int *) malloc(nprocs * sizeof(int));
+    displs = (int *) malloc(nprocs * sizeof(int));
+    if (NULL == sbuf || NULL == rbuf || NULL == counts || NULL == displs) {
+        fprintf(stderr, "mpi_perf: out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+    memset(sbuf, 1, buffer_size);
+    memset(rbuf, 0, buffer_size);
+
+    if (0 == rank) {
+        out = stdout;
+        if (NULL != output && NULL == (out = fopen(output, "w"))) {
+            fprintf(stderr, "mpi_perf: cannot open %s\n", output);
+            MPI_Abort(MPI_COMM_WORLD, -1);
+        }
+        gethostname(hostname, sizeof(hostname));
+        hostname[sizeof(hostname) - 1] = '\0';
+        fprintf(out, "{\n  \"benchmark\": \"mpi_perf\",\n  \"nprocs\": %d,\n  \"hostname\": \"%s\",\n"
+                "  \"max_bytes\": %ld,\n  \"iterations\": %d,\n  \"results\": [",
+                nprocs, hostname, max_bytes, iterations);
+    }
+
+    if (NULL != strstr(suites, "pt2pt")) {
+        perf_pt2pt();
+    }
+    if (NULL != strstr(suites, "coll")) {
+        perf_coll();
+    }
+    if (NULL != strstr(suites, "osc")) {
+        perf_osc();
+    }
+    if (NULL != strstr(suites, "io")) {
+        perf_io();
+    }
+
+    if (0 == rank) {
+        fprintf(out, "\n  ]\n}\n");
+        if (stdout != out) {
+            fclose(out);
+        }
+    }
+
+    free(displs);
+    free(counts);
+    free(rbuf);
+    free(sbuf);
+
+    MPI_T_finalize();
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Message rate of MPI_Isend/MPI_Irecv with several threads per process
+ * under MPI_THREAD_MULTIPLE.
+ *
+ * The processes are paired, even ranks send to the next odd rank. Thread
+ * t of a sender sends windows of small messages to thread t of its
+ * receiver on a communicator of its own, and waits for a zero byte
+ * acknowledgement after each window. The request and fragment
+ * allocations of all the threads go through the same free lists, so the
+ * rate shows their contention, for example with and without
+ * --mca opal_free_list_magazine_size 32.
+ *
+ * Usage: mpirun -np 2 mt_msgrate [threads [bytes [windows]]]
+ */
+
+#include "mpi.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define WINDOW 64
+
+static int rank, nprocs, nthreads = 4, bytes = 8, windows = 10000;
+static MPI_Comm *comms;
+static pthread_barrier_t barrier;
+static double *times;
+
+static void *thread_main(void *arg)
+{
+    int t = (int) (intptr_t) arg, peer = (rank % 2) ? rank - 1 : rank + 1;
+    MPI_Request reqs[WINDOW];
+    char *buf = malloc((size_t) bytes * WINDOW + 1);
+    double start;
+
+    pthread_barrier_wait(&barrier);
+    start = MPI_Wtime();
+    for (int w = 0 ; w < windows ; ++w) {
+        for (int i = 0 ; i < WINDOW ; ++i) {
+            if (0 == rank % 2) {
+                MPI_Isend(buf + i * bytes, bytes, MPI_BYTE, peer, i, comms[t], reqs + i);
+            } else {
+                MPI_Irecv(buf + i * bytes, bytes, MPI_BYTE, peer, i, comms[t], reqs + i);
+            }
+        }
+        MPI_Waitall(WINDOW, reqs, MPI_STATUSES_IGNORE);
+        if (0 == rank % 2) {
+            MPI_Recv(NULL, 0, MPI_BYTE, peer, WINDOW, comms[t], MPI_STATUS_IGNORE);
+        } else {
+            MPI_Send(NULL, 0, MPI_BYTE, peer, WINDOW, comms[t]);
+        }
+    }
+    times[t] = MPI_Wtime() - start;
+
+    free(buf);
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    double time = 0.0, rate;
+    pthread_t *threads;
+    int provided;
+
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    if (argc > 1) {
+        nthreads = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        bytes = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        windows = atoi(argv[3]);
+    }
+
+    if (MPI_THREAD_MULTIPLE != provided || nprocs % 2 || nthreads < 1 || bytes < 0 || windows < 1) {
+        if (0 == rank) {
+            fprintf(stderr, "usage: mpirun -np <even> %s [threads [bytes [windows]]] "
+                    "(needs MPI_THREAD_MULTIPLE)\n", argv[0]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    comms = malloc(nthreads * sizeof(MPI_Comm));
+    threads = malloc(nthreads * sizeof(pthread_t));
+    times = malloc(nthreads * sizeof(double));
+    for (int t = 0 ; t < nthreads ; ++t) {
+        MPI_Comm_dup(MPI_COMM_WORLD, comms + t);
+    }
+    pthread_barrier_init(&barrier, NULL, nthreads);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    for (int t = 0 ; t < nthreads ; ++t) {
+        pthread_create(threads + t, NULL, thread_main, (void *) (intptr_t) t);
+    }
+    for (int t = 0 ; t < nthreads ; ++t) {
+        pthread_join(threads[t], NULL);
+        time = (times[t] > time) ? times[t] : time;
+    }
+
+    /* messages sent by all the senders per second of the slowest thread */
+    MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    rate = (double) windows * WINDOW * nthreads * (nprocs / 2) / time;
+    if (0 == rank) {
+        printf("threads %d bytes %d messages/s %.0f (%.3f us per message per thread)\n",
+                nthreads, bytes, rate, 1.0e6 * time / ((double) windows * WINDOW));
+    }
+
+    pthread_barrier_destroy(&barrier);
+    for (int t = 0 ; t < nthreads ; ++t) {
+        MPI_Comm_free(comms + t);
+    }
+    free(times);
+    free(threads);
+    free(comms);
+
+    MPI_Finalize();
+    return 0;
+}
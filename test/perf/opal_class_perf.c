@@ -0,0 +1,443 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Throughput of the opal/class containers on the hot paths: operations
+ * per second of each container with 1, 2, 4, ... up to the requested
+ * number of threads. The threads share one container, so the scaling
+ * shows the cost of the atomics and of the cache lines they share.
+ *
+ *   hash_table     opal_hash_table_get_value_uint64 (shared, read only),
+ *                  set_value_uint64 and remove_value_uint64 (1 thread)
+ *   pointer_array  opal_pointer_array_get_item (shared),
+ *                  add and set_item (1 thread)
+ *   free_list      opal_free_list_get_mt / return_mt pairs
+ *   lifo           opal_lifo_pop_atomic / push_atomic pairs
+ *   fifo           opal_fifo_pop_atomic / push_atomic pairs
+ *   interval_tree  opal_interval_tree_find_overlapping (shared),
+ *                  insert and delete (1 thread)
+ *
+ * Usage: opal_class_perf [-t max_threads] [-n operations] [-s size] [container ...]
+ *
+ * -n is the number of operations per thread, -s the number of elements in
+ * the containers. The MCA parameters apply, e.g. set
+ * OMPI_MCA_opal_free_list_magazine_size=32 to measure the free list with
+ * per-thread magazines.
+ */
+
+#include "opal_config.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_pointer_array.h"
+#include "opal/class/opal_free_list.h"
+#include "opal/class/opal_lifo.h"
+#include "opal/class/opal_fifo.h"
+#include "opal/class/opal_interval_tree.h"
+#include "opal/runtime/opal.h"
+#include "opal/constants.h"
+
+typedef void (*perf_fn_t) (int thread, long n);
+
+static long num_ops = 1000000;
+static long size = 1024;
+static int max_threads = 1;
+
+static opal_hash_table_t hash_table;
+static opal_pointer_array_t pointer_array;
+static opal_free_list_t free_list;
+static opal_lifo_t lifo;
+static opal_fifo_t fifo;
+static opal_interval_tree_t interval_tree;
+
+static pthread_barrier_t barrier;
+
+static double perf_time (void)
+{
+    struct timeval tv;
+
+    gettimeofday (&tv, NULL);
+    return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
+/* per-thread pseudo random keys, so that the threads do not walk the containers in step */
+static inline uint64_t perf_rand (uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/*
+ * hash table
+ */
+
+static void hash_table_get (int thread, long n)
+{
+    uint64_t state = 0x9e3779b97f4a7c15ull * (thread + 1);
+    void *value;
+
+    for (long i = 0 ; i < n ; ++i) {
+        (void) opal_hash_table_get_value_uint64 (&hash_table, perf_rand (&state) % size, &value);
+    }
+}
+
+static void hash_table_set (int thread, long n)
+{
+    for (long i = 0 ; i < n ; ++i) {
+        (void) opal_hash_table_set_value_uint64 (&hash_table, size + i, (void *) (intptr_t) i);
+    }
+}
+
+static void hash_table_remove (int thread, long n)
+{
+    for (long i = 0 ; i < n ; ++i) {
+        (void) opal_hash_table_remove_value_uint64 (&hash_table, size + i);
+    }
+}
+
+/*
+ * pointer array
+ */
+
+static void pointer_array_get (int thread, long n)
+{
+    uint64_t state = 0x9e3779b97f4a7c15ull * (thread + 1);
+
+    for (long i = 0 ; i < n ; ++i) {
+        (void) opal_pointer_array_get_item (&pointer_array, (int) (perf_rand (&state) % size));
+    }
+}
+
+static void pointer_array_set (int thread, long n)
+{
+    for (long i = 0 ; i < n ; ++i) {
+        (void) opal_pointer_array_set_item (&pointer_array, (int) (i % size), (void *) (intptr_t) i);
+    }
+}
+
+static void pointer_array_add (int thread, long n)
+{
+    for (long i = 0 ; i < n ; ++i) {
+        (void) opal_pointer_array_add (&pointer_array, (void *) (intptr_t) (i + 1));
+    }
+}
+
+/*
+ * free list, lifo and fifo: each thread takes a few items and returns them
+ */
+
+#define PERF_BATCH 8
+
+static void free_list_get_return (int thread, long n)
+{
+    opal_free_list_item_t *items[PERF_BATCH];
+
+    for (long i = 0 ; i < n ; i += PERF_BATCH) {
+        for (int j = 0 ; j < PERF_BATCH ; ++j) {
+            items[j] = opal_free_list_get_mt (&free_list);
+        }
+        for (int j = 0 ; j < PERF_BATCH ; ++j) {
+            if (NULL != items[j]) {
+                opal_free_list_return_mt (&free_list, items[j]);
+            }
+        }
+    }
+}
+
+static void lifo_pop_push (int thread, long n)
+{
+    opal_list_item_t *items[PERF_BATCH];
+
+    for (long i = 0 ; i < n ; i += PERF_BATCH) {
+        for (int j = 0 ; j < PERF_BATCH ; ++j) {
+            items[j] = opal_lifo_pop_atomic (&lifo);
+        }
+        for (int j = 0 ; j < PERF_BATCH ; ++j) {
+            if (NULL != items[j]) {
+                (void) opal_lifo_push_atomic (&lifo, items[j]);
+            }
+        }
+    }
+}
+
+static void fifo_pop_push (int thread, long n)
+{
+    opal_list_item_t *items[PERF_BATCH];
+
+    for (long i = 0 ; i < n ; i += PERF_BATCH) {
+        for (int j = 0 ; j < PERF_BATCH ; ++j) {
+            items[j] = opal_fifo_pop_atomic (&fifo);
+        }
+        for (int j = 0 ; j < PERF_BATCH ; ++j) {
+            if (NULL != items[j]) {
+                (void) opal_fifo_push_atomic (&fifo, items[j]);
+            }
+        }
+    }
+}
+
+/*
+ * interval tree: size intervals of 4 kB, one page apart
+ */
+
+static void interval_tree_find (int thread, long n)
+{
+    uint64_t state = 0x9e3779b97f4a7c15ull * (thread + 1);
+
+    for (long i = 0 ; i < n ; ++i) {
+        uint64_t base = (perf_rand (&state) % size) * 8192;
+        (void) opal_interval_tree_find_overlapping (&interval_tree, base + 16, base + 32);
+    }
+}
+
+static void interval_tree_insert (int thread, long n)
+{
+    for (long i = 0 ; i < n ; ++i) {
+        uint64_t base = (size + i) * 8192;
+        (void) opal_interval_tree_insert (&interval_tree, (void *) (intptr_t) (i + 1), base, base + 4096);
+    }
+}
+
+static void interval_tree_delete (int thread, long n)
+{
+    for (long i = 0 ; i < n ; ++i) {
+        uint64_t base = (size + i) * 8192;
+        (void) opal_interval_tree_delete (&interval_tree, base, base + 4096, (void *) (intptr_t) (i + 1));
+    }
+}
+
+/*
+ * driver
+ */
+
+struct perf_thread_t {
+    perf_fn_t fn;
+    int thread;
+    long n;
+    double time;
+};
+typedef struct perf_thread_t perf_thread_t;
+
+static void *perf_thread (void *arg)
+{
+    perf_thread_t *t = (perf_thread_t *) arg;
+    double start;
+
+    pthread_barrier_wait (&barrier);
+    start = perf_time ();
+    t->fn (t->thread, t->n);
+    t->time = perf_time () - start;
+
+    return NULL;
+}
+
+/* run fn in nthreads threads and print the operations per second of all of them */
+static void perf_run (const char *container, const char *op, perf_fn_t fn, int nthreads, long n)
+{
+    perf_thread_t threads[nthreads];
+    pthread_t ids[nthreads];
+    double time = 0.0;
+
+    pthread_barrier_init (&barrier, NULL, nthreads);
+
+    for (int i = 0 ; i < nthreads ; ++i) {
+        threads[i] = (perf_thread_t) {.fn = fn, .thread = i, .n = n};
+        if (i > 0) {
+            pthread_create (ids + i, NULL, perf_thread, threads + i);
+        }
+    }
+    perf_thread (threads);
+    for (int i = 1 ; i < nthreads ; ++i) {
+        pthread_join (ids[i], NULL);
+    }
+
+    for (int i = 0 ; i < nthreads ; ++i) {
+        time = (threads[i].time > time) ? threads[i].time : time;
+    }
+    pthread_barrier_destroy (&barrier);
+
+    printf ("%-14s %-14s %7d %14.0f %10.1f\n", container, op, nthreads,
+            (double) n * nthreads / time, 1.0e9 * time / (double) n);
+    fflush (stdout);
+}
+
+/* run fn with 1, 2, 4, ... max_threads threads */
+static void perf_scale (const char *container, const char *op, perf_fn_t fn)
+{
+    for (int nthreads = 1 ; ; nthreads *= 2) {
+        if (nthreads > max_threads) {
+            nthreads = max_threads;
+        }
+        perf_run (container, op, fn, nthreads, num_ops);
+        if (nthreads == max_threads) {
+            break;
+        }
+    }
+}
+
+static void perf_hash_table (void)
+{
+    OBJ_CONSTRUCT(&hash_table, opal_hash_table_t);
+    opal_hash_table_init (&hash_table, size);
+    for (long i = 0 ; i < size ; ++i) {
+        opal_hash_table_set_value_uint64 (&hash_table, i, (void *) (intptr_t) (i + 1));
+    }
+
+    perf_scale ("hash_table", "get", hash_table_get);
+    perf_run ("hash_table", "set", hash_table_set, 1, size);
+    perf_run ("hash_table", "remove", hash_table_remove, 1, size);
+
+    OBJ_DESTRUCT(&hash_table);
+}
+
+static void perf_pointer_array (void)
+{
+    OBJ_CONSTRUCT(&pointer_array, opal_pointer_array_t);
+    opal_pointer_array_init (&pointer_array, 16, INT_MAX, 16);
+
+    perf_run ("pointer_array", "add", pointer_array_add, 1, size);
+    perf_scale ("pointer_array", "get_item", pointer_array_get);
+    perf_run ("pointer_array", "set_item", pointer_array_set, 1, num_ops);
+
+    OBJ_DESTRUCT(&pointer_array);
+}
+
+static void perf_free_list (void)
+{
+    OBJ_CONSTRUCT(&free_list, opal_free_list_t);
+    opal_free_list_init (&free_list, sizeof (opal_free_list_item_t), 8, OBJ_CLASS(opal_free_list_item_t),
+                         0, 0, (int) size, -1, 64, NULL, 0, NULL, NULL, NULL);
+
+    perf_scale ("free_list", "get_return", free_list_get_return);
+
+    OBJ_DESTRUCT(&free_list);
+}
+
+static void perf_lifo (void)
+{
+    opal_list_item_t *items = (opal_list_item_t *) calloc (size, sizeof (opal_list_item_t));
+    opal_list_item_t *item;
+
+    OBJ_CONSTRUCT(&lifo, opal_lifo_t);
+    for (long i = 0 ; i < size ; ++i) {
+        OBJ_CONSTRUCT(items + i, opal_list_item_t);
+        opal_lifo_push_st (&lifo, items + i);
+    }
+
+    perf_scale ("lifo", "pop_push", lifo_pop_push);
+
+    while (NULL != (item = opal_lifo_pop_st (&lifo))) {
+        OBJ_DESTRUCT(item);
+    }
+    OBJ_DESTRUCT(&lifo);
+    free (items);
+}
+
+static void perf_fifo (void)
+{
+    opal_list_item_t *items = (opal_list_item_t *) calloc (size, sizeof (opal_list_item_t));
+    opal_list_item_t *item;
+
+    OBJ_CONSTRUCT(&fifo, opal_fifo_t);
+    for (long i = 0 ; i < size ; ++i) {
+        OBJ_CONSTRUCT(items + i, opal_list_item_t);
+        opal_fifo_push_st (&fifo, items + i);
+    }
+
+    perf_scale ("fifo", "pop_push", fifo_pop_push);
+
+    while (NULL != (item = opal_fifo_pop_st (&fifo))) {
+        OBJ_DESTRUCT(item);
+    }
+    OBJ_DESTRUCT(&fifo);
+    free (items);
+}
+
+static void perf_interval_tree (void)
+{
+    OBJ_CONSTRUCT(&interval_tree, opal_interval_tree_t);
+    opal_interval_tree_init (&interval_tree);
+    for (long i = 0 ; i < size ; ++i) {
+        opal_interval_tree_insert (&interval_tree, (void *) (intptr_t) (i + 1), i * 8192, i * 8192 + 4096);
+    }
+
+    perf_scale ("interval_tree", "find", interval_tree_find);
+    perf_run ("interval_tree", "insert", interval_tree_insert, 1, size);
+    perf_run ("interval_tree", "delete", interval_tree_delete, 1, size);
+
+    OBJ_DESTRUCT(&interval_tree);
+}
+
+static const struct {
+    const char *name;
+    void (*fn) (void);
+} perf_containers[] = {
+    {"hash_table", perf_hash_table},
+    {"pointer_array", perf_pointer_array},
+    {"free_list", perf_free_list},
+    {"lifo", perf_lifo},
+    {"fifo", perf_fifo},
+    {"interval_tree", perf_interval_tree},
+};
+#define PERF_NUM_CONTAINERS (int) (sizeof (perf_containers) / sizeof (perf_containers[0]))
+
+int main (int argc, char *argv[])
+{
+    int opt, rc;
+
+    max_threads = (int) sysconf (_SC_NPROCESSORS_ONLN);
+
+    while (-1 != (opt = getopt (argc, argv, "t:n:s:"))) {
+        switch (opt) {
+        case 't': max_threads = atoi (optarg); break;
+        case 'n': num_ops = atol (optarg); break;
+        case 's': size = atol (optarg); break;
+        default:
+            fprintf (stderr, "usage: %s [-t max_threads] [-n operations] [-s size] [container ...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (max_threads < 1 || num_ops < 1 || size < 1 || size > INT_MAX) {
+        fprintf (stderr, "opal_class_perf: invalid argument\n");
+        return 1;
+    }
+
+    rc = opal_init_util (&argc, &argv);
+    if (OPAL_SUCCESS != rc) {
+        fprintf (stderr, "opal_class_perf: opal_init_util failed: %d\n", rc);
+        return 1;
+    }
+    /* use the thread safe versions of the operations */
+    opal_set_using_threads (true);
+
+    printf ("%-14s %-14s %7s %14s %10s\n", "container", "operation", "threads", "ops/s", "ns/op");
+    for (int i = 0 ; i < PERF_NUM_CONTAINERS ; ++i) {
+        bool selected = (optind == argc);
+
+        for (int j = optind ; j < argc ; ++j) {
+            selected |= (0 == strcmp (argv[j], perf_containers[i].name));
+        }
+        if (selected) {
+            perf_containers[i].fn ();
+        }
+    }
+
+    opal_finalize_util ();
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Overlap of a non-blocking collective with computation.
+ *
+ * For each message size, time
+ *   comm:    MPI_Iallreduce immediately followed by MPI_Wait
+ *   compute: a compute loop calibrated to last as long as comm
+ *   overlap: MPI_Iallreduce, the compute loop, then MPI_Wait
+ * and report the overlap ratio (comm + compute - overlap) / comm, which
+ * is 0 when the collective only progresses in MPI_Wait and 1 when it is
+ * completely hidden behind the computation. The compute loop does not
+ * call into MPI, so the collective only progresses behind it with the
+ * asynchronous progress thread:
+ *
+ * Usage: mpirun -np N [--mca mpi_async_progress 1] overlap [max_bytes [iterations]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static volatile double sink;
+
+static void compute(long n)
+{
+    double x = 1.0;
+
+    for (long i = 0 ; i < n ; ++i) {
+        x = x * 1.0000001 + 1.0e-9;
+    }
+    sink = x;
+}
+
+/* number of compute loop iterations lasting about seconds */
+static long calibrate(double seconds)
+{
+    long n = 1000;
+    double t;
+
+    for (;;) {
+        t = MPI_Wtime();
+        compute(n);
+        t = MPI_Wtime() - t;
+        if (t > 1.0e-3 || n > (1L << 40)) {
+            break;
+        }
+        n *= 2;
+    }
+
+    n = (long) ((double) n * seconds / t);
+    /* all processes compute for the same number of iterations */
+    MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+    return (n > 0) ? n : 1;
+}
+
+int main(int argc, char **argv)
+{
+    int rank, size, provided, iterations = 100;
+    long max_bytes = 4 * 1024 * 1024;
+    double *sbuf, *rbuf;
+    MPI_Request req;
+
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc > 1) {
+        max_bytes = atol(argv[1]);
+    }
+    if (argc > 2) {
+        iterations = atoi(argv[2]);
+    }
+    if (max_bytes < (long) sizeof(double) || iterations < 1) {
+        fprintf(stderr, "usage: %s [max_bytes [iterations]]\n", argv[0]);
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+
+    sbuf = (double *) malloc(max_bytes);
+    rbuf = (double *) malloc(max_bytes);
+    if (NULL == sbuf || NULL == rbuf) {
+        fprintf(stderr, "out of memory\n");
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+    for (long i = 0 ; i < max_bytes / (long) sizeof(double) ; ++i) {
+        sbuf[i] = (double) (rank + i);
+    }
+
+    if (0 == rank) {
+        printf("%d processes, %d iterations per size\n", size, iterations);
+        printf("%12s %14s %14s %14s %10s\n", "bytes", "comm (us)", "compute (us)",
+               "overlap (us)", "overlap%");
+    }
+
+    for (long bytes = sizeof(double) ; bytes <= max_bytes ; bytes *= 4) {
+        int count = (int) (bytes / sizeof(double));
+        double t_comm, t_comp, t_ovl;
+        long n;
+
+        /* warm up */
+        MPI_Iallreduce(sbuf, rbuf, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t_comm = MPI_Wtime();
+        for (int it = 0 ; it < iterations ; ++it) {
+            MPI_Iallreduce(sbuf, rbuf, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req);
+            MPI_Wait(&req, MPI_STATUS_IGNORE);
+        }
+        t_comm = (MPI_Wtime() - t_comm) / iterations;
+        MPI_Allreduce(MPI_IN_PLACE, &t_comm, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        n = calibrate(t_comm);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t_comp = MPI_Wtime();
+        for (int it = 0 ; it < iterations ; ++it) {
+            compute(n);
+        }
+        t_comp = (MPI_Wtime() - t_comp) / iterations;
+        MPI_Allreduce(MPI_IN_PLACE, &t_comp, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t_ovl = MPI_Wtime();
+        for (int it = 0 ; it < iterations ; ++it) {
+            MPI_Iallreduce(sbuf, rbuf, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req);
+            compute(n);
+            MPI_Wait(&req, MPI_STATUS_IGNORE);
+        }
+        t_ovl = (MPI_Wtime() - t_ovl) / iterations;
+        MPI_Allreduce(MPI_IN_PLACE, &t_ovl, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        if (0 == rank) {
+            double ratio = (t_comm + t_comp - t_ovl) / t_comm;
+            if (ratio < 0.0) ratio = 0.0;
+            if (ratio > 1.0) ratio = 1.0;
+            printf("%12ld %14.2f %14.2f %14.2f %9.1f%%\n", bytes, t_comm * 1.0e6,
+                   t_comp * 1.0e6, t_ovl * 1.0e6, 100.0 * ratio);
+        }
+    }
+
+    free(sbuf);
+    free(rbuf);
+
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Latency of a message that arrives after the receiver has been polling
+ * for a while, to check that the progress backoff
+ * (--mca opal_progress_backoff_max) does not delay it.
+ *
+ * Rank 0 spins for delay microseconds, sends a message to rank 1 and
+ * waits for the reply. Rank 1 waits for the message in one of the
+ * following ways, and replies as soon as it has arrived:
+ *   recv    MPI_Recv
+ *   test    MPI_Irecv, then MPI_Test until complete
+ *   iprobe  MPI_Iprobe until a message is found, then MPI_Recv
+ * While rank 0 spins, the progress engine of rank 1 sees no event, so
+ * its callbacks are backed off if nothing wakes them. The round trip
+ * time measured by rank 0 includes that delay. Compare a run with
+ * backoff_max 0 with a run with backoff_max > 0: the times should be
+ * the same.
+ *
+ * Usage: mpirun -np 2 progress_latency [iterations [delay_us ...]]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *modes[] = {"recv", "test", "iprobe"};
+#define NUM_MODES (int) (sizeof (modes) / sizeof (modes[0]))
+
+static void spin(double us)
+{
+    double end = MPI_Wtime() + us * 1.0e-6;
+
+    while (MPI_Wtime() < end) {
+        ;
+    }
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/* value of an integer control variable, -1 if it does not exist */
+static int cvar_value(const char *name)
+{
+    int index, count, value = -1;
+    MPI_T_cvar_handle handle;
+
+    if (MPI_SUCCESS != MPI_T_cvar_get_index(name, &index) ||
+        MPI_SUCCESS != MPI_T_cvar_handle_alloc(index, NULL, &handle, &count)) {
+        return -1;
+    }
+    if (1 != count || MPI_SUCCESS != MPI_T_cvar_read(handle, &value)) {
+        value = -1;
+    }
+    MPI_T_cvar_handle_free(&handle);
+    return value;
+}
+
+static void run(int mode, double delay, int iterations, double *times)
+{
+    int rank, flag;
+    char msg = 0;
+    MPI_Request req;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    for (int i = 0 ; i < iterations ; ++i) {
+        if (0 == rank) {
+            double start;
+
+            spin(delay);
+            start = MPI_Wtime();
+            MPI_Send(&msg, 1, MPI_CHAR, 1, 0, MPI_COMM_WORLD);
+            MPI_Recv(&msg, 1, MPI_CHAR, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            times[i] = MPI_Wtime() - start;
+        } else if (1 == rank) {
+            switch (mode) {
+            case 0:
+                MPI_Recv(&msg, 1, MPI_CHAR, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                break;
+            case 1:
+                MPI_Irecv(&msg, 1, MPI_CHAR, 0, 0, MPI_COMM_WORLD, &req);
+                do {
+                    MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+                } while (!flag);
+                break;
+            default:
+                do {
+                    MPI_Iprobe(0, 0, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+                } while (!flag);
+                MPI_Recv(&msg, 1, MPI_CHAR, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                break;
+            }
+            MPI_Send(&msg, 1, MPI_CHAR, 0, 0, MPI_COMM_WORLD);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const double default_delays[] = {0.0, 100.0, 1000.0};
+    const double *delays = default_delays;
+    int rank, nprocs, provided, iterations = 1000, num_delays = 3;
+    double *times, *argv_delays = NULL;
+
+    MPI_Init(&argc, &argv);
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    if (argc > 1) {
+        iterations = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        num_delays = argc - 2;
+        argv_delays = malloc(num_delays * sizeof(double));
+        for (int d = 0 ; d < num_delays ; ++d) {
+            argv_delays[d] = atof(argv[d + 2]);
+        }
+        delays = argv_delays;
+    }
+    if (nprocs < 2 || iterations < 1) {
+        if (0 == rank) {
+            fprintf(stderr, "usage: mpirun -np 2 %s [iterations [delay_us ...]]\n", argv[0]);
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    times = malloc(iterations * sizeof(double));
+    if (0 == rank) {
+        printf("opal_progress_backoff_max %d, %d iterations\n",
+               cvar_value("opal_progress_backoff_max"), iterations);
+        printf("%-8s %10s %12s %12s %12s\n", "mode", "delay (us)", "median (us)",
+               "avg (us)", "max (us)");
+    }
+
+    for (int m = 0 ; m < NUM_MODES ; ++m) {
+        for (int d = 0 ; d < num_delays ; ++d) {
+            run(m, delays[d], iterations, times);
+            if (0 == rank) {
+                double sum = 0.0;
+
+                qsort(times, iterations, sizeof(double), cmp_double);
+                for (int i = 0 ; i < iterations ; ++i) {
+                    sum += times[i];
+                }
+                printf("%-8s %10.0f %12.2f %12.2f %12.2f\n", modes[m], delays[d],
+                       times[iterations / 2] * 1.0e6, sum / iterations * 1.0e6,
+                       times[iterations - 1] * 1.0e6);
+            }
+        }
+    }
+
+    free(times);
+    free(argv_delays);
+    MPI_T_finalize();
+    MPI_Finalize();
+    return 0;
+}
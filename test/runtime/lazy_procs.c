@@ -0,0 +1,154 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Check the mpi_lazy_procs mode: after MPI_Init no remote process
+ * structure may exist yet, a peer must be created and resolved from the
+ * modex by the first message exchanged with it, peers that were never
+ * addressed must stay unresolved until then, MPI_COMM_TYPE_SHARED and
+ * the remote peer check must see the node-local peers without creating
+ * them, and peers created on demand must still carry their node
+ * locality.
+ *
+ * The test enables the mode itself. It needs a PML that does not
+ * require all processes at startup (e.g. ob1) and several processes:
+ *
+ *   mpirun -np 4 lazy_procs
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/group/group.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/proc/proc.h"
+
+static int rank, size, errors = 0;
+
+static ompi_proc_t *existing_peer(int peer)
+{
+    return ompi_group_peer_lookup_existing(MPI_COMM_WORLD->c_remote_group, peer);
+}
+
+static void check(bool cond, const char *what, int peer)
+{
+    if (!cond) {
+        fprintf(stderr, "lazy_procs: rank %d peer %d: %s\n", rank, peer, what);
+        ++errors;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int left, right, far, sbuf, rbuf, shared_size, shared_rank, local_peers, len, total;
+    char host[MPI_MAX_PROCESSOR_NAME], *hosts;
+    MPI_Comm shared;
+    ompi_proc_t *proc;
+
+    setenv("OMPI_MCA_mpi_lazy_procs", "1", 0);
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (size < 2 || mca_pml_base_requires_world()) {
+        if (0 == rank) {
+            fprintf(stderr, "lazy_procs: needs at least 2 processes and a PML "
+                    "that supports lazy process creation, skipped\n");
+        }
+        MPI_Finalize();
+        return 77;
+    }
+
+    left = (rank + size - 1) % size;
+    right = (rank + 1) % size;
+    far = (rank + size / 2) % size;
+
+    /* nothing but the local proc exists after MPI_Init */
+    for (int peer = 0 ; peer < size ; ++peer) {
+        if (peer != rank) {
+            check(NULL == existing_peer(peer), "created during MPI_Init", peer);
+        }
+    }
+
+    /* the first exchange creates the neighbours */
+    sbuf = rank;
+    MPI_Sendrecv(&sbuf, 1, MPI_INT, right, 0, &rbuf, 1, MPI_INT, left, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    check(rbuf == left, "wrong data received", left);
+
+    for (int i = 0 ; i < 2 ; ++i) {
+        int peer = i ? right : left;
+
+        proc = existing_peer(peer);
+        check(NULL != proc, "not created by the first message", peer);
+        if (NULL != proc) {
+            check(0 != proc->super.proc_arch, "architecture not resolved", peer);
+        }
+    }
+
+    /* a peer that was never addressed stays unresolved */
+    if (far != left && far != right && far != rank) {
+        check(NULL == existing_peer(far), "created without being addressed", far);
+    }
+
+    /* node-local peers are still sentinels, but MPI_COMM_TYPE_SHARED
+     * must find all of them */
+    MPI_Get_processor_name(host, &len);
+    hosts = malloc(size * MPI_MAX_PROCESSOR_NAME);
+    MPI_Allgather(host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, hosts, MPI_MAX_PROCESSOR_NAME,
+                  MPI_CHAR, MPI_COMM_WORLD);
+    local_peers = 0;
+    for (int peer = 0 ; peer < size ; ++peer) {
+        local_peers += (0 == strcmp(host, hosts + peer * MPI_MAX_PROCESSOR_NAME));
+    }
+    free(hosts);
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shared);
+    MPI_Comm_size(shared, &shared_size);
+    MPI_Comm_rank(shared, &shared_rank);
+    check(shared_size == local_peers, "wrong MPI_COMM_TYPE_SHARED size", rank);
+    check(!ompi_group_have_remote_peers(shared->c_local_group),
+          "remote peers in MPI_COMM_TYPE_SHARED", rank);
+    check(ompi_group_have_remote_peers(MPI_COMM_WORLD->c_local_group) == (local_peers < size),
+          "wrong remote peers in MPI_COMM_WORLD", rank);
+
+    /* neither of the above may create a proc */
+    if (far != left && far != right && far != rank) {
+        check(NULL == existing_peer(far), "created by the locality checks", far);
+    }
+
+    /* peers sharing the node must get their locality on creation */
+    for (int d = 1 ; d < shared_size ; ++d) {
+        MPI_Sendrecv(&sbuf, 1, MPI_INT, (shared_rank + d) % shared_size, 1, &rbuf, 1, MPI_INT,
+                     (shared_rank + shared_size - d) % shared_size, 1, shared, MPI_STATUS_IGNORE);
+    }
+    for (int peer = 0 ; peer < shared_size ; ++peer) {
+        proc = ompi_group_peer_lookup_existing(shared->c_local_group, peer);
+        check(NULL != proc, "node-local peer not created", peer);
+        if (NULL != proc && proc != ompi_proc_local()) {
+            check(OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags),
+                  "node-local peer without local node flag", peer);
+        }
+    }
+    MPI_Comm_free(&shared);
+
+    MPI_Allreduce(&errors, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("lazy_procs: %s (%d errors on %d processes)\n",
+               total ? "FAILED" : "passed", total, size);
+    }
+
+    MPI_Finalize();
+    return total ? 1 : 0;
+}
@@ -0,0 +1,265 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Measure the cost of the process-table setup performed during MPI_Init
+ * as a function of the job size, without a resource manager.
+ *
+ * A small in-memory key/value store stands in for the PMIx server: it is
+ * populated with the hostname, locality and architecture of every
+ * simulated rank (the data a real launcher would publish) before the
+ * clock starts. Each simulated rank then builds its process table either
+ *
+ *   eager: one entry and three modex lookups for every rank in the job
+ *          (what ompi_proc_complete_init() does below mpi_add_procs_cutoff)
+ *   lazy:  entries only for the peers it actually talks to, here the
+ *          O(log P) partners of a binomial tree (mpi_lazy_procs=1)
+ *
+ * Usage: lazy_procs_init [max_ranks [samples]]
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "opal/runtime/opal.h"
+#include "opal/constants.h"
+#include "opal/class/opal_hash_table.h"
+#include "opal/util/printf.h"
+
+#define MODEX_KEY_HOSTNAME 0
+#define MODEX_KEY_LOCALITY 1
+#define MODEX_KEY_ARCH     2
+#define MODEX_NUM_KEYS     3
+
+#define RANKS_PER_NODE     64
+
+typedef struct {
+    char hostname[32];
+    uint16_t locality;
+    uint32_t arch;
+} test_proc_t;
+
+/* stand-in for the PMIx server side data store */
+static opal_hash_table_t modex_store;
+
+static double wtime(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + (double) tv.tv_usec * 1.0e-6;
+}
+
+static uint64_t modex_key(uint32_t vpid, int key)
+{
+    return ((uint64_t) vpid << 8) | (uint64_t) key;
+}
+
+static int modex_publish(uint32_t nranks)
+{
+    for (uint32_t vpid = 0 ; vpid < nranks ; ++vpid) {
+        char *hostname;
+        uint16_t *locality;
+        uint32_t *arch;
+
+        if (0 > opal_asprintf(&hostname, "node%05u", vpid / RANKS_PER_NODE)) {
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+        locality = malloc(sizeof(*locality));
+        arch = malloc(sizeof(*arch));
+        if (NULL == locality || NULL == arch) {
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+        *locality = 0;
+        *arch = 0x4c000000;
+
+        opal_hash_table_set_value_uint64(&modex_store, modex_key(vpid, MODEX_KEY_HOSTNAME), hostname);
+        opal_hash_table_set_value_uint64(&modex_store, modex_key(vpid, MODEX_KEY_LOCALITY), locality);
+        opal_hash_table_set_value_uint64(&modex_store, modex_key(vpid, MODEX_KEY_ARCH), arch);
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static void modex_release(void)
+{
+    uint64_t key;
+    void *value, *node = NULL;
+    int ret;
+
+    ret = opal_hash_table_get_first_key_uint64(&modex_store, &key, &value, &node);
+    while (OPAL_SUCCESS == ret) {
+        free(value);
+        ret = opal_hash_table_get_next_key_uint64(&modex_store, &key, &value, node, &node);
+    }
+    opal_hash_table_remove_all(&modex_store);
+}
+
+static int proc_for_vpid(opal_hash_table_t *procs, uint32_t vpid)
+{
+    test_proc_t *proc;
+    void *value;
+
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(procs, vpid, (void **) &proc)) {
+        return OPAL_SUCCESS;
+    }
+
+    proc = calloc(1, sizeof(*proc));
+    if (NULL == proc) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&modex_store, modex_key(vpid, MODEX_KEY_HOSTNAME), &value)) {
+        strncpy(proc->hostname, (char *) value, sizeof(proc->hostname) - 1);
+    }
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&modex_store, modex_key(vpid, MODEX_KEY_LOCALITY), &value)) {
+        proc->locality = *(uint16_t *) value;
+    }
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&modex_store, modex_key(vpid, MODEX_KEY_ARCH), &value)) {
+        proc->arch = *(uint32_t *) value;
+    }
+
+    return opal_hash_table_set_value_uint64(procs, vpid, proc);
+}
+
+static void procs_release(opal_hash_table_t *procs)
+{
+    uint64_t key;
+    void *value, *node = NULL;
+    int ret;
+
+    ret = opal_hash_table_get_first_key_uint64(procs, &key, &value, &node);
+    while (OPAL_SUCCESS == ret) {
+        free(value);
+        ret = opal_hash_table_get_next_key_uint64(procs, &key, &value, node, &node);
+    }
+    OBJ_DESTRUCT(procs);
+}
+
+static int init_eager(uint32_t nranks, size_t *nprocs)
+{
+    opal_hash_table_t procs;
+    int ret = OPAL_SUCCESS;
+
+    OBJ_CONSTRUCT(&procs, opal_hash_table_t);
+    opal_hash_table_init(&procs, nranks);
+
+    /* the local proc is created like any other */
+    for (uint32_t vpid = 0 ; vpid < nranks && OPAL_SUCCESS == ret ; ++vpid) {
+        ret = proc_for_vpid(&procs, vpid);
+    }
+
+    *nprocs = opal_hash_table_get_size(&procs);
+    procs_release(&procs);
+    return ret;
+}
+
+static int init_lazy(uint32_t nranks, uint32_t my_vpid, size_t *nprocs)
+{
+    opal_hash_table_t procs;
+    int ret;
+
+    OBJ_CONSTRUCT(&procs, opal_hash_table_t);
+    opal_hash_table_init(&procs, 1024);
+
+    /* the local proc is always created */
+    ret = proc_for_vpid(&procs, my_vpid);
+
+    /* first communication with the binomial tree partners */
+    for (uint32_t mask = 1 ; mask < nranks && OPAL_SUCCESS == ret ; mask <<= 1) {
+        uint32_t peer = my_vpid ^ mask;
+        if (peer < nranks) {
+            ret = proc_for_vpid(&procs, peer);
+        }
+    }
+
+    *nprocs = opal_hash_table_get_size(&procs);
+    procs_release(&procs);
+    return ret;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t max_ranks = 65536, samples = 8;
+    int ret;
+
+    if (argc > 1) {
+        max_ranks = (uint32_t) strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        samples = (uint32_t) strtoul(argv[2], NULL, 10);
+    }
+    if (0 == samples) {
+        samples = 1;
+    }
+
+    ret = opal_init_util(&argc, &argv);
+    if (OPAL_SUCCESS != ret) {
+        return (-1 * ret);
+    }
+
+    OBJ_CONSTRUCT(&modex_store, opal_hash_table_t);
+    opal_hash_table_init(&modex_store, (size_t) max_ranks * MODEX_NUM_KEYS);
+
+    printf("%10s %14s %10s %14s %10s %8s\n", "ranks", "eager (us)", "procs",
+           "lazy (us)", "procs", "speedup");
+
+    for (uint32_t nranks = 64 ; nranks <= max_ranks ; nranks <<= 2) {
+        double eager_time = 0.0, lazy_time = 0.0, start;
+        size_t eager_procs = 0, lazy_procs = 0;
+
+        ret = modex_publish(nranks);
+        if (OPAL_SUCCESS != ret) {
+            break;
+        }
+
+        /* sample a few different simulated ranks from the same job */
+        for (uint32_t i = 0 ; i < samples ; ++i) {
+            uint32_t my_vpid = (uint32_t) (((uint64_t) i * nranks) / samples);
+
+            start = wtime();
+            ret = init_eager(nranks, &eager_procs);
+            eager_time += wtime() - start;
+            if (OPAL_SUCCESS != ret) {
+                break;
+            }
+
+            start = wtime();
+            ret = init_lazy(nranks, my_vpid, &lazy_procs);
+            lazy_time += wtime() - start;
+            if (OPAL_SUCCESS != ret) {
+                break;
+            }
+        }
+
+        modex_release();
+        if (OPAL_SUCCESS != ret) {
+            break;
+        }
+
+        eager_time = eager_time * 1.0e6 / samples;
+        lazy_time = lazy_time * 1.0e6 / samples;
+        printf("%10u %14.2f %10zu %14.2f %10zu %7.1fx\n", nranks, eager_time, eager_procs,
+               lazy_time, lazy_procs, (lazy_time > 0.0) ? eager_time / lazy_time : 0.0);
+
+        /* lazy mode must never create more than log2(P) + 1 procs */
+        if (eager_procs != nranks || lazy_procs > 33) {
+            fprintf(stderr, "unexpected process table size\n");
+            ret = OPAL_ERROR;
+            break;
+        }
+    }
+
+    OBJ_DESTRUCT(&modex_store);
+    opal_finalize_util();
+
+    return (OPAL_SUCCESS == ret) ? 0 : 1;
+}